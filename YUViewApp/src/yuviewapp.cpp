@@ -33,6 +33,7 @@
 #include <QCoreApplication>
 
 #include "common/typedef.h"
+#include "handler/commandLineHandler.h"
 #include "ui/YUViewApplication.h"
 
 int main(int argc, char *argv[])
@@ -45,6 +46,10 @@ int main(int argc, char *argv[])
   QCoreApplication::setAttribute(Qt::AA_SynthesizeTouchForUnhandledMouseEvents,false);
 
   qRegisterMetaType<recacheIndicator>("recacheIndicator");
+
+  // Batch processing without a display (YUView -headless <command> ...). No window is created.
+  if (commandLineHandler::isHeadlessCall(argc, argv))
+    return commandLineHandler::runHeadless(argc, argv);
   
   YUViewApplication app(argc, argv);
 
@@ -42,6 +42,7 @@
 #endif
 
 #include <QIcon>
+#include <QPainter>
 #include <QSettings>
 #include <QThread>
 
@@ -103,6 +104,14 @@ unsigned int functions::getOptimalThreadCount()
     return 1;
 }
 
+QRectF functions::getVisiblePaintRect(QPainter *painter)
+{
+  QRectF visibleRect = painter->combinedTransform().inverted().mapRect(QRectF(painter->viewport()));
+  if (painter->hasClipping())
+    visibleRect &= painter->clipBoundingRect();
+  return visibleRect;
+}
+
 unsigned int functions::systemMemorySizeInMB()
 {
   static unsigned int memorySizeInMB;
@@ -36,6 +36,8 @@
 
 #include "typedef.h"
 
+class QPainter;
+
 namespace functions
 {
 
@@ -99,6 +101,9 @@ void setupUi(void *ui, void(*setupUi)(void *ui, QWidget *widget));
 // so that one thread is "reserved" for the main GUI. I don't know if this is optimal.
 unsigned int getOptimalThreadCount();
 
+// Get the part of the paint device that is visible (the viewport and the clip region) in the coordinates of the painter
+QRectF getVisiblePaintRect(QPainter *painter);
+
 // Returns the size of system memory in megabytes.
 // This function is thread safe and inexpensive to call.
 unsigned int systemMemorySizeInMB();
@@ -200,6 +200,16 @@ private:
 // If the zoom factor is >= this value, the statistics values will be drawn alongside the blocks.
 #define STATISTICS_DRAW_VALUES_ZOOM 16
 
+// If the zoom factor is below this value, the statistics blocks are drawn into an image at display resolution
+// instead of one by one and the vectors are combined into bins of STATISTICS_LOD_VECTOR_BIN_SIZE display pixels.
+#define STATISTICS_LOD_ZOOM 1
+#define STATISTICS_LOD_VECTOR_BIN_SIZE 16
+
+// The statistics handler keeps the statistics of up to this many frames (besides the current frame) in memory.
+// During playback, the statistics of the next STATISTICS_PREFETCH_FRAMES frames are loaded in advance.
+#define STATISTICS_CACHE_FRAMES 16
+#define STATISTICS_PREFETCH_FRAMES 4
+
 // If this macro is set to true, YUView will try to self update if an update is available.
 // If it is set to false, we will still check for updates, but the update feature is 
 // disabled. Do not set this manually in your own build because the update feature will
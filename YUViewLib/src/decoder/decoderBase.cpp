@@ -32,9 +32,12 @@
 
 #include "decoderBase.h"
 
+#include <algorithm>
 #include <QDir>
 #include <QSettings>
 
+#include "common/functions.h"
+
 using namespace YUView;
 
 // Debug the decoder ( 0:off 1:interactive deocder only 2:caching decoder only 3:both)
@@ -57,6 +60,12 @@ decoderBase::decoderBase(bool cachingDecoder)
   DEBUG_DECODERBASE("decoderBase::decoderBase create base%s", cachingDecoder ? " - caching" : "");
   isCachingDecoder = cachingDecoder;
 
+  QSettings settings;
+  settings.beginGroup("Decoders");
+  nrDecoderThreadsSetting = settings.value(cachingDecoder ? "ThreadsCaching" : "ThreadsInteractive", 0).toInt();
+  nrCachingDecoders = clip(settings.value("CachingDecoders", 1).toInt(), 1, 16);
+  settings.endGroup();
+
   resetDecoder();
 }
 
@@ -70,6 +79,24 @@ void decoderBase::resetDecoder()
   rawFormat = raw_Invalid;
 }
 
+int decoderBase::getNrDecoderThreads() const
+{
+  if (nrDecoderThreadsSetting > 0)
+    return nrDecoderThreadsSetting;
+  // Auto: The caching decoders run in parallel and share the available threads.
+  const int optimalThreads = int(functions::getOptimalThreadCount());
+  if (isCachingDecoder)
+    return std::max(optimalThreads / nrCachingDecoders, 1);
+  return optimalThreads;
+}
+
+bool decoderBase::useFrameThreads() const
+{
+  // Frame threading adds a delay of several frames to every seek. In auto mode, the interactive
+  // decoder only uses slice/tile threads so that it stays responsive.
+  return isCachingDecoder || nrDecoderThreadsSetting > 0;
+}
+
 statisticsData decoderBase::getStatisticsData(int typeIdx)
 {
   if (!retrieveStatistics)
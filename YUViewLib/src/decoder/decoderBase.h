@@ -118,6 +118,16 @@ protected:
   int decodeSignal { 0 }; ///< Which signal should be decoded?
   bool isCachingDecoder; ///< Is this the caching or the interactive decoder?
 
+  // How many threads should the decoder library use (frame/slice/tile/wavefront threads, depending on the library)?
+  // This is set separately for the interactive and the caching decoder in the settings ("Decoders/ThreadsInteractive" and
+  // "Decoders/ThreadsCaching") and read when the decoder is created. A setting of 0 (the default) selects the thread count
+  // automatically: The caching decoders split the optimal thread count between them and the interactive decoder does not use
+  // frame threads (see useFrameThreads).
+  int getNrDecoderThreads() const;
+  bool useFrameThreads() const;
+  int nrDecoderThreadsSetting { 0 };
+  int nrCachingDecoders { 1 };
+
   bool internalsSupported { false };  ///< Enable in the constructor if you support statistics
   bool retrieveStatistics { false };  ///< If enabled, the decoder should also retrive statistics data from the bitstream
   QSize frameSize;
@@ -182,6 +182,12 @@ void decoderDav1d::allocateNewDecoder()
 
   dav1d_default_settings(&settings);
 
+  // Dav1d decodes multiple frames in parallel and can use multiple threads for the tiles of each frame.
+  // Use up to 4 tile threads and split the remaining threads over the frames.
+  const int nrThreads = getNrDecoderThreads();
+  settings.n_tile_threads = clip(nrThreads, 1, 4);
+  settings.n_frame_threads = useFrameThreads() ? clip(nrThreads / settings.n_tile_threads, 1, 256) : 1;
+
   // Create new decoder object
   int err = dav1d_open(&decoder, &settings);
   if (err != 0)
@@ -455,6 +455,14 @@ bool decoderFFmpeg::createDecoder(AVCodecIDWrapper codecID, AVCodecParametersWra
   if (ret < 0)
     return this->setErrorB(QStringLiteral("Could not request motion vector retrieval. Return code %1").arg(ret));
 
+  // Decode with multiple frame and slice threads. Which one is used depends on the codec and the stream.
+  ret = this->ff.av_dict_set(opts, "threads", QString::number(this->getNrDecoderThreads()).toLatin1().constData(), 0);
+  if (ret < 0)
+    return this->setErrorB(QStringLiteral("Could not set the number of decoder threads. Return code %1").arg(ret));
+  ret = this->ff.av_dict_set(opts, "thread_type", this->useFrameThreads() ? "frame+slice" : "slice", 0);
+  if (ret < 0)
+    return this->setErrorB(QStringLiteral("Could not set the decoder thread type. Return code %1").arg(ret));
+
   // Open codec
   ret = this->ff.avcodec_open2(decCtx, videoCodec, opts);
   if (ret < 0)
@@ -32,6 +32,7 @@
 
 #include "decoderLibde265.h"
 
+#include <algorithm>
 #include <cstring>
 #include <QCoreApplication>
 #include <QDir>
@@ -221,8 +222,8 @@ void decoderLibde265::allocateNewDecoder()
   de265_set_limit_TID(decoder, 100);
 
   // Set the number of decoder threads. Libde265 can use wavefronts to utilize these.
-  // TODO: We should add a setting for this maybe?
-  de265_error err = de265_start_worker_threads(decoder, 8);
+  // Libde265 can not use more than 32 threads.
+  de265_error err = de265_start_worker_threads(decoder, std::min(getNrDecoderThreads(), 32));
   if (err != DE265_OK)
     return setError("Error starting libde265 worker threads (de265_start_worker_threads)");
 
@@ -56,6 +56,11 @@ FileSource::FileSource()
   connect(&fileWatcher, &QFileSystemWatcher::fileChanged, this, &FileSource::fileSystemWatcherFileChanged);
 }
 
+FileSource::~FileSource()
+{
+  qDeleteAll(idleReadHandles);
+}
+
 bool FileSource::openFile(const QString &filePath)
 {
   // Check if the file exists
@@ -65,6 +70,7 @@ bool FileSource::openFile(const QString &filePath)
 
   if (isFileOpened && srcFile.isOpen())
     srcFile.close();
+  unmapFile();
 
   // open file for reading
   srcFile.setFileName(filePath);
@@ -72,8 +78,13 @@ bool FileSource::openFile(const QString &filePath)
   if (!isFileOpened)
     return false;
 
-  // Save the full file path
+  // Save the full file path. Handles to the old file that are still in use (readBytes) are closed when they are returned.
+  readMutex.lock();
   fullFilePath = filePath;
+  qDeleteAll(idleReadHandles);
+  idleReadHandles.clear();
+  readHandlesFileGeneration++;
+  readMutex.unlock();
 
   // Install a watcher for the file (if file watching is active)
   updateFileWatchSetting();
@@ -103,17 +114,66 @@ int64_t FileSource::readBytes(QByteArray &targetBuffer, int64_t startPos, int64_
   if(!isOk())
     return 0;
 
-  if (targetBuffer.size() < nrBytes)
-    targetBuffer.resize(nrBytes);
-
 #if FILESOURCE_DEBUG_SIMULATESLOWLOADING && !NDEBUG
   QThread::msleep(50);
 #endif
 
-  // lock the seek and read function
+  // If the requested data is in the mapping, just point to it. Everything else (e.g. data that was appended to
+  // the file after it was mapped) is read from the file.
+  const auto mapping = activeMapping.load();
+  if (mapping != nullptr && startPos >= 0 && startPos + nrBytes <= mapping->size)
+  {
+    targetBuffer = QByteArray::fromRawData((const char*)mapping->data + startPos, int(nrBytes));
+    return nrBytes;
+  }
+
+  if (targetBuffer.size() < nrBytes)
+    targetBuffer.resize(nrBytes);
+
+  int fileGeneration;
+  auto handle = takeReadHandle(fileGeneration);
+  if (handle == nullptr)
+    return 0;
+
+  int64_t nrBytesRead = 0;
+  if (handle->seek(startPos))
+    nrBytesRead = handle->read(targetBuffer.data(), nrBytes);
+
+  returnReadHandle(handle, fileGeneration);
+  return nrBytesRead;
+}
+
+QFile *FileSource::takeReadHandle(int &fileGeneration)
+{
+  readMutex.lock();
+  fileGeneration = readHandlesFileGeneration;
+  if (!idleReadHandles.isEmpty())
+  {
+    auto handle = idleReadHandles.takeLast();
+    readMutex.unlock();
+    return handle;
+  }
+  const auto filePath = fullFilePath;
+  readMutex.unlock();
+
+  // Open a new handle. The reads are usually big (whole frames), so we don't need the buffering of QFile.
+  auto handle = new QFile(filePath);
+  if (!handle->open(QIODevice::ReadOnly | QIODevice::Unbuffered))
+  {
+    delete handle;
+    return nullptr;
+  }
+  return handle;
+}
+
+void FileSource::returnReadHandle(QFile *handle, int fileGeneration)
+{
   QMutexLocker locker(&readMutex);
-  srcFile.seek(startPos);
-  return srcFile.read(targetBuffer.data(), nrBytes);
+  if (fileGeneration == readHandlesFileGeneration)
+    idleReadHandles.append(handle);
+  else
+    // The file was reopened in the meantime
+    delete handle;
 }
 
 QList<infoItem> FileSource::getFileInfoList() const
@@ -326,6 +386,56 @@ void FileSource::updateFileWatchSetting()
     fileWatcher.removePath(fullFilePath);
 }
 
+void FileSource::fileSystemWatcherFileChanged(const QString &path)
+{
+  Q_UNUSED(path);
+  fileChanged = true;
+  // The file might have been truncated. Accessing the mapping beyond the new end of the file would crash (SIGBUS),
+  // so all following reads go to the file. The owner has to drop its data and call unmapFile().
+  activeMapping = nullptr;
+}
+
+void FileSource::updateMemoryMapSetting()
+{
+  QSettings settings;
+  if (!isFileOpened || !settings.value("VideoCache/MemoryMapFiles", false).toBool())
+  {
+    // Stop using the mapping. Data that was returned by readBytes stays valid (see fileMapping).
+    activeMapping = nullptr;
+    return;
+  }
+  if (activeMapping.load() != nullptr)
+    return;
+  if (fileMapping)
+  {
+    // Reuse the existing mapping of the file
+    activeMapping = fileMapping.data();
+    return;
+  }
+
+  // Map the file using its own QFile. The mapping stays valid if srcFile is closed.
+  QScopedPointer<FileMapping> mapping(new FileMapping);
+  mapping->file.setFileName(fullFilePath);
+  if (!mapping->file.open(QIODevice::ReadOnly))
+    return;
+  mapping->size = mapping->file.size();
+  if (mapping->size <= 0)
+    return;
+  mapping->data = mapping->file.map(0, mapping->size);
+  if (mapping->data == nullptr)
+    // Mapping failed (e.g. not enough address space). We will keep reading from the file.
+    return;
+
+  fileMapping.swap(mapping);
+  activeMapping = fileMapping.data();
+}
+
+void FileSource::unmapFile()
+{
+  activeMapping = nullptr;
+  fileMapping.reset();
+}
+
 void FileSource::clearFileCache()
 {
   if (!isFileOpened)
@@ -336,6 +446,8 @@ void FileSource::clearFileCache()
   // Suggested: http://stackoverflow.com/questions/478340/clear-file-cache-to-repeat-performance-testing
   QMutexLocker locker(&readMutex);
   srcFile.close();
+  qDeleteAll(idleReadHandles);
+  idleReadHandles.clear();
 
   LPCWSTR file = (const wchar_t*) fullFilePath.utf16();
   HANDLE hFile = CreateFile(file, GENERIC_READ, 0, NULL, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, NULL);
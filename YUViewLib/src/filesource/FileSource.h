@@ -32,11 +32,14 @@
 
 #pragma once
 
+#include <atomic>
+
 #include <QFile>
 #include <QFileInfo>
 #include <QFileSystemWatcher>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QScopedPointer>
 #include <QSize>
 #include <QString>
 
@@ -52,6 +55,7 @@ class FileSource : public QObject
 
 public:
   FileSource();
+  virtual ~FileSource();
 
   // Try to open the given file and install a watcher for the file.
   virtual bool openFile(const QString &filePath);
@@ -71,7 +75,7 @@ public:
   virtual bool atEnd() const { return !isFileOpened ? true : srcFile.atEnd(); }
   QByteArray readLine() { return !isFileOpened ? QByteArray() : srcFile.readLine(); }
   virtual bool seek(int64_t pos) { return !isFileOpened ? false : srcFile.seek(pos); }
-  int64_t pos() { return !isFileOpened ? 0 : srcFile.pos(); }
+  virtual int64_t pos() { return !isFileOpened ? 0 : srcFile.pos(); }
 
   // Guess the format (width, height, framerate, packed/planar) from the file name.
   // Certain patterns are recognized. E.g: "something_352x288_24.yuv"
@@ -89,6 +93,10 @@ public:
 
   // Read the given number of bytes starting at startPos into the QByteArray out
   // Resize the QByteArray if necessary. Return how many bytes were read.
+  // This does not change the position of the file (pos()) and can be called by multiple threads at the same time.
+  // If the file is memory mapped, the QByteArray is set to point to the data in the mapping instead. No data is copied
+  // in this case. Writing to the QByteArray will detach it from the mapping (see QByteArray::fromRawData). The data
+  // stays valid until the file is unmapped (unmapFile() or openFile()).
   int64_t readBytes(QByteArray &targetBuffer, int64_t startPos, int64_t nrBytes);
 #if SSE_CONVERSION
   void readBytes(byteArrayAligned &data, int64_t startPos, int64_t nrBytes);
@@ -103,12 +111,19 @@ public:
   bool isFileChanged() { bool b = fileChanged; fileChanged = false; return b; }
   // Check if we are supposed to watch the file for changes. If no, remove the file watcher. If yes, install one.
   void updateFileWatchSetting();
+  // Check if we are supposed to memory map the file. If yes, map the file (if it is not mapped yet). If no, stop
+  // reading from the mapping.
+  void updateMemoryMapSetting();
+  bool isMemoryMapped() const { return activeMapping.load() != nullptr; }
+  bool hasFileMapping() const { return !fileMapping.isNull(); }
+  // Unmap the file. All data that readBytes returned from the mapping is invalid afterwards.
+  void unmapFile();
 
   // Clear the cache of the file in the system. Currently only windows supported.
   void clearFileCache();
 
 private slots:
-  void fileSystemWatcherFileChanged(const QString &path) { Q_UNUSED(path); fileChanged = true; }
+  void fileSystemWatcherFileChanged(const QString &path);
 
 protected:
   // Info on the source file.
@@ -124,6 +139,25 @@ private:
   QFileSystemWatcher fileWatcher;
   bool fileChanged;
 
-  // protect the read function with a mutex
+  // readBytes reads from its own handles to the file (not from srcFile). Every reading thread takes one of the idle
+  // handles (or opens a new one) and puts it back when it is done. So multiple threads can read at the same time
+  // and each read only has to lock the readMutex for taking and returning the handle.
+  QFile *takeReadHandle(int &fileGeneration);
+  void returnReadHandle(QFile *handle, int fileGeneration);
+  QList<QFile*> idleReadHandles;
+  int readHandlesFileGeneration {0};
   QMutex readMutex;
+
+  // A read only memory mapping of the whole file. Reads within the mapping do not need any file handle.
+  struct FileMapping
+  {
+    ~FileMapping() { if (data != nullptr) file.unmap(const_cast<uchar*>(data)); }
+    QFile file;
+    const uchar *data {nullptr};
+    int64_t size {0};
+  };
+  std::atomic<FileMapping*> activeMapping {nullptr};
+  // Data returned by readBytes may still point into the mapping if it is not active anymore (e.g. if memory mapping
+  // was switched off). So the mapping is kept (and reused if mapping is switched on again) until the file is unmapped.
+  QScopedPointer<FileMapping> fileMapping;
 };
@@ -32,6 +32,11 @@
 
 #include "FileSourceAnnexBFile.h"
 
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include "StartCodeSearch.h"
+
 #define ANNEXBFILE_DEBUG_OUTPUT 0
 #if ANNEXBFILE_DEBUG_OUTPUT && !NDEBUG
 #include <QDebug>
@@ -41,11 +46,16 @@
 #endif
 
 const auto BUFFERSIZE = 500000;
-const auto STARTCODE = QByteArrayLiteral("\x00\x00\x01");
 
 FileSourceAnnexBFile::FileSourceAnnexBFile()
 {
   this->fileBuffer.resize(BUFFERSIZE);
+  this->readAheadBuffer.resize(BUFFERSIZE);
+}
+
+FileSourceAnnexBFile::~FileSourceAnnexBFile()
+{
+  this->waitForReadAhead();
 }
 
 // Open the file and fill the read buffer. 
@@ -54,13 +64,16 @@ bool FileSourceAnnexBFile::openFile(const QString &fileName)
   DEBUG_ANNEXBFILE("FileSourceAnnexBFile::openFile fileName " << fileName);
 
   // Open the input file (again)
+  this->waitForReadAhead();
   FileSource::openFile(fileName);
 
   // Fill the buffer
+  this->bufferStartPosInFile = 0;
   this->fileBufferSize = srcFile.read(this->fileBuffer.data(), BUFFERSIZE);
   if (this->fileBufferSize == 0)
     // The file is empty of there was an error reading from the file.
     return false;
+  this->startReadAhead();
 
   // Discard all bytes until we find a start code
   this->seekToFirstNAL();
@@ -74,7 +87,7 @@ bool FileSourceAnnexBFile::atEnd() const
 
 void FileSourceAnnexBFile::seekToFirstNAL()
 {
-  auto nextStartCodePos = this->fileBuffer.indexOf(STARTCODE);
+  auto nextStartCodePos = StartCodeSearch::findStartCode(this->fileBuffer.constData(), int64_t(this->fileBufferSize));
   if (nextStartCodePos < 0)
     // The first buffer does not contain a start code. This is very unusual. Use the normal getNextNALUnit to seek
     this->getNextNALUnit();
@@ -112,9 +125,9 @@ QByteArray FileSourceAnnexBFile::getNextNALUnit(bool getLastDataAgain, pairUint6
       const auto nrZeroBytesMissing = std::abs(this->posInBuffer);
       this->lastReturnArray.append(nrZeroBytesMissing, char(0));
     }
-    nextStartCodePos = this->fileBuffer.indexOf(STARTCODE, this->posInBuffer + searchOffset);
+    nextStartCodePos = int(StartCodeSearch::findStartCode(this->fileBuffer.constData(), int64_t(this->fileBufferSize), this->posInBuffer + searchOffset));
 
-    if (nextStartCodePos < 0 || (uint64_t)nextStartCodePos > this->fileBufferSize)
+    if (nextStartCodePos < 0)
     {
       // No start code found ... append all data in the current buffer.
       this->lastReturnArray += this->fileBuffer.mid(this->posInBuffer, this->fileBufferSize - this->posInBuffer);
@@ -227,8 +240,18 @@ bool FileSourceAnnexBFile::updateBuffer()
   // Save the position of the first byte in this new buffer
   this->bufferStartPosInFile += this->fileBufferSize;
 
-  this->fileBufferSize = srcFile.read(this->fileBuffer.data(), BUFFERSIZE);
+  if (this->readAheadRunning)
+  {
+    // The next buffer was already read in the background. Wait for it (if it is not done yet) and swap the buffers.
+    this->fileBufferSize = this->waitForReadAhead();
+    this->fileBuffer.swap(this->readAheadBuffer);
+  }
+  else
+    // Nothing was read ahead since the last seek. Read the next buffer now.
+    this->fileBufferSize = uint64_t(std::max(srcFile.read(this->fileBuffer.data(), BUFFERSIZE), qint64(0)));
   this->posInBuffer = 0;
+  // From now on, the file is probably read sequentially
+  this->startReadAhead();
 
   DEBUG_ANNEXBFILE("FileSourceAnnexBFile::updateBuffer this->fileBufferSize " << this->fileBufferSize);
   return (this->fileBufferSize > 0);
@@ -240,7 +263,10 @@ bool FileSourceAnnexBFile::seek(int64_t pos)
     return false;
 
   DEBUG_ANNEXBFILE("FileSourceAnnexBFile::seek ot " << pos);
-  // Seek the file and update the buffer
+  // Seek the file and update the buffer. The data that was read ahead is discarded.
+  // No new read-ahead is started here. A seek is usually followed by getFrameData which mostly only needs this buffer.
+  // If more data is needed, updateBuffer reads it and starts the read-ahead again.
+  this->waitForReadAhead();
   srcFile.seek(pos);
   this->fileBufferSize = srcFile.read(this->fileBuffer.data(), BUFFERSIZE);
   if (this->fileBufferSize == 0)
@@ -265,3 +291,36 @@ bool FileSourceAnnexBFile::seek(int64_t pos)
 
   return true;
 }
+
+int64_t FileSourceAnnexBFile::pos()
+{
+  if (!isFileOpened)
+    return 0;
+  return int64_t(this->bufferStartPosInFile) + std::max(this->posInBuffer, int64_t(0));
+}
+
+void FileSourceAnnexBFile::startReadAhead()
+{
+  if (this->fileBufferSize < BUFFERSIZE)
+    // The current buffer reaches to the end of the file. There is nothing more to read.
+    return;
+
+  // We use our own pool so that the read-ahead does not wait for long running jobs in the global pool (e.g. the parsing of this file).
+  static QThreadPool readAheadThreadPool;
+
+  this->readAheadFuture = QtConcurrent::run(&readAheadThreadPool, [this]() {
+    return int64_t(this->srcFile.read(this->readAheadBuffer.data(), BUFFERSIZE));
+  });
+  this->readAheadRunning = true;
+}
+
+uint64_t FileSourceAnnexBFile::waitForReadAhead()
+{
+  if (!this->readAheadRunning)
+    return 0;
+
+  const auto nrBytesRead = this->readAheadFuture.result();
+  this->readAheadRunning = false;
+  DEBUG_ANNEXBFILE("FileSourceAnnexBFile::waitForReadAhead nrBytesRead " << nrBytesRead);
+  return (nrBytesRead > 0) ? uint64_t(nrBytesRead) : 0;
+}
@@ -32,12 +32,15 @@
 
 #pragma once
 
+#include <QFuture>
+
 #include "FileSource.h"
 #include "common/typedef.h"
 
 /* This class is a normal FileSource for opening of raw AnnexBFiles.
  * Basically it understands that this is a binary file where each unit starts with a start code (0x0000001)
- * TODO: The reading / parsing could be performed in a background thread in order to increase the performance
+ * While the NAL units in the current buffer are scanned, the next part of the file is already read into a second
+ * buffer in the background (read-ahead). So reading and parsing of the file overlap.
 */
 class FileSourceAnnexBFile : public FileSource
 {
@@ -46,7 +49,7 @@ class FileSourceAnnexBFile : public FileSource
 public:
   FileSourceAnnexBFile();
   FileSourceAnnexBFile(const QString &filePath) : FileSourceAnnexBFile() { openFile(filePath); }
-  ~FileSourceAnnexBFile() {};
+  ~FileSourceAnnexBFile();
 
   bool openFile(const QString &filePath) override;
 
@@ -66,9 +69,13 @@ public:
   // The data will be returned in the ISO/IEC 14496-15 format (4 bytes size followed by the payload).
   QByteArray getFrameData(pairUint64 startEndFilePos);
   
-  // Seek the file to the given byte position. Update the buffer.
+  // Seek the file to the given byte position. Update the buffer. Nothing is read ahead until the next updateBuffer
+  // so that random access (getFrameData) only reads the data once.
   bool seek(int64_t pos) override;
 
+  // The position of the current NAL unit. The file itself may already be read further (read-ahead).
+  int64_t pos() override;
+
   uint64_t getNrBytesBeforeFirstNAL() const { return this->nrBytesBeforeFirstNAL; }
 
 protected:
@@ -85,6 +92,16 @@ protected:
   // load the next buffer
   bool updateBuffer();
 
+  // The next part of the file (after the fileBuffer) is read into the readAheadBuffer in the background.
+  // The read-ahead is the only user of srcFile while it is running. So it must be finished (waitForReadAhead)
+  // before srcFile is used in any other way (seek, read, reopen).
+  QByteArray readAheadBuffer;
+  QFuture<int64_t> readAheadFuture;
+  bool readAheadRunning {false};
+  void startReadAhead();
+  // Wait for a running read-ahead and return the number of bytes in the readAheadBuffer (0 if none was running)
+  uint64_t waitForReadAhead();
+
   // Seek to the first NAL header in the bitstream
   void seekToFirstNAL();
 
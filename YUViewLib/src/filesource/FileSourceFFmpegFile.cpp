@@ -36,6 +36,7 @@
 #include <QProgressDialog>
 
 #include "parser/common/SubByteReader.h"
+#include "StartCodeSearch.h"
 
 #define FILESOURCEFFMPEGFILE_DEBUG_OUTPUT 0
 #if FILESOURCEFFMPEGFILE_DEBUG_OUTPUT && !NDEBUG
@@ -50,11 +51,6 @@ using namespace YUV_Internals;
 
 FileSourceFFmpegFile::FileSourceFFmpegFile()
 {
-  // Set the start code to look for (0x00 0x00 0x01)
-  startCode.append((char)0);
-  startCode.append((char)0);
-  startCode.append((char)1);
-
   connect(&fileWatcher, &QFileSystemWatcher::fileChanged, this, &FileSourceFFmpegFile::fileSystemWatcherFileChanged);
 }
 
@@ -110,7 +106,7 @@ QByteArray FileSourceFFmpegFile::getNextUnit(bool getLastDataAgain, uint64_t *pt
     }
     
     // Look for the next start code (or the end of the file)
-    int nextStartCodePos = currentPacketData.indexOf(startCode, posInData + 3);
+    int nextStartCodePos = int(StartCodeSearch::findStartCode(currentPacketData.constData(), currentPacketData.size(), posInData + 3));
 
     if (nextStartCodePos == -1)
     {
@@ -402,6 +398,15 @@ int FileSourceFFmpegFile::getClosestSeekableDTSBefore(int frameIdx, int &seekToF
   return bestSeekDTS;
 }
 
+QList<int> FileSourceFFmpegFile::getKeyFrameNumbers() const
+{
+  QList<int> frameNumbers;
+  for (pictureIdx idx : keyFrameList)
+    if (idx.frame >= 0)
+      frameNumbers.append(idx.frame);
+  return frameNumbers;
+}
+
 bool FileSourceFFmpegFile::scanBitstream(QWidget *mainWindow)
 {
   if (!isFileOpened)
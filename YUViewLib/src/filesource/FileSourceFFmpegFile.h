@@ -103,6 +103,8 @@ public:
   // Look through the keyframes and find the closest one before (or equal)
   // the given frameIdx where we can start decoding
   int getClosestSeekableDTSBefore(int frameIdx, int &seekToFrameIdx) const;
+  // Get the frame indices of all keyframes (in ascending order)
+  QList<int> getKeyFrameNumbers() const;
 
   QStringList getFFmpegLoadingLog() const { return ff.getLog(); }
   
@@ -170,9 +172,6 @@ protected:
 
   packetDataFormat_t packetDataFormat {packetFormatUnknown};
 
-  // The start code pattern to look for in case of a raw format
-  QByteArray startCode;
-
   // These are filled after opening a file (after scanBitstream was called)
   QList<pictureIdx> keyFrameList;  //< A list of pairs (frameNr, PTS) that we can seek to.
   //pictureIdx getClosestSeekableFrameNumberBeforeBefore(int frameIdx);
@@ -0,0 +1,160 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "StartCodeSearch.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STARTCODE_SEARCH_SSE2 1
+#include <emmintrin.h>
+#else
+#define STARTCODE_SEARCH_SSE2 0
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define STARTCODE_SEARCH_NEON 1
+#include <arm_neon.h>
+#else
+#define STARTCODE_SEARCH_NEON 0
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "video/yuvConversionSIMD.h"
+
+namespace StartCodeSearch
+{
+
+namespace
+{
+
+#if STARTCODE_SEARCH_SSE2
+int countTrailingZeros(unsigned int mask)
+{
+#if defined(_MSC_VER)
+  unsigned long idx;
+  _BitScanForward(&idx, mask);
+  return int(idx);
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+
+// Search 16 bytes at a time. For every position i in a block, the bytes i, i+1 and i+2 are compared at once by
+// loading the block three times with an offset of 0, 1 and 2 bytes.
+int64_t findStartCodeSSE2(const char *data, int64_t size, int64_t &pos)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i one = _mm_set1_epi8(1);
+  for (; pos + 18 <= size; pos += 16)
+  {
+    // Most blocks do not contain a 0x01 byte at all. Check this first.
+    const __m128i v2 = _mm_loadu_si128((const __m128i*)(data + pos + 2));
+    const int maskOne = _mm_movemask_epi8(_mm_cmpeq_epi8(v2, one));
+    if (maskOne == 0)
+      continue;
+    const __m128i v0 = _mm_loadu_si128((const __m128i*)(data + pos));
+    const __m128i v1 = _mm_loadu_si128((const __m128i*)(data + pos + 1));
+    const int mask = maskOne & _mm_movemask_epi8(_mm_cmpeq_epi8(v0, zero)) & _mm_movemask_epi8(_mm_cmpeq_epi8(v1, zero));
+    if (mask != 0)
+      return pos + countTrailingZeros(unsigned(mask));
+  }
+  return -1;
+}
+#endif
+
+#if STARTCODE_SEARCH_NEON
+int64_t findStartCodeNEON(const char *data, int64_t size, int64_t &pos)
+{
+  const uint8x16_t zero = vdupq_n_u8(0);
+  const uint8x16_t one = vdupq_n_u8(1);
+  for (; pos + 18 <= size; pos += 16)
+  {
+    const uint8x16_t v0 = vld1q_u8((const uint8_t*)(data + pos));
+    const uint8x16_t v1 = vld1q_u8((const uint8_t*)(data + pos + 1));
+    const uint8x16_t v2 = vld1q_u8((const uint8_t*)(data + pos + 2));
+    const uint8x16_t match = vandq_u8(vandq_u8(vceqq_u8(v0, zero), vceqq_u8(v1, zero)), vceqq_u8(v2, one));
+    if (vmaxvq_u8(match) == 0)
+      continue;
+    // There is a match in this block. Find the first one.
+    uint8_t matchBytes[16];
+    vst1q_u8(matchBytes, match);
+    for (int i = 0; i < 16; i++)
+      if (matchBytes[i] != 0)
+        return pos + i;
+  }
+  return -1;
+}
+#endif
+
+} // namespace
+
+int64_t findStartCodeScalar(const char *data, int64_t size, int64_t startPos)
+{
+  for (int64_t i = (startPos < 0 ? 0 : startPos); i + 3 <= size; i++)
+  {
+    // If the third byte is not 0 or 1, no start code can begin at i, i+1 or i+2
+    const char c = data[i + 2];
+    if (c > 1 || c < 0)
+      i += 2;
+    else if (c == 1 && data[i] == 0 && data[i + 1] == 0)
+      return i;
+  }
+  return -1;
+}
+
+int64_t findStartCode(const char *data, int64_t size, int64_t startPos)
+{
+  int64_t pos = (startPos < 0) ? 0 : startPos;
+
+  using YUV_Internals::SIMDInstructionSet;
+  const auto instructionSet = YUV_Internals::getSIMDInstructionSet();
+  int64_t found = -1;
+#if YUV_SIMD_X86
+  if (instructionSet == SIMDInstructionSet::AVX2)
+    found = findStartCodeAVX2(data, size, pos);
+#endif
+#if STARTCODE_SEARCH_SSE2
+  if (found < 0 && instructionSet != SIMDInstructionSet::None)
+    found = findStartCodeSSE2(data, size, pos);
+#endif
+#if STARTCODE_SEARCH_NEON
+  if (instructionSet == SIMDInstructionSet::NEON)
+    found = findStartCodeNEON(data, size, pos);
+#endif
+  if (found >= 0)
+    return found;
+
+  // The vectorized search stops before the end of the data. Search the remainder.
+  return findStartCodeScalar(data, size, pos);
+}
+
+} // namespace StartCodeSearch
@@ -0,0 +1,58 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+// This header is included by the translation unit that is compiled for AVX2 (StartCodeSearch_AVX2.cpp).
+// So it must not contain any inline functions and must not include any Qt headers.
+
+namespace StartCodeSearch
+{
+
+// Find the first start code (0x00 0x00 0x01) in data that begins at or after startPos. Only the first size bytes
+// of data are searched. Return the position of the first 0 byte of the start code or -1 if there is none.
+// For a 4 byte start code (0x00 0x00 0x00 0x01), this is the position of the second 0 byte.
+// The search is vectorized (SSE2/AVX2/NEON). Which instruction set is used is decided at runtime (see YUV_Internals::getSIMDInstructionSet).
+int64_t findStartCode(const char *data, int64_t size, int64_t startPos = 0);
+
+// The scalar reference implementation
+int64_t findStartCodeScalar(const char *data, int64_t size, int64_t startPos = 0);
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+// Search 32 bytes at a time. Only call this if the CPU supports AVX2. Returns the position of the first start code
+// or -1 if none was found. In this case, pos is set to the position at which the (scalar) search must continue.
+int64_t findStartCodeAVX2(const char *data, int64_t size, int64_t &pos);
+#endif
+
+} // namespace StartCodeSearch
@@ -0,0 +1,91 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "StartCodeSearch.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Everything below is compiled for AVX2. It is only called if the CPU supports it (see findStartCode).
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace StartCodeSearch
+{
+
+// Search 32 bytes at a time. For every position i in a block, the bytes i, i+1 and i+2 are compared at once by
+// loading the block three times with an offset of 0, 1 and 2 bytes.
+int64_t findStartCodeAVX2(const char *data, int64_t size, int64_t &pos)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i one = _mm256_set1_epi8(1);
+  for (; pos + 34 <= size; pos += 32)
+  {
+    // Most blocks do not contain a 0x01 byte at all. Check this first.
+    const __m256i v2 = _mm256_loadu_si256((const __m256i*)(data + pos + 2));
+    const unsigned maskOne = unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v2, one)));
+    if (maskOne == 0)
+      continue;
+    const __m256i v0 = _mm256_loadu_si256((const __m256i*)(data + pos));
+    const __m256i v1 = _mm256_loadu_si256((const __m256i*)(data + pos + 1));
+    const unsigned mask = maskOne & unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v0, zero))) & unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v1, zero)));
+    if (mask != 0)
+    {
+#if defined(_MSC_VER)
+      unsigned long idx;
+      _BitScanForward(&idx, mask);
+      return pos + int64_t(idx);
+#else
+      return pos + __builtin_ctz(mask);
+#endif
+    }
+  }
+  return -1;
+}
+
+} // namespace StartCodeSearch
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif
@@ -0,0 +1,515 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "commandLineHandler.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QDomDocument>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+
+#include "playlistitem/playlistItems.h"
+#include "video/sequenceMetrics.h"
+#include "video/videoHandler.h"
+
+namespace
+{
+
+void printError(const QString &message)
+{
+  std::cerr << message.toStdString() << '\n';
+}
+
+}
+
+bool commandLineHandler::isHeadlessCall(int argc, char *argv[])
+{
+  return argc > 1 && (qstrcmp(argv[1], "-headless") == 0 || qstrcmp(argv[1], "--headless") == 0);
+}
+
+int commandLineHandler::runHeadless(int &argc, char *argv[])
+{
+  // No display is needed. All frames are only converted in memory.
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+
+  // The playlist items are tree widget items (with icons), so a QApplication is needed even though nothing is shown.
+  // The names must match the GUI (see YUViewApplication) so that the same settings (e.g. decoder libraries) are used.
+  QApplication app(argc, argv);
+  app.setApplicationName("YUView");
+  app.setApplicationVersion(QString::fromUtf8(YUVIEW_VERSION));
+  app.setOrganizationName("Institut für Nachrichtentechnik, RWTH Aachen University");
+  app.setOrganizationDomain("ient.rwth-aachen.de");
+
+  commandLineHandler handler;
+  if (!handler.parseArguments(app.arguments()))
+    return handler.helpShown ? 0 : 1;
+
+  // Compressed items must not load frames in the main thread (see playlistItemCompressedVideo::loadFrame). The command
+  // runs in a background thread while the main thread handles the events of the items.
+  QFutureWatcher<int> watcher;
+  QObject::connect(&watcher, &QFutureWatcher<int>::finished, &app, &QCoreApplication::quit);
+  watcher.setFuture(QtConcurrent::run([&handler]() { return handler.runCommand(); }));
+  app.exec();
+  return watcher.result();
+}
+
+commandLineHandler::~commandLineHandler()
+{
+  qDeleteAll(inputItems);
+}
+
+bool commandLineHandler::parseArguments(const QStringList &arguments)
+{
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Process videos without a graphical user interface.\n\n"
+                                   "Commands:\n"
+                                   "  convert    Save the frames as PNG images in the output directory.\n"
+                                   "  rawyuv     Write the raw (YUV/RGB) data of the frames to the output file.\n"
+                                   "  metrics    Calculate PSNR, MSE and SSIM of two videos (or of a difference item in a\n"
+                                   "             playlist) and write them to the output CSV file.\n"
+                                   "  benchmark  Measure the loading/decoding and conversion speed.");
+  // "-headless" is one option and not the short options -h -e -a ...
+  parser.setSingleDashWordOptionMode(QCommandLineParser::ParseAsLongOptions);
+
+  const QCommandLineOption headlessOption("headless", "Run without a graphical user interface (must be the first argument).");
+  const QCommandLineOption helpOption(QStringList() << "h" << "help", "Show this help.");
+  const QCommandLineOption outputOption(QStringList() << "o" << "output", "The output directory (convert) or file (rawyuv, metrics).", "path");
+  const QCommandLineOption framesOption("frames", "Only process the given frames (e.g. 10:19 or 5). By default, all frames are processed.", "first:last");
+  const QCommandLineOption itemOption("item", "The index of the top level item to process if a playlist is opened. By default, the first item is used.", "index");
+  const QCommandLineOption sizeOption("size", "The frame size of raw files (e.g. 1920x1080). Must be given together with --format.", "WxH");
+  const QCommandLineOption formatOption("format", "The pixel format of raw files (e.g. \"YUV 4:2:0 8-bit\"). Must be given together with --size.", "name");
+  parser.addOptions({headlessOption, helpOption, outputOption, framesOption, itemOption, sizeOption, formatOption});
+  parser.addPositionalArgument("command", "convert, rawyuv, metrics or benchmark");
+  parser.addPositionalArgument("files", "The video files or playlists to open.", "<files...>");
+
+  if (!parser.parse(arguments))
+  {
+    printError(parser.errorText());
+    return false;
+  }
+  if (parser.isSet(helpOption))
+  {
+    std::cout << parser.helpText().toStdString();
+    helpShown = true;
+    return false;
+  }
+
+  const QStringList positionalArguments = parser.positionalArguments();
+  const QStringList commands = QStringList() << "convert" << "rawyuv" << "metrics" << "benchmark";
+  if (positionalArguments.size() < 2 || !commands.contains(positionalArguments[0]))
+  {
+    std::cerr << parser.helpText().toStdString();
+    return false;
+  }
+  command = positionalArguments[0];
+  outputPath = parser.value(outputOption);
+
+  if (parser.isSet(framesOption))
+  {
+    const QStringList frames = parser.value(framesOption).split(':');
+    bool okFirst = false;
+    bool okLast = false;
+    if (frames.size() == 1)
+      selectedFrames = indexRange(frames[0].toInt(&okFirst), frames[0].toInt(&okLast));
+    else if (frames.size() == 2)
+      selectedFrames = indexRange(frames[0].toInt(&okFirst), frames[1].toInt(&okLast));
+    if (!okFirst || !okLast || selectedFrames.first < 0 || selectedFrames.second < selectedFrames.first)
+    {
+      printError(QString("Invalid range of frames %1.").arg(parser.value(framesOption)));
+      return false;
+    }
+  }
+
+  if (parser.isSet(itemOption))
+  {
+    bool ok;
+    selectedItem = parser.value(itemOption).toInt(&ok);
+    if (!ok || selectedItem < 0)
+    {
+      printError(QString("Invalid item index %1.").arg(parser.value(itemOption)));
+      return false;
+    }
+  }
+
+  QSize frameSize(-1, -1);
+  if (parser.isSet(sizeOption))
+  {
+    const QStringList size = parser.value(sizeOption).split('x');
+    bool okWidth = false;
+    bool okHeight = false;
+    if (size.size() == 2)
+      frameSize = QSize(size[0].toInt(&okWidth), size[1].toInt(&okHeight));
+    if (!okWidth || !okHeight || frameSize.width() <= 0 || frameSize.height() <= 0)
+    {
+      printError(QString("Invalid frame size %1.").arg(parser.value(sizeOption)));
+      return false;
+    }
+  }
+  const QString pixelFormat = parser.value(formatOption);
+  if (parser.isSet(sizeOption) != parser.isSet(formatOption))
+  {
+    printError("The frame size (--size) and the pixel format (--format) must be given together.");
+    return false;
+  }
+
+  for (const QString &filePath : positionalArguments.mid(1))
+  {
+    const bool isPlaylist = (QFileInfo(filePath).suffix().toLower() == "yuvplaylist");
+    if (!(isPlaylist ? openPlaylist(filePath) : openFile(filePath, frameSize, pixelFormat)))
+      return false;
+  }
+  return true;
+}
+
+bool commandLineHandler::openFile(const QString &filePath, const QSize &frameSize, const QString &pixelFormat)
+{
+  QFileInfo fileInfo(filePath);
+  if (!fileInfo.exists())
+  {
+    printError(QString("The file %1 does not exist.").arg(filePath));
+    return false;
+  }
+
+  // Only videos can be processed. For unknown file types, playlistItems::createPlaylistItemFromFile would ask the user.
+  const QString ext = fileInfo.suffix().toLower();
+  QStringList rawExtensions, compressedExtensions, filters;
+  playlistItemRawFile::getSupportedFileExtensions(rawExtensions, filters);
+  playlistItemCompressedVideo::getSupportedFileExtensions(compressedExtensions, filters);
+
+  if (rawExtensions.contains(ext))
+  {
+    // Without a given format, it is guessed from the file name and the data like in the GUI
+    if (frameSize.isValid())
+      inputItems.append(new playlistItemRawFile(filePath, frameSize, pixelFormat));
+    else
+      inputItems.append(new playlistItemRawFile(filePath));
+  }
+  else if (compressedExtensions.contains(ext))
+    inputItems.append(new playlistItemCompressedVideo(filePath));
+  else
+  {
+    printError(QString("The file %1 is no raw or compressed video file.").arg(filePath));
+    return false;
+  }
+  return true;
+}
+
+bool commandLineHandler::openPlaylist(const QString &filePath)
+{
+  QFile file(filePath);
+  if (!file.open(QIODevice::ReadOnly))
+  {
+    printError(QString("Error opening the playlist %1.").arg(filePath));
+    return false;
+  }
+
+  QDomDocument doc;
+  const bool success = doc.setContent(&file);
+  const QDomElement root = doc.documentElement();
+  if (!success || root.tagName() != "playlistItems" || root.attribute("version") != "2.0")
+  {
+    printError(QString("The format of the playlist %1 could not be recognized.").arg(filePath));
+    return false;
+  }
+
+  // The view states in the playlist are not needed
+  for (QDomElement elem = root.firstChildElement(); !elem.isNull(); elem = elem.nextSiblingElement())
+  {
+    playlistItem *newItem = playlistItems::loadPlaylistItem(elem, filePath);
+    if (newItem)
+      inputItems.append(newItem);
+  }
+  return true;
+}
+
+int commandLineHandler::runCommand()
+{
+  if (command == "convert")
+    return convertFrames();
+  if (command == "rawyuv")
+    return writeRawFrames();
+  if (command == "metrics")
+    return calculateMetrics();
+  return runBenchmark();
+}
+
+bool commandLineHandler::getVideoItem(playlistItem *&item, videoHandler *&video)
+{
+  const int itemIdx = std::max(selectedItem, 0);
+  if (itemIdx >= inputItems.size())
+  {
+    printError(QString("There is no item %1. Only %2 items were opened.").arg(itemIdx).arg(inputItems.size()));
+    return false;
+  }
+
+  item = inputItems[itemIdx];
+  video = dynamic_cast<videoHandler*>(item->getFrameHandler());
+  if (video == nullptr)
+  {
+    printError(QString("The item %1 is no video.").arg(item->getName()));
+    return false;
+  }
+  if (!video->isFormatValid())
+  {
+    printError(QString("The format of %1 is not valid. For raw files, it can be given with --size and --format.").arg(item->getName()));
+    return false;
+  }
+  if (video->getBytesPerFrame() <= 0)
+  {
+    printError(QString("The item %1 has no YUV or RGB frames.").arg(item->getName()));
+    return false;
+  }
+  return true;
+}
+
+bool commandLineHandler::limitFrameRange(indexRange &range)
+{
+  if (selectedFrames.first >= 0)
+    range = indexRange(std::max(range.first, selectedFrames.first), std::min(range.second, selectedFrames.second));
+  if (range.first < 0 || range.second < range.first)
+  {
+    printError("There are no frames to process.");
+    return false;
+  }
+  return true;
+}
+
+int commandLineHandler::convertFrames()
+{
+  playlistItem *item;
+  videoHandler *video;
+  if (!getVideoItem(item, video))
+    return 1;
+  indexRange range = item->getFrameIdxRange();
+  if (!limitFrameRange(range))
+    return 1;
+
+  QDir outputDir(outputPath.isEmpty() ? QDir::currentPath() : outputPath);
+  if (!outputDir.mkpath("."))
+  {
+    printError(QString("Error creating the output directory %1.").arg(outputDir.path()));
+    return 1;
+  }
+
+  // The images are named after the item and the frame index (e.g. video_000010.png)
+  const QString baseName = QFileInfo(item->getName()).completeBaseName();
+  for (int frameIdx = range.first; frameIdx <= range.second; frameIdx++)
+  {
+    QByteArray rawData;
+    QImage image;
+    if (video->loadRawFrame(item->getFrameIdxInternal(frameIdx), rawData))
+      image = video->convertRawFrame(rawData);
+    if (image.isNull())
+    {
+      printError(QString("Loading frame %1 of %2 failed.").arg(frameIdx).arg(item->getName()));
+      return 1;
+    }
+
+    const QString fileName = outputDir.filePath(QString("%1_%2.png").arg(baseName).arg(frameIdx, 6, 10, QChar('0')));
+    if (!image.save(fileName, "PNG"))
+    {
+      printError(QString("Error writing the image %1.").arg(fileName));
+      return 1;
+    }
+  }
+
+  std::cout << "Saved " << (range.second - range.first + 1) << " frames to " << outputDir.path().toStdString() << '\n';
+  return 0;
+}
+
+int commandLineHandler::writeRawFrames()
+{
+  if (outputPath.isEmpty())
+  {
+    printError("The output file must be given (--output).");
+    return 1;
+  }
+
+  playlistItem *item;
+  videoHandler *video;
+  if (!getVideoItem(item, video))
+    return 1;
+  indexRange range = item->getFrameIdxRange();
+  if (!limitFrameRange(range))
+    return 1;
+
+  QFile file(outputPath);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    printError(QString("Error opening the file %1 for writing.").arg(outputPath));
+    return 1;
+  }
+
+  // The frames are written in the format of the item (e.g. the output format of the decoder)
+  const int64_t bytesPerFrame = video->getBytesPerFrame();
+  for (int frameIdx = range.first; frameIdx <= range.second; frameIdx++)
+  {
+    QByteArray rawData;
+    if (!video->loadRawFrame(item->getFrameIdxInternal(frameIdx), rawData) || rawData.size() < bytesPerFrame)
+    {
+      printError(QString("Loading frame %1 of %2 failed.").arg(frameIdx).arg(item->getName()));
+      return 1;
+    }
+    if (file.write(rawData.constData(), bytesPerFrame) != bytesPerFrame)
+    {
+      printError(QString("Error writing to the file %1.").arg(outputPath));
+      return 1;
+    }
+  }
+
+  // The format is "width;height;YUV/RGB;pixel format". Print it so that the file can be opened again.
+  const QStringList format = video->getFormatAsString().split(';');
+  std::cout << "Wrote " << (range.second - range.first + 1) << " frames to " << outputPath.toStdString() << '\n';
+  if (format.size() >= 4)
+    std::cout << "Format: --size " << format[0].toStdString() << 'x' << format[1].toStdString() << " --format \"" << format[3].toStdString() << "\"\n";
+  return 0;
+}
+
+int commandLineHandler::calculateMetrics()
+{
+  // Either a difference item (e.g. from a playlist) or two videos are compared
+  playlistItem *items[2] {nullptr, nullptr};
+  indexRange range;
+  const int itemIdx = std::max(selectedItem, 0);
+  auto difference = (itemIdx < inputItems.size()) ? dynamic_cast<playlistItemDifference*>(inputItems[itemIdx]) : nullptr;
+  if (difference)
+  {
+    if (difference->childCount() != 2)
+    {
+      printError("The difference item needs two items to compare.");
+      return 1;
+    }
+    // The frame indices of the difference item are the frame indices of the children (see playlistItemDifference::startSequenceMetrics)
+    items[0] = dynamic_cast<playlistItem*>(difference->child(0));
+    items[1] = dynamic_cast<playlistItem*>(difference->child(1));
+    range = difference->getStartEndFrameLimits();
+  }
+  else if (selectedItem < 0 && inputItems.size() == 2)
+  {
+    items[0] = inputItems[0];
+    items[1] = inputItems[1];
+    range = indexRange(0, std::min(items[0]->getFrameIdxRange().second, items[1]->getFrameIdxRange().second));
+  }
+  else
+  {
+    printError("The metrics are calculated for two videos or for a difference item of a playlist (--item).");
+    return 1;
+  }
+  if (!limitFrameRange(range))
+    return 1;
+
+  SequenceMetricsJob job(items[0], items[1], range);
+  QString errorMessage;
+  if (!job.prepare(outputPath, errorMessage))
+  {
+    printError(errorMessage);
+    return 1;
+  }
+  if (!job.run())
+  {
+    printError(job.getErrorMessage());
+    return 1;
+  }
+
+  // Print the mean values of the sequence
+  using Metric = SequenceMetricsPlotModel::Metric;
+  const auto frameMetrics = job.getFrameMetrics();
+  const int nrComponents = frameMetrics.first().nrComponents;
+  std::cout << "Mean of " << frameMetrics.size() << " frames\n";
+  for (const Metric metric : {Metric::PSNR, Metric::MSE, Metric::SSIM})
+  {
+    for (int component = 0; component < 4; component++)
+    {
+      if (component >= nrComponents && !(metric == Metric::MSE && component == 3))
+        continue;
+      double sum = 0;
+      for (const auto &frame : frameMetrics)
+        sum += (metric == Metric::PSNR) ? frame.psnr[component] : (metric == Metric::MSE) ? frame.mse[component] : frame.ssim[component];
+      std::cout << SequenceMetricsPlotModel::getMetricName(metric, component).toStdString() << ": " << sum / frameMetrics.size() << '\n';
+    }
+  }
+  return 0;
+}
+
+int commandLineHandler::runBenchmark()
+{
+  playlistItem *item;
+  videoHandler *video;
+  if (!getVideoItem(item, video))
+    return 1;
+  indexRange range = item->getFrameIdxRange();
+  if (!limitFrameRange(range))
+    return 1;
+
+  // Like for caching, the loading (reading/decoding) and the conversion are measured separately
+  QElapsedTimer timer;
+  int64_t loadingNsec = 0;
+  int64_t conversionNsec = 0;
+  for (int frameIdx = range.first; frameIdx <= range.second; frameIdx++)
+  {
+    QByteArray rawData;
+    timer.start();
+    const bool loaded = video->loadRawFrame(item->getFrameIdxInternal(frameIdx), rawData);
+    loadingNsec += timer.nsecsElapsed();
+
+    timer.start();
+    const QImage image = loaded ? video->convertRawFrame(rawData) : QImage();
+    conversionNsec += timer.nsecsElapsed();
+    if (image.isNull())
+    {
+      printError(QString("Loading frame %1 of %2 failed.").arg(frameIdx).arg(item->getName()));
+      return 1;
+    }
+  }
+
+  const int nrFrames = range.second - range.first + 1;
+  auto printDuration = [nrFrames](const char *name, int64_t nsec)
+  {
+    const double fps = (nsec > 0) ? double(nrFrames) * 1e9 / nsec : 0.0;
+    std::cout << name << ": " << double(nsec) / 1e6 / nrFrames << " ms/frame (" << fps << " fps)\n";
+  };
+  std::cout << "Benchmark of " << nrFrames << " frames of " << item->getName().toStdString() << " (" << video->getFormatAsString().toStdString() << ")\n";
+  printDuration("Loading", loadingNsec);
+  printDuration("Conversion", conversionNsec);
+  printDuration("Total", loadingNsec + conversionNsec);
+  return 0;
+}
@@ -0,0 +1,97 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <QList>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+
+#include "common/typedef.h"
+
+class playlistItem;
+class videoHandler;
+
+/* The headless mode of YUView: "YUView -headless <command> [options] <files>". The given files or playlists are opened
+ * and processed without creating any widgets, so this can run on a build server without a display (the Qt "offscreen"
+ * platform is used unless QT_QPA_PLATFORM is set). Compressed files are decoded with the same decoders as in the GUI.
+ * The commands are:
+ *  convert:   Convert the frames of a video to RGB and save them as PNG images
+ *  rawyuv:    Write the raw (YUV/RGB) data of the frames of a video to one file
+ *  metrics:   Calculate PSNR, MSE and SSIM of all frames of two videos (or of the two items of a difference item in a
+ *             playlist) and write them to a CSV file (see SequenceMetricsJob)
+ *  benchmark: Measure how fast the frames of a video are loaded (read/decoded) and converted to RGB
+ * Errors are printed to stderr and the program returns a non-zero exit code.
+ */
+class commandLineHandler
+{
+public:
+  // Is this a call of the headless mode? This is checked before an application object is created.
+  static bool isHeadlessCall(int argc, char *argv[]);
+
+  // Create the application, run the command and return the exit code of the program.
+  static int runHeadless(int &argc, char *argv[]);
+
+private:
+  commandLineHandler() = default;
+  ~commandLineHandler();
+
+  // Parse the arguments and open the input files. On error, a message is printed and false is returned.
+  bool parseArguments(const QStringList &arguments);
+  // For raw files, the frame size and pixel format can be given. Otherwise they are guessed like in the GUI.
+  bool openFile(const QString &filePath, const QSize &frameSize, const QString &pixelFormat);
+  bool openPlaylist(const QString &filePath);
+
+  // Run the command. This is called from a background thread. Returns the exit code.
+  int runCommand();
+  int convertFrames();
+  int writeRawFrames();
+  int calculateMetrics();
+  int runBenchmark();
+
+  // Get the selected item (--item) if it is a video with YUV or RGB frames
+  bool getVideoItem(playlistItem *&item, videoHandler *&video);
+  // Restrict the given range of frames to the range that was selected with --frames
+  bool limitFrameRange(indexRange &range);
+
+  QString command;
+  QString outputPath;
+  // The frames (--frames) and the index of the item (--item) to process. -1 if not given.
+  indexRange selectedFrames {-1, -1};
+  int selectedItem {-1};
+  bool helpShown {false};
+
+  // The top level items of all given files and playlists
+  QList<playlistItem*> inputItems;
+};
@@ -41,10 +41,15 @@
 
 #include "BitratePlotModel.h"
 
+#include <algorithm>
 #include <common/functions.h>
 
+// The average is calculated over the points this far before and after the point
+const unsigned int averageRange = 10;
+
 unsigned BitratePlotModel::getNrStreams() const
 {
+  QMutexLocker locker(&this->dataMutex);
   return this->dataPerStream.size();
 }
 
@@ -60,7 +65,7 @@ PlotModel::StreamParameter BitratePlotModel::getStreamParameter(unsigned streamI
     streamParameter.yRange.min = double(this->rangeBitratePerStream[streamIndex].min);
     streamParameter.yRange.max = double(this->rangeBitratePerStream[streamIndex].max);
 
-    const auto nrPoints = unsigned(this->dataPerStream[streamIndex].size());
+    const auto nrPoints = this->dataPerStream[streamIndex].nrEntries;
     streamParameter.plotParameters.append({PlotType::Bar, nrPoints});
     streamParameter.plotParameters.append({PlotType::Line, nrPoints});
 
@@ -72,25 +77,46 @@ PlotModel::StreamParameter BitratePlotModel::getStreamParameter(unsigned streamI
 PlotModel::Point BitratePlotModel::getPlotPoint(unsigned streamIndex, unsigned plotIndex, unsigned pointIndex) const
 {
   QMutexLocker locker(&this->dataMutex);
+  return this->getPlotPointInternal(streamIndex, plotIndex, pointIndex);
+}
+
+std::optional<QVector<PlotModel::PointSummary>> BitratePlotModel::getPlotSummaries(unsigned streamIndex, unsigned plotIndex, Range<double> xRange, unsigned maxNrSummaries) const
+{
+  QMutexLocker locker(&this->dataMutex);
+
+  if (!this->dataPerStream.contains(streamIndex) || plotIndex > 1)
+    return {};
 
+  // Sorting in new entries invalidates the summaries from the first moved entry on
+  this->getSortedOrder(streamIndex);
+
+  auto &stream = this->dataPerStream[streamIndex];
+  auto &summary = (plotIndex == 0) ? stream.bitrateSummary : stream.averageSummary;
+  auto getPoint = [this, streamIndex, plotIndex](unsigned pointIndex) { return this->getPlotPointInternal(streamIndex, plotIndex, pointIndex); };
+  return summary.getSummaries(stream.nrEntries, getPoint, xRange, maxNrSummaries);
+}
+
+PlotModel::Point BitratePlotModel::getPlotPointInternal(unsigned streamIndex, unsigned plotIndex, unsigned pointIndex) const
+{
   if (!this->dataPerStream.contains(streamIndex))
     return {};
 
-  if (pointIndex < unsigned(this->dataPerStream[streamIndex].size()))
+  if (pointIndex < this->dataPerStream[streamIndex].nrEntries)
   {
+    const auto &entry = this->getSortedEntry(streamIndex, pointIndex);
     PlotModel::Point point;
     if (this->sortMode == SortMode::DECODE_ORDER)
-      point.x = this->dataPerStream[streamIndex][pointIndex].dts;
+      point.x = entry.dts;
     else
-      point.x = this->dataPerStream[streamIndex][pointIndex].pts;
-    point.intra = this->dataPerStream[streamIndex][pointIndex].keyframe;
+      point.x = entry.pts;
+    point.intra = entry.keyframe;
     
     const auto isAveragePlot = (plotIndex == 1);
     if (isAveragePlot)
       point.y = this->calculateAverageValue(streamIndex, pointIndex);
     else
-      point.y = this->dataPerStream[streamIndex][pointIndex].bitrate;
-    point.width = this->dataPerStream[streamIndex][pointIndex].duration;
+      point.y = entry.bitrate;
+    point.width = entry.duration;
 
     return point;
   }
@@ -101,7 +127,10 @@ PlotModel::Point BitratePlotModel::getPlotPoint(unsigned streamIndex, unsigned p
 QString BitratePlotModel::getPointInfo(unsigned streamIndex, unsigned plotIndex, unsigned pointIndex) const
 {
   QMutexLocker locker(&this->dataMutex);
-  auto &entry = this->dataPerStream[streamIndex][pointIndex];
+  if (!this->dataPerStream.contains(streamIndex) || pointIndex >= this->dataPerStream[streamIndex].nrEntries)
+    return {};
+
+  const auto &entry = this->getSortedEntry(streamIndex, pointIndex);
   const auto isAveragePlot = (plotIndex == 1);
 
   if (isAveragePlot)
@@ -134,12 +163,14 @@ QString BitratePlotModel::getPointInfo(unsigned streamIndex, unsigned plotIndex,
 
 std::optional<unsigned> BitratePlotModel::getReasonabelRangeToShowOnXAxisPer100Pixels() const
 {
+  QMutexLocker locker(&this->dataMutex);
+
   std::optional<unsigned> range;
-  for (auto &list : this->dataPerStream)
+  for (const auto &stream : this->dataPerStream)
   {
-    if (list.size() >= 2)
+    if (stream.nrEntries >= 2)
     {
-      const auto minDistance = unsigned(std::abs(list.at(1).dts - list.at(0).dts));
+      const auto minDistance = unsigned(std::abs(stream.at(1).dts - stream.at(0).dts));
       // Try to show 10 of these distance steps per 100 px
       const auto minDistancePer100Pix = minDistance * 10;
       if (minDistance == 0)
@@ -170,8 +201,9 @@ void BitratePlotModel::addBitratePoint(int streamIndex, BitrateEntry &entry)
   QMutexLocker locker(&this->dataMutex);
 
   const auto newStream = !this->dataPerStream.contains(streamIndex);
+  auto &stream = this->dataPerStream[streamIndex];
 
-  if (this->dataPerStream[streamIndex].empty())
+  if (stream.nrEntries == 0)
   {
     rangeDts.min = entry.dts;
     rangeDts.max = entry.dts;
@@ -191,18 +223,10 @@ void BitratePlotModel::addBitratePoint(int streamIndex, BitrateEntry &entry)
 
   DEBUG_PLOT("BitrateItemModel::addBitratePoint streamIndex " << streamIndex << " pts " << entry.pts << " dts " << entry.dts << " rate " << entry.bitrate << " keyframe " << entry.keyframe);
 
-  // Keep the list sorted
-  const auto currentSortMode = this->sortMode;
-  auto compareFunctionLessThen = [currentSortMode](const BitrateEntry &a, const BitrateEntry &b) 
-  {
-    if (currentSortMode == SortMode::DECODE_ORDER)
-      return a.dts < b.dts;
-    else
-      return b.pts < a.pts;
-  };
+  // The entry is only appended. It is sorted in when the data is read the next time.
+  stream.append(entry);
+  locker.unlock();
 
-  auto insertIterator = std::upper_bound(this->dataPerStream[streamIndex].begin(), this->dataPerStream[streamIndex].end(), entry, compareFunctionLessThen);
-  this->dataPerStream[streamIndex].insert(insertIterator, entry);
   this->eventSubsampler.postEvent();
   if (newStream)
     emit nrStreamsChanged();
@@ -214,29 +238,74 @@ void BitratePlotModel::setBitrateSortingIndex(int index)
   if (this->sortMode == newSortMode)
     return;
 
+  QMutexLocker locker(&this->dataMutex);
   this->sortMode = newSortMode;
 
-  const auto currentSortMode = this->sortMode;
-  auto compareFunctionLessThen = [currentSortMode](const BitrateEntry &a, const BitrateEntry &b) 
+  // Both orders are kept so nothing has to be sorted here. Only the summaries are for the other order.
+  for (auto &stream : this->dataPerStream)
   {
-    if (currentSortMode == SortMode::DECODE_ORDER)
-      return a.dts < b.dts;
-    else
-      return a.pts < b.pts;
+    stream.bitrateSummary.clear();
+    stream.averageSummary.clear();
+  }
+}
+
+void BitratePlotModel::StreamData::append(const BitrateEntry &entry)
+{
+  if (this->nrEntries % ChunkSize == 0)
+  {
+    this->chunks.append({});
+    this->chunks.last().reserve(int(ChunkSize));
+  }
+  this->chunks.last().append(entry);
+  this->nrEntries++;
+}
+
+const QVector<unsigned> &BitratePlotModel::getSortedOrder(unsigned streamIndex) const
+{
+  auto &stream = this->dataPerStream[streamIndex];
+  const auto decodeOrder = (this->sortMode == SortMode::DECODE_ORDER);
+  auto &order = decodeOrder ? stream.dtsOrder : stream.ptsOrder;
+
+  const auto nrSorted = order.size();
+  if (unsigned(nrSorted) == stream.nrEntries)
+    return order;
+
+  // Entries with the same timestamp stay in the order in which they were added
+  auto lessThan = [&stream, decodeOrder](unsigned a, unsigned b)
+  {
+    const auto timeA = decodeOrder ? stream.at(a).dts : stream.at(a).pts;
+    const auto timeB = decodeOrder ? stream.at(b).dts : stream.at(b).pts;
+    return timeA < timeB || (timeA == timeB && a < b);
   };
 
-  QMutexLocker locker(&this->dataMutex);
-  for (auto &list : this->dataPerStream)
-    std::sort(list.begin(), list.end(), compareFunctionLessThen);
+  // Sort the new entries and merge them into the already sorted ones. Usually, the new entries
+  // go to the end so that only the new entries have to be sorted.
+  order.reserve(int(stream.nrEntries));
+  for (auto i = unsigned(nrSorted); i < stream.nrEntries; i++)
+    order.append(i);
+  std::sort(order.begin() + nrSorted, order.end(), lessThan);
+  const auto firstMoved = int(std::upper_bound(order.begin(), order.begin() + nrSorted, order[nrSorted], lessThan) - order.begin());
+  std::inplace_merge(order.begin() + firstMoved, order.begin() + nrSorted, order.end(), lessThan);
+
+  // The points from the first moved one on changed. The averages also change for the points before it.
+  stream.bitrateSummary.invalidateFrom(unsigned(firstMoved));
+  stream.averageSummary.invalidateFrom(unsigned(firstMoved) > averageRange ? unsigned(firstMoved) - averageRange : 0);
+  return order;
+}
+
+const BitratePlotModel::BitrateEntry &BitratePlotModel::getSortedEntry(unsigned streamIndex, unsigned pointIndex) const
+{
+  const auto &order = this->getSortedOrder(streamIndex);
+  return this->dataPerStream[streamIndex].at(order[int(pointIndex)]);
 }
 
 unsigned int BitratePlotModel::calculateAverageValue(unsigned streamIndex, unsigned pointIndex) const
 {
-  const unsigned int averageRange = 10;
   unsigned averageBitrate = 0;
-  const unsigned start = qMax(unsigned(0), pointIndex - averageRange);
-  const unsigned end = qMin(pointIndex + averageRange, unsigned(this->dataPerStream[streamIndex].size()));
+  const auto nrEntries = this->dataPerStream[streamIndex].nrEntries;
+  const unsigned start = (pointIndex > averageRange) ? pointIndex - averageRange : 0;
+  const unsigned end = qMin(pointIndex + averageRange, nrEntries);
   for (unsigned i = start; i < end; i++)
-    averageBitrate += this->dataPerStream[streamIndex][i].bitrate;
+    averageBitrate += this->getSortedEntry(streamIndex, i).bitrate;
   return averageBitrate / (end - start);
 }
@@ -35,9 +35,11 @@
 #include <QMap>
 #include <QMutex>
 #include <QString>
+#include <QVector>
 
 #include "common/typedef.h"
 #include "ui/views/plotModel.h"
+#include "ui/views/PlotSummaryPyramid.h"
 
 class BitratePlotModel : public PlotModel
 {
@@ -48,6 +50,7 @@ public:
   unsigned getNrStreams() const override;
   PlotModel::StreamParameter getStreamParameter(unsigned streamIndex) const override;
   PlotModel::Point getPlotPoint(unsigned streamIndex, unsigned plotIndex, unsigned pointIndex) const override;
+  std::optional<QVector<PlotModel::PointSummary>> getPlotSummaries(unsigned streamIndex, unsigned plotIndex, Range<double> xRange, unsigned maxNrSummaries) const override;
   QString getPointInfo(unsigned streamIndex, unsigned plotIndex, unsigned pointIndex) const override;
   std::optional<unsigned> getReasonabelRangeToShowOnXAxisPer100Pixels() const override;
   QString formatValue(Axis axis, double value) const override;
@@ -76,10 +79,36 @@ private:
   };
   SortMode sortMode { SortMode::DECODE_ORDER };
 
-  QMap<unsigned int, QList<BitrateEntry>> dataPerStream;
+  struct StreamData
+  {
+    const BitrateEntry &at(unsigned index) const { return this->chunks[int(index / ChunkSize)][int(index % ChunkSize)]; }
+    void append(const BitrateEntry &entry);
+
+    // The entries in the order in which they were added. They are stored in chunks of ChunkSize entries
+    // so that adding an entry never copies the existing ones.
+    static constexpr unsigned ChunkSize = 4096;
+    QVector<QVector<BitrateEntry>> chunks;
+    unsigned nrEntries {0};
+
+    // The indices of the entries sorted by DTS and PTS. These are only updated when the order is needed.
+    // Then only the entries that were added since the last update are sorted and merged in.
+    QVector<unsigned> dtsOrder;
+    QVector<unsigned> ptsOrder;
+
+    // Summaries of the bitrate (plot 0) and the average bitrate (plot 1) in the current order for drawing when zoomed out
+    PlotSummaryPyramid bitrateSummary;
+    PlotSummaryPyramid averageSummary;
+  };
+  // Mutable because the orders and summaries are updated when the data is read
+  mutable QMap<unsigned int, StreamData> dataPerStream;
   mutable QMutex dataMutex;
 
+  // Get the entry indices of the stream in the current sort order. The mutex must be locked.
+  const QVector<unsigned> &getSortedOrder(unsigned streamIndex) const;
+  const BitrateEntry &getSortedEntry(unsigned streamIndex, unsigned pointIndex) const;
+
   unsigned int calculateAverageValue(unsigned streamIndex, unsigned pointIndex) const;
+  PlotModel::Point getPlotPointInternal(unsigned streamIndex, unsigned plotIndex, unsigned pointIndex) const;
 
   Range<int> rangeDts;
   Range<int> rangePts;
@@ -85,17 +85,38 @@ PlotModel::Point HRDPlotModel::getPlotPoint(unsigned streamIndex, unsigned plotI
   if (streamIndex > 0)
     return {};
 
-  if (pointIndex == 0)
-    return {0, 0, 0, false};
+  QMutexLocker locker(&this->dataMutex);
+  return this->getPlotPointInternal(pointIndex);
+}
+
+std::optional<QVector<PlotModel::PointSummary>> HRDPlotModel::getPlotSummaries(unsigned streamIndex, unsigned plotIndex, Range<double> xRange, unsigned maxNrSummaries) const
+{
+  Q_UNUSED(plotIndex);
+
+  if (streamIndex > 0)
+    return {};
 
   QMutexLocker locker(&this->dataMutex);
 
+  // The summaries only have to be updated for the added entries
+  const auto nrPoints = this->data.empty() ? 0 : unsigned(this->data.size() + 1);
+  auto getPoint = [this](unsigned pointIndex) { return this->getPlotPointInternal(pointIndex); };
+  return this->summary.getSummaries(nrPoints, getPoint, xRange, maxNrSummaries);
+}
+
+PlotModel::Point HRDPlotModel::getPlotPointInternal(unsigned pointIndex) const
+{
+  if (pointIndex == 0)
+    return {0, 0, 0, false};
+
   if (pointIndex > unsigned(this->data.size()))
     return {};
 
   PlotModel::Point point;
   point.x = this->data[pointIndex - 1].time_offset_end;
   point.y = this->data[pointIndex - 1].cbp_fullness_end;
+  point.width = 0;
+  point.intra = false;
   
   return point;
 }
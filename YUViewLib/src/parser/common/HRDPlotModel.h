@@ -38,6 +38,7 @@
 
 #include "common/typedef.h"
 #include "ui/views/plotModel.h"
+#include "ui/views/PlotSummaryPyramid.h"
 
 class HRDPlotModel : public PlotModel
 {
@@ -48,6 +49,7 @@ public:
   unsigned getNrStreams() const override { return 1; }
   PlotModel::StreamParameter getStreamParameter(unsigned streamIndex) const override;
   PlotModel::Point getPlotPoint(unsigned streamIndex, unsigned plotIndex, unsigned pointIndex) const override;
+  std::optional<QVector<PlotModel::PointSummary>> getPlotSummaries(unsigned streamIndex, unsigned plotIndex, Range<double> xRange, unsigned maxNrSummaries) const override;
   QString getPointInfo(unsigned streamIndex, unsigned plotIndex, unsigned pointIndex) const override;
   std::optional<unsigned> getReasonabelRangeToShowOnXAxisPer100Pixels() const override { return 1; }
   QString formatValue(Axis axis, double value) const override;
@@ -83,6 +85,11 @@ private:
   QList<HRDEntry> data;
   mutable QMutex dataMutex;
 
+  PlotModel::Point getPlotPointInternal(unsigned pointIndex) const;
+
+  // Summary of the buffer level for drawing when zoomed out. Updated when drawing.
+  mutable PlotSummaryPyramid summary;
+
   int cpb_buffer_size {0};
   double time_offset_max {0};
   Range<int> bufferLevelLimits {0, 0};
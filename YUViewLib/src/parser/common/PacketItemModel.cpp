@@ -32,8 +32,11 @@
 
 #include "PacketItemModel.h"
 
+#include <memory>
 #include <QBrush>
 #include <QColor>
+#include <QFutureWatcher>
+#include <QtConcurrent>
 
 #if PARSERCOMMON_DEBUG_FILTER_OUTPUT && !NDEBUG
 #include <QDebug>
@@ -162,6 +165,59 @@ int PacketItemModel::rowCount(const QModelIndex &parent) const
   return (p == nullptr) ? 0 : p->childItems.count();
 }
 
+bool PacketItemModel::hasChildren(const QModelIndex &parent) const
+{
+  if (parent.isValid() && parent.column() == 0)
+  {
+    TreeItem *p = static_cast<TreeItem*>(parent.internalPointer());
+    if (p != nullptr && p->hasLazyChildren())
+      return true;
+  }
+  return QAbstractItemModel::hasChildren(parent);
+}
+
+bool PacketItemModel::canFetchMore(const QModelIndex &parent) const
+{
+  if (!parent.isValid() || !unitDetailsParserFactory)
+    return false;
+  TreeItem *p = static_cast<TreeItem*>(parent.internalPointer());
+  return p != nullptr && p->hasLazyChildren();
+}
+
+void PacketItemModel::fetchMore(const QModelIndex &parent)
+{
+  if (!canFetchMore(parent))
+    return;
+
+  TreeItem *p = static_cast<TreeItem*>(parent.internalPointer());
+  auto parseDetails = unitDetailsParserFactory(p->lazyUnitIndex);
+  p->lazyUnitIndex = -1;
+  if (!parseDetails)
+    return;
+
+  // Parsing the unit may require parsing many other units first. Do this in the background and parse into a separate
+  // item. The rows are inserted once we know how many there are (if the item still exists then).
+  auto details = std::make_shared<TreeItem>(nullptr);
+  QPersistentModelIndex parentIndex(parent);
+  auto watcher = new QFutureWatcher<void>(this);
+  connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher, details, parentIndex]()
+  {
+    watcher->deleteLater();
+    if (!parentIndex.isValid() || details->childItems.isEmpty())
+      return;
+
+    TreeItem *p = static_cast<TreeItem*>(parentIndex.internalPointer());
+    const int firstRow = p->childItems.count();
+    beginInsertRows(parentIndex, firstRow, firstRow + details->childItems.count() - 1);
+    for (auto child : details->childItems)
+      child->parentItem = p;
+    p->childItems.append(details->childItems);
+    details->childItems.clear();
+    endInsertRows();
+  });
+  watcher->setFuture(QtConcurrent::run([parseDetails, details]() { parseDetails(details.get()); }));
+}
+
 void PacketItemModel::updateNumberModelItems()
 {
   auto n = getNumberFirstLevelChildren();
@@ -35,6 +35,8 @@
 #include <QAbstractItemModel>
 #include <QSortFilterProxyModel>
 
+#include <functional>
+
 #include "TreeItem.h"
 
 // The item model which is used to display packets from the bitstream. This can be AVPackets or other units from the bitstream (NAL units e.g.)
@@ -53,6 +55,9 @@ public:
   virtual QModelIndex parent(const QModelIndex &index) const Q_DECL_OVERRIDE;
   virtual int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
   virtual int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE { Q_UNUSED(parent); return 5; }
+  virtual bool hasChildren(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+  virtual bool canFetchMore(const QModelIndex &parent) const Q_DECL_OVERRIDE;
+  virtual void fetchMore(const QModelIndex &parent) Q_DECL_OVERRIDE;
 
   // The root of the tree
   QScopedPointer<TreeItem> rootItem;
@@ -63,6 +68,13 @@ public:
   void setShowVideoStreamOnly(bool showVideoOnly);
 
   void updateNumberModelItems();
+
+  // In the lazy mode, the parser only creates the first level items while parsing. When such an item is expanded, the
+  // factory is called to get a function that parses the unit with the given index again and adds the children to the given
+  // item. This function is run in a background thread and the rows are inserted when it is done.
+  using UnitDetailsParser = std::function<void(TreeItem *parent)>;
+  void setUnitDetailsParserFactory(std::function<UnitDetailsParser(int unitIndex)> factory) { unitDetailsParserFactory = factory; }
+
 private:
   // This is the current number of first level child items which we show right now.
   // The brackground parser will add more items and it will notify the bitstreamAnalysisWindow
@@ -74,6 +86,8 @@ private:
   static QList<QColor> streamIndexColors;
   bool useColorCoding { true };
   bool showVideoOnly  { false };
+
+  std::function<UnitDetailsParser(int unitIndex)> unitDetailsParserFactory;
 };
 
 class FilterByStreamIndexProxyModel : public QSortFilterProxyModel
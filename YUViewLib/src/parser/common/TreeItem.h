@@ -69,6 +69,11 @@ public:
   int getStreamIndex() { if (streamIndex >= 0) return streamIndex; if (parentItem) return parentItem->getStreamIndex(); return -1; }
   void setStreamIndex(int idx) { streamIndex = idx; }
 
+  // In the lazy mode of the packet model, the children of a unit (NAL, OBU ...) are only created when the item is expanded.
+  // Until then, only the index of the unit is saved here (see PacketItemModel::fetchMore).
+  bool hasLazyChildren() const { return lazyUnitIndex >= 0; }
+  int lazyUnitIndex { -1 };
+
 private:
   bool error { false };
   // This is set for the first layer items in case of AVPackets
@@ -32,9 +32,18 @@
 
 #include "parserAnnexB.h"
 
+#include <algorithm>
 #include <assert.h>
-#include <QProgressDialog>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
 #include <QElapsedTimer>
+#include <QHash>
+#include <QProgressDialog>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include "common/ReaderHelper.h"
 
 #define PARSERANNEXB_DEBUG_OUTPUT 0
 #if PARSERANNEXB_DEBUG_OUTPUT && !NDEBUG
@@ -44,6 +53,10 @@
 #define DEBUG_ANNEXB(msg) ((void)0)
 #endif
 
+// The index cache files start with this identifier followed by the version. Increase the version if the format changes.
+const quint32 INDEXCACHE_MAGIC = 0x59564958;
+const qint32 INDEXCACHE_VERSION = 1;
+
 QString parserAnnexB::getShortStreamDescription(int streamIndex) const
 {
   Q_UNUSED(streamIndex);
@@ -78,6 +91,9 @@ bool parserAnnexB::addFrameToList(int poc, std::optional<pairUint64> fileStartEn
 
 void parserAnnexB::logNALSize(QByteArray &data, TreeItem *root, std::optional<pairUint64> nalStartEndPos)
 {
+  if (root == nullptr)
+    return;
+
   int startCodeSize = 0;
   if (data[0] == char(0) && data[1] == char(0) && data[2] == char(0) && data[3] == char(1))
     startCodeSize = 4;
@@ -126,6 +142,20 @@ int parserAnnexB::getClosestSeekableFrameNumberBefore(int frameIdx, int &codingO
   return POCList.indexOf(bestSeekPOC);
 }
 
+QList<int> parserAnnexB::getRandomAccessPointFrameNumbers() const
+{
+  QHash<int, int> frameIdxForPOC;
+  for (int i = 0; i < POCList.length(); i++)
+    frameIdxForPOC.insert(POCList[i], i);
+
+  QList<int> frameNumbers;
+  for (const auto &f : frameList)
+    if (f.randomAccessPoint && frameIdxForPOC.contains(f.poc))
+      frameNumbers.append(frameIdxForPOC.value(f.poc));
+  std::sort(frameNumbers.begin(), frameNumbers.end());
+  return frameNumbers;
+}
+
 std::optional<pairUint64> parserAnnexB::getFrameStartEndPos(int codingOrderFrameIdx)
 {
   if (codingOrderFrameIdx < 0 || codingOrderFrameIdx >= frameList.size())
@@ -137,6 +167,16 @@ bool parserAnnexB::parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, Q
 {
   DEBUG_ANNEXB("parserAnnexB::parseAnnexBFile");
 
+  // The bitstream analysis needs all NAL units in the packet model. This is not in the index.
+  const bool useIndexCache = this->packetModel->isNull();
+  if (useIndexCache && this->loadIndexCache(file.data()))
+  {
+    DEBUG_ANNEXB("parserAnnexB::parseAnnexBFile Loaded index from cache. Found " << POCList.length() << " POCs");
+    emit streamInfoUpdated();
+    emit backgroundParsingDone("");
+    return true;
+  }
+
   int64_t maxPos = file->getFileSize();
   QScopedPointer<QProgressDialog> progressDialog;
   int curPercentValue = 0;
@@ -156,6 +196,10 @@ bool parserAnnexB::parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, Q
   stream_info.parsing = true;
   emit streamInfoUpdated();
 
+  const bool recordLazyNALUnits = this->lazyPacketModel && !this->packetModel->isNull();
+  if (recordLazyNALUnits)
+    this->lazyFilePath = file->absoluteFilePath();
+
   // Just push all NAL units from the annexBFile into the annexBParser
   QByteArray nalData;
   int nalID = 0;
@@ -170,6 +214,7 @@ bool parserAnnexB::parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, Q
     if (stream_info.file_size > 0)
       progressPercentValue = clip((int)(pos * 100 / stream_info.file_size), 0, 100);
 
+    const auto nrNalUnitsInList = nalUnitList.size();
     try
     {
       nalData = file->getNextNALUnit(false, &nalStartEndPosFile);
@@ -195,6 +240,20 @@ bool parserAnnexB::parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, Q
       DEBUG_ANNEXB("parserAnnexB::parseAndAddNALUnit Exception thrown parsing NAL " << nalID);
     }
 
+    if (recordLazyNALUnits)
+    {
+      // Only parameter sets and random access points are added to the nalUnitList
+      LazyNALUnit unit;
+      unit.fileStartEndPos = nalStartEndPosFile;
+      if (nalUnitList.size() > nrNalUnitsInList)
+      {
+        unit.parameterSet = nalUnitList.last()->isParameterSet();
+        unit.randomAccessPoint = !unit.parameterSet;
+      }
+      QMutexLocker locker(&this->lazyNALUnitsMutex);
+      this->lazyNALUnits.append(unit);
+    }
+
     nalID++;
 
     if (progressDialog)
@@ -246,9 +305,297 @@ bool parserAnnexB::parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, Q
   emit streamInfoUpdated();
   emit backgroundParsingDone("");
 
+  if (useIndexCache && !abortParsing)
+    this->saveIndexCache(file.data());
+
   return !cancelBackgroundParser;
 }
 
+TreeItem *parserAnnexB::createNALTreeItem(int nalID, TreeItem *parent)
+{
+  if (parent)
+    return new TreeItem(parent);
+  if (this->packetModel->isNull())
+    return nullptr;
+
+  auto item = new TreeItem(this->packetModel->getRootItem());
+  if (this->lazyPacketModel)
+    item->lazyUnitIndex = nalID;
+  return item;
+}
+
+PacketItemModel::UnitDetailsParser parserAnnexB::getUnitDetailsParser(int nalID)
+{
+  // Get the NAL units that must be parsed to get to the state of the parser in which the NAL unit was parsed
+  QList<QPair<int, pairUint64>> parseNALUnits;
+  {
+    QMutexLocker locker(&this->lazyNALUnitsMutex);
+    if (nalID < 0 || nalID >= this->lazyNALUnits.size())
+      return {};
+
+    int startID = nalID;
+    for (int i = nalID; i >= 0; i--)
+    {
+      if (this->lazyNALUnits[i].randomAccessPoint)
+      {
+        startID = i;
+        break;
+      }
+    }
+    for (int i = 0; i < startID; i++)
+      if (this->lazyNALUnits[i].parameterSet)
+        parseNALUnits.append(qMakePair(i, this->lazyNALUnits[i].fileStartEndPos));
+    for (int i = startID; i <= nalID; i++)
+      parseNALUnits.append(qMakePair(i, this->lazyNALUnits[i].fileStartEndPos));
+  }
+
+  // The returned function only uses its own parser and file
+  QSharedPointer<parserAnnexB> parser(this->newParserOfSameType());
+  const QString filePath = this->lazyFilePath;
+  return [parser, filePath, parseNALUnits, nalID](TreeItem *parent)
+  {
+    FileSource file;
+    if (!file.openFile(filePath))
+    {
+      ReaderHelper::addErrorMessageChildItem("Error opening the file to parse the NAL unit.", parent);
+      return;
+    }
+
+    TreeItem nalItems(nullptr);
+    for (const auto &unit : parseNALUnits)
+    {
+      const auto startEnd = unit.second;
+      QByteArray nalData;
+      file.readBytes(nalData, int64_t(startEnd.first), int64_t(startEnd.second - startEnd.first + 1));
+      try
+      {
+        parser->parseAndAddNALUnit(unit.first, nalData, {}, startEnd, (unit.first == nalID) ? &nalItems : nullptr);
+      }
+      catch (...)
+      {
+        DEBUG_ANNEXB("parserAnnexB::getUnitDetailsParser Exception thrown parsing NAL " << unit.first);
+      }
+    }
+
+    // Move the details of the NAL unit to the given parent
+    if (nalItems.childItems.isEmpty())
+      return;
+    auto nalItem = nalItems.childItems.first();
+    for (auto child : nalItem->childItems)
+    {
+      child->parentItem = parent;
+      parent->childItems.append(child);
+    }
+    nalItem->childItems.clear();
+  };
+}
+
+QList<QByteArray> parserAnnexB::getSeekFrameParamerSetsOrIndex(int iFrameNr, uint64_t &filePos)
+{
+  if (!this->loadedFromIndex)
+    return this->getSeekFrameParamerSets(iFrameNr, filePos);
+
+  QList<QByteArray> paramSets;
+  if (iFrameNr < 0 || iFrameNr >= POCList.size() || !this->indexSeekPoints.contains(POCList[iFrameNr]))
+    return paramSets;
+
+  const auto &seekPoint = this->indexSeekPoints[POCList[iFrameNr]];
+  filePos = seekPoint.filePos;
+  for (auto idx : seekPoint.parameterSetIndices)
+    paramSets.append(this->indexParameterSets[idx]);
+  return paramSets;
+}
+
+QString parserAnnexB::getIndexCacheFilePath(const QString &absoluteFilePath)
+{
+  const auto cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  if (cacheDir.isEmpty())
+    return {};
+  const auto pathHash = QCryptographicHash::hash(absoluteFilePath.toUtf8(), QCryptographicHash::Sha1).toHex();
+  return cacheDir + "/AnnexBIndex/" + QString::fromLatin1(pathHash) + ".idx";
+}
+
+bool parserAnnexB::loadIndexCache(FileSourceAnnexBFile *file)
+{
+  const auto fileInfo = file->getFileInfo();
+  const auto indexFilePath = getIndexCacheFilePath(fileInfo.absoluteFilePath());
+  QFile indexFile(indexFilePath);
+  if (indexFilePath.isEmpty() || !indexFile.open(QIODevice::ReadOnly))
+    return false;
+
+  QDataStream in(&indexFile);
+  quint32 magic;
+  qint32 version;
+  QString parserName, filePath;
+  qint64 fileSize, fileModified;
+  in >> magic >> version;
+  if (magic != INDEXCACHE_MAGIC || version != INDEXCACHE_VERSION)
+    return false;
+  in >> parserName >> filePath >> fileSize >> fileModified;
+  if (parserName != this->metaObject()->className() || filePath != fileInfo.absoluteFilePath() || fileSize != fileInfo.size() || fileModified != fileInfo.lastModified().toMSecsSinceEpoch())
+  {
+    DEBUG_ANNEXB("parserAnnexB::loadIndexCache The index is outdated");
+    return false;
+  }
+
+  auto readFilePos = [&in]() -> std::optional<pairUint64> {
+    bool hasPos;
+    quint64 start, end;
+    in >> hasPos >> start >> end;
+    if (!hasPos)
+      return {};
+    return pairUint64(start, end);
+  };
+
+  qint32 nrNalUnits, firstRAPOC, nrFrames;
+  in >> nrNalUnits >> firstRAPOC >> nrFrames;
+  QList<AnnexBFrame> newFrameList;
+  for (int i = 0; i < nrFrames && in.status() == QDataStream::Ok; i++)
+  {
+    AnnexBFrame frame;
+    qint32 poc;
+    in >> poc >> frame.randomAccessPoint;
+    frame.poc = poc;
+    frame.fileStartEndPos = readFilePos();
+    newFrameList.append(frame);
+  }
+  QList<int> newPOCList;
+  in >> newPOCList;
+
+  // The parameter sets are parsed again (in the original order) so that the parser knows all the properties of the stream.
+  qint32 nrParameterSets;
+  in >> nrParameterSets;
+  QList<QByteArray> parameterSets;
+  QList<std::optional<pairUint64>> parameterSetsFilePos;
+  for (int i = 0; i < nrParameterSets && in.status() == QDataStream::Ok; i++)
+  {
+    QByteArray data;
+    in >> data;
+    parameterSets.append(data);
+    parameterSetsFilePos.append(readFilePos());
+  }
+
+  QList<QByteArray> newIndexParameterSets;
+  in >> newIndexParameterSets;
+  qint32 nrSeekPoints;
+  in >> nrSeekPoints;
+  QMap<int, IndexSeekPoint> newSeekPoints;
+  for (int i = 0; i < nrSeekPoints && in.status() == QDataStream::Ok; i++)
+  {
+    qint32 poc;
+    quint64 filePos;
+    IndexSeekPoint seekPoint;
+    in >> poc >> filePos >> seekPoint.parameterSetIndices;
+    seekPoint.filePos = filePos;
+    for (auto idx : seekPoint.parameterSetIndices)
+      if (idx < 0 || idx >= newIndexParameterSets.size())
+        return false;
+    newSeekPoints.insert(poc, seekPoint);
+  }
+
+  if (in.status() != QDataStream::Ok || newFrameList.size() != nrFrames || newPOCList.size() != nrFrames)
+  {
+    DEBUG_ANNEXB("parserAnnexB::loadIndexCache Error reading the index");
+    return false;
+  }
+
+  for (int i = 0; i < parameterSets.size(); i++)
+  {
+    try
+    {
+      this->parseAndAddNALUnit(i, QByteArrayLiteral("\x00\x00\x01") + parameterSets[i], {}, parameterSetsFilePos[i], nullptr);
+    }
+    catch (...)
+    {
+      DEBUG_ANNEXB("parserAnnexB::loadIndexCache Exception thrown parsing parameter set " << i);
+    }
+  }
+
+  this->frameList = newFrameList;
+  this->POCList = newPOCList;
+  this->pocOfFirstRandomAccessFrame = firstRAPOC;
+  this->indexParameterSets = newIndexParameterSets;
+  this->indexSeekPoints = newSeekPoints;
+  this->loadedFromIndex = true;
+
+  stream_info.file_size = file->getFileSize();
+  stream_info.parsing = false;
+  stream_info.nr_nal_units = nrNalUnits;
+  stream_info.nr_frames = frameList.size();
+  return true;
+}
+
+void parserAnnexB::saveIndexCache(FileSourceAnnexBFile *file)
+{
+  const auto fileInfo = file->getFileInfo();
+  const auto indexFilePath = getIndexCacheFilePath(fileInfo.absoluteFilePath());
+  if (indexFilePath.isEmpty() || this->frameList.isEmpty() || !QDir().mkpath(QFileInfo(indexFilePath).absolutePath()))
+    return;
+
+  // Get the seek information for all random access points. Different parameter sets are only saved once.
+  QList<QByteArray> seekParameterSets;
+  QMap<int, IndexSeekPoint> seekPoints;
+  for (const auto &frame : this->frameList)
+  {
+    if (!frame.randomAccessPoint)
+      continue;
+    const auto frameIdx = POCList.indexOf(frame.poc);
+    if (frameIdx < 0)
+      continue;
+    IndexSeekPoint seekPoint;
+    for (const auto &paramSet : this->getSeekFrameParamerSets(frameIdx, seekPoint.filePos))
+    {
+      auto idx = seekParameterSets.indexOf(paramSet);
+      if (idx < 0)
+      {
+        idx = seekParameterSets.size();
+        seekParameterSets.append(paramSet);
+      }
+      seekPoint.parameterSetIndices.append(idx);
+    }
+    seekPoints.insert(frame.poc, seekPoint);
+  }
+
+  QSaveFile indexFile(indexFilePath);
+  if (!indexFile.open(QIODevice::WriteOnly))
+    return;
+
+  auto writeFilePos = [](QDataStream &out, const std::optional<pairUint64> &pos) {
+    out << bool(pos) << quint64(pos ? pos->first : 0) << quint64(pos ? pos->second : 0);
+  };
+
+  QDataStream out(&indexFile);
+  out << INDEXCACHE_MAGIC << INDEXCACHE_VERSION;
+  out << QString(this->metaObject()->className()) << fileInfo.absoluteFilePath() << qint64(fileInfo.size()) << qint64(fileInfo.lastModified().toMSecsSinceEpoch());
+  out << qint32(stream_info.nr_nal_units) << qint32(this->pocOfFirstRandomAccessFrame) << qint32(this->frameList.size());
+  for (const auto &frame : this->frameList)
+  {
+    out << qint32(frame.poc) << frame.randomAccessPoint;
+    writeFilePos(out, frame.fileStartEndPos);
+  }
+  out << this->POCList;
+
+  QList<QSharedPointer<nal_unit>> parameterSets;
+  for (const auto &nal : this->nalUnitList)
+    if (nal->isParameterSet())
+      parameterSets.append(nal);
+  out << qint32(parameterSets.size());
+  for (const auto &nal : parameterSets)
+  {
+    out << nal->getRawNALData();
+    writeFilePos(out, nal->filePosStartEnd);
+  }
+
+  out << seekParameterSets;
+  out << qint32(seekPoints.size());
+  for (auto it = seekPoints.constBegin(); it != seekPoints.constEnd(); it++)
+    out << qint32(it.key()) << quint64(it.value().filePos) << it.value().parameterSetIndices;
+
+  if (out.status() == QDataStream::Ok)
+    indexFile.commit();
+  DEBUG_ANNEXB("parserAnnexB::saveIndexCache Saved index to " << indexFilePath);
+}
+
 bool parserAnnexB::runParsingOfFile(QString compressedFilePath)
 {
   DEBUG_ANNEXB("playlistItemCompressedVideo::runParsingOfFile");
@@ -33,7 +33,9 @@
 #pragma once
 
 #include <QList>
+#include <QMutex>
 #include <QTreeWidgetItem>
+#include <QVector>
 
 #include <optional>
 
@@ -99,6 +101,8 @@ public:
   // frameIdx: The frame index in display order that we want to seek to
   // codingOrderFrameIdx: The index of the frame in coding order (for use with getFrameStartEndPos).
   int getClosestSeekableFrameNumberBefore(int frameIdx, int &codingOrderFrameIdx) const;
+  // Get the frame indices (in display order) of all random access points in ascending order.
+  QList<int> getRandomAccessPointFrameNumbers() const;
 
   // Get the parameters sets as extradata. The format of this depends on the underlying codec.
   virtual QByteArray getExtradata() = 0;
@@ -108,8 +112,13 @@ public:
 
   std::optional<pairUint64> getFrameStartEndPos(int codingOrderFrameIdx);
 
+  // Parse the whole file. If there is a valid index of the file in the index cache (see loadIndexCache), the index is
+  // loaded instead. Without a packet model (no bitstream analysis), the result of a complete parsing is saved to the index cache.
   bool parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, QWidget *mainWindow=nullptr);
 
+  // Like getSeekFrameParamerSets but if the file was loaded from the index cache, the seek information is taken from there.
+  QList<QByteArray> getSeekFrameParamerSetsOrIndex(int iFrameNr, uint64_t &filePos);
+
   // Called from the bitstream analyzer. This function can run in a background process.
   bool runParsingOfFile(QString compressedFilePath) Q_DECL_OVERRIDE;
 
@@ -182,6 +191,45 @@ protected:
 
   int pocOfFirstRandomAccessFrame {-1};
 
+  // --- Lazy packet model ---
+  // In the lazy mode (setLazyPacketModel), only the item of each NAL unit is added to the packet model while parsing.
+  // For every NAL unit, we record the position in the file and if it is a parameter set or a random access point.
+  // When an item is expanded, a new parser of the same type parses all parameter sets before and all NAL units from
+  // the closest random access point up to the NAL unit. Only the details of the NAL unit itself are added to the tree.
+  // This requires that the parser adds all parameter sets and random access slices to the nalUnitList.
+  struct LazyNALUnit
+  {
+    pairUint64 fileStartEndPos;
+    bool parameterSet {false};
+    bool randomAccessPoint {false};
+  };
+  QVector<LazyNALUnit> lazyNALUnits;
+  QMutex lazyNALUnitsMutex;
+  QString lazyFilePath;
+
+  // Create the item for a NAL unit in the given parent or (if no parent is given) in the packet model.
+  // In the lazy mode, the items in the packet model are created without details (TreeItem::hasLazyChildren).
+  TreeItem *createNALTreeItem(int nalID, TreeItem *parent);
+  PacketItemModel::UnitDetailsParser getUnitDetailsParser(int nalID) override;
+  virtual parserAnnexB *newParserOfSameType() const = 0;
+
+  // --- Index cache ---
+  // After a file was parsed completely, everything that is needed to open and seek the file (frame list, POCs, file positions,
+  // parameter sets and the parameter sets to send at each random access point) is saved to an index file in the cache directory.
+  // The index is only valid for a file with the same path, size and modification time. The slices are not in the nalUnitList
+  // of a parser that was loaded from the index. So the seek information (indexSeekPoints) is used instead of getSeekFrameParamerSets.
+  bool loadIndexCache(FileSourceAnnexBFile *file);
+  void saveIndexCache(FileSourceAnnexBFile *file);
+  static QString getIndexCacheFilePath(const QString &absoluteFilePath);
+  struct IndexSeekPoint
+  {
+    uint64_t filePos {0};
+    QList<int> parameterSetIndices;  //< Indices in indexParameterSets
+  };
+  QMap<int, IndexSeekPoint> indexSeekPoints;  //< Key is the POC of the random access frame
+  QList<QByteArray> indexParameterSets;       //< All different parameter sets that are used by the indexSeekPoints
+  bool loadedFromIndex {false};
+
   // Save general information about the file here
   struct stream_info_type
   {
@@ -175,11 +175,9 @@ parserAnnexB::ParseResult parserAnnexBAVC::parseAndAddNALUnit(int nalID, QByteAr
   // We don't set data (a name) for this item yet. 
   // We want to parse the item and then set a good description.
   QString specificDescription;
-  TreeItem *nalRoot = nullptr;
-  if (parent)
-    nalRoot = new TreeItem(parent);
-  else if (!packetModel->isNull())
-    nalRoot = new TreeItem(packetModel->getRootItem());
+  // In the lazy mode, only the item is created now and the details are not parsed into the tree (nalRoot is null).
+  TreeItem *nalItem = this->createNALTreeItem(nalID, parent);
+  TreeItem *nalRoot = (nalItem && nalItem->hasLazyChildren()) ? nullptr : nalItem;
 
   parserAnnexB::logNALSize(data, nalRoot, nalStartEndPosFile);
 
@@ -461,11 +459,11 @@ parserAnnexB::ParseResult parserAnnexBAVC::parseAndAddNALUnit(int nalID, QByteAr
     this->currentAUSliceTypes[currentSliceType]++;
   }
 
-  if (nalRoot)
+  if (nalItem)
   {
     // Set a useful name of the TreeItem (the root for this NAL)
-    nalRoot->itemData.append(QString("NAL %1: %2").arg(nal_avc.nal_idx).arg(nal_unit_type_toString.value(nal_avc.nal_unit_type)) + specificDescription);
-    nalRoot->setError(!parsingSuccess);
+    nalItem->itemData.append(QString("NAL %1: %2").arg(nal_avc.nal_idx).arg(nal_unit_type_toString.value(nal_avc.nal_unit_type)) + specificDescription);
+    nalItem->setError(!parsingSuccess);
   }
 
   parseResult.success = true;
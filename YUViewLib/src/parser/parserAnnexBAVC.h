@@ -49,6 +49,10 @@ public:
   parserAnnexBAVC(QObject *parent = nullptr) : parserAnnexB(parent) { curFrameFileStartEndPos = pairUint64(-1, -1); };
   ~parserAnnexBAVC() {};
 
+  parserAnnexB *newParserOfSameType() const override { return new parserAnnexBAVC(); }
+  // All parameter sets and random access slices are added to the nalUnitList
+  bool supportsLazyPacketModel() const override { return true; }
+
   // Get properties
   double getFramerate() const Q_DECL_OVERRIDE;
   QSize getSequenceSizeSamples() const Q_DECL_OVERRIDE;
@@ -49,6 +49,10 @@ public:
   parserAnnexBHEVC(QObject *parent = nullptr) : parserAnnexB(parent) { curFrameFileStartEndPos = pairUint64(-1, -1); }
   ~parserAnnexBHEVC() {};
 
+  parserAnnexB *newParserOfSameType() const override { return new parserAnnexBHEVC(); }
+  // All parameter sets and random access slices are added to the nalUnitList
+  bool supportsLazyPacketModel() const override { return true; }
+
   // Get some properties
   double getFramerate() const Q_DECL_OVERRIDE;
   QSize getSequenceSizeSamples() const Q_DECL_OVERRIDE;
@@ -163,11 +163,9 @@ parserAnnexB::ParseResult parserAnnexBMpeg2::parseAndAddNALUnit(int nalID, QByte
   // We don't set data (a name) for this item yet. 
   // We want to parse the item and then set a good description.
   QString specificDescription;
-  TreeItem *nalRoot = nullptr;
-  if (parent)
-    nalRoot = new TreeItem(parent);
-  else if (!packetModel->isNull())
-    nalRoot = new TreeItem(packetModel->getRootItem());
+  // In the lazy mode, only the item is created now and the details are not parsed into the tree (nalRoot is null).
+  TreeItem *nalItem = this->createNALTreeItem(nalID, parent);
+  TreeItem *nalRoot = (nalItem && nalItem->hasLazyChildren()) ? nullptr : nalItem;
 
   parserAnnexB::logNALSize(data, nalRoot, nalStartEndPosFile);
 
@@ -319,9 +317,9 @@ parserAnnexB::ParseResult parserAnnexBMpeg2::parseAndAddNALUnit(int nalID, QByte
     this->currentAUSliceTypes[currentSliceType]++;
   }
   
-  if (nalRoot)
+  if (nalItem)
     // Set a useful name of the TreeItem (the root for this NAL)
-    nalRoot->itemData.append(QString("NAL %1: %2").arg(nal_mpeg2.nal_idx).arg(nal_unit_type_toString.value(nal_mpeg2.nal_unit_type)) + specificDescription);
+    nalItem->itemData.append(QString("NAL %1: %2").arg(nal_mpeg2.nal_idx).arg(nal_unit_type_toString.value(nal_mpeg2.nal_unit_type)) + specificDescription);
 
   parseResult.success = true;
   return parseResult;
@@ -42,6 +42,8 @@ public:
   parserAnnexBMpeg2(QObject *parent = nullptr) : parserAnnexB(parent) {};
   ~parserAnnexBMpeg2() {};
 
+  parserAnnexB *newParserOfSameType() const override { return new parserAnnexBMpeg2(); }
+
   // Get properties
   double getFramerate() const Q_DECL_OVERRIDE;
   QSize getSequenceSizeSamples() const Q_DECL_OVERRIDE;
@@ -108,11 +108,9 @@ parserAnnexB::ParseResult parserAnnexBVVC::parseAndAddNALUnit(int nalID, QByteAr
   // Create a new TreeItem root for the NAL unit. We don't set data (a name) for this item
   // yet. We want to parse the item and then set a good description.
   QString specificDescription;
-  TreeItem *nalRoot = nullptr;
-  if (parent)
-    nalRoot = new TreeItem(parent);
-  else if (!packetModel->isNull())
-    nalRoot = new TreeItem(packetModel->getRootItem());
+  // In the lazy mode, only the item is created now and the details are not parsed into the tree (nalRoot is null).
+  TreeItem *nalItem = this->createNALTreeItem(nalID, parent);
+  TreeItem *nalRoot = (nalItem && nalItem->hasLazyChildren()) ? nullptr : nalItem;
 
   parserAnnexB::logNALSize(data, nalRoot, nalStartEndPosFile);
 
@@ -164,9 +162,9 @@ parserAnnexB::ParseResult parserAnnexBVVC::parseAndAddNALUnit(int nalID, QByteAr
 
   sizeCurrentAU += data.size();
 
-  if (nalRoot)
+  if (nalItem)
     // Set a useful name of the TreeItem (the root for this NAL)
-    nalRoot->itemData.append(QString("NAL %1: %2").arg(nal_vvc.nal_idx).arg(nal_vvc.nal_unit_type_id) + specificDescription);
+    nalItem->itemData.append(QString("NAL %1: %2").arg(nal_vvc.nal_idx).arg(nal_vvc.nal_unit_type_id) + specificDescription);
 
   parseResult.success = true;
   return parseResult;
@@ -48,6 +48,8 @@ public:
   parserAnnexBVVC(QObject *parent = nullptr) : parserAnnexB(parent) { curFrameFileStartEndPos = pairUint64(-1, -1); }
   ~parserAnnexBVVC() {};
 
+  parserAnnexB *newParserOfSameType() const override { return new parserAnnexBVVC(); }
+
   // Get some properties
   double getFramerate() const override;
   QSize getSequenceSizeSamples() const override;
@@ -79,6 +79,15 @@ void parserBase::enableModel()
     this->packetModel->rootItem.reset(new TreeItem(QStringList() << "Name" << "Value" << "Coding" << "Code" << "Meaning", nullptr));
 }
 
+void parserBase::setLazyPacketModel(bool lazy)
+{
+  this->lazyPacketModel = lazy && this->supportsLazyPacketModel();
+  if (this->lazyPacketModel)
+    this->packetModel->setUnitDetailsParserFactory([this](int unitIndex) { return this->getUnitDetailsParser(unitIndex); });
+  else
+    this->packetModel->setUnitDetailsParserFactory({});
+}
+
 void parserBase::updateNumberModelItems()
 { 
   this->packetModel->updateNumberModelItems();
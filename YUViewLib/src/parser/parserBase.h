@@ -81,6 +81,11 @@ public:
   void setParsingLimitEnabled(bool limitEnabled) { parsingLimitEnabled = limitEnabled; }
   void setBitrateSortingIndex(int sortingIndex) { bitratePlotModel->setBitrateSortingIndex(sortingIndex); }
 
+  // In the lazy mode, only one item per unit (NAL, OBU ...) is added to the packet model while parsing. The details of a unit
+  // are parsed when the item is expanded. This is only supported by parsers that can restore the parser state for a single
+  // unit (supportsLazyPacketModel). Other parsers ignore the setting and always add all details.
+  void setLazyPacketModel(bool lazy);
+
 signals:
   // Some data was updated and the models can be updated to reflec this. This is called regularly
   // but not for every packet/Nal unit that is parsed.
@@ -97,10 +102,17 @@ protected:
 
   static QString convertSliceTypeMapToString(QMap<QString, unsigned int> &currentAUSliceTypes);
 
+  // Lazy mode: Can the parser parse a single unit again (with the state of the parser when the unit was parsed)?
+  virtual bool supportsLazyPacketModel() const { return false; }
+  // Lazy mode: Get a function that parses the unit with the given index again and adds its details as children of the given item.
+  // The function is run in a background thread, so it must not access the parser.
+  virtual PacketItemModel::UnitDetailsParser getUnitDetailsParser(int unitIndex) { Q_UNUSED(unitIndex); return {}; }
+
   // If this variable is set (from an external thread), the parsing process should cancel immediately
   bool cancelBackgroundParser {false};
   int  progressPercentValue   {0};
   bool parsingLimitEnabled    {false};
+  bool lazyPacketModel        {false};
 
 private:
   QScopedPointer<HRDPlotModel> hrdPlotModel;
@@ -180,6 +180,11 @@ public:
   virtual bool taggedForDeletion() const { return itemTaggedForDeletion; }
   // Is there a limit on the number of threads that can cache from this item at the same time? (-1 = no limit)
   virtual int cachingThreadLimit() { return -1; }
+  // Some items (e.g. compressed videos) can only load frames efficiently in order starting from certain frames. Such an
+  // item can split the given range of frames into segments. Each segment is then cached in order by one thread at a time
+  // but multiple segments can be cached in parallel (up to cachingThreadLimit()). An empty list (default) means that
+  // there are no such restrictions.
+  virtual QList<indexRange> getCachingSegments(indexRange range) { Q_UNUSED(range); return QList<indexRange>(); }
   // Tag the item as "to be deleted"
   void tagItemForDeletion() { itemTaggedForDeletion = true; }
   // Cache the given frame. This function is thread save. So multiple instances of this function can run at the same time.
@@ -193,6 +198,10 @@ public:
   // Remove the frame with the given index from the cache.
   virtual void removeFrameFromCache(int idx) { Q_UNUSED(idx); }
   virtual void removeAllFramesFromCache() {};
+  // For the conversion speed test: The time that was spent in cacheFrame (summed over all threads) and how much of it
+  // was spent loading the raw data (reading / decoding). Returns false if the item does not measure this.
+  virtual void resetCachingDurations() {}
+  virtual bool getCachingDurations(int64_t &loadingNsec, int64_t &totalNsec) const { Q_UNUSED(loadingNsec); Q_UNUSED(totalNsec); return false; }
 
   // ----- Detection of source/file change events -----
 
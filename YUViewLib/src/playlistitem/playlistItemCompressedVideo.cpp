@@ -32,6 +32,10 @@
 
 #include "playlistItemCompressedVideo.h"
 
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
 #include <QThread>
 #include <QInputDialog>
 #include <QPlainTextEdit>
@@ -82,6 +86,12 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
   // An compressed file can be cached if nothing goes wrong
   cachingEnabled = true;
 
+  // How many decoders should cache frames of this file in parallel?
+  QSettings settings;
+  settings.beginGroup("Decoders");
+  const int nrCachingDecoders = clip(settings.value("CachingDecoders", 1).toInt(), 1, 16);
+  settings.endGroup();
+
   // Open the input file and get some properties (size, bit depth, subsampling) from the file
   if (input == inputInvalid)
   {
@@ -107,9 +117,16 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
   {
     // Open file
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo Open annexB file");
-    inputFileAnnexBLoading.reset(new FileSourceAnnexBFile(compressedFilePath));
+    loadingContext.inputFileAnnexB.reset(new FileSourceAnnexBFile(compressedFilePath));
     if (cachingEnabled)
-      inputFileAnnexBCaching.reset(new FileSourceAnnexBFile(compressedFilePath));
+    {
+      for (int i = 0; i < nrCachingDecoders; i++)
+      {
+        auto context = QSharedPointer<decoderContext>::create();
+        context->inputFileAnnexB.reset(new FileSourceAnnexBFile(compressedFilePath));
+        cachingContexts.append(context);
+      }
+    }
     // inputFormatType a parser
     if (inputFormatType == inputAnnexBHEVC)
     {
@@ -135,7 +152,8 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
     }
 
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo Start parsing of file");
-    inputFileAnnexBParser->parseAnnexBFile(inputFileAnnexBLoading, mainWindow);
+    inputFileAnnexBParser->parseAnnexBFile(loadingContext.inputFileAnnexB, mainWindow);
+    cachingSegmentStarts = inputFileAnnexBParser->getRandomAccessPointFrameNumbers();
     
     // Get the frame size and the pixel format
     frameSize = inputFileAnnexBParser->getSequenceSizeSamples();
@@ -150,29 +168,29 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
   {
     // Try ffmpeg to open the file
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo Open file using ffmpeg");
-    inputFileFFmpegLoading.reset(new FileSourceFFmpegFile());
-    if (!inputFileFFmpegLoading->openFile(compressedFilePath, mainWindow))
+    loadingContext.inputFileFFmpeg.reset(new FileSourceFFmpegFile());
+    if (!loadingContext.inputFileFFmpeg->openFile(compressedFilePath, mainWindow))
     {
       setError("Error opening file using libavcodec.");
       return;
     }
     // Is this file RGB or YUV?
-    rawFormat = inputFileFFmpegLoading->getRawFormat();
+    rawFormat = loadingContext.inputFileFFmpeg->getRawFormat();
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo Raw format %s", rawFormat == raw_YUV ? "YUV" : rawFormat == raw_RGB ? "RGB" : "Unknown");
     if (rawFormat == raw_YUV)
-      format_yuv = inputFileFFmpegLoading->getPixelFormatYUV();
+      format_yuv = loadingContext.inputFileFFmpeg->getPixelFormatYUV();
     else if (rawFormat == raw_RGB)
-      format_rgb = inputFileFFmpegLoading->getPixelFormatRGB();
+      format_rgb = loadingContext.inputFileFFmpeg->getPixelFormatRGB();
     else
     {
       setError("Unknown raw format.");
       return;
     }
-    frameSize = inputFileFFmpegLoading->getSequenceSizeSamples();
+    frameSize = loadingContext.inputFileFFmpeg->getSequenceSizeSamples();
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo Frame size %dx%d", frameSize.width(), frameSize.height());
-    frameRate = inputFileFFmpegLoading->getFramerate();
+    frameRate = loadingContext.inputFileFFmpeg->getFramerate();
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo framerate %f", frameRate);
-    ffmpegCodec = inputFileFFmpegLoading->getVideoStreamCodecID();
+    ffmpegCodec = loadingContext.inputFileFFmpeg->getVideoStreamCodecID();
     DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo ffmpeg codec %s", ffmpegCodec.getCodecName().toStdString().c_str());
     if (!ffmpegCodec.isNone())
       possibleDecoders.append(decoderEngineFFMpeg);
@@ -186,13 +204,19 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
 
     if (cachingEnabled)
     {
-      // Open the file again for caching
-      inputFileFFmpegCaching.reset(new FileSourceFFmpegFile());
-      if (!inputFileFFmpegCaching->openFile(compressedFilePath, mainWindow, inputFileFFmpegLoading.data()))
+      // Open the file again for each caching decoder
+      for (int i = 0; i < nrCachingDecoders; i++)
       {
-        setError("Error opening file a second time using libavcodec for caching.");
-        return;
+        auto context = QSharedPointer<decoderContext>::create();
+        context->inputFileFFmpeg.reset(new FileSourceFFmpegFile());
+        if (!context->inputFileFFmpeg->openFile(compressedFilePath, mainWindow, loadingContext.inputFileFFmpeg.data()))
+        {
+          setError("Error opening file a second time using libavcodec for caching.");
+          return;
+        }
+        cachingContexts.append(context);
       }
+      cachingSegmentStarts = loadingContext.inputFileFFmpeg->getKeyFrameNumbers();
     }
   }
 
@@ -241,7 +265,6 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
     else if (possibleDecoders.length() > 1)
     {
       // Is a default decoder set in the settings?
-      QSettings settings;
       settings.beginGroup("Decoders");
       decoderEngine defaultDecoder = (decoderEngine)settings.value("DefaultDecoder", -1).toInt();
       if (possibleDecoders.contains(defaultDecoder))
@@ -267,7 +290,7 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
   if (rawFormat == raw_YUV)
   {
     videoHandlerYUV *yuvVideo = getYUVVideo();
-    yuvVideo->showPixelValuesAsDiff = loadingDecoder->isSignalDifference(loadingDecoder->getDecodeSignal());
+    yuvVideo->showPixelValuesAsDiff = loadingContext.decoder->isSignalDifference(loadingContext.decoder->getDecodeSignal());
   }
 
   // Fill the list of statistics that we can provide
@@ -283,12 +306,17 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
 
   // Seek both decoders to the start of the bitstream (this will also push the parameter sets / extradata to the decoder)
   DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo Seek decoders to 0");
-  seekToPosition(0, 0, false);
-  if (cachingEnabled)
-    seekToPosition(0, 0, true);
+  seekToPosition(loadingContext, 0, 0);
+  for (auto &context : cachingContexts)
+    seekToPosition(*context, 0, 0);
+
+  updateSettings();
 
   // Connect signals for requesting data and statistics
   connect(video.data(), &videoHandler::signalRequestRawData, this, &playlistItemCompressedVideo::loadRawData, Qt::DirectConnection);
+  // Each caching thread decodes with one of the caching decoders
+  connect(video.data(), &videoHandler::signalRequestRawDataConcurrent, this, &playlistItemCompressedVideo::loadRawDataConcurrent, Qt::DirectConnection);
+  video->setConcurrentRawDataRequests(true);
   connect(video.data(), &videoHandler::signalUpdateFrameLimits, this, &playlistItemCompressedVideo::slotUpdateFrameLimits);
   connect(&statSource, &statisticHandler::updateItem, this, &playlistItemCompressedVideo::updateStatSource);
   connect(&statSource, &statisticHandler::requestStatisticsLoading, this, &playlistItemCompressedVideo::loadStatisticToCache, Qt::DirectConnection);
@@ -309,10 +337,11 @@ void playlistItemCompressedVideo::savePlaylist(QDomElement &root, const QDir &pl
   // Append all the properties of the HEVC file (the path to the file. Relative and absolute)
   d.appendProperiteChild("absolutePath", fileURL.toString());
   d.appendProperiteChild("relativePath", relativePath);
-  d.appendProperiteChild("displayComponent", QString::number(loadingDecoder ? loadingDecoder->getDecodeSignal() : -1));
+  d.appendProperiteChild("displayComponent", QString::number(loadingContext.decoder ? loadingContext.decoder->getDecodeSignal() : -1));
 
   d.appendProperiteChild("inputFormat", functions::getInputFormatName(inputFormatType));
   d.appendProperiteChild("decoder", functions::getDecoderEngineName(decoderEngineType));
+  d.appendProperiteChild("retainDecodedFrames", QString::number(retainDecodedFrames ? 1 : 0));
   
   root.appendChild(d);
 }
@@ -339,6 +368,7 @@ playlistItemCompressedVideo *playlistItemCompressedVideo::newPlaylistItemCompres
   
   // We can still not be sure that the file really exists, but we gave our best to try to find it.
   playlistItemCompressedVideo *newFile = new playlistItemCompressedVideo(filePath, displaySignal, input, decoder);
+  newFile->retainDecodedFrames = (root.findChildValue("retainDecodedFrames").toInt() != 0);
 
   // Load the propertied of the playlistItemIndexed
   playlistItem::loadPropertiesFromPlaylist(root, newFile);
@@ -351,12 +381,12 @@ infoData playlistItemCompressedVideo::getInfo() const
   infoData info("HEVC File Info");
 
   // At first append the file information part (path, date created, file size...)
-  // info.items.append(loadingDecoder->getFileInfoList());
+  // info.items.append(loadingContext.decoder->getFileInfoList());
 
   info.items.append(infoItem("Reader", functions::getInputFormatName(inputFormatType)));
-  if (inputFileFFmpegLoading)
+  if (loadingContext.inputFileFFmpeg)
   {
-    QStringList l = inputFileFFmpegLoading->getLibraryPaths();
+    QStringList l = loadingContext.inputFileFFmpeg->getLibraryPaths();
     if (l.length() % 3 == 0)
     {
       for (int i=0; i<l.length()/3; i++)
@@ -370,16 +400,16 @@ infoData playlistItemCompressedVideo::getInfo() const
     info.items.append(infoItem("Num POCs", QString::number(startEndFrame.second - startEndFrame.first + 1), "The number of pictures in the stream."));
     if (decodingEnabled)
     {
-      QStringList l = loadingDecoder->getLibraryPaths();
+      QStringList l = loadingContext.decoder->getLibraryPaths();
       if (l.length() % 3 == 0)
       {
         for (int i=0; i<l.length()/3; i++)
           info.items.append(infoItem(l[i*3], l[i*3+1], l[i*3+2]));
       }
-      info.items.append(infoItem("Decoder", loadingDecoder->getDecoderName()));
-      info.items.append(infoItem("Decoder", loadingDecoder->getCodecName()));
-      info.items.append(infoItem("Statistics", loadingDecoder->statisticsSupported() ? "Yes" : "No", "Is the decoder able to provide internals (statistics)?"));
-      info.items.append(infoItem("Stat Parsing", loadingDecoder->statisticsEnabled() ? "Yes" : "No", "Are the statistics of the sequence currently extracted from the stream?"));
+      info.items.append(infoItem("Decoder", loadingContext.decoder->getDecoderName()));
+      info.items.append(infoItem("Decoder", loadingContext.decoder->getCodecName()));
+      info.items.append(infoItem("Statistics", loadingContext.decoder->statisticsSupported() ? "Yes" : "No", "Is the decoder able to provide internals (statistics)?"));
+      info.items.append(infoItem("Stat Parsing", loadingContext.decoder->statisticsEnabled() ? "Yes" : "No", "Are the statistics of the sequence currently extracted from the stream?"));
     }
   }
   if (decoderEngineType == decoderEngineFFMpeg)
@@ -406,9 +436,9 @@ void playlistItemCompressedVideo::infoListButtonPressed(int buttonID)
     uiDialog.ffmpegLogEdit->setPlainText(logFFmpegString);
 
     // Get the loading log
-    if (inputFileFFmpegLoading)
+    if (loadingContext.inputFileFFmpeg)
     {
-      QStringList logLoading = inputFileFFmpegLoading->getFFmpegLoadingLog();
+      QStringList logLoading = loadingContext.inputFileFFmpeg->getFFmpegLoadingLog();
       QString logLoadingString;
       for (QString l : logLoading)
         logLoadingString.append(l + "\n");
@@ -426,7 +456,8 @@ itemLoadingState playlistItemCompressedVideo::needsLoading(int frameIdx, bool lo
 
   const int frameIdxInternal = getFrameIdxInternal(frameIdx);
   auto videoState = video->needsLoading(frameIdxInternal, loadRawData);
-  if (videoState == LoadingNeeded && decodingNotPossibleAfter >= 0 && frameIdxInternal >= decodingNotPossibleAfter && frameIdxInternal >= currentFrameIdx[0])
+  const int decodingNotPossibleAfter = getDecodingNotPossibleAfter();
+  if (videoState == LoadingNeeded && decodingNotPossibleAfter >= 0 && frameIdxInternal >= decodingNotPossibleAfter && frameIdxInternal >= loadingContext.currentFrameIdx)
     // The decoder can not decode this frame. 
     return LoadingNotNeeded;
   if (videoState == LoadingNeeded || statSource.needsLoading(frameIdxInternal) == LoadingNeeded)
@@ -437,6 +468,7 @@ itemLoadingState playlistItemCompressedVideo::needsLoading(int frameIdx, bool lo
 void playlistItemCompressedVideo::drawItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData)
 {
   const int frameIdxInternal = getFrameIdxInternal(frameIdx);
+  const int decodingNotPossibleAfter = getDecodingNotPossibleAfter();
 
   if (decodingNotPossibleAfter >= 0 && frameIdxInternal >= decodingNotPossibleAfter)
   {
@@ -448,7 +480,7 @@ void playlistItemCompressedVideo::drawItem(QPainter *painter, int frameIdx, doub
   {
     playlistItem::drawItem(painter, -1, zoomFactor, drawRawData);
   }
-  else if (loadingDecoder.isNull())
+  else if (loadingContext.decoder.isNull())
   {
     infoText = "No decoder allocated.\n";
     playlistItem::drawItem(painter, -1, zoomFactor, drawRawData);
@@ -462,31 +494,146 @@ void playlistItemCompressedVideo::drawItem(QPainter *painter, int frameIdx, doub
 
 void playlistItemCompressedVideo::loadRawData(int frameIdxInternal, bool caching)
 {
-  if (caching && !cachingEnabled)
+  if (caching)
+    // The caching threads request the raw data using loadRawDataConcurrent (with their own decoders)
     return;
-  if (!caching && loadingDecoder->errorInDecoder())
+  if (loadingContext.decoder->errorInDecoder())
   {
-    if (frameIdxInternal < currentFrameIdx[0])
+    if (frameIdxInternal < loadingContext.currentFrameIdx)
     {
       // There was an error in the loading decoder but we will seek backwards so maybe this will work again
     }
     else
       return;
   }
-  if (caching && cachingDecoder->errorInDecoder())
-    return;
   
-  DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData %d %s", frameIdxInternal, caching ? "caching" : "");
+  DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData %d", frameIdxInternal);
 
-  if (frameIdxInternal > startEndFrame.second || frameIdxInternal < 0)
+  if (decodeFrame(loadingContext, frameIdxInternal, false))
+  {
+    video->rawData = loadingContext.decoder->getRawFrameData();
+    video->rawData_frameIdx = frameIdxInternal;
+  }
+
+  const int decodingNotPossibleAfter = loadingContext.decodingNotPossibleAfter;
+  if (decodingNotPossibleAfter >= 0 && frameIdxInternal >= decodingNotPossibleAfter)
   {
-    DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData Invalid frame index");
+    // Just set the frame number of the buffer to the current frame so that it will trigger a
+    // reload when the frame number changes.
+    video->rawData_frameIdx = frameIdxInternal;
+  }
+  else if (loadingContext.decoder->errorInDecoder())
+  {
+    // There was an error in the deocder. 
+    infoText = "There was an error in the decoder: \n";
+    infoText += loadingContext.decoder->decoderErrorString();
+    infoText += "\n";
+    
+    decodingEnabled = false;
+  }
+}
+
+void playlistItemCompressedVideo::loadRawDataConcurrent(int frameIdxInternal, QByteArray &targetBuffer)
+{
+  if (!cachingEnabled || cachingContexts.isEmpty())
     return;
+
+  DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawDataConcurrent %d", frameIdxInternal);
+
+  decoderContext *context = lockCachingContext(frameIdxInternal);
+  if (!context->decoder->errorInDecoder() && decodeFrame(*context, frameIdxInternal, true))
+    targetBuffer = context->decoder->getRawFrameData();
+  context->mutex.unlock();
+}
+
+playlistItemCompressedVideo::decoderContext *playlistItemCompressedVideo::lockCachingContext(int frameIdxInternal)
+{
+  // Use an idle decoder. Prefer one that is already positioned in the segment of the frame (before the frame) so that
+  // it can continue decoding without a seek. Otherwise, prefer a decoder that is not in the middle of another segment.
+  // Its caching thread is probably just between two frames and would have to seek again.
+  auto nextSegment = std::upper_bound(cachingSegmentStarts.begin(), cachingSegmentStarts.end(), frameIdxInternal);
+  const int segmentStart = (nextSegment == cachingSegmentStarts.begin()) ? 0 : *(nextSegment - 1);
+  const int segmentEnd = (nextSegment == cachingSegmentStarts.end()) ? startEndFrame.second : *nextSegment - 1;
+
+  auto isInOtherSegment = [](decoderContext *context) { return context->currentFrameIdx >= 0 && context->currentFrameIdx < context->segmentEnd; };
+  auto lockIdleContext = [this, segmentEnd](const std::function<bool(decoderContext*)> &accept) -> decoderContext*
+  {
+    for (auto &c : cachingContexts)
+    {
+      decoderContext *context = c.data();
+      if (!context->mutex.tryLock())
+        continue;
+      if (accept(context))
+      {
+        context->segmentEnd = segmentEnd;
+        return context;
+      }
+      context->mutex.unlock();
+    }
+    return nullptr;
+  };
+
+  if (auto context = lockIdleContext([&](decoderContext *c) { return c->currentFrameIdx >= segmentStart && c->currentFrameIdx <= frameIdxInternal; }))
+    return context;
+  if (auto context = lockIdleContext([&](decoderContext *c) { return !isInOtherSegment(c); }))
+    return context;
+  if (auto context = lockIdleContext([](decoderContext *) { return true; }))
+    return context;
+
+  // All decoders are busy. Wait for one of them. The caching threads are limited to the number of decoders (see
+  // cachingThreadLimit), so this only happens while the decoders are locked for an update (e.g. a new decoder).
+  const int segmentIdx = int(nextSegment - cachingSegmentStarts.begin());
+  decoderContext *context = cachingContexts[segmentIdx % cachingContexts.count()].data();
+  context->mutex.lock();
+  context->segmentEnd = segmentEnd;
+  return context;
+}
+
+int playlistItemCompressedVideo::getDecodingNotPossibleAfter() const
+{
+  int limit = loadingContext.decodingNotPossibleAfter;
+  for (auto &context : cachingContexts)
+  {
+    const int contextLimit = context->decodingNotPossibleAfter;
+    if (contextLimit >= 0 && (limit < 0 || contextLimit < limit))
+      limit = contextLimit;
   }
+  return limit;
+}
 
-  // Get the right decoder
-  decoderBase *dec = caching ? cachingDecoder.data() : loadingDecoder.data();
-  int curFrameIdx = caching ? currentFrameIdx[1] : currentFrameIdx[0];
+QList<indexRange> playlistItemCompressedVideo::getCachingSegments(indexRange range)
+{
+  if (cachingContexts.count() <= 1 || cachingSegmentStarts.count() <= 1)
+    // Cache everything in order with the one caching decoder
+    return QList<indexRange>();
+
+  // The range is given in external frame indices
+  QList<indexRange> segments;
+  int segmentStart = range.first;
+  for (int frameIdxInternal : cachingSegmentStarts)
+  {
+    const int frameIdx = getFrameIdxExternal(frameIdxInternal);
+    if (frameIdx <= segmentStart)
+      continue;
+    if (frameIdx > range.second)
+      break;
+    segments.append(indexRange(segmentStart, frameIdx - 1));
+    segmentStart = frameIdx;
+  }
+  segments.append(indexRange(segmentStart, range.second));
+  return segments;
+}
+
+bool playlistItemCompressedVideo::decodeFrame(decoderContext &context, int frameIdxInternal, bool caching)
+{
+  if (frameIdxInternal > startEndFrame.second || frameIdxInternal < 0)
+  {
+    DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame Invalid frame index");
+    return false;
+  }
+
+  decoderBase *dec = context.decoder.data();
+  int curFrameIdx = context.currentFrameIdx;
 
   // Should we seek?
   if (curFrameIdx == -1 || frameIdxInternal < curFrameIdx || frameIdxInternal > curFrameIdx + FORWARD_SEEK_THRESHOLD)
@@ -501,12 +648,7 @@ void playlistItemCompressedVideo::loadRawData(int frameIdxInternal, bool caching
     if (isInputFormatTypeAnnexB(inputFormatType))
       seekToFrame = inputFileAnnexBParser->getClosestSeekableFrameNumberBefore(frameIdxInternal, seekToAnnexBFrameCount);
     else
-    {
-      if (caching)
-        seekToDTS = inputFileFFmpegCaching->getClosestSeekableDTSBefore(frameIdxInternal, seekToFrame);
-      else
-        seekToDTS = inputFileFFmpegLoading->getClosestSeekableDTSBefore(frameIdxInternal, seekToFrame);
-    }
+      seekToDTS = context.inputFileFFmpeg->getClosestSeekableDTSBefore(frameIdxInternal, seekToFrame);
 
     if (curFrameIdx == -1 || seekToFrame > curFrameIdx + FORWARD_SEEK_THRESHOLD)
     {
@@ -516,83 +658,96 @@ void playlistItemCompressedVideo::loadRawData(int frameIdxInternal, bool caching
 
     if (seek)
     {
-      // Seek and update the frame counters. The seekToPosition function will update the currentFrameIdx[] indices
-      readAnnexBFrameCounterCodingOrder = seekToAnnexBFrameCount;
-      DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData seeking to frame %d PTS %d AnnexBCnt %d", seekToFrame, seekToDTS, readAnnexBFrameCounterCodingOrder);
-      seekToPosition(seekToFrame, seekToDTS, caching);
+      // Seek and update the frame counters. The seekToPosition function will update the currentFrameIdx of the context.
+      context.readAnnexBFrameCounterCodingOrder = seekToAnnexBFrameCount;
+      DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame seeking to frame %d PTS %d AnnexBCnt %d", seekToFrame, seekToDTS, context.readAnnexBFrameCounterCodingOrder);
+      seekToPosition(context, seekToFrame, seekToDTS);
     }
   }
   
+  // Should frames that are decoded on the way to the requested frame be put into the cache? This is only done for
+  // interactive loading (the caching decoders are requested to decode all frames in order anyways). We only retain the
+  // frames right before the requested frame that fit into the cache. If the cache overflows, the video cache will
+  // remove frames when it updates its caching queue.
+  int retainFramesFrom = -1;
+  if (!caching && retainDecodedFrames && cachingEnabled && retainDecodedFramesMaxBytes > 0)
+  {
+    const int64_t cachingFrameSize = video->getCachingFrameSize();
+    if (cachingFrameSize > 0)
+      retainFramesFrom = frameIdxInternal - int(qMin(retainDecodedFramesMaxBytes / cachingFrameSize, int64_t(frameIdxInternal)));
+  }
+  int nrFramesRetained = 0;
+
   // Decode until we get the right frame from the deocder
-  bool rightFrame = caching ? currentFrameIdx[1] == frameIdxInternal : currentFrameIdx[0] == frameIdxInternal;
+  bool rightFrame = context.currentFrameIdx == frameIdxInternal;
   while (!rightFrame)
   {
     while (dec->needsMoreData())
     {
-      DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData decoder needs more data");
+      DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame decoder needs more data");
       if (isInputFormatTypeFFmpeg(inputFormatType) && decoderEngineType == decoderEngineFFMpeg)
       {
         // In this scenario, we can read and push AVPackets
         // from the FFmpeg file and pass them to the FFmpeg decoder directly.
-        AVPacketWrapper pkt = caching ? inputFileFFmpegCaching->getNextPacket(repushData) : inputFileFFmpegLoading->getNextPacket(repushData);
-        repushData = false;
+        AVPacketWrapper pkt = context.inputFileFFmpeg->getNextPacket(context.repushData);
+        context.repushData = false;
         if (pkt)
-          DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData retrived packet PTS %" PRId64 "", pkt.get_pts());
+          DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame retrived packet PTS %" PRId64 "", pkt.get_pts());
         else
-          DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData retrived empty packet");
-        decoderFFmpeg *ffmpegDec = (caching ? dynamic_cast<decoderFFmpeg*>(cachingDecoder.data()) : dynamic_cast<decoderFFmpeg*>(loadingDecoder.data()));
+          DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame retrived empty packet");
+        decoderFFmpeg *ffmpegDec = dynamic_cast<decoderFFmpeg*>(dec);
         if (!ffmpegDec->pushAVPacket(pkt))
         {
           if (!ffmpegDec->decodeFrames())
             // The decoder did not switch to decoding frame mode. Error.
-            return;
-          repushData = true;
+            return false;
+          context.repushData = true;
         }
       }
       else if (isInputFormatTypeAnnexB(inputFormatType) && decoderEngineType == decoderEngineFFMpeg)
       {
         // We are reading from a raw annexB file and use ffmpeg for decoding
         QByteArray data;
-        if (readAnnexBFrameCounterCodingOrder >= inputFileAnnexBParser->getNumberPOCs())
+        if (context.readAnnexBFrameCounterCodingOrder >= inputFileAnnexBParser->getNumberPOCs())
         {
-          DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData EOF");
+          DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame EOF");
         }
         else
         {
           // Get the data of the next frame (which might be multiple NAL units)
-          auto frameStartEndFilePos = inputFileAnnexBParser->getFrameStartEndPos(readAnnexBFrameCounterCodingOrder);
-          Q_ASSERT_X(frameStartEndFilePos, "playlistItemCompressedVideo::loadRawData", "frameStartEndFilePos could not be retrieved. This should always work for a raw AnnexB file.");
+          auto frameStartEndFilePos = inputFileAnnexBParser->getFrameStartEndPos(context.readAnnexBFrameCounterCodingOrder);
+          Q_ASSERT_X(frameStartEndFilePos, "playlistItemCompressedVideo::decodeFrame", "frameStartEndFilePos could not be retrieved. This should always work for a raw AnnexB file.");
 
-          data = caching ? inputFileAnnexBCaching->getFrameData(*frameStartEndFilePos) : inputFileAnnexBLoading->getFrameData(*frameStartEndFilePos);
-          DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData retrived frame data from file - AnnexBCnt %d startEnd %lu-%lu - size %d", readAnnexBFrameCounterCodingOrder, frameStartEndFilePos.first, frameStartEndFilePos.second, data.size());
+          data = context.inputFileAnnexB->getFrameData(*frameStartEndFilePos);
+          DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame retrived frame data from file - AnnexBCnt %d startEnd %lu-%lu - size %d", context.readAnnexBFrameCounterCodingOrder, frameStartEndFilePos.first, frameStartEndFilePos.second, data.size());
         }
 
         if (!dec->pushData(data))
         {
           if (!dec->decodeFrames())
           {
-            DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData The decoder did not switch to decoding frame mode. Error.");
-            decodingNotPossibleAfter = frameIdxInternal;
+            DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame The decoder did not switch to decoding frame mode. Error.");
+            context.decodingNotPossibleAfter = frameIdxInternal;
             break;
           }
           // Pushing the data failed because the ffmpeg decoder wants us to read frames first.
           // Don't increase readAnnexBFrameCounterCodingOrder so that we will push the same data again.
         }
         else
-          readAnnexBFrameCounterCodingOrder++;
+          context.readAnnexBFrameCounterCodingOrder++;
       }
       else if (isInputFormatTypeAnnexB(inputFormatType) && decoderEngineType != decoderEngineFFMpeg)
       {
-        QByteArray data = caching ? inputFileAnnexBCaching->getNextNALUnit(repushData) : inputFileAnnexBLoading->getNextNALUnit(repushData);
-        DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData retrived nal unit from file - size %d", data.size());
-        repushData = !dec->pushData(data);
+        QByteArray data = context.inputFileAnnexB->getNextNALUnit(context.repushData);
+        DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame retrived nal unit from file - size %d", data.size());
+        context.repushData = !dec->pushData(data);
       }
       else if (isInputFormatTypeFFmpeg(inputFormatType) && decoderEngineType != decoderEngineFFMpeg)
       {
         // Get the next unit (NAL or OBU) form ffmepg and push it to the decoder
-        QByteArray data = caching ? inputFileFFmpegCaching->getNextUnit(repushData) : inputFileFFmpegLoading->getNextUnit(repushData);
-        DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData retrived nal unit from file - size %d", data.size());
-        repushData = !dec->pushData(data);
+        QByteArray data = context.inputFileFFmpeg->getNextUnit(context.repushData);
+        DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame retrived nal unit from file - size %d", data.size());
+        context.repushData = !dec->pushData(data);
       }
       else
         assert(false);
@@ -602,59 +757,48 @@ void playlistItemCompressedVideo::loadRawData(int frameIdxInternal, bool caching
     {
       if (dec->decodeNextFrame())
       {
-        if (caching)
-          currentFrameIdx[1]++;
-        else
-          currentFrameIdx[0]++;
-
-        DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData decoded frame %d", caching ? currentFrameIdx[1] : currentFrameIdx[0]);
-        rightFrame = caching ? currentFrameIdx[1] == frameIdxInternal : currentFrameIdx[0] == frameIdxInternal;
-        if (rightFrame)
+        context.currentFrameIdx++;
+        DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame decoded frame %d", context.currentFrameIdx);
+        rightFrame = context.currentFrameIdx == frameIdxInternal;
+        if (!rightFrame && retainFramesFrom >= 0 && context.currentFrameIdx >= retainFramesFrom && context.currentFrameIdx < frameIdxInternal)
         {
-          video->rawData = dec->getRawFrameData();
-          video->rawData_frameIdx = frameIdxInternal;
+          DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame retaining intermediate frame %d in the cache", context.currentFrameIdx);
+          if (video->cacheRawFrame(context.currentFrameIdx, dec->getRawFrameData()))
+            nrFramesRetained++;
         }
       }
     }
 
     if (!dec->needsMoreData() && !dec->decodeFrames())
     {
-      DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData decoder neither needs more data nor can decode frames");
-      decodingNotPossibleAfter = frameIdxInternal;
+      DEBUG_COMPRESSED("playlistItemCompressedVideo::decodeFrame decoder neither needs more data nor can decode frames");
+      context.decodingNotPossibleAfter = frameIdxInternal;
       break;
     }
   }
 
+  if (nrFramesRetained > 0)
+    // Frames were added to the cache. Let the video cache update its caching queue (and enforce the cache size).
+    emit signalItemChanged(false, RECACHE_UPDATE);
+
+  const int decodingNotPossibleAfter = context.decodingNotPossibleAfter;
   if (decodingNotPossibleAfter >= 0 && frameIdxInternal >= decodingNotPossibleAfter)
   {
     // The specified frame (which is thoretically in the bitstream) can not be decoded.
     // Maybe the bitstream was cut at a position that it was not supposed to be cut at.
-    if (caching)
-      currentFrameIdx[1] = frameIdxInternal;
-    else
-      currentFrameIdx[0] = frameIdxInternal;
-    // Just set the frame number of the buffer to the current frame so that it will trigger a
-    // reload when the frame number changes.
-    video->rawData_frameIdx = frameIdxInternal;
-  }
-  else if (loadingDecoder->errorInDecoder())
-  {
-    // There was an error in the deocder. 
-    infoText = "There was an error in the decoder: \n";
-    infoText += loadingDecoder->decoderErrorString();
-    infoText += "\n";
-    
-    decodingEnabled = false;
+    context.currentFrameIdx = frameIdxInternal;
   }
+
+  return rightFrame;
 }
 
-void playlistItemCompressedVideo::seekToPosition(int seekToFrame, int seekToDTS, bool caching)
+void playlistItemCompressedVideo::seekToPosition(decoderContext &context, int seekToFrame, int seekToDTS)
 {
   // Do the seek
-  decoderBase *dec = caching ? cachingDecoder.data() : loadingDecoder.data();
+  decoderBase *dec = context.decoder.data();
   dec->resetDecoder();
-  repushData = false;
-  decodingNotPossibleAfter = -1;
+  context.repushData = false;
+  context.decodingNotPossibleAfter = -1;
 
   // Retrieval of the raw metadata is only required if the the reader or the decoder is not ffmpeg
   const bool bothFFmpeg = (!isInputFormatTypeAnnexB(inputFormatType) && decoderEngineType == decoderEngineFFMpeg);
@@ -665,22 +809,16 @@ void playlistItemCompressedVideo::seekToPosition(int seekToFrame, int seekToDTS,
   {
     uint64_t filePos = 0;
     if (!bothFFmpeg)
-      parametersets = inputFileAnnexBParser->getSeekFrameParamerSets(seekToFrame, filePos);
+      parametersets = inputFileAnnexBParser->getSeekFrameParamerSetsOrIndex(seekToFrame, filePos);
     DEBUG_COMPRESSED("playlistItemCompressedVideo::seekToPosition seeking annexB file to filePos %" PRIu64 "", filePos);
-    if (caching)
-      inputFileAnnexBCaching->seek(filePos);
-    else
-      inputFileAnnexBLoading->seek(filePos);
+    context.inputFileAnnexB->seek(filePos);
   }
   else
   {
     if (!bothFFmpeg)
-      parametersets = caching ? inputFileFFmpegCaching->getParameterSets() : inputFileFFmpegLoading->getParameterSets();
+      parametersets = context.inputFileFFmpeg->getParameterSets();
     DEBUG_COMPRESSED("playlistItemCompressedVideo::seekToPosition seeking ffmpeg file to pts %d", seekToDTS);
-    if (caching)
-      inputFileFFmpegCaching->seekToDTS(seekToDTS);
-    else
-      inputFileFFmpegLoading->seekToDTS(seekToDTS);
+    context.inputFileFFmpeg->seekToDTS(seekToDTS);
   }
 
   // In case of using ffmpeg for decoding, we don't need to push the parameter sets (the
@@ -696,10 +834,7 @@ void playlistItemCompressedVideo::seekToPosition(int seekToFrame, int seekToDTS,
         return;
       }
   }
-  if (caching)
-    currentFrameIdx[1] = seekToFrame - 1;
-  else
-    currentFrameIdx[0] = seekToFrame - 1;
+  context.currentFrameIdx = seekToFrame - 1;
 }
 
 void playlistItemCompressedVideo::createPropertiesWidget()
@@ -735,10 +870,10 @@ void playlistItemCompressedVideo::createPropertiesWidget()
   ui.verticalLayout->insertLayout(6, statSource.createStatisticsHandlerControls(), 1);
 
   // Set the components that we can display
-  if (loadingDecoder)
+  if (loadingContext.decoder)
   {
-    ui.comboBoxDisplaySignal->addItems(loadingDecoder->getSignalNames());
-    ui.comboBoxDisplaySignal->setCurrentIndex(loadingDecoder->getDecodeSignal());
+    ui.comboBoxDisplaySignal->addItems(loadingContext.decoder->getSignalNames());
+    ui.comboBoxDisplaySignal->setCurrentIndex(loadingContext.decoder->getDecodeSignal());
   }
   // Add decoders we can use
   for (decoderEngine e : possibleDecoders)
@@ -748,55 +883,87 @@ void playlistItemCompressedVideo::createPropertiesWidget()
   }
   ui.comboBoxDecoder->setCurrentIndex(possibleDecoders.indexOf(decoderEngineType));
 
+  ui.checkBoxRetainDecodedFrames->setChecked(retainDecodedFrames);
+
   // Connect signals/slots
   connect(ui.comboBoxDisplaySignal, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &playlistItemCompressedVideo::displaySignalComboBoxChanged);
   connect(ui.comboBoxDecoder, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &playlistItemCompressedVideo::decoderComboxBoxChanged);
+  connect(ui.checkBoxRetainDecodedFrames, &QCheckBox::toggled, this, &playlistItemCompressedVideo::retainDecodedFramesCheckBoxToggled);
+}
+
+void playlistItemCompressedVideo::updateSettings()
+{
+  // TODO loadingContext.decoder->updateFileWatchSetting(); statSource.updateSettings();
+  playlistItemWithVideo::updateSettings();
+
+  QSettings settings;
+  settings.beginGroup("VideoCache");
+  if (settings.value("Enabled", true).toBool())
+    retainDecodedFramesMaxBytes = (int64_t)settings.value("ThresholdValueMB", 49).toUInt() * 1000 * 1000;
+  else
+    retainDecodedFramesMaxBytes = 0;
+  settings.endGroup();
 }
 
 bool playlistItemCompressedVideo::allocateDecoder(int displayComponent)
 {
+  // The caching threads may be decoding with the existing decoders. Wait for them and keep them out until the new
+  // decoders are allocated.
+  std::vector<std::unique_ptr<QMutexLocker>> cachingContextLocks;
+  for (auto &context : cachingContexts)
+    cachingContextLocks.emplace_back(new QMutexLocker(&context->mutex));
+
   // Reset (existing) decoders
-  loadingDecoder.reset();
-  cachingDecoder.reset();
+  loadingContext.decoder.reset();
+  for (auto &context : cachingContexts)
+  {
+    context->decoder.reset();
+    context->currentFrameIdx = -1;
+    context->decodingNotPossibleAfter = -1;
+  }
 
   if (decoderEngineType == decoderEngineLibde265)
   {
     DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive libde265 decoder");
-    loadingDecoder.reset(new decoderLibde265(displayComponent));
+    loadingContext.decoder.reset(new decoderLibde265(displayComponent));
     if (cachingEnabled)
     {
       DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing caching libde265 decoder");
-      cachingDecoder.reset(new decoderLibde265(displayComponent, true));
+      for (auto &context : cachingContexts)
+        context->decoder.reset(new decoderLibde265(displayComponent, true));
     }
   }
   else if (decoderEngineType == decoderEngineHM)
   {
     DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive HM decoder");
-    loadingDecoder.reset(new decoderHM(displayComponent));
+    loadingContext.decoder.reset(new decoderHM(displayComponent));
     if (cachingEnabled)
     {
       DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder caching interactive HM decoder");
-      cachingDecoder.reset(new decoderHM(displayComponent, true));
+      for (auto &context : cachingContexts)
+        context->decoder.reset(new decoderHM(displayComponent, true));
     }
   }
   else if (decoderEngineType == decoderEngineVTM)
   {
     DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive VTM decoder");
-    loadingDecoder.reset(new decoderVTM(displayComponent));
+    loadingContext.decoder.reset(new decoderVTM(displayComponent));
     if (cachingEnabled)
     {
       DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder caching interactive VTM decoder");
-      cachingDecoder.reset(new decoderVTM(displayComponent, true));
+      for (auto &context : cachingContexts)
+        context->decoder.reset(new decoderVTM(displayComponent, true));
     }
   }
   else if (decoderEngineType == decoderEngineDav1d)
   {
     DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive dav1d decoder");
-    loadingDecoder.reset(new decoderDav1d(displayComponent));
+    loadingContext.decoder.reset(new decoderDav1d(displayComponent));
     if (cachingEnabled)
     {
       DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder caching interactive dav1d decoder");
-      cachingDecoder.reset(new decoderDav1d(displayComponent, true));
+      for (auto &context : cachingContexts)
+        context->decoder.reset(new decoderDav1d(displayComponent, true));
     }
   }
   else if (decoderEngineType == decoderEngineFFMpeg)
@@ -810,21 +977,23 @@ bool playlistItemCompressedVideo::allocateDecoder(int displayComponent)
       auto ratio = inputFileAnnexBParser->getSampleAspectRatio();
 
       DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive ffmpeg decoder from raw anexB stream. frameSize %dx%d extradata length %d yuvPixelFormat %s profile/level %d/%d, aspect raio %d/%d", frameSize.width(), frameSize.height(), extradata.length(), fmt.getName().toStdString().c_str(), profileLevel.first, profileLevel.second, ratio.first, ratio.second);
-      loadingDecoder.reset(new decoderFFmpeg(ffmpegCodec, frameSize, extradata, fmt, profileLevel, ratio));
+      loadingContext.decoder.reset(new decoderFFmpeg(ffmpegCodec, frameSize, extradata, fmt, profileLevel, ratio));
       if (cachingEnabled)
       {
         DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing caching ffmpeg decoder from raw anexB stream. Same settings.");
-        cachingDecoder.reset(new decoderFFmpeg(ffmpegCodec, frameSize, extradata, fmt, profileLevel, ratio, true));
+        for (auto &context : cachingContexts)
+          context->decoder.reset(new decoderFFmpeg(ffmpegCodec, frameSize, extradata, fmt, profileLevel, ratio, true));
       }
     }
     else
     {
       DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive ffmpeg decoder using ffmpeg as parser");
-      loadingDecoder.reset(new decoderFFmpeg(inputFileFFmpegLoading->getVideoCodecPar()));
+      loadingContext.decoder.reset(new decoderFFmpeg(loadingContext.inputFileFFmpeg->getVideoCodecPar()));
       if (cachingEnabled)
       {
         DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing caching ffmpeg decoder using ffmpeg as parser");
-        cachingDecoder.reset(new decoderFFmpeg(inputFileFFmpegCaching->getVideoCodecPar()));
+        for (auto &context : cachingContexts)
+          context->decoder.reset(new decoderFFmpeg(context->inputFileFFmpeg->getVideoCodecPar(), true));
       }
     }
   }
@@ -835,11 +1004,11 @@ bool playlistItemCompressedVideo::allocateDecoder(int displayComponent)
     return false;
   }
 
-  decodingEnabled = !loadingDecoder->errorInDecoder();
+  decodingEnabled = !loadingContext.decoder->errorInDecoder();
   if (!decodingEnabled)
   {
     infoText = "There was an error allocating the new decoder: \n";
-    infoText += loadingDecoder->decoderErrorString();
+    infoText += loadingContext.decoder->decoderErrorString();
     infoText += "\n";
     return false;
   }
@@ -849,39 +1018,39 @@ bool playlistItemCompressedVideo::allocateDecoder(int displayComponent)
 
 void playlistItemCompressedVideo::fillStatisticList()
 {
-  if (!loadingDecoder || !loadingDecoder->statisticsSupported())
+  if (!loadingContext.decoder || !loadingContext.decoder->statisticsSupported())
     return;
 
-  loadingDecoder->fillStatisticList(statSource);
+  loadingContext.decoder->fillStatisticList(statSource);
 }
 
-void playlistItemCompressedVideo::loadStatisticToCache(int frameIdx, int typeIdx)
+void playlistItemCompressedVideo::loadStatisticToCache(int frameIdx, int typeIdx, QHash<int, statisticsData> &cache)
 {
   DEBUG_COMPRESSED("playlistItemCompressedVideo::loadStatisticToCache Request statistics type %d for frame %d", typeIdx, frameIdx);
   const int frameIdxInternal = getFrameIdxInternal(frameIdx);
 
-  if (!loadingDecoder->statisticsSupported())
+  if (!loadingContext.decoder->statisticsSupported())
     return;
-  if (!loadingDecoder->statisticsEnabled())
+  if (!loadingContext.decoder->statisticsEnabled())
   {
     // We have to enable collecting of statistics in the decoder. By default (for speed reasons) this is off.
     // Enabeling works like this: Enable collection, reset the decoder and decode the current frame again.
     // Statisitcs are always retrieved for the loading decoder.
-    loadingDecoder->enableStatisticsRetrieval();
+    loadingContext.decoder->enableStatisticsRetrieval();
 
     // Reload the current frame (force a seek and decode operation)
-    int frameToLoad = currentFrameIdx[0];
-    currentFrameIdx[0] = INT_MAX;
+    int frameToLoad = loadingContext.currentFrameIdx;
+    loadingContext.currentFrameIdx = INT_MAX;
     loadRawData(frameToLoad, false);
 
     // The statistics should now be loaded
   }
-  else if (frameIdxInternal != currentFrameIdx[0])
+  else if (frameIdxInternal != loadingContext.currentFrameIdx)
     // If the requested frame is not currently decoded, decode it.
     // This can happen if the picture was gotten from the cache.
     loadRawData(frameIdxInternal, false);
 
-  statSource.statsCache[typeIdx] = loadingDecoder->getStatisticsData(typeIdx);
+  cache[typeIdx] = loadingContext.decoder->getStatisticsData(typeIdx);
 }
 
 indexRange playlistItemCompressedVideo::getStartEndFrameLimits() const
@@ -893,7 +1062,7 @@ indexRange playlistItemCompressedVideo::getStartEndFrameLimits() const
     if (isInputFormatTypeAnnexB(inputFormatType))
       return indexRange(0, inputFileAnnexBParser->getNumberPOCs() - 1);
     else
-      return inputFileFFmpegLoading->getDecodableFrameLimits();
+      return loadingContext.inputFileFFmpeg->getDecodableFrameLimits();
   }  
 }
 
@@ -903,7 +1072,7 @@ ValuePairListSets playlistItemCompressedVideo::getPixelValues(const QPoint &pixe
   const int frameIdxInternal = getFrameIdxInternal(frameIdx);
 
   newSet.append("YUV", video->getPixelValues(pixelPos, frameIdxInternal));
-  if (loadingDecoder->statisticsSupported() && loadingDecoder->statisticsEnabled())
+  if (loadingContext.decoder->statisticsSupported() && loadingContext.decoder->statisticsEnabled())
     newSet.append("Stats", statSource.getValuesAt(pixelPos));
 
   return newSet;
@@ -931,7 +1100,7 @@ void playlistItemCompressedVideo::reloadItemSource()
   // TODO: The caching decoder must also be reloaded
   //       All items in the cache are also now invalid
 
-  //loadingDecoder->reloadItemSource();
+  //loadingContext.decoder->reloadItemSource();
   // Reset the decoder somehow
 
   // Set the frame number limits
@@ -950,10 +1119,9 @@ void playlistItemCompressedVideo::cacheFrame(int frameIdx, bool testMode)
   if (!cachingEnabled)
     return;
 
-  // Cache a certain frame. This is always called in a separate thread.
-  cachingMutex.lock();
+  // Cache a certain frame. This is always called in a separate thread. The video handler will request the data
+  // using loadRawDataConcurrent which locks one of the caching decoders.
   video->cacheFrame(getFrameIdxInternal(frameIdx), testMode);
-  cachingMutex.unlock();
 }
 
 void playlistItemCompressedVideo::loadFrame(int frameIdx, bool playing, bool loadRawdata, bool emitSignals)
@@ -1003,25 +1171,32 @@ void playlistItemCompressedVideo::loadFrame(int frameIdx, bool playing, bool loa
 
 void playlistItemCompressedVideo::displaySignalComboBoxChanged(int idx)
 {
-  if (loadingDecoder && idx != loadingDecoder->getDecodeSignal())
+  if (loadingContext.decoder && idx != loadingContext.decoder->getDecodeSignal())
   {
     bool resetDecoder = false;
-    loadingDecoder->setDecodeSignal(idx, resetDecoder);
-    cachingDecoder->setDecodeSignal(idx, resetDecoder);
+    loadingContext.decoder->setDecodeSignal(idx, resetDecoder);
+    for (auto &context : cachingContexts)
+    {
+      QMutexLocker lock(&context->mutex);
+      context->decoder->setDecodeSignal(idx, resetDecoder);
+    }
 
     if (resetDecoder)
     {
-      loadingDecoder->resetDecoder();
-      cachingDecoder->resetDecoder();
-
+      loadingContext.decoder->resetDecoder();
       // Reset the decoded frame indices so that decoding of the current frame is triggered
-      currentFrameIdx[0] = -1;
-      currentFrameIdx[1] = -1;
+      loadingContext.currentFrameIdx = -1;
+      for (auto &context : cachingContexts)
+      {
+        QMutexLocker lock(&context->mutex);
+        context->decoder->resetDecoder();
+        context->currentFrameIdx = -1;
+      }
     }
 
     // A different display signal was chosen. Invalidate the cache and signal that we will need a redraw.
     videoHandlerYUV *yuvVideo = dynamic_cast<videoHandlerYUV*>(video.data());
-    yuvVideo->showPixelValuesAsDiff = loadingDecoder->isSignalDifference(idx);
+    yuvVideo->showPixelValuesAsDiff = loadingContext.decoder->isSignalDifference(idx);
     yuvVideo->invalidateAllBuffers();
 
     emit signalItemChanged(true, RECACHE_CLEAR);
@@ -1039,21 +1214,20 @@ void playlistItemCompressedVideo::decoderComboxBoxChanged(int idx)
 
     // A different display signal was chosen. Invalidate the cache and signal that we will need a redraw.
     videoHandlerYUV *yuvVideo = dynamic_cast<videoHandlerYUV*>(video.data());
-    if (loadingDecoder)
-      yuvVideo->showPixelValuesAsDiff = loadingDecoder->isSignalDifference(idx);
+    if (loadingContext.decoder)
+      yuvVideo->showPixelValuesAsDiff = loadingContext.decoder->isSignalDifference(idx);
     yuvVideo->invalidateAllBuffers();
 
     // Reset the decoded frame indices so that decoding of the current frame is triggered
-    currentFrameIdx[0] = -1;
-    currentFrameIdx[1] = -1;
+    loadingContext.currentFrameIdx = -1;
 
     // Update the list of display signals
-    if (loadingDecoder)
+    if (loadingContext.decoder)
     {
       QSignalBlocker block(ui.comboBoxDisplaySignal);
       ui.comboBoxDisplaySignal->clear();
-      ui.comboBoxDisplaySignal->addItems(loadingDecoder->getSignalNames());
-      ui.comboBoxDisplaySignal->setCurrentIndex(loadingDecoder->getDecodeSignal());
+      ui.comboBoxDisplaySignal->addItems(loadingContext.decoder->getSignalNames());
+      ui.comboBoxDisplaySignal->setCurrentIndex(loadingContext.decoder->getDecodeSignal());
     }
 
     // Update the statistics list with what the new decoder can provide
@@ -1064,3 +1238,9 @@ void playlistItemCompressedVideo::decoderComboxBoxChanged(int idx)
     emit signalItemChanged(true, RECACHE_CLEAR);
   }
 }
+
+void playlistItemCompressedVideo::retainDecodedFramesCheckBoxToggled(bool checked)
+{
+  // This only changes what is put into the cache in the future. Frames that are already cached stay valid.
+  retainDecodedFrames = checked;
+}
@@ -32,6 +32,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <QMutex>
+#include <QSharedPointer>
+
 #include "decoder/decoderBase.h"
 #include "filesource/FileSourceFFmpegFile.h"
 #include "parser/parserAnnexB.h"
@@ -87,7 +91,7 @@ public:
   // ----- Detection of source/file change events -----
   virtual bool isSourceChanged()        Q_DECL_OVERRIDE { /* TODO */ return false; }
   virtual void reloadItemSource()       Q_DECL_OVERRIDE;
-  virtual void updateSettings()         Q_DECL_OVERRIDE { /* TODO loadingDecoder->updateFileWatchSetting(); statSource.updateSettings(); */ }
+  virtual void updateSettings()         Q_DECL_OVERRIDE;
 
   // Do we need to load the given frame first?
   virtual itemLoadingState needsLoading(int frameIdx, bool loadRawData) Q_DECL_OVERRIDE;
@@ -98,12 +102,14 @@ public:
   virtual bool isLoadingDoubleBuffer() const Q_DECL_OVERRIDE { return isFrameLoadingDoubleBuffer; }
 
   // Cache the frame with the given index.
-  // For all compressed items, a mutex must be locked when caching a frame (only one frame can be cached at a time because we only have one decoder).
   void cacheFrame(int idx, bool testMode) Q_DECL_OVERRIDE;
 
-  // We only have one caching decoder so it is better if only one thread caches frames from this item.
-  // This way, the frames will always be cached in the right order and no unnecessary decoding is performed.
-  virtual int cachingThreadLimit() Q_DECL_OVERRIDE { return 1; }
+  // Each caching decoder can only decode one frame at a time. So it is better if there are not more threads caching frames
+  // from this item than there are caching decoders. This way, no unnecessary decoding is performed.
+  virtual int cachingThreadLimit() Q_DECL_OVERRIDE { return cachingContexts.isEmpty() ? 1 : cachingContexts.count(); }
+  // If there are multiple caching decoders, split the range at the random access points so that each decoder
+  // can cache a different part of the sequence in order.
+  virtual QList<indexRange> getCachingSegments(indexRange range) Q_DECL_OVERRIDE;
 
   YUView::inputFormat getInputFormat() const { return inputFormatType; }
   
@@ -113,10 +119,36 @@ protected:
 
   virtual void createPropertiesWidget() Q_DECL_OVERRIDE;
 
-  // We allocate two decoder: One for loading images in the foreground and one for caching in the background.
-  // This is better if random access and linear decoding (caching) is performed at the same time.
-  QScopedPointer<decoderBase> loadingDecoder;
-  QScopedPointer<decoderBase> cachingDecoder;
+  // Everything that is needed to decode frames independently from the other decoders: The decoder, an own instance of the
+  // file source (so that the read position is independent) and the current position of the decoder in the sequence.
+  struct decoderContext
+  {
+    QScopedPointer<decoderBase> decoder;
+    QScopedPointer<FileSourceAnnexBFile> inputFileAnnexB;
+    QScopedPointer<FileSourceFFmpegFile> inputFileFFmpeg;
+    // The current frame index of the decoder
+    int currentFrameIdx {-1};
+    // The last frame of the caching segment (see getCachingSegments) that the decoder was last used for
+    int segmentEnd {-1};
+    // When reading annex B data using the FileSourceAnnexBFile::getFrameData function, we need to count how many frames we already read.
+    int readAnnexBFrameCounterCodingOrder {-1};
+    // For certain decoders (FFmpeg or HM), pushing data may fail. The decoder may or may not switch to retrieveing mode.
+    // In this case, we must re-push the packet for which pushing failed.
+    bool repushData {false};
+    // If the bitstream is invalid (for example it was cut at a position that it should not be cut at), the decoder
+    // might be unable to decode the frames from this index on. Reset when the decoder seeks.
+    std::atomic<int> decodingNotPossibleAfter {-1};
+    // Only one frame can be decoded at a time
+    QMutex mutex;
+  };
+
+  // We allocate at least two decoders: One for loading images in the foreground and one (or more) for caching in the background.
+  // This is better if random access and linear decoding (caching) is performed at the same time. If there are multiple caching
+  // decoders, each one caches a different part of the sequence (starting at a random access point).
+  decoderContext loadingContext;
+  QList<QSharedPointer<decoderContext>> cachingContexts;
+  // The frame indices (in display order) where the sequence can be split for the caching decoders (the random access points).
+  QList<int> cachingSegmentStarts;
 
   // When opening the file, we will fill this list with the possible decoders
   QList<YUView::decoderEngine> possibleDecoders;
@@ -126,31 +158,19 @@ protected:
   bool allocateDecoder(int displayComponent = 0);
 
   // In order to parse raw annexB files, we need a file reader (that can read NAL units)
-  // and a parser that can understand what the NAL units mean. We open the file source twice (once for interactive loading,
-  // once for the background caching). The parser is only needed once and can be used for both loading and caching tasks.
-  QScopedPointer<FileSourceAnnexBFile> inputFileAnnexBLoading;
-  QScopedPointer<FileSourceAnnexBFile> inputFileAnnexBCaching;
+  // and a parser that can understand what the NAL units mean. We open the file source once per decoder (see decoderContext).
+  // The parser is only needed once and can be used for both loading and caching tasks. For FFMpeg files we don't need a
+  // parser. But if the container contains a supported format, we can read the NAL units from the FileSourceFFmpegFile.
   QScopedPointer<parserAnnexB> inputFileAnnexBParser;
-  // When reading annex B data using the FileSourceAnnexBFile::getFrameData function, we need to count how many frames we already read.
-  int readAnnexBFrameCounterCodingOrder { -1 };
   
   // Which type is the input?
   YUView::inputFormat inputFormatType;
   AVCodecIDWrapper ffmpegCodec;
 
-  // For FFMpeg files we don't need a reader to parse them. But if the container contains a supported format, we can
-  // read the NAL units from the compressed file.
-  QScopedPointer<FileSourceFFmpegFile> inputFileFFmpegLoading;
-  QScopedPointer<FileSourceFFmpegFile> inputFileFFmpegCaching;
-  
   // Is the loadFrame function currently loading?
   bool isFrameLoading { false };
   bool isFrameLoadingDoubleBuffer { false };
 
-  // Only cache one frame at a time. Caching should also always be done in display order of the frames.
-  // TODO: Could we somehow make shure that caching is always performed in display order?
-  QMutex cachingMutex;
-
   statisticHandler statSource;
 
   // Fill the list of statistic types that we can provide
@@ -158,33 +178,43 @@ protected:
 
   SafeUi<Ui::playlistItemCompressedFile_Widget> ui;
 
-  // The current frame index of the decoders (interactive/caching)
-  int currentFrameIdx[2] {-1, -1};
-
-  // Seek the input file to the given position, reset the decoder and prepare it to start decoding from the given position.
-  void seekToPosition(int seekToFrame, int seekToDTS, bool caching);
-
-  // For certain decoders (FFmpeg or HM), pushing data may fail. The decoder may or may not switch to retrieveing mode.
-  // In this case, we must re-push the packet for which pushing failed.
-  bool repushData {false};
+  // Seek the input file of the given decoder context to the given position, reset the decoder and prepare it to start decoding from the given position.
+  void seekToPosition(decoderContext &context, int seekToFrame, int seekToDTS);
+  // Decode until the decoder of the given context returns the given frame. Seek if necessary. Returns true if the frame was decoded.
+  // When interactively loading (not caching), intermediate frames may be retained in the cache (see retainDecodedFrames).
+  bool decodeFrame(decoderContext &context, int frameIdxInternal, bool caching);
+  // Get an idle caching decoder context for the given frame and lock its mutex. A decoder that is already positioned
+  // in the segment (see getCachingSegments) of the frame is preferred.
+  decoderContext *lockCachingContext(int frameIdxInternal);
 
   // Besides the normal stats (error / no error) this item might be able to parse the file but not to decode it.
   void setDecodingError(QString err) { infoText = err; decodingEnabled = false; }
   bool decodingEnabled {false};
 
   // If the bitstream is invalid (for example it was cut at a position that it should not be cut at), we
-  // might be unable to decode some of the frames at the end of the sequence.
-  int decodingNotPossibleAfter { -1 };
+  // might be unable to decode some of the frames at the end of the sequence. This is the lowest frame index
+  // at which one of the decoders failed (or -1).
+  int getDecodingNotPossibleAfter() const;
+
+  // When seeking, all frames from the random access point up to the requested frame must be decoded. If this is set,
+  // these intermediate frames are put into the cache of the video handler instead of being discarded.
+  bool retainDecodedFrames { false };
+  // The maximum size of the video cache in bytes (from the settings). We never retain more intermediate frames than fit in there.
+  int64_t retainDecodedFramesMaxBytes { 0 };
 
 private slots:
   // Load the raw (YUV or RGN) data for the given frame index from file. This slot is called by the videoHandler if the frame that is
   // requested to be drawn has not been loaded yet.
   virtual void loadRawData(int frameIdxInternal, bool forceDecodingNow);
+  // Decode the given frame with one of the caching decoders. This slot is called by the videoHandler (in a caching thread)
+  // if a frame is cached. Multiple caching threads can call this at the same time.
+  void loadRawDataConcurrent(int frameIdxInternal, QByteArray &targetBuffer);
 
   // The statistic with the given frameIdx/typeIdx could not be found in the cache. Load it.
-  virtual void loadStatisticToCache(int frameIdx, int typeIdx);
+  virtual void loadStatisticToCache(int frameIdx, int typeIdx, QHash<int, statisticsData> &cache);
 
   void updateStatSource(bool bRedraw) { emit signalItemChanged(bRedraw, RECACHE_NONE); }
   void displaySignalComboBoxChanged(int idx);
   void decoderComboxBoxChanged(int idx);
+  void retainDecodedFramesCheckBoxToggled(bool checked);
 };
@@ -46,6 +46,9 @@
 
 #define DIFFERENCE_INFO_TEXT "Please drop two video item's onto this difference item to calculate the difference."
 
+// The SSIM values of the blocks are multiplied by this factor for the statistics
+#define SSIM_STATISTICS_SCALE 1000
+
 playlistItemDifference::playlistItemDifference()
   : playlistItemContainer("Difference Item")
 {
@@ -63,6 +66,13 @@ playlistItemDifference::playlistItemDifference()
   infoText = DIFFERENCE_INFO_TEXT;
 
   connect(&difference, &videoHandlerDifference::signalHandlerChanged, this, &playlistItemDifference::signalItemChanged);
+
+  // If both inputs are YUV, the SSIM of the luma component per block can be shown as statistics
+  StatisticsType ssimType(0, "SSIM Y", 0, QColor(255, 0, 0), SSIM_STATISTICS_SCALE, QColor(0, 255, 0));
+  ssimType.description = QString("The SSIM of the luma component per %1x%1 block multiplied by %2").arg(YUV_Internals::SSIMMap::blockSize).arg(SSIM_STATISTICS_SCALE);
+  statSource.addStatType(ssimType);
+  connect(&statSource, &statisticHandler::updateItem, [this](bool redraw){ emit signalItemChanged(redraw, RECACHE_NONE); });
+  connect(&statSource, &statisticHandler::requestStatisticsLoading, this, &playlistItemDifference::loadStatisticToCache, Qt::DirectConnection);
 }
 
 /* For a difference item, the info list is just a list of the names of the
@@ -108,6 +118,8 @@ void playlistItemDifference::drawItem(QPainter *painter, int frameIdx, double zo
       childVideo1 = getChildPlaylistItem(1)->getFrameHandler();
 
     difference.setInputVideos(childVideo0, childVideo1);
+    statSource.setFrameSize(difference.getFrameSize());
+    statSource.clearStatisticsCache();
 
     // Update the frame range
     startEndFrame = getStartEndFrameLimits();
@@ -127,6 +139,7 @@ void playlistItemDifference::drawItem(QPainter *painter, int frameIdx, double zo
     int idx0 = getChildPlaylistItem(0)->getFrameIdxInternal(frameIdxInternal);
     int idx1 = getChildPlaylistItem(1)->getFrameIdxInternal(frameIdxInternal);
     difference.drawDifferenceFrame(painter, frameIdxInternal, idx0, idx1, zoomFactor, drawRawData);
+    statSource.paintStatistics(painter, frameIdxInternal, zoomFactor);
   }
 }
 
@@ -160,10 +173,11 @@ void playlistItemDifference::createPropertiesWidget()
   vAllLaout->addLayout(difference.createFrameHandlerControls(true));
   vAllLaout->addWidget(line);
   vAllLaout->addLayout(difference.createDifferenceHandlerControls());
+  vAllLaout->addLayout(statSource.createStatisticsHandlerControls());
 
   // Insert a stretch at the bottom of the vertical global layout so that everything
   // gets 'pushed' to the top
-  vAllLaout->insertStretch(3, 1);
+  vAllLaout->insertStretch(4, 1);
 }
 
 void playlistItemDifference::savePlaylist(QDomElement &root, const QDir &playlistDir) const
@@ -205,11 +219,21 @@ ValuePairListSets playlistItemDifference::getPixelValues(const QPoint &pixelPos,
   {
     newSet.append("Item B", getChildPlaylistItem(1)->getFrameHandler()->getPixelValues(pixelPos, frameIdxInternalB));
     newSet.append("Diff (A-B)", difference.getPixelValues(pixelPos, frameIdxInternalA, nullptr, frameIdxInternalB));
+    newSet.append("Stats", statSource.getValuesAt(pixelPos));
   }
 
   return newSet;
 }
 
+itemLoadingState playlistItemDifference::needsLoading(int frameIdx, bool loadRawData)
+{
+  const int frameIdxInternal = getFrameIdxInternal(frameIdx);
+  const auto state = difference.needsLoading(frameIdxInternal, loadRawData);
+  if (state == LoadingNeeded || statSource.needsLoading(frameIdxInternal) == LoadingNeeded)
+    return LoadingNeeded;
+  return state;
+}
+
 void playlistItemDifference::loadFrame(int frameIdx, bool playing, bool loadRawData, bool emitSignals) 
 {
   Q_UNUSED(playing);
@@ -218,15 +242,24 @@ void playlistItemDifference::loadFrame(int frameIdx, bool playing, bool loadRawD
   const int frameIdxInternal = getFrameIdxInternal(frameIdx);
   
   auto state = difference.needsLoading(frameIdxInternal, loadRawData);
-  if (state == LoadingNeeded)
+  auto stateStat = statSource.needsLoading(frameIdxInternal);
+  if (state == LoadingNeeded || stateStat == LoadingNeeded)
   {
-    // Load the requested current frame
-    DEBUG_DIFF("playlistItemDifference::loadFrame loading difference for frame %d", frameIdxInternal);
     isDifferenceLoading = true;
-    // Since every playlist item can have it's own relative indexing, we need two frame indices
-    int idx0 = getChildPlaylistItem(0)->getFrameIdxInternal(frameIdxInternal);
-    int idx1 = getChildPlaylistItem(1)->getFrameIdxInternal(frameIdxInternal);
-    difference.loadFrameDifference(frameIdxInternal, idx0, idx1);
+    if (state == LoadingNeeded)
+    {
+      // Load the requested current frame
+      DEBUG_DIFF("playlistItemDifference::loadFrame loading difference for frame %d", frameIdxInternal);
+      // Since every playlist item can have it's own relative indexing, we need two frame indices
+      int idx0 = getChildPlaylistItem(0)->getFrameIdxInternal(frameIdxInternal);
+      int idx1 = getChildPlaylistItem(1)->getFrameIdxInternal(frameIdxInternal);
+      difference.loadFrameDifference(frameIdxInternal, idx0, idx1);
+    }
+    if (stateStat == LoadingNeeded)
+    {
+      DEBUG_DIFF("playlistItemDifference::loadFrame loading statistics for frame %d", frameIdxInternal);
+      statSource.loadStatistics(frameIdxInternal);
+    }
     isDifferenceLoading = false;
     if (emitSignals)
       emit signalItemChanged(true, RECACHE_NONE);
@@ -256,5 +289,57 @@ void playlistItemDifference::childChanged(bool redraw, recacheIndicator recache)
   // One of the child items changed and needs to redraw. This means that the difference is out of date
   // and has to be recalculated.
   difference.invalidateAllBuffers();
+  statSource.clearStatisticsCache();
   playlistItemContainer::childChanged(redraw, recache);
-}
\ No newline at end of file
+}
+
+SequenceMetricsJob *playlistItemDifference::startSequenceMetrics(const QString &csvFilePath, QString &errorMessage)
+{
+  if (childCount() != 2)
+  {
+    errorMessage = "The difference item needs two items to compare.";
+    return nullptr;
+  }
+
+  // The frame indices of the difference item are the frame indices of the children (see drawItem)
+  metricsJob.reset(new SequenceMetricsJob(getChildPlaylistItem(0), getChildPlaylistItem(1), getStartEndFrameLimits()));
+  if (!metricsJob->prepare(csvFilePath, errorMessage))
+  {
+    metricsJob.reset();
+    return nullptr;
+  }
+  metricsJob->start();
+  return metricsJob.data();
+}
+
+void playlistItemDifference::itemAboutToBeDeleted(playlistItem *item)
+{
+  if (metricsJob)
+    metricsJob->cancel();
+  playlistItemContainer::itemAboutToBeDeleted(item);
+}
+
+void playlistItemDifference::loadStatisticToCache(int frameIdxInternal, int typeID, QHash<int, statisticsData> &cache)
+{
+  // There is only the SSIM map. It is a byproduct of the difference calculation.
+  int mapFrameIdx;
+  auto ssimMap = difference.getSSIMMap(mapFrameIdx);
+  if (mapFrameIdx != frameIdxInternal && childCount() == 2 && difference.inputsValid())
+  {
+    const int idx0 = getChildPlaylistItem(0)->getFrameIdxInternal(frameIdxInternal);
+    const int idx1 = getChildPlaylistItem(1)->getFrameIdxInternal(frameIdxInternal);
+    difference.loadFrameDifference(frameIdxInternal, idx0, idx1);
+    ssimMap = difference.getSSIMMap(mapFrameIdx);
+  }
+
+  statisticsData data;
+  if (mapFrameIdx == frameIdxInternal)
+  {
+    const int blockSize = YUV_Internals::SSIMMap::blockSize;
+    for (int y = 0; y < ssimMap.size.height(); y++)
+      for (int x = 0; x < ssimMap.size.width(); x++)
+        data.addBlockValue(x * blockSize, y * blockSize, blockSize, blockSize, qRound(ssimMap.values[y * ssimMap.size.width() + x] * SSIM_STATISTICS_SCALE));
+  }
+  statSource.setFrameSize(difference.getFrameSize());
+  cache.insert(typeID, data);
+}
@@ -33,6 +33,8 @@
 #pragma once
 
 #include "playlistItemContainer.h"
+#include "statistics/statisticHandler.h"
+#include "video/sequenceMetrics.h"
 #include "video/videoHandlerDifference.h"
 
 class playlistItemDifference :
@@ -54,7 +56,7 @@ public:
   virtual void drawItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData) Q_DECL_OVERRIDE;
 
   // Do we need to load the given frame first?
-  virtual itemLoadingState needsLoading(int frameIdx, bool loadRawData) Q_DECL_OVERRIDE { return difference.needsLoading(getFrameIdxInternal(frameIdx), loadRawData); }
+  virtual itemLoadingState needsLoading(int frameIdx, bool loadRawData) Q_DECL_OVERRIDE;
   // This is part of the caching interface. The loadFrame function is always called from a different thread.
   virtual void loadFrame(int frameIdx, bool playing, bool loadRawData, bool emitSignals=true) Q_DECL_OVERRIDE;
   virtual bool isLoading() const Q_DECL_OVERRIDE { return isDifferenceLoading; }
@@ -71,9 +73,23 @@ public:
   // Return the frame handler pointer that draws the difference
   virtual frameHandler *getFrameHandler() Q_DECL_OVERRIDE { return &difference; }
 
+  // The difference can provide the SSIM per block as statistics
+  virtual bool providesStatistics() const Q_DECL_OVERRIDE { return true; }
+  virtual statisticHandler *getStatisticsHandler() Q_DECL_OVERRIDE { return &statSource; }
+
+  // Calculate the metrics of all frames of the two items in the background and write them to the CSV file (if a path
+  // is given). A job that is still running is canceled. Returns nullptr and sets the errorMessage if the job can not be started.
+  SequenceMetricsJob *startSequenceMetrics(const QString &csvFilePath, QString &errorMessage);
+
+  // A running metrics job is stopped before one of the items is deleted
+  virtual void itemAboutToBeDeleted(playlistItem *item) Q_DECL_OVERRIDE;
+
 protected slots:
   virtual void childChanged(bool redraw, recacheIndicator recache) Q_DECL_OVERRIDE;
 
+  // Load the statistics with the given frameIdx/typeID into the cache (the SSIM map of the difference)
+  void loadStatisticToCache(int frameIdxInternal, int typeID, QHash<int, statisticsData> &cache);
+
 private:
 
   // Overload from playlistItem. Create a properties widget custom to the playlistItemDifference
@@ -81,6 +97,8 @@ private:
   virtual void createPropertiesWidget() Q_DECL_OVERRIDE;
 
   videoHandlerDifference difference;
+  statisticHandler statSource;
+  QScopedPointer<SequenceMetricsJob> metricsJob;
   bool isDifferenceLoading;
   bool isDifferenceLoadingToDoubleBuffer;
 };
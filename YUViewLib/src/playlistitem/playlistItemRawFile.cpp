@@ -71,6 +71,9 @@ playlistItemRawFile::playlistItemRawFile(const QString &rawFilePath, const QSize
     return;
   }
 
+  // If enabled, the frames are read directly from a memory mapping of the file
+  dataSource.updateMemoryMapSetting();
+
   // Create a new videoHandler instance depending on the input format
   QFileInfo fi(rawFilePath);
   QString ext = fi.suffix();
@@ -129,6 +132,8 @@ playlistItemRawFile::playlistItemRawFile(const QString &rawFilePath, const QSize
 
   // If the videHandler requests raw data, we provide it from the file
   connect(video.data(), &videoHandler::signalRequestRawData, this, &playlistItemRawFile::loadRawData, Qt::DirectConnection);
+  connect(video.data(), &videoHandler::signalRequestRawDataConcurrent, this, &playlistItemRawFile::loadRawDataConcurrent, Qt::DirectConnection);
+  video->setConcurrentRawDataRequests(true);
   connect(video.data(), &videoHandler::signalUpdateFrameLimits, this, &playlistItemRawFile::slotUpdateFrameLimits);
 
   // Connect the basic signals from the video
@@ -485,6 +490,26 @@ void playlistItemRawFile::loadRawData(int frameIdxInternal)
   DEBUG_RAWFILE("playlistItemRawFile::loadRawData %d Done", frameIdxInternal);
 }
 
+void playlistItemRawFile::loadRawDataConcurrent(int frameIdxInternal, QByteArray &targetBuffer)
+{
+  // The format can be changed from the GUI thread while we are loading. Get the frame size only once and discard the
+  // data if the format changed in the meantime.
+  const int formatGeneration = video->getFormatGeneration();
+  if (!video->isFormatValid())
+    return;
+  const int64_t nrBytes = getBytesPerFrame();
+
+  int64_t fileStartPos;
+  if (isY4MFile)
+    fileStartPos = y4mFrameIndices.at(frameIdxInternal);
+  else
+    fileStartPos = frameIdxInternal * nrBytes;
+
+  DEBUG_RAWFILE("playlistItemRawFile::loadRawDataConcurrent frame %d bytes %d", frameIdxInternal, int(nrBytes));
+  if (dataSource.readBytes(targetBuffer, fileStartPos, nrBytes) < nrBytes || video->getFormatGeneration() != formatGeneration)
+    targetBuffer.clear(); // Error or stale format
+}
+
 void playlistItemRawFile::slotVideoPropertiesChanged()
 {
   DEBUG_RAWFILE("playlistItemRawFile::slotVideoPropertiesChanged");
@@ -517,6 +542,21 @@ void playlistItemRawFile::getSupportedFileExtensions(QStringList &allExtensions,
   filters.append("YUV4MPEG2 File (*.y4m)");
 }
 
+bool playlistItemRawFile::isSourceChanged()
+{
+  if (!dataSource.isFileChanged())
+    return false;
+
+  if (dataSource.hasFileMapping())
+  {
+    // The file might have been truncated. Drop all buffered frames (they may point into the mapping) and unmap it.
+    video->invalidateAllBuffers();
+    dataSource.unmapFile();
+    emit signalItemChanged(true, RECACHE_NONE);
+  }
+  return true;
+}
+
 void playlistItemRawFile::reloadItemSource()
 {
   // Reopen the file
@@ -524,6 +564,7 @@ void playlistItemRawFile::reloadItemSource()
   if (!dataSource.isOk())
     // Opening the file failed.
     return;
+  dataSource.updateMemoryMapSetting();
 
   video->invalidateAllBuffers();
 
@@ -71,9 +71,9 @@ public:
   static void getSupportedFileExtensions(QStringList &allExtensions, QStringList &filters);
 
   // ----- Detection of source/file change events -----
-  virtual bool isSourceChanged()  Q_DECL_OVERRIDE { return dataSource.isFileChanged(); }
+  virtual bool isSourceChanged()  Q_DECL_OVERRIDE;
   virtual void reloadItemSource() Q_DECL_OVERRIDE;
-  virtual void updateSettings()   Q_DECL_OVERRIDE { dataSource.updateFileWatchSetting(); }
+  virtual void updateSettings()   Q_DECL_OVERRIDE { dataSource.updateFileWatchSetting(); dataSource.updateMemoryMapSetting(); playlistItemWithVideo::updateSettings(); }
 
   // Cache the given frame
   virtual void cacheFrame(int idx, bool testMode) Q_DECL_OVERRIDE { if (testMode) dataSource.clearFileCache(); playlistItemWithVideo::cacheFrame(idx, testMode); }
@@ -82,6 +82,9 @@ private slots:
   // Load the raw data for the given frame index from file. This slot is called by the videoHandler if the frame that is
   // requested to be drawn has not been loaded yet.
   void loadRawData(int frameIdxInternal);
+  // Load the raw data for the given frame index into the given buffer. This slot is called by the caching threads of the
+  // videoHandler at the same time. The dataSource can handle concurrent reads.
+  void loadRawDataConcurrent(int frameIdxInternal, QByteArray &targetBuffer);
 
   void slotVideoPropertiesChanged();
 
@@ -0,0 +1,260 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "playlistItemStatisticsBinaryFile.h"
+
+#include <cstring>
+#include <QFileInfo>
+#include "playlistItemStatisticsCSVFile.h"
+#include "playlistItemStatisticsVTMBMSFile.h"
+
+playlistItemStatisticsBinaryFile::playlistItemStatisticsBinaryFile(const QString &itemNameOrFileName)
+  : playlistItemStatisticsFile(itemNameOrFileName)
+{
+  if (!file.isOk())
+    return;
+
+  // Everything that is needed to access the frames is in the header and the index
+  readHeaderFromFile();
+
+  connect(&statSource, &statisticHandler::updateItem, [this](bool redraw){ emit signalItemChanged(redraw, RECACHE_NONE); });
+  connect(&statSource, &statisticHandler::requestStatisticsLoading, this, &playlistItemStatisticsBinaryFile::loadStatisticToCache, Qt::DirectConnection);
+
+  // Every frame/type is a separate chunk in the file. These can be read and decoded in parallel.
+  statSource.setParallelTypeLoading(true);
+}
+
+void playlistItemStatisticsBinaryFile::readHeaderFromFile()
+{
+  using namespace StatisticsBinaryFormat;
+
+  // Cleanup old types
+  statSource.clearStatTypes();
+  pocTypeIndex.clear();
+  maxPOC = 0;
+
+  QByteArray data;
+  FileHeader header;
+  if (file.readBytes(data, 0, sizeof(FileHeader)) != int64_t(sizeof(FileHeader)))
+  {
+    parsingError = "The file is too short for a binary statistics file.";
+    return;
+  }
+  std::memcpy(&header, data.constData(), sizeof(FileHeader));
+  if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version)
+  {
+    parsingError = "The file is no binary statistics file or the version is not supported.";
+    return;
+  }
+
+  QVector<StatisticsType> types;
+  if (file.readBytes(data, header.typesOffset, header.typesSize) != int64_t(header.typesSize) || !decodeTypes(data, types))
+  {
+    parsingError = "Error reading the statistics types.";
+    return;
+  }
+  for (const StatisticsType &type : types)
+    statSource.addStatType(type);
+
+  if (header.frameWidth > 0 && header.frameHeight > 0)
+    statSource.setFrameSize(QSize(header.frameWidth, header.frameHeight));
+  if (header.frameRate > 0.0)
+    frameRate = header.frameRate;
+
+  const int64_t indexSize = int64_t(header.nrIndexEntries) * sizeof(IndexEntry);
+  if (file.readBytes(data, header.indexOffset, indexSize) != indexSize)
+  {
+    parsingError = "Error reading the index of the statistics file.";
+    return;
+  }
+  for (uint32_t i = 0; i < header.nrIndexEntries; i++)
+  {
+    IndexEntry entry;
+    std::memcpy(&entry, data.constData() + i * sizeof(IndexEntry), sizeof(IndexEntry));
+    pocTypeIndex.insert(qMakePair(int(entry.poc), int(entry.typeID)), entry);
+    if (entry.poc > maxPOC)
+      maxPOC = entry.poc;
+  }
+
+  backgroundParserProgress = 100.0;
+  setStartEndFrame(indexRange(0, maxPOC), false);
+}
+
+void playlistItemStatisticsBinaryFile::loadStatisticToCache(int frameIdxInternal, int typeID, QHash<int, statisticsData> &cache)
+{
+  if (!file.isOk())
+    return;
+
+  statisticsData data;
+  auto entry = pocTypeIndex.constFind(qMakePair(frameIdxInternal, typeID));
+  if (entry != pocTypeIndex.constEnd())
+  {
+    // If the file is memory mapped, the chunk is not copied
+    QByteArray chunk;
+    if (file.readBytes(chunk, entry->offset, entry->size) != int64_t(entry->size) ||
+        !StatisticsBinaryFormat::decodeData(chunk.constData(), chunk.size(), data))
+    {
+      // The types are loaded in parallel
+      setParsingError(QString("Error reading the statistics of frame %1 type %2.").arg(frameIdxInternal).arg(typeID));
+      data = statisticsData();
+    }
+  }
+
+  // If there is no data for the given frame and type, an empty entry is inserted.
+  cache.insert(typeID, data);
+}
+
+playlistItemStatisticsFile *playlistItemStatisticsBinaryFile::openConversionSource(const QString &sourceFilePath, QString &errorMessage)
+{
+  // Open the source file in a separate item so that the caches of items in the playlist are not touched
+  QStringList csvExtensions, vtmbmsExtensions, filters;
+  playlistItemStatisticsCSVFile::getSupportedFileExtensions(csvExtensions, filters);
+  playlistItemStatisticsVTMBMSFile::getSupportedFileExtensions(vtmbmsExtensions, filters);
+  const QString ext = QFileInfo(sourceFilePath).suffix().toLower();
+
+  if (csvExtensions.contains(ext))
+    return new playlistItemStatisticsCSVFile(sourceFilePath);
+  if (vtmbmsExtensions.contains(ext))
+    return new playlistItemStatisticsVTMBMSFile(sourceFilePath);
+  errorMessage = "Only CSV and VTMBMS statistics files can be converted.";
+  return nullptr;
+}
+
+bool playlistItemStatisticsBinaryFile::convertStatisticsFile(playlistItemStatisticsFile *source, const QString &targetFilePath, QString &errorMessage,
+                                                             std::function<bool(int)> progress)
+{
+  // The start positions of all POCs/types must be known
+  source->waitForBackgroundParser();
+  if (!source->getParsingError().isEmpty())
+  {
+    errorMessage = source->getParsingError();
+    return false;
+  }
+
+  statisticHandler *handler = source->getStatisticsHandler();
+  const StatisticsTypeList types = handler->getStatisticsTypeList();
+  StatisticsBinaryFormat::Writer writer;
+  if (!writer.open(targetFilePath, handler->getFrameSize(), source->getFrameRate(), types))
+  {
+    errorMessage = QString("Error opening the file %1 for writing.").arg(targetFilePath);
+    return false;
+  }
+
+  const int maxPOC = source->getMaxPOC();
+  for (int poc = 0; poc <= maxPOC; poc++)
+  {
+    // An interleaved file loads all types of the POC at once
+    QHash<int, statisticsData> cache;
+    for (const StatisticsType &type : types)
+      if (!cache.contains(type.typeID))
+        source->loadStatisticToCache(poc, type.typeID, cache);
+
+    for (const StatisticsType &type : types)
+    {
+      if (!cache.contains(type.typeID))
+        continue;
+      const statisticsData &data = cache[type.typeID];
+      if (data.valueBlocks.count() == 0 && data.vectorBlocks.count() == 0 && data.affineTFBlocks.count() == 0 &&
+          data.polygonValueData.isEmpty() && data.polygonVectorData.isEmpty())
+        // Frames/types without data are not stored
+        continue;
+      if (!writer.addData(poc, type.typeID, data))
+      {
+        errorMessage = QString("Error writing to the file %1.").arg(targetFilePath);
+        writer.abort();
+        return false;
+      }
+    }
+
+    if (progress && !progress(int(int64_t(poc + 1) * 100 / (maxPOC + 1))))
+    {
+      errorMessage = "The conversion was canceled.";
+      writer.abort();
+      return false;
+    }
+  }
+  if (!writer.finish())
+  {
+    errorMessage = QString("Error writing to the file %1.").arg(targetFilePath);
+    writer.abort();
+    return false;
+  }
+  return true;
+}
+
+playlistItemStatisticsBinaryFile *playlistItemStatisticsBinaryFile::newplaylistItemStatisticsBinaryFile(const YUViewDomElement &root, const QString &playlistFilePath)
+{
+  // Parse the DOM element. It should have all values of a playlistItemStatisticsFile
+  QString absolutePath = root.findChildValue("absolutePath");
+  QString relativePath = root.findChildValue("relativePath");
+
+  // check if file with absolute path exists, otherwise check relative path
+  QString filePath = FileSource::getAbsPathFromAbsAndRel(playlistFilePath, absolutePath, relativePath);
+  if (filePath.isEmpty())
+    return nullptr;
+
+  playlistItemStatisticsBinaryFile *newStat = new playlistItemStatisticsBinaryFile(filePath);
+
+  // Load the propertied of the playlistItem
+  playlistItem::loadPropertiesFromPlaylist(root, newStat);
+
+  // Load the status of the statistics (which are shown, transparency ...)
+  newStat->statSource.loadPlaylist(root);
+
+  return newStat;
+}
+
+void playlistItemStatisticsBinaryFile::reloadItemSource()
+{
+  // Set default variables
+  blockOutsideOfFrame_idx = -1;
+  setParsingError(QString());
+  currentDrawnFrameIdx = -1;
+
+  // Clear the cached data
+  statSource.clearStatisticsCache();
+
+  // Reopen the file
+  file.openFile(plItemNameOrFileName);
+  if (!file.isOk())
+    return;
+
+  readHeaderFromFile();
+  statSource.updateStatisticsHandlerControls();
+}
+
+void playlistItemStatisticsBinaryFile::getSupportedFileExtensions(QStringList &allExtensions, QStringList &filters)
+{
+  allExtensions.append("yuvstats");
+  filters.append("Binary Statistics File (*.yuvstats)");
+}
@@ -0,0 +1,83 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <functional>
+#include <QHash>
+#include <QPair>
+#include "playlistItemStatisticsFile.h"
+#include "statistics/StatisticsBinaryFormat.h"
+
+// A statistics file in the binary format (see StatisticsBinaryFormat). The file contains an index of all POCs/types,
+// so no background parsing is needed and the data of a frame is read without any text parsing.
+class playlistItemStatisticsBinaryFile : public playlistItemStatisticsFile
+{
+  Q_OBJECT
+
+public:
+  playlistItemStatisticsBinaryFile(const QString &itemNameOrFileName);
+
+  bool isFileSource() const Q_DECL_OVERRIDE { return true; };
+
+  // Create a new playlistItemStatisticsBinaryFile from the playlist file entry. Return nullptr if parsing failed.
+  static playlistItemStatisticsBinaryFile *newplaylistItemStatisticsBinaryFile(const YUViewDomElement &root, const QString &playlistFilePath);
+
+  // Add the file type filters and the extensions of files that we can load.
+  static void getSupportedFileExtensions(QStringList &allExtensions, QStringList &filters);
+
+  // Open a CSV or VTMBMS statistics file as the source of a conversion. This must be called in the GUI thread.
+  // The item is not added to the playlist. Returns nullptr (and sets the errorMessage) if the file can not be converted.
+  static playlistItemStatisticsFile *openConversionSource(const QString &sourceFilePath, QString &errorMessage);
+  // Convert the statistics of the source (see openConversionSource) to a binary statistics file. This can run in a
+  // background thread. progress is called after every frame with the percentage of converted frames. If it returns
+  // false, the conversion is canceled. If the conversion fails or is canceled, the target file is removed.
+  static bool convertStatisticsFile(playlistItemStatisticsFile *source, const QString &targetFilePath, QString &errorMessage,
+                                    std::function<bool(int)> progress = nullptr);
+
+  // ----- Detection of source/file change events -----
+  virtual void reloadItemSource() Q_DECL_OVERRIDE;
+public slots:
+  //! Load the statistics with frameIdx/type from file and put it into the cache.
+  void loadStatisticToCache(int frameIdxInternal, int typeID, QHash<int, statisticsData> &cache) Q_DECL_OVERRIDE;
+
+private:
+
+  QString getPlaylistTag() const Q_DECL_OVERRIDE { return "playlistItemStatisticsBinaryFile"; }
+
+  //! Read the header, the statistics types and the index from the file.
+  void readHeaderFromFile();
+
+  // The position and size of the data of every POC/type in the file
+  QHash<QPair<int, int>, StatisticsBinaryFormat::IndexEntry> pocTypeIndex;
+};
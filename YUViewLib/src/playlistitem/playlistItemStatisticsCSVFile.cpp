@@ -32,19 +32,15 @@
 
 #include "playlistItemStatisticsCSVFile.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <QDebug>
 #include <QtConcurrent>
 #include <QTime>
+#include "statistics/CSVStatisticsParser.h"
 #include "statistics/statisticsExtensions.h"
 
-// The internal buffer for parsing the starting positions. The buffer must not be larger than 2GB
-// so that we can address all the positions in it with int (using such a large buffer is not a good
-// idea anyways)
-#define STAT_PARSING_BUFFER_SIZE 1048576
-#define STAT_MAX_STRING_SIZE 1<<28
-
 playlistItemStatisticsCSVFile::playlistItemStatisticsCSVFile(const QString &itemNameOrFileName)
   : playlistItemStatisticsFile(itemNameOrFileName)
 {
@@ -82,140 +78,98 @@ void playlistItemStatisticsCSVFile::readFrameAndTypePositionsFromFile()
     if (!inputFile.openFile(file.absoluteFilePath()))
       return;
 
-    // We perform reading using an input buffer
-    QByteArray inputBuffer;
-    bool fileAtEnd = false;
-    qint64 bufferStartPos = 0;
-
-    QString lineBuffer;
-    qint64  lineBufferStartPos = 0;
-    int     lastPOC = INT_INVALID;
-    int     lastType = INT_INVALID;
-    bool    sortingFixed = false; 
-    
-    while (!fileAtEnd && !cancelBackgroundParser)
+    int  lastPOC = INT_INVALID;
+    int  lastType = INT_INVALID;
+    bool sortingFixed = false;
+
+    CSVStatisticsParser::readDataLines(inputFile, 0, [&](const CSVStatisticsParser::DataLine &line, int64_t lineStartPos)
     {
-      // Fill the buffer
-      int bufferSize = inputFile.readBytes(inputBuffer, bufferStartPos, STAT_PARSING_BUFFER_SIZE);
-      if (bufferSize < STAT_PARSING_BUFFER_SIZE)
-        // Less bytes than the maximum buffer size were read. The file is at the end.
-        // This is the last run of the loop.
-        fileAtEnd = true;
-      // a corrupted file may contain an arbitrary amount of non-\n symbols
-      // prevent lineBuffer overflow by dumping it for such cases
-      if (lineBuffer.size() > STAT_MAX_STRING_SIZE)
-        lineBuffer.clear(); // prevent an overflow here
-      for (int i = 0; i < bufferSize; i++)
+      // check for POC/type information
+      const int poc = line.poc;
+      const int typeID = line.typeID;
+
+      if (lastType == -1 && lastPOC == -1)
       {
-        // Search for '\n' newline characters
-        if (inputBuffer.at(i) == 10)
+        // First POC/type line
+        pocTypeStartList[poc][typeID] = lineStartPos;
+        if (poc == currentDrawnFrameIdx)
+          // We added a start position for the frame index that is currently drawn. We might have to redraw.
+          emit signalItemChanged(true, RECACHE_NONE);
+
+        lastType = typeID;
+        lastPOC = poc;
+
+        // update number of frames
+        if (poc > maxPOC)
+          maxPOC = poc;
+      }
+      else if (typeID != lastType && poc == lastPOC)
+      {
+        // we found a new type but the POC stayed the same.
+        // This seems to be an interleaved file
+        // Check if we already collected a start position for this type
+        if (!sortingFixed)
         {
-          // We found a newline character
-          if (lineBuffer.size() > 0)
-          {
-            // Parse the previous line
-            // get components of this line
-            QStringList rowItemList = parseCSVLine(lineBuffer, ';');
-
-            // ignore empty entries and headers
-            if (!rowItemList[0].isEmpty() && rowItemList[0][0] != '%')
-            {
-              // check for POC/type information
-              int poc = rowItemList[0].toInt();
-              int typeID = rowItemList[5].toInt();
-
-              if (lastType == -1 && lastPOC == -1)
-              {
-                // First POC/type line
-                pocTypeStartList[poc][typeID] = lineBufferStartPos;
-                if (poc == currentDrawnFrameIdx)
-                  // We added a start position for the frame index that is currently drawn. We might have to redraw.
-                  emit signalItemChanged(true, RECACHE_NONE);
-
-                lastType = typeID;
-                lastPOC = poc;
-
-                // update number of frames
-                if (poc > maxPOC)
-                  maxPOC = poc;
-              }
-              else if (typeID != lastType && poc == lastPOC)
-              {
-                // we found a new type but the POC stayed the same.
-                // This seems to be an interleaved file
-                // Check if we already collected a start position for this type
-                if (!sortingFixed)
-                {
-                  // we only check the first occurence of this, in a non-interleaved file
-                  // the above condition can be met and will reset fileSortedByPOC
-                  
-                  fileSortedByPOC = true;
-                  sortingFixed = true; 
-                }
-                lastType = typeID;
-                if (!pocTypeStartList[poc].contains(typeID))
-                {
-                  pocTypeStartList[poc][typeID] = lineBufferStartPos;
-                  if (poc == currentDrawnFrameIdx)
-                    // We added a start position for the frame index that is currently drawn. We might have to redraw.
-                    emit signalItemChanged(true, RECACHE_NONE);
-                }
-              }
-              else if (poc != lastPOC)
-              {
-                // this is apparently not sorted by POCs and we will not check it further
-                if(!sortingFixed)
-                  sortingFixed = true;
-                
-                // We found a new POC
-                if (fileSortedByPOC)
-                {
-                  // There must not be a start position for any type with this POC already.
-                  if (pocTypeStartList.contains(poc))
-                    throw "The data for each POC must be continuous in an interleaved statistics file->";
-                }
-                else
-                {
-                
-                  // There must not be a start position for this POC/type already.
-                  if (pocTypeStartList.contains(poc) && pocTypeStartList[poc].contains(typeID))
-                    throw "The data for each typeID must be continuous in an non interleaved statistics file->";
-                }
-
-                lastPOC = poc;
-                lastType = typeID;
-
-                pocTypeStartList[poc][typeID] = lineBufferStartPos;
-                if (poc == currentDrawnFrameIdx)
-                  // We added a start position for the frame index that is currently drawn. We might have to redraw.
-                  emit signalItemChanged(true, RECACHE_NONE);
-
-                // update number of frames
-                if (poc > maxPOC)
-                  maxPOC = poc;
-
-                // Update percent of file parsed
-                backgroundParserProgress = ((double)lineBufferStartPos * 100 / (double)inputFile.getFileSize());
-              }
-            }
-          }
+          // we only check the first occurence of this, in a non-interleaved file
+          // the above condition can be met and will reset fileSortedByPOC
 
-          lineBuffer.clear();
-          lineBufferStartPos = bufferStartPos + i + 1;
+          fileSortedByPOC = true;
+          sortingFixed = true;
         }
-        else
+        lastType = typeID;
+        if (!pocTypeStartList[poc].contains(typeID))
         {
-          // No newline character found
-          lineBuffer.append(inputBuffer.at(i));
+          pocTypeStartList[poc][typeID] = lineStartPos;
+          if (poc == currentDrawnFrameIdx)
+            // We added a start position for the frame index that is currently drawn. We might have to redraw.
+            emit signalItemChanged(true, RECACHE_NONE);
         }
       }
+      else if (poc != lastPOC)
+      {
+        // this is apparently not sorted by POCs and we will not check it further
+        if(!sortingFixed)
+          sortingFixed = true;
 
-      bufferStartPos += bufferSize;
-    }
+        // We found a new POC
+        if (fileSortedByPOC)
+        {
+          // There must not be a start position for any type with this POC already.
+          if (pocTypeStartList.contains(poc))
+            throw "The data for each POC must be continuous in an interleaved statistics file->";
+        }
+        else
+        {
+          // There must not be a start position for this POC/type already.
+          if (pocTypeStartList.contains(poc) && pocTypeStartList[poc].contains(typeID))
+            throw "The data for each typeID must be continuous in an non interleaved statistics file->";
+        }
+
+        lastPOC = poc;
+        lastType = typeID;
+
+        pocTypeStartList[poc][typeID] = lineStartPos;
+        if (poc == currentDrawnFrameIdx)
+          // We added a start position for the frame index that is currently drawn. We might have to redraw.
+          emit signalItemChanged(true, RECACHE_NONE);
+
+        // update number of frames
+        if (poc > maxPOC)
+          maxPOC = poc;
+
+        // Update percent of file parsed
+        backgroundParserProgress = ((double)lineStartPos * 100 / (double)inputFile.getFileSize());
+      }
+      return true;
+    }, &cancelBackgroundParser);
 
     // Parsing complete
     backgroundParserProgress = 100.0;
 
+    // In a file sorted by typeID, every type of a frame is read from its own position in the file.
+    // The file can be read from multiple threads at the same time so all types can be loaded in parallel.
+    statSource.setParallelTypeLoading(!fileSortedByPOC);
+
     setStartEndFrame(indexRange(0, maxPOC), false);
     emit signalItemChanged(false, RECACHE_NONE);
 
@@ -403,19 +357,17 @@ void playlistItemStatisticsCSVFile::readHeaderFromFile()
   return;
 }
 
-void playlistItemStatisticsCSVFile::loadStatisticToCache(int frameIdxInternal, int typeID)
+void playlistItemStatisticsCSVFile::loadStatisticToCache(int frameIdxInternal, int typeID, QHash<int, statisticsData> &cache)
 {
   try
   {
     if (!file.isOk())
       return;
 
-    QTextStream in(file.getQFile());
-
     if (!pocTypeStartList.contains(frameIdxInternal) || !pocTypeStartList[frameIdxInternal].contains(typeID))
     {
       // There are no statistics in the file for the given frame and index.
-      statSource.statsCache.insert(typeID, statisticsData());
+      cache.insert(typeID, statisticsData());
       return;
     }
 
@@ -434,70 +386,49 @@ void playlistItemStatisticsCSVFile::loadStatisticToCache(int frameIdxInternal, i
           startPos = value;
     }
 
-    // fast forward
-    in.seek(startPos);
-
-    while (!in.atEnd())
+    // The lines end before the next POC (or the next type if the file is not sorted by POC) starts. Don't read
+    // more than that so that small blocks of statistics don't need a whole read buffer.
+    qint64 endPos = file.getFileSize();
+    for (auto poc = pocTypeStartList.constBegin(); poc != pocTypeStartList.constEnd(); ++poc)
     {
-      // read one line
-      QString aLine = in.readLine();
-
-      // get components of this line
-      QStringList rowItemList = parseCSVLine(aLine, ';');
-
-      if (rowItemList[0].isEmpty())
+      if (fileSortedByPOC && poc.key() == frameIdxInternal)
         continue;
+      for (const qint64 &value : poc.value())
+        if (value > startPos && value < endPos)
+          endPos = value;
+    }
+    const int64_t bufferSize = std::max<int64_t>(std::min<int64_t>(endPos - startPos, CSVStatisticsParser::ReadBufferSize), 1);
 
-      int poc = rowItemList[0].toInt();
-      int type = rowItemList[5].toInt();
-
+    CSVStatisticsParser::readDataLines(file, startPos, [&](const CSVStatisticsParser::DataLine &line, int64_t)
+    {
       // if there is a new POC, we are done here!
-      if (poc != frameIdxInternal)
-        break;
+      if (line.poc != frameIdxInternal)
+        return false;
       // if there is a new type and this is a non interleaved file, we are done here.
-      if (!fileSortedByPOC && type != typeID)
-        break;
-
-      int values[4] = {0};
-
-      values[0] = rowItemList[6].toInt();
-
-      bool vectorData = false;
-      bool lineData = false; // or a vector specified by 2 points
-
-      if (rowItemList.count() > 7)
-      {
-        values[1] = rowItemList[7].toInt();
-        vectorData = true;
-      }
-      if (rowItemList.count() > 8)
-      {
-        values[2] = rowItemList[8].toInt();
-        values[3] = rowItemList[9].toInt();
-        lineData = true;
-        vectorData = false;
-      }
+      if (!fileSortedByPOC && line.typeID != typeID)
+        return false;
 
-      int posX = rowItemList[1].toInt();
-      int posY = rowItemList[2].toInt();
-      int width = rowItemList[3].toUInt();
-      int height = rowItemList[4].toUInt();
+      // One value is block data, two values are a vector and more values are a line (a vector specified by 2 points)
+      const bool vectorData = (line.nrValues == 2);
+      const bool lineData = (line.nrValues > 2);
 
       // Check if block is within the image range
-      if (blockOutsideOfFrame_idx == -1 && (posX + width > statSource.getFrameSize().width() || posY + height > statSource.getFrameSize().height()))
+      if (blockOutsideOfFrame_idx == -1 && (line.posX + line.width > statSource.getFrameSize().width() || line.posY + line.height > statSource.getFrameSize().height()))
         // Block not in image. Warn about this.
         blockOutsideOfFrame_idx = frameIdxInternal;
 
-      const StatisticsType *statsType = statSource.getStatisticsType(type);
+      const StatisticsType *statsType = statSource.getStatisticsType(line.typeID);
       Q_ASSERT_X(statsType != nullptr, Q_FUNC_INFO, "Stat type not found.");
 
+      const int *values = line.values;
       if (vectorData && statsType->hasVectorData)
-        statSource.statsCache[type].addBlockVector(posX, posY, width, height, values[0], values[1]);
+        cache[line.typeID].addBlockVector(line.posX, line.posY, line.width, line.height, values[0], values[1]);
       else if (lineData && statsType->hasVectorData)
-        statSource.statsCache[type].addLine(posX, posY, width, height, values[0], values[1], values[2], values[3]);
+        cache[line.typeID].addLine(line.posX, line.posY, line.width, line.height, values[0], values[1], values[2], values[3]);
       else
-        statSource.statsCache[type].addBlockValue(posX, posY, width, height, values[0]);
-    }
+        cache[line.typeID].addBlockValue(line.posX, line.posY, line.width, line.height, values[0]);
+      return true;
+    }, nullptr, bufferSize);
 
   } // try
   catch (const char *str)
@@ -552,6 +483,7 @@ void playlistItemStatisticsCSVFile::reloadItemSource()
 {
   // Set default variables
   fileSortedByPOC = false;
+  statSource.setParallelTypeLoading(false);
   blockOutsideOfFrame_idx = -1;
   backgroundParserProgress = 0.0;
   parsingError.clear();
@@ -568,8 +500,7 @@ void playlistItemStatisticsCSVFile::reloadItemSource()
 
   // Clear the parsed data
   pocTypeStartList.clear();
-  statSource.statsCache.clear();
-  statSource.statsCacheFrameIdx = -1;
+  statSource.clearStatisticsCache();
 
   // Reopen the file
   file.openFile(plItemNameOrFileName);
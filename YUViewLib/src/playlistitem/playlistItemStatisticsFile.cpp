@@ -56,6 +56,7 @@ playlistItemStatisticsFile::playlistItemStatisticsFile(const QString &itemNameOr
   currentDrawnFrameIdx = -1;
   maxPOC = 0;
   isStatisticsLoading = false;
+  isStatisticsLoadingDoubleBuffer = false;
 
   // Set statistics icon
   setIcon(0, functions::convertIcon(":img_stats.png"));
@@ -96,8 +97,9 @@ infoData playlistItemStatisticsFile::getInfo() const
     info.items.append(infoItem("Warning", QString("A block in frame %1 is outside of the given size of the statistics.").arg(blockOutsideOfFrame_idx)));
 
   // Show any errors that occurred during parsing
-  if (!parsingError.isEmpty())
-    info.items.append(infoItem("Parsing Error:", parsingError));
+  const QString error = getParsingError();
+  if (!error.isEmpty())
+    info.items.append(infoItem("Parsing Error:", error));
 
   return info;
 }
@@ -179,9 +181,20 @@ void playlistItemStatisticsFile::savePlaylist(QDomElement &root, const QDir &pla
   root.appendChild(d);
 }
 
+itemLoadingState playlistItemStatisticsFile::needsLoading(int frameIdx, bool loadRawdata)
+{
+  Q_UNUSED(loadRawdata);
+  const int frameIdxInternal = getFrameIdxInternal(frameIdx);
+
+  auto state = statSource.needsLoading(frameIdxInternal);
+  if (state == LoadingNotNeeded && statSource.getNextFrameToPrefetch(frameIdxInternal, maxPOC) != -1)
+    // The frame can be drawn but the statistics of the next frames should be loaded for playback
+    return LoadingNeededDoubleBuffer;
+  return state;
+}
+
 void playlistItemStatisticsFile::loadFrame(int frameIdx, bool playback, bool loadRawdata, bool emitSignals)
 {
-  Q_UNUSED(playback);
   Q_UNUSED(loadRawdata);
   const int frameIdxInternal = getFrameIdxInternal(frameIdx);
 
@@ -193,4 +206,22 @@ void playlistItemStatisticsFile::loadFrame(int frameIdx, bool playback, bool loa
     if (emitSignals)
       emit signalItemChanged(true, RECACHE_NONE);
   }
+
+  if (!playback)
+    return;
+
+  // Prefetch the statistics of the next frames. Playback has to wait for the next frame (the double buffer)
+  // but not for the frames after that.
+  for (int i = 0; i < STATISTICS_PREFETCH_FRAMES; i++)
+  {
+    const int prefetchFrameIdx = statSource.getNextFrameToPrefetch(frameIdxInternal, maxPOC);
+    if (prefetchFrameIdx == -1)
+      break;
+    const bool doubleBuffer = (prefetchFrameIdx == frameIdxInternal + 1);
+    isStatisticsLoadingDoubleBuffer = doubleBuffer;
+    statSource.prefetchStatistics(prefetchFrameIdx);
+    isStatisticsLoadingDoubleBuffer = false;
+    if (doubleBuffer && emitSignals)
+      emit signalItemDoubleBufferLoaded();
+  }
 }
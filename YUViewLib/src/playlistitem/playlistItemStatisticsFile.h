@@ -34,6 +34,7 @@
 
 #include <QBasicTimer>
 #include <QFuture>
+#include <QMutex>
 #include "filesource/FileSource.h"
 #include "playlistItem.h"
 #include "statistics/statisticHandler.h"
@@ -66,12 +67,14 @@ public:
 
   // ------ Statistics ----
 
-  // Do we need to load the statistics first?
-  virtual itemLoadingState needsLoading(int frameIdx, bool loadRawdata) Q_DECL_OVERRIDE { Q_UNUSED(loadRawdata); return statSource.needsLoading(getFrameIdxInternal(frameIdx)); }
+  // Do we need to load the statistics first? If the statistics of the next frames are not loaded yet, LoadingNeededDoubleBuffer is returned.
+  virtual itemLoadingState needsLoading(int frameIdx, bool loadRawdata) Q_DECL_OVERRIDE;
   // Load the statistics for the given frame. Emit signalItemChanged(true,false) when done. Always called from a thread.
+  // During playback, the statistics of the next frames are prefetched.
   virtual void loadFrame(int frameIdx, bool playback, bool loadRawdata, bool emitSignals=true) Q_DECL_OVERRIDE;
   // Are statistics currently being loaded?
   virtual bool isLoading() const Q_DECL_OVERRIDE { return isStatisticsLoading; }
+  virtual bool isLoadingDoubleBuffer() const Q_DECL_OVERRIDE { return isStatisticsLoadingDoubleBuffer; }
 
   // Override from playlistItem. Return the statistics values under the given pixel position.
   virtual ValuePairListSets getPixelValues(const QPoint &pixelPos, int frameIdx) Q_DECL_OVERRIDE { Q_UNUSED(frameIdx); return ValuePairListSets("Stats",statSource.getValuesAt(pixelPos)); }
@@ -84,6 +87,14 @@ public:
   virtual bool isSourceChanged()  Q_DECL_OVERRIDE { return file.isFileChanged(); }
   virtual void updateSettings()   Q_DECL_OVERRIDE { file.updateFileWatchSetting(); statSource.updateSettings(); }
 
+  // Load the statistics with frameIdx/type from file and put it into the given cache [statsTypeID].
+  virtual void loadStatisticToCache(int frameIdxInternal, int typeID, QHash<int, statisticsData> &cache) = 0;
+
+  // Wait until the background parser scanned the whole file. After this, getMaxPOC() is final.
+  void waitForBackgroundParser() { backgroundParserFuture.waitForFinished(); }
+  int getMaxPOC() const { return maxPOC; }
+  QString getParsingError() const { QMutexLocker lock(&parsingErrorMutex); return parsingError; }
+
 protected:
   virtual indexRange getStartEndFrameLimits() const Q_DECL_OVERRIDE { return indexRange(0, maxPOC); }
 
@@ -97,8 +108,9 @@ protected:
   // The statistics source
   statisticHandler statSource;
 
-  // Is the loadFrame function currently loading?
+  // Is the loadFrame function currently loading (the current frame or the next frame during playback)?
   bool isStatisticsLoading;
+  bool isStatisticsLoadingDoubleBuffer;
 
   QFuture<void> backgroundParserFuture;
   double backgroundParserProgress;
@@ -115,8 +127,11 @@ protected:
   // The maximum POC number in the file (as far as we know)
   int maxPOC;
 
-  // If an error occurred while parsing, this error text will be set and can be shown
+  // If an error occurred while parsing, this error text will be set and can be shown. Use setParsingError if the
+  // statistics are loaded from multiple threads (see statisticHandler::setParallelTypeLoading).
   QString parsingError;
+  mutable QMutex parsingErrorMutex;
+  void setParsingError(const QString &error) { QMutexLocker lock(&parsingErrorMutex); parsingError = error; }
 
   FileSource file;
 
@@ -360,7 +360,7 @@ void playlistItemStatisticsVTMBMSFile::readHeaderFromFile()
   return;
 }
 
-void playlistItemStatisticsVTMBMSFile::loadStatisticToCache(int frameIdxInternal, int typeID)
+void playlistItemStatisticsVTMBMSFile::loadStatisticToCache(int frameIdxInternal, int typeID, QHash<int, statisticsData> &cache)
 {
   try
   {
@@ -372,7 +372,7 @@ void playlistItemStatisticsVTMBMSFile::loadStatisticToCache(int frameIdxInternal
     if (!pocStartList.contains(frameIdxInternal))
     {
       // There are no statistics in the file for the given frame and index.
-      statSource.statsCache.insert(typeID, statisticsData());
+      cache.insert(typeID, statisticsData());
       return;
     }
 
@@ -500,11 +500,11 @@ void playlistItemStatisticsVTMBMSFile::loadStatisticToCache(int frameIdxInternal
               {
                 int vecX1 = statisitcMatch.captured(8).toInt();
                 int vecY1 = statisitcMatch.captured(9).toInt();
-                statSource.statsCache[typeID].addLine(posX, posY, width, height, vecX, vecY,vecX1,vecY1);
+                cache[typeID].addLine(posX, posY, width, height, vecX, vecY,vecX1,vecY1);
               }
               else
               {
-                statSource.statsCache[typeID].addBlockVector(posX, posY, width, height, vecX, vecY);
+                cache[typeID].addBlockVector(posX, posY, width, height, vecX, vecY);
               }
             }
             else if (aType->hasAffineTFData)
@@ -515,12 +515,12 @@ void playlistItemStatisticsVTMBMSFile::loadStatisticToCache(int frameIdxInternal
               int vecY1 = statisitcMatch.captured(9).toInt();
               int vecX2 = statisitcMatch.captured(10).toInt();
               int vecY2 = statisitcMatch.captured(11).toInt();
-              statSource.statsCache[typeID].addBlockAffineTF(posX, posY, width, height, vecX0, vecY0, vecX1, vecY1, vecX2, vecY2);
+              cache[typeID].addBlockAffineTF(posX, posY, width, height, vecX0, vecY0, vecX1, vecY1, vecX2, vecY2);
             }
             else
             {
               scalar = statisitcMatch.captured(6).toInt();
-              statSource.statsCache[typeID].addBlockValue(posX, posY, width, height, scalar);
+              cache[typeID].addBlockValue(posX, posY, width, height, scalar);
             }
           }
           else
@@ -550,22 +550,22 @@ void playlistItemStatisticsVTMBMSFile::loadStatisticToCache(int frameIdxInternal
             {
               vecX = statisitcMatch.captured(3).toInt();
               vecY = statisitcMatch.captured(4).toInt();
-              statSource.statsCache[typeID].addPolygonVector(points, vecX, vecY);
+              cache[typeID].addPolygonVector(points, vecX, vecY);
             }
             else if(aType->hasValueData)
             {
               scalar = statisitcMatch.captured(3).toInt();
-              statSource.statsCache[typeID].addPolygonValue(points, scalar);
+              cache[typeID].addPolygonValue(points, scalar);
             }
           }
         }
       }
     }
 
-    if(!statSource.statsCache.contains(typeID))
+    if(!cache.contains(typeID))
     {
       // There are no statistics in the file for the given frame and index.
-      statSource.statsCache.insert(typeID, statisticsData());
+      cache.insert(typeID, statisticsData());
       return;
     }
 
@@ -635,8 +635,7 @@ void playlistItemStatisticsVTMBMSFile::reloadItemSource()
 
   // Clear the parsed data
   pocStartList.clear();
-  statSource.statsCache.clear();
-  statSource.statsCacheFrameIdx = -1;
+  statSource.clearStatisticsCache();
 
   // Reopen the file
   file.openFile(plItemNameOrFileName);
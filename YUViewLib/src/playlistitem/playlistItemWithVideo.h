@@ -68,9 +68,14 @@ public:
   // Remove the given frame from the cache
   virtual void removeFrameFromCache(int idx) Q_DECL_OVERRIDE { if (video) video->removeFrameFromCache(getFrameIdxInternal(idx)); }
   virtual void removeAllFramesFromCache() Q_DECL_OVERRIDE { if (video) video->removeAllFrameFromCache(); }
+  virtual void resetCachingDurations() Q_DECL_OVERRIDE { if (video) video->resetCachingDurations(); }
+  virtual bool getCachingDurations(int64_t &loadingNsec, int64_t &totalNsec) const Q_DECL_OVERRIDE { if (!video) return false; video->getCachingDurations(loadingNsec, totalNsec); return true; }
   // This item is cachable, if caching is enabled and if the raw format is valid (can be cached).
   virtual bool isCachable() const Q_DECL_OVERRIDE { return !unresolvableError && playlistItem::isCachable() && video->isFormatValid(); }
 
+  // The caching mode of the video handler might have changed
+  virtual void updateSettings() Q_DECL_OVERRIDE { if (video) video->updateSettings(); }
+
   // Load the frame in the video item. Emit signalItemChanged(true,false) when done. Always called from a thread.
   virtual void loadFrame(int frameIdx, bool playing, bool loadRawData, bool emitSignals=true) Q_DECL_OVERRIDE;
 
@@ -34,6 +34,7 @@
 
 #include "playlistItemCompressedVideo.h"
 #include "playlistItemDifference.h"
+#include "playlistItemStatisticsBinaryFile.h"
 #include "playlistItemStatisticsCSVFile.h"
 #include "playlistItemStatisticsVTMBMSFile.h"
 #include "playlistItemImageFile.h"
@@ -0,0 +1,139 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "CSVStatisticsParser.h"
+
+#include <climits>
+#include <cstring>
+
+namespace CSVStatisticsParser
+{
+
+namespace
+{
+
+bool isSpace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+}
+
+const char *findNewline(const char *begin, const char *end)
+{
+  auto newline = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+  return (newline == nullptr) ? end : newline;
+}
+
+bool parseInt(const char *begin, const char *end, int &value)
+{
+  while (begin < end && isSpace(*begin))
+    begin++;
+  while (end > begin && isSpace(*(end - 1)))
+    end--;
+
+  bool negative = false;
+  if (begin < end && (*begin == '-' || *begin == '+'))
+  {
+    negative = (*begin == '-');
+    begin++;
+  }
+  if (begin == end)
+    return false;
+
+  int64_t v = 0;
+  for (const char *c = begin; c < end; c++)
+  {
+    const unsigned digit = unsigned(*c - '0');
+    if (digit > 9)
+      return false;
+    v = v * 10 + digit;
+    if (v > int64_t(INT_MAX) + 1)
+      return false;
+  }
+  if (negative)
+    v = -v;
+  if (v > INT_MAX)
+    return false;
+
+  value = int(v);
+  return true;
+}
+
+bool parseDataLine(const char *begin, const char *end, DataLine &line)
+{
+  while (begin < end && isSpace(*begin))
+    begin++;
+  if (begin == end || *begin == '%')
+    return false;
+
+  // POC, position, size, type and up to 4 values
+  int fields[10];
+  int nrFields = 0;
+  const char *fieldStart = begin;
+  while (nrFields < 10)
+  {
+    auto fieldEnd = static_cast<const char*>(std::memchr(fieldStart, ';', end - fieldStart));
+    if (fieldEnd == nullptr)
+      fieldEnd = end;
+    if (!parseInt(fieldStart, fieldEnd, fields[nrFields]))
+    {
+      // An empty last field (a delimiter at the end of the line) is ignored
+      const char *c = fieldStart;
+      while (c < fieldEnd && isSpace(*c))
+        c++;
+      if (c != fieldEnd || fieldEnd != end || nrFields == 0)
+        return false;
+      break;
+    }
+    nrFields++;
+    if (fieldEnd == end)
+      break;
+    fieldStart = fieldEnd + 1;
+  }
+  if (nrFields < 7)
+    return false;
+
+  line.poc = fields[0];
+  line.posX = fields[1];
+  line.posY = fields[2];
+  line.width = fields[3];
+  line.height = fields[4];
+  line.typeID = fields[5];
+  line.nrValues = nrFields - 6;
+  for (int i = 0; i < 4; i++)
+    line.values[i] = (i < line.nrValues) ? fields[6 + i] : 0;
+  return true;
+}
+
+} // namespace CSVStatisticsParser
@@ -0,0 +1,109 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <QByteArray>
+#include "filesource/FileSource.h"
+
+// Parsing of the data lines of CSV statistics files. The lines are parsed directly in the buffers that are read
+// from the file. No strings or lists are created per line.
+namespace CSVStatisticsParser
+{
+
+// The size of the blocks in which the file is read
+const int64_t ReadBufferSize = 4 * 1024 * 1024;
+
+// One data line of a statistics file: POC;posX;posY;width;height;typeID;value0[;value1[;value2;value3]]
+struct DataLine
+{
+  int poc;
+  int posX, posY;
+  int width, height;
+  int typeID;
+  int values[4];
+  int nrValues;
+};
+
+// Find the next newline character in [begin, end). Return end if there is none. The search is vectorized (memchr).
+const char *findNewline(const char *begin, const char *end);
+
+// Parse a decimal integer with an optional sign. Spaces, tabs and carriage returns around the number are ignored.
+// Return false if [begin, end) contains anything else or the number does not fit into an int.
+bool parseInt(const char *begin, const char *end, int &value);
+
+// Parse one line (without the newline character). Return false for empty lines, header/comment lines (starting
+// with '%') and lines that are no valid data lines.
+bool parseDataLine(const char *begin, const char *end, DataLine &line);
+
+// Read the file from startPos on and call onLine(const DataLine &line, int64_t lineStartPos) for every data line
+// in the file. Reading stops at the end of the file, if onLine returns false or if cancel is set.
+template<typename F>
+void readDataLines(FileSource &file, int64_t startPos, F onLine, const bool *cancel = nullptr, int64_t bufferSize = ReadBufferSize)
+{
+  QByteArray buffer;
+  DataLine line;
+  int64_t bufferStartPos = startPos;
+  while (cancel == nullptr || !*cancel)
+  {
+    const int64_t nrBytes = file.readBytes(buffer, bufferStartPos, bufferSize);
+    if (nrBytes <= 0)
+      return;
+    // Less bytes than requested were read or the buffer reaches the end of the file. This is the last buffer.
+    const bool fileAtEnd = nrBytes < bufferSize || bufferStartPos + nrBytes >= file.getFileSize();
+
+    const char *data = buffer.constData();
+    const char *end = data + nrBytes;
+    const char *lineStart = data;
+    while (lineStart < end)
+    {
+      const char *lineEnd = findNewline(lineStart, end);
+      if (lineEnd == end && !fileAtEnd)
+        // The line continues in the next buffer. The next buffer is read from the start of this line.
+        break;
+      if (parseDataLine(lineStart, lineEnd, line) && !onLine(line, bufferStartPos + (lineStart - data)))
+        return;
+      lineStart = lineEnd + 1;
+    }
+    if (fileAtEnd)
+      return;
+
+    if (lineStart == data)
+      // A line that is longer than the whole buffer. The file is probably corrupt. Skip the data.
+      lineStart = end;
+    bufferStartPos += lineStart - data;
+  }
+}
+
+} // namespace CSVStatisticsParser
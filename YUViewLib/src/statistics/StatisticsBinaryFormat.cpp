@@ -0,0 +1,378 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "StatisticsBinaryFormat.h"
+
+#include <cstring>
+#include <QDataStream>
+#include <QPen>
+
+namespace StatisticsBinaryFormat
+{
+
+namespace
+{
+
+// The start of each data chunk
+struct ChunkHeader
+{
+  uint32_t nrValueBlocks;
+  uint32_t nrVectorBlocks;
+  uint32_t nrAffineTFBlocks;
+  uint32_t nrPolygonValues;
+  uint32_t nrPolygonVectors;
+  uint32_t nrPolygonPoints;
+  uint32_t maxBlockSize;
+  int32_t maxVectorComponent;
+};
+
+// Append the array to the chunk. Every array starts at a multiple of 4 bytes.
+template<typename T>
+void appendArray(QByteArray &chunk, const T *data, int n)
+{
+  chunk.append(reinterpret_cast<const char*>(data), int(sizeof(T)) * n);
+  while (chunk.size() % 4 != 0)
+    chunk.append(char(0));
+}
+
+void appendPoints(QByteArray &chunk, const QVector<QPoint> &points)
+{
+  QVector<int32_t> coordinates;
+  coordinates.reserve(points.count() * 2);
+  for (const QPoint &p : points)
+  {
+    coordinates.append(p.x());
+    coordinates.append(p.y());
+  }
+  appendArray(chunk, coordinates.constData(), coordinates.count());
+}
+
+void appendBlocks(QByteArray &chunk, const statisticsBlockList &blocks)
+{
+  appendArray(chunk, blocks.posX.constData(), blocks.count());
+  appendArray(chunk, blocks.posY.constData(), blocks.count());
+  appendArray(chunk, blocks.width.constData(), blocks.count());
+  appendArray(chunk, blocks.height.constData(), blocks.count());
+}
+
+// Reads the arrays of a chunk in the order in which they were appended. Returns nullptr if the chunk is too short.
+class chunkReader
+{
+public:
+  chunkReader(const char *chunk, int64_t size) : pos(chunk), end(chunk + size) {}
+
+  template<typename T>
+  const T *takeArray(int64_t n)
+  {
+    const int64_t nrBytes = int64_t(sizeof(T)) * n;
+    const int64_t nrBytesPadded = (nrBytes + 3) / 4 * 4;
+    if (n < 0 || end - pos < nrBytesPadded)
+      return nullptr;
+    const char *data = pos;
+    pos += nrBytesPadded;
+    return reinterpret_cast<const T*>(data);
+  }
+
+  bool takePoints(int64_t n, QVector<QPoint> &points)
+  {
+    auto coordinates = takeArray<int32_t>(n * 2);
+    if (coordinates == nullptr)
+      return false;
+    points.resize(int(n));
+    for (int i = 0; i < n; i++)
+      points[i] = QPoint(coordinates[2*i], coordinates[2*i+1]);
+    return true;
+  }
+
+  bool takeBlocks(int64_t n, statisticsBlockList &blocks)
+  {
+    auto x = takeArray<unsigned short>(n);
+    auto y = takeArray<unsigned short>(n);
+    auto w = takeArray<unsigned short>(n);
+    auto h = takeArray<unsigned short>(n);
+    if (x == nullptr || y == nullptr || w == nullptr || h == nullptr)
+      return false;
+    blocks.setBlocks(x, y, w, h, int(n));
+    return true;
+  }
+
+private:
+  const char *pos;
+  const char *end;
+};
+
+}
+
+QByteArray encodeTypes(const QVector<StatisticsType> &types)
+{
+  QByteArray data;
+  QDataStream out(&data, QIODevice::WriteOnly);
+  out.setVersion(QDataStream::Qt_5_6);
+
+  out << qint32(types.count());
+  for (const StatisticsType &t : types)
+  {
+    out << qint32(t.typeID) << t.typeName << t.description << t.valMap;
+    out << t.render << qint32(t.alphaFactor);
+    out << t.hasValueData << t.renderValueData << t.scaleValueToBlockSize;
+    out << qint32(t.colMapper.type) << qint32(t.colMapper.rangeMin) << qint32(t.colMapper.rangeMax);
+    out << t.colMapper.minColor << t.colMapper.maxColor << t.colMapper.colorMap << t.colMapper.colorMapOther << t.colMapper.complexType;
+    out << t.hasVectorData << t.hasAffineTFData << t.renderVectorData << t.renderVectorDataValues << t.scaleVectorToZoom;
+    out << t.vectorPen << qint32(t.vectorScale) << t.mapVectorToColor << qint32(t.arrowHead);
+    out << t.renderGrid << t.gridPen << t.scaleGridToZoom << t.isPolygon;
+  }
+  return data;
+}
+
+bool decodeTypes(const QByteArray &data, QVector<StatisticsType> &types)
+{
+  QDataStream in(data);
+  in.setVersion(QDataStream::Qt_5_6);
+
+  qint32 nrTypes;
+  in >> nrTypes;
+  for (int i = 0; i < nrTypes && in.status() == QDataStream::Ok; i++)
+  {
+    StatisticsType t;
+    qint32 typeID, alphaFactor, mappingType, rangeMin, rangeMax, vectorScale, arrowHead;
+    in >> typeID >> t.typeName >> t.description >> t.valMap;
+    in >> t.render >> alphaFactor;
+    in >> t.hasValueData >> t.renderValueData >> t.scaleValueToBlockSize;
+    in >> mappingType >> rangeMin >> rangeMax;
+    in >> t.colMapper.minColor >> t.colMapper.maxColor >> t.colMapper.colorMap >> t.colMapper.colorMapOther >> t.colMapper.complexType;
+    in >> t.hasVectorData >> t.hasAffineTFData >> t.renderVectorData >> t.renderVectorDataValues >> t.scaleVectorToZoom;
+    in >> t.vectorPen >> vectorScale >> t.mapVectorToColor >> arrowHead;
+    in >> t.renderGrid >> t.gridPen >> t.scaleGridToZoom >> t.isPolygon;
+
+    t.typeID = typeID;
+    t.alphaFactor = alphaFactor;
+    t.colMapper.type = colorMapper::mappingType(mappingType);
+    t.colMapper.rangeMin = rangeMin;
+    t.colMapper.rangeMax = rangeMax;
+    t.vectorScale = vectorScale;
+    t.arrowHead = StatisticsType::arrowHead_t(arrowHead);
+    t.setInitialState();
+    types.append(t);
+  }
+  return in.status() == QDataStream::Ok;
+}
+
+QByteArray encodeData(const statisticsData &data)
+{
+  ChunkHeader header;
+  header.nrValueBlocks = data.valueBlocks.count();
+  header.nrVectorBlocks = data.vectorBlocks.count();
+  header.nrAffineTFBlocks = data.affineTFBlocks.count();
+  header.nrPolygonValues = data.polygonValueData.count();
+  header.nrPolygonVectors = data.polygonVectorData.count();
+  header.nrPolygonPoints = 0;
+  for (const statisticsItemPolygon_Value &v : data.polygonValueData)
+    header.nrPolygonPoints += v.corners.count();
+  for (const statisticsItemPolygon_Vector &v : data.polygonVectorData)
+    header.nrPolygonPoints += v.corners.count();
+  header.maxBlockSize = data.maxBlockSize;
+  header.maxVectorComponent = data.maxVectorComponent;
+
+  QByteArray chunk;
+  appendArray(chunk, &header, 1);
+
+  appendBlocks(chunk, data.valueBlocks);
+  appendArray(chunk, data.values.constData(), data.values.count());
+
+  appendBlocks(chunk, data.vectorBlocks);
+  appendPoints(chunk, data.vectorPoints0);
+  appendPoints(chunk, data.vectorPoints1);
+  QVector<uint8_t> isLine;
+  for (bool b : data.vectorIsLine)
+    isLine.append(b ? 1 : 0);
+  appendArray(chunk, isLine.constData(), isLine.count());
+
+  appendBlocks(chunk, data.affineTFBlocks);
+  appendPoints(chunk, data.affineTFPoints);
+
+  QVector<uint32_t> pointCounts;
+  QVector<int32_t> values;
+  QVector<QPoint> points;
+  for (const statisticsItemPolygon_Value &v : data.polygonValueData)
+  {
+    pointCounts.append(v.corners.count());
+    values.append(v.value);
+    points.append(v.corners);
+  }
+  appendArray(chunk, pointCounts.constData(), pointCounts.count());
+  appendArray(chunk, values.constData(), values.count());
+
+  pointCounts.clear();
+  QVector<QPoint> vectors;
+  for (const statisticsItemPolygon_Vector &v : data.polygonVectorData)
+  {
+    pointCounts.append(v.corners.count());
+    vectors.append(v.point[0]);
+    points.append(v.corners);
+  }
+  appendArray(chunk, pointCounts.constData(), pointCounts.count());
+  appendPoints(chunk, vectors);
+  appendPoints(chunk, points);
+
+  return chunk;
+}
+
+bool decodeData(const char *chunk, int64_t size, statisticsData &data)
+{
+  chunkReader reader(chunk, size);
+  auto headerData = reader.takeArray<ChunkHeader>(1);
+  if (headerData == nullptr)
+    return false;
+  ChunkHeader header;
+  std::memcpy(&header, headerData, sizeof(ChunkHeader));
+
+  if (!reader.takeBlocks(header.nrValueBlocks, data.valueBlocks))
+    return false;
+  auto values = reader.takeArray<int32_t>(header.nrValueBlocks);
+  if (values == nullptr)
+    return false;
+  data.values.resize(header.nrValueBlocks);
+  std::memcpy(data.values.data(), values, header.nrValueBlocks * sizeof(int32_t));
+
+  if (!reader.takeBlocks(header.nrVectorBlocks, data.vectorBlocks) ||
+      !reader.takePoints(header.nrVectorBlocks, data.vectorPoints0) ||
+      !reader.takePoints(header.nrVectorBlocks, data.vectorPoints1))
+    return false;
+  auto isLine = reader.takeArray<uint8_t>(header.nrVectorBlocks);
+  if (isLine == nullptr)
+    return false;
+  data.vectorIsLine.resize(header.nrVectorBlocks);
+  for (uint32_t i = 0; i < header.nrVectorBlocks; i++)
+    data.vectorIsLine[i] = (isLine[i] != 0);
+
+  if (!reader.takeBlocks(header.nrAffineTFBlocks, data.affineTFBlocks) ||
+      !reader.takePoints(int64_t(header.nrAffineTFBlocks) * 3, data.affineTFPoints))
+    return false;
+
+  auto polygonValueCounts = reader.takeArray<uint32_t>(header.nrPolygonValues);
+  auto polygonValues = reader.takeArray<int32_t>(header.nrPolygonValues);
+  auto polygonVectorCounts = reader.takeArray<uint32_t>(header.nrPolygonVectors);
+  QVector<QPoint> polygonVectors, polygonPoints;
+  if (polygonValueCounts == nullptr || polygonValues == nullptr || polygonVectorCounts == nullptr ||
+      !reader.takePoints(header.nrPolygonVectors, polygonVectors) || !reader.takePoints(header.nrPolygonPoints, polygonPoints))
+    return false;
+
+  int pointIdx = 0;
+  auto takePolygon = [&](uint32_t nrPoints, QPolygon &polygon)
+  {
+    if (pointIdx + int64_t(nrPoints) > polygonPoints.count())
+      return false;
+    polygon = QPolygon(polygonPoints.mid(pointIdx, nrPoints));
+    pointIdx += nrPoints;
+    return true;
+  };
+  for (uint32_t i = 0; i < header.nrPolygonValues; i++)
+  {
+    statisticsItemPolygon_Value v;
+    if (!takePolygon(polygonValueCounts[i], v.corners))
+      return false;
+    v.value = polygonValues[i];
+    data.polygonValueData.append(v);
+  }
+  for (uint32_t i = 0; i < header.nrPolygonVectors; i++)
+  {
+    statisticsItemPolygon_Vector v;
+    if (!takePolygon(polygonVectorCounts[i], v.corners))
+      return false;
+    v.point[0] = polygonVectors[i];
+    data.polygonVectorData.append(v);
+  }
+
+  data.maxBlockSize = header.maxBlockSize;
+  data.maxVectorComponent = header.maxVectorComponent;
+  return true;
+}
+
+bool Writer::open(const QString &filePath, QSize frameSize, double frameRate, const QVector<StatisticsType> &types)
+{
+  file.setFileName(filePath);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return false;
+
+  const QByteArray typeData = encodeTypes(types);
+  std::memcpy(header.magic, Magic, sizeof(Magic));
+  header.version = Version;
+  header.nrIndexEntries = 0;
+  header.frameWidth = frameSize.width();
+  header.frameHeight = frameSize.height();
+  header.frameRate = frameRate;
+  header.typesOffset = sizeof(FileHeader);
+  header.typesSize = typeData.size();
+  header.indexOffset = 0;
+  index.clear();
+
+  // The header is written again with the position of the index when the file is finished. The data chunks
+  // start at a multiple of 4 bytes so that the arrays in them are aligned.
+  const QByteArray padding((4 - typeData.size() % 4) % 4, char(0));
+  return file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader)) == sizeof(FileHeader) &&
+         file.write(typeData) == typeData.size() && file.write(padding) == padding.size();
+}
+
+bool Writer::addData(int poc, int typeID, const statisticsData &data)
+{
+  const QByteArray chunk = encodeData(data);
+  IndexEntry entry;
+  entry.poc = poc;
+  entry.typeID = typeID;
+  entry.offset = file.pos();
+  entry.size = chunk.size();
+  index.append(entry);
+  return file.write(chunk) == chunk.size();
+}
+
+bool Writer::finish()
+{
+  header.nrIndexEntries = index.count();
+  header.indexOffset = file.pos();
+  for (const IndexEntry &entry : index)
+    if (file.write(reinterpret_cast<const char*>(&entry), sizeof(IndexEntry)) != sizeof(IndexEntry))
+      return false;
+  if (!file.seek(0) || file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader)) != sizeof(FileHeader))
+    return false;
+  file.close();
+  return true;
+}
+
+void Writer::abort()
+{
+  // Removing the file also closes it
+  if (!file.fileName().isEmpty())
+    file.remove();
+}
+
+} // namespace StatisticsBinaryFormat
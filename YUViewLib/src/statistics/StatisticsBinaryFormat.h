@@ -0,0 +1,106 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QSize>
+#include <QVector>
+#include "statisticsExtensions.h"
+
+// A compact binary format for statistics files (*.yuvstats). It consists of:
+//  - The FileHeader
+//  - The definitions of all statistics types (serialized with QDataStream)
+//  - One data chunk for every POC/type. A chunk contains the blocks as fixed width arrays in the same layout as
+//    statisticsData (positions, sizes, values/vectors) so that it can be copied directly into a statisticsData.
+//  - The index: One IndexEntry per chunk.
+// All values are stored in the byte order of the machine that wrote the file so that the chunks can be used without
+// conversion. On a machine with a different byte order, the version in the header does not match and the file is rejected.
+// The data chunks start at a multiple of 4 bytes. All arrays in a chunk are padded to 4 bytes (the largest element size).
+namespace StatisticsBinaryFormat
+{
+
+const char Magic[8] = {'Y', 'U', 'V', 'S', 'T', 'A', 'T', 'S'};
+const uint32_t Version = 1;
+
+struct FileHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t nrIndexEntries;
+  int32_t frameWidth;
+  int32_t frameHeight;
+  double frameRate;
+  uint64_t typesOffset;
+  uint64_t typesSize;
+  uint64_t indexOffset;
+};
+static_assert(sizeof(FileHeader) == 56, "The FileHeader must not contain any padding");
+
+struct IndexEntry
+{
+  int32_t poc;
+  int32_t typeID;
+  uint64_t offset;
+  uint64_t size;
+};
+static_assert(sizeof(IndexEntry) == 24, "The IndexEntry must not contain any padding");
+
+// Serialize all information of the statistics types (not the state of the controls)
+QByteArray encodeTypes(const QVector<StatisticsType> &types);
+bool decodeTypes(const QByteArray &data, QVector<StatisticsType> &types);
+
+// Encode the statistics data of one POC/type into a chunk. Decode a chunk into the (empty) statisticsData.
+QByteArray encodeData(const statisticsData &data);
+bool decodeData(const char *chunk, int64_t size, statisticsData &data);
+
+// Write a binary statistics file. Call addData for every POC/type and finish when done.
+class Writer
+{
+public:
+  bool open(const QString &filePath, QSize frameSize, double frameRate, const QVector<StatisticsType> &types);
+  bool addData(int poc, int typeID, const statisticsData &data);
+  bool finish();
+  // Close and remove the (incomplete) file
+  void abort();
+
+private:
+  QFile file;
+  FileHeader header;
+  QList<IndexEntry> index;
+};
+
+} // namespace StatisticsBinaryFormat
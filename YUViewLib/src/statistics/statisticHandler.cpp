@@ -32,8 +32,10 @@
 
 #include "statisticHandler.h"
 
+#include <algorithm>
 #include <cmath>
 #include <QPainter>
+#include <QtConcurrent>
 #include <QtGlobal>
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
     #include <QPainterPath>
@@ -72,33 +74,12 @@ statisticHandler::statisticHandler()
 
 itemLoadingState statisticHandler::needsLoading(int frameIdx)
 {
-  if (frameIdx != statsCacheFrameIdx)
-  {
-    // New frame, but do we even render any statistics?
-    for (StatisticsType t : statsTypeList)
-      if(t.render)
-      {
-        // At least one statistic type is drawn. We need to load it.
-        DEBUG_STAT("statisticHandler::needsLoading %d LoadingNeeded", frameIdx);
-        return LoadingNeeded;
-      }
-  }
-
   QMutexLocker lock(&statsCacheAccessMutex);
-  // Check all the statistics. Do some need loading?
-  for (int i = statsTypeList.count() - 1; i >= 0; i--)
+  if (!isFrameCached(frameIdx))
   {
-    // If the statistics for this frame index were not loaded yet but will be rendered, load them now.
-    int typeIdx = statsTypeList[i].typeID;
-    if (statsTypeList[i].render)
-    {
-      if (!statsCache.contains(typeIdx))
-      {
-        // Return that loading is needed before we can render the statitics.
-        DEBUG_STAT("statisticHandler::needsLoading %d LoadingNeeded", frameIdx);
-        return LoadingNeeded;
-      }
-    }
+    // Return that loading is needed before we can render the statitics.
+    DEBUG_STAT("statisticHandler::needsLoading %d LoadingNeeded", frameIdx);
+    return LoadingNeeded;
   }
 
   // Everything needed for drawing is loaded
@@ -106,35 +87,144 @@ itemLoadingState statisticHandler::needsLoading(int frameIdx)
   return LoadingNotNeeded;
 }
 
+bool statisticHandler::isFrameCached(int frameIdx) const
+{
+  const QHash<int, statisticsData> *frameData = nullptr;
+  if (frameIdx == statsCacheFrameIdx)
+    frameData = &statsCache;
+  else
+  {
+    auto it = statsFrameCache.constFind(frameIdx);
+    if (it != statsFrameCache.constEnd())
+      frameData = &it.value();
+  }
+
+  // Check all the statistics. Do some need loading? If no statistics are rendered, nothing has to be loaded.
+  for (const StatisticsType &t : statsTypeList)
+    if (t.render && (frameData == nullptr || !frameData->contains(t.typeID)))
+      return false;
+  return true;
+}
+
 void statisticHandler::loadStatistics(int frameIdx)
 {
   DEBUG_STAT("statisticHandler::loadStatistics frame %d", frameIdx);
 
+  loadMissingStatistics(frameIdx);
+
+  QMutexLocker lock(&statsCacheAccessMutex);
+  setCurrentCacheFrame(frameIdx);
+}
+
+int statisticHandler::getNextFrameToPrefetch(int frameIdx, int lastFrameIdx)
+{
   QMutexLocker lock(&statsCacheAccessMutex);
-  if (frameIdx != statsCacheFrameIdx)
-    // New frame to draw. Clear the cache.
-    statsCache.clear();
+  for (int i = frameIdx + 1; i <= std::min(frameIdx + STATISTICS_PREFETCH_FRAMES, lastFrameIdx); i++)
+    if (!isFrameCached(i))
+      return i;
+  return -1;
+}
 
-  // Request all the data for the statistics (that were not already loaded to the local cache)
-  int statTypeRenderCount = 0;
-  for (int i = statsTypeList.count() - 1; i >= 0; i--)
+void statisticHandler::prefetchStatistics(int frameIdx)
+{
+  DEBUG_STAT("statisticHandler::prefetchStatistics frame %d", frameIdx);
+  loadMissingStatistics(frameIdx);
+
+  QMutexLocker lock(&statsCacheAccessMutex);
+  trimFrameCache();
+}
+
+void statisticHandler::loadMissingStatistics(int frameIdx)
+{
+  // Get all the statistics that will be rendered but that were not loaded to the cache yet
+  QList<QPair<int, QHash<int, statisticsData>>> typeLoads;
   {
-    // If the statistics for this frame index were not loaded yet but will be rendered, load them now.
-    int typeIdx = statsTypeList[i].typeID;
-    if (statsTypeList[i].render)
+    QMutexLocker lock(&statsCacheAccessMutex);
+    const QHash<int, statisticsData> frameData = (frameIdx == statsCacheFrameIdx) ? statsCache : statsFrameCache.value(frameIdx);
+    for (int i = statsTypeList.count() - 1; i >= 0; i--)
+      if (statsTypeList[i].render && !frameData.contains(statsTypeList[i].typeID))
+        typeLoads.append(qMakePair(statsTypeList[i].typeID, QHash<int, statisticsData>()));
+  }
+  if (typeLoads.isEmpty())
+    return;
+
+  // Load the statistics without holding the lock so that the current frame can still be drawn in the meantime.
+  // Every type is loaded into its own cache so that the types can be loaded in parallel.
+  auto loadType = [this, frameIdx](QPair<int, QHash<int, statisticsData>> &typeLoad)
+  {
+    emit requestStatisticsLoading(frameIdx, typeLoad.first, typeLoad.second);
+  };
+  if (parallelTypeLoading && typeLoads.count() > 1)
+    QtConcurrent::blockingMap(typeLoads, loadType);
+  else
+  {
+    // A loader may load more than the requested type (e.g. if all types of a frame are interleaved in a file).
+    // Skip the types that were already loaded.
+    for (int i = 0; i < typeLoads.count(); i++)
     {
-      statTypeRenderCount++;
-      if (!statsCache.contains(typeIdx))
-        // Load the statistics
-        emit requestStatisticsLoading(frameIdx, typeIdx);
+      bool alreadyLoaded = false;
+      for (int j = 0; j < i; j++)
+        if (typeLoads[j].second.contains(typeLoads[i].first))
+          alreadyLoaded = true;
+      if (!alreadyLoaded)
+        loadType(typeLoads[i]);
     }
   }
 
+  QMutexLocker lock(&statsCacheAccessMutex);
+  QHash<int, statisticsData> &frameData = (frameIdx == statsCacheFrameIdx) ? statsCache : statsFrameCache[frameIdx];
+  for (const auto &typeLoad : typeLoads)
+    for (auto it = typeLoad.second.constBegin(); it != typeLoad.second.constEnd(); it++)
+      if (!frameData.contains(it.key()))
+        frameData.insert(it.key(), it.value());
+  if (frameIdx == statsCacheFrameIdx)
+    // The data in the cache changed. Draw the level of detail image again.
+    lodTile.frameIdx = -1;
+}
+
+void statisticHandler::trimFrameCache()
+{
+  // Drop the frames that are the furthest behind the current frame first. Then drop the ones that are the furthest ahead.
+  while (statsFrameCache.count() > STATISTICS_CACHE_FRAMES)
+  {
+    if (statsFrameCache.firstKey() < statsCacheFrameIdx)
+      statsFrameCache.remove(statsFrameCache.firstKey());
+    else
+      statsFrameCache.remove(statsFrameCache.lastKey());
+  }
+}
+
+void statisticHandler::setCurrentCacheFrame(int frameIdx)
+{
+  if (frameIdx == statsCacheFrameIdx)
+    return;
+
+  // Keep the data of the previous frame. It is dropped from statsFrameCache when loading other frames.
+  if (statsCacheFrameIdx != -1)
+    statsFrameCache.insert(statsCacheFrameIdx, statsCache);
+  statsCache = statsFrameCache.take(frameIdx);
   statsCacheFrameIdx = frameIdx;
+  lodTile.frameIdx = -1;
+  trimFrameCache();
+}
+
+void statisticHandler::clearStatisticsCache()
+{
+  QMutexLocker lock(&statsCacheAccessMutex);
+  statsCache.clear();
+  statsFrameCache.clear();
+  statsCacheFrameIdx = -1;
+  lodTile.frameIdx = -1;
 }
 
 void statisticHandler::paintStatistics(QPainter *painter, int frameIdx, double zoomFactor)
 {
+  {
+    QMutexLocker lock(&statsCacheAccessMutex);
+    if (statsCacheFrameIdx != frameIdx && statsFrameCache.contains(frameIdx))
+      // The statistics of this frame were prefetched (or shown before)
+      setCurrentCacheFrame(frameIdx);
+  }
   if (statsCacheFrameIdx != frameIdx)
     // If the internal statistics cache is not up to date, do not display the statistics.
     // The statistics for the new frame index should be loading the background.
@@ -156,6 +246,12 @@ void statisticHandler::paintStatistics(QPainter *painter, int frameIdx, double z
   int xMax = statRect.width() / 2 - (worldTransform.dx() - viewport.width());
   int yMax = statRect.height() / 2 - (worldTransform.dy() - viewport.height());
 
+  // The visible area in samples of the frame. Only the blocks in this area are looked at. The margin makes sure that
+  // the values next to blocks and the arrow heads are drawn even if the block itself is just outside of the viewport.
+  const int areaMargin = 64;
+  const QRect visibleArea(QPoint(int(floor((xMin - areaMargin) / zoomFactor)), int(floor((yMin - areaMargin) / zoomFactor))),
+                          QPoint(int(ceil((xMax + areaMargin) / zoomFactor)), int(ceil((yMax + areaMargin) / zoomFactor))));
+
   painter->translate(statRect.topLeft());
 
   // First, get if more than one statistic that has block values is rendered.
@@ -183,31 +279,36 @@ void statisticHandler::paintStatistics(QPainter *painter, int frameIdx, double z
   QList<QPoint> drawStatPoints;       // The positions of each value
   QList<QStringList> drawStatTexts;   // For each point: The values to draw
   double maxLineWidth = 0.0;          // Also get the maximum width of the lines that is drawn. This will be used as an offset.
-  for (int i = statsTypeList.count() - 1; i >= 0; i--)
+  const bool drawLOD = zoomFactor < STATISTICS_LOD_ZOOM;
+  if (drawLOD)
+    // Most blocks are smaller than a pixel. Draw the values and grids of all types as one image.
+    paintStatisticsTile(painter, frameIdx, zoomFactor, visibleArea, QRect(QPoint(xMin, yMin), QPoint(xMax, yMax)));
+  for (int i = statsTypeList.count() - 1; i >= 0 && !drawLOD; i--)
   {
     int typeIdx = statsTypeList[i].typeID;
     if (!statsTypeList[i].render || !statsCache.contains(typeIdx))
       // This statistics type is not rendered or could not be loaded.
       continue;
 
-    // Go through all the value data
-    for (const statisticsItem_Value &valueItem : statsCache[typeIdx].valueData)
+    // Go through all the value data in the visible area
+    const statisticsData &data = statsCache[typeIdx];
+    data.valueBlocks.forEachBlockIn(visibleArea, [&](int b)
     {
       // Calculate the size and position of the rectangle to draw (zoomed in)
-      QRect rect = QRect(valueItem.pos[0], valueItem.pos[1], valueItem.size[0], valueItem.size[1]);
+      QRect rect = data.valueBlocks.getRect(b);
       QRect displayRect = QRect(rect.left()*zoomFactor, rect.top()*zoomFactor, rect.width()*zoomFactor, rect.height()*zoomFactor);
       // Check if the rectangle of the statistics item is even visible
       bool rectVisible = (!(displayRect.left() > xMax || displayRect.right() < xMin || displayRect.top() > yMax || displayRect.bottom() < yMin));
 
       if (rectVisible)
       {
-        int value = valueItem.value; // This value determines the color for this item
+        int value = data.values[b]; // This value determines the color for this item
         if (statsTypeList[i].renderValueData)
         {
           // Get the right color for the item and draw it.
           QColor rectColor;
           if (statsTypeList[i].scaleValueToBlockSize)
-            rectColor = statsTypeList[i].colMapper.getColor(float(value) / (valueItem.size[0] * valueItem.size[1]));
+            rectColor = statsTypeList[i].colMapper.getColor(float(value) / (rect.width() * rect.height()));
           else
             rectColor = statsTypeList[i].colMapper.getColor(value);
           rectColor.setAlpha(rectColor.alpha()*((float)statsTypeList[i].alphaFactor / 100.0));
@@ -237,7 +338,7 @@ void statisticHandler::paintStatistics(QPainter *painter, int frameIdx, double z
         {
           QString valTxt  = statsTypeList[i].getValueTxt(value);
           if (!statsTypeList[i].valMap.contains(value) && statsTypeList[i].scaleValueToBlockSize)
-            valTxt = QString("%1").arg(float(value) / (valueItem.size[0] * valueItem.size[1]));
+            valTxt = QString("%1").arg(float(value) / (rect.width() * rect.height()));
 
           QString typeTxt = statsTypeList[i].typeName;
           QString statTxt = moreThanOneBlockStatRendered ? typeTxt + ":" + valTxt : valTxt;
@@ -254,7 +355,7 @@ void statisticHandler::paintStatistics(QPainter *painter, int frameIdx, double z
             drawStatTexts[i].append(statTxt);
         }
       }
-    }
+    });
   }
 
   // Draw all the polygon value types. Also, if the zoom factor is larger than STATISTICS_DRAW_VALUES_ZOOM,
@@ -365,11 +466,20 @@ void statisticHandler::paintStatistics(QPainter *painter, int frameIdx, double z
       // This statistics type is not rendered or could not be loaded.
       continue;
 
-    // Go through all the vector data
-    for (const statisticsItem_Vector &vectorItem : statsCache[typeIdx].vectorData)
+    // Go through all the vector data in the visible area. A vector can be visible even if its block is not.
+    const statisticsData &data = statsCache[typeIdx];
+    const QRect vectorArea = visibleArea.adjusted(-data.maxVectorComponent, -data.maxVectorComponent, data.maxVectorComponent, data.maxVectorComponent);
+    if (drawLOD)
+    {
+      // Draw one averaged vector per bin instead of all vectors. The grids were already drawn into the image.
+      paintVectorsBinned(painter, i, data, zoomFactor, vectorArea, xMin, xMax, yMin, yMax);
+      continue;
+    }
+
+    data.vectorBlocks.forEachBlockIn(vectorArea, [&](int b)
     {
       // Calculate the size and position of the rectangle to draw (zoomed in)
-      const QRect rect = QRect(vectorItem.pos[0], vectorItem.pos[1], vectorItem.size[0], vectorItem.size[1]);
+      const QRect rect = data.vectorBlocks.getRect(b);
       const QRect displayRect = QRect(rect.left()*zoomFactor, rect.top()*zoomFactor, rect.width()*zoomFactor, rect.height()*zoomFactor);
       
       if (statsTypeList[i].renderVectorData)
@@ -377,12 +487,12 @@ void statisticHandler::paintStatistics(QPainter *painter, int frameIdx, double z
         // Calculate the start and end point of the arrow. The vector starts at center of the block.
         int x1,y1,x2,y2;
         float vx, vy;
-        if (vectorItem.isLine)
+        if (data.vectorIsLine[b])
         {
-          x1 = displayRect.left() + zoomFactor*vectorItem.point[0].x();
-          y1 = displayRect.top() + zoomFactor*vectorItem.point[0].y();
-          x2 = displayRect.left() + zoomFactor*vectorItem.point[1].x();
-          y2 = displayRect.top() + zoomFactor*vectorItem.point[1].y();
+          x1 = displayRect.left() + zoomFactor*data.vectorPoints0[b].x();
+          y1 = displayRect.top() + zoomFactor*data.vectorPoints0[b].y();
+          x2 = displayRect.left() + zoomFactor*data.vectorPoints1[b].x();
+          y2 = displayRect.top() + zoomFactor*data.vectorPoints1[b].y();
           vx = (float)(x2-x1) / statsTypeList[i].vectorScale;
           vy = (float)(y2-y1) / statsTypeList[i].vectorScale;
         }
@@ -392,8 +502,8 @@ void statisticHandler::paintStatistics(QPainter *painter, int frameIdx, double z
           y1 = displayRect.top() + displayRect.height() / 2;
 
           // The length of the vector
-          vx = (float)vectorItem.point[0].x() / statsTypeList[i].vectorScale;
-          vy = (float)vectorItem.point[0].y() / statsTypeList[i].vectorScale;
+          vx = (float)data.vectorPoints0[b].x() / statsTypeList[i].vectorScale;
+          vy = (float)data.vectorPoints0[b].y() / statsTypeList[i].vectorScale;
 
           // The end point of the vector
           x2 = x1 + zoomFactor * vx;
@@ -413,7 +523,7 @@ void statisticHandler::paintStatistics(QPainter *painter, int frameIdx, double z
           vectorPen.setColor(arrowColor);
           if (statsTypeList[i].scaleVectorToZoom)
             vectorPen.setWidthF(vectorPen.widthF() * zoomFactor / 8);
-          if (vectorItem.isLine)
+          if (data.vectorIsLine[b])
               vectorPen.setCapStyle(Qt::RoundCap);
           painter->setPen(vectorPen);
           painter->setBrush(arrowColor);
@@ -467,7 +577,7 @@ void statisticHandler::paintStatistics(QPainter *painter, int frameIdx, double z
 
             if (zoomFactor >= STATISTICS_DRAW_VALUES_ZOOM && statsTypeList[i].renderVectorDataValues)
             {
-              if (vectorItem.isLine)
+              if (data.vectorIsLine[b])
               {
                 // if we just draw a line, we want to simply see the coordinate pairs
                 QString txt1 = QString("(%1, %2)").arg(x1/zoomFactor).arg(y1/zoomFactor);
@@ -550,13 +660,13 @@ void statisticHandler::paintStatistics(QPainter *painter, int frameIdx, double z
           painter->drawRect(displayRect);
         }
       }
-    }
+    });
 
     // Go through all the affine transform data
-    for (const statisticsItem_AffineTF &affineTFItem : statsCache[typeIdx].affineTFData)
+    data.affineTFBlocks.forEachBlockIn(vectorArea, [&](int b)
     {
       // Calculate the size and position of the rectangle to draw (zoomed in)
-      const QRect rect = QRect(affineTFItem.pos[0], affineTFItem.pos[1], affineTFItem.size[0], affineTFItem.size[1]);
+      const QRect rect = data.affineTFBlocks.getRect(b);
       const QRect displayRect = QRect(rect.left()*zoomFactor, rect.top()*zoomFactor, rect.width()*zoomFactor, rect.height()*zoomFactor);
       // Check if the rectangle of the statistics item is even visible
       const bool rectVisible = (!(displayRect.left() > xMax || displayRect.right() < xMin || displayRect.top() > yMax || displayRect.bottom() < yMin));
@@ -579,12 +689,12 @@ void statisticHandler::paintStatistics(QPainter *painter, int frameIdx, double z
           yLBstart = displayRect.bottom();
 
           // The length of the vectors
-          vxLT = (float)affineTFItem.point[0].x() / statsTypeList[i].vectorScale;
-          vyLT = (float)affineTFItem.point[0].y() / statsTypeList[i].vectorScale;
-          vxRT = (float)affineTFItem.point[1].x() / statsTypeList[i].vectorScale;
-          vyRT = (float)affineTFItem.point[1].y() / statsTypeList[i].vectorScale;
-          vxLB = (float)affineTFItem.point[2].x() / statsTypeList[i].vectorScale;
-          vyLB = (float)affineTFItem.point[2].y() / statsTypeList[i].vectorScale;
+          vxLT = (float)data.affineTFPoints[3*b+0].x() / statsTypeList[i].vectorScale;
+          vyLT = (float)data.affineTFPoints[3*b+0].y() / statsTypeList[i].vectorScale;
+          vxRT = (float)data.affineTFPoints[3*b+1].x() / statsTypeList[i].vectorScale;
+          vyRT = (float)data.affineTFPoints[3*b+1].y() / statsTypeList[i].vectorScale;
+          vxLB = (float)data.affineTFPoints[3*b+2].x() / statsTypeList[i].vectorScale;
+          vyLB = (float)data.affineTFPoints[3*b+2].y() / statsTypeList[i].vectorScale;
 
           // The end point of the vectors
           xLTend = xLTstart + zoomFactor * vxLT;
@@ -613,7 +723,7 @@ void statisticHandler::paintStatistics(QPainter *painter, int frameIdx, double z
           painter->drawRect(displayRect);
         }
       }
-    }
+    });
   }
   
   // Draw all polygon vector data
@@ -908,6 +1018,232 @@ void statisticHandler::paintVector(QPainter *painter, const int& statTypeIdx, co
   }
 }
 
+namespace
+{
+
+// Fill the pixels [x0, x1) x [y0, y1) of the image with the color. The area is clipped to the image.
+void fillImageRect(QImage &image, int x0, int y0, int x1, int y1, QRgb color)
+{
+  x0 = std::max(x0, 0);
+  y0 = std::max(y0, 0);
+  x1 = std::min(x1, image.width());
+  y1 = std::min(y1, image.height());
+  for (int y = y0; y < y1; y++)
+  {
+    QRgb *line = reinterpret_cast<QRgb*>(image.scanLine(y));
+    std::fill(line + x0, line + x1, color);
+  }
+}
+
+}
+
+bool statisticHandler::lodTileLayer::operator==(const lodTileLayer &other) const
+{
+  return typeIdx == other.typeIdx && alphaFactor == other.alphaFactor && renderValueData == other.renderValueData &&
+         scaleValueToBlockSize == other.scaleValueToBlockSize && !(colMapper != other.colMapper) &&
+         renderGrid == other.renderGrid && gridColor == other.gridColor &&
+         valueBlockCount == other.valueBlockCount && gridBlockCount == other.gridBlockCount;
+}
+
+void statisticHandler::paintStatisticsTile(QPainter *painter, int frameIdx, double zoomFactor, const QRect &visibleArea, const QRect &displayArea)
+{
+  const QRect tileRect = displayArea.intersected(QRect(QPoint(0,0), statFrameSize * zoomFactor));
+  if (tileRect.isEmpty())
+    return;
+
+  // Collect everything that is drawn into the image. If nothing changed, the last image can be drawn again.
+  QList<lodTileLayer> layers;
+  for (int i = statsTypeList.count() - 1; i >= 0; i--)
+  {
+    const StatisticsType &type = statsTypeList[i];
+    if (!type.render || !statsCache.contains(type.typeID))
+      continue;
+
+    const statisticsData &data = statsCache[type.typeID];
+    lodTileLayer layer;
+    layer.typeIdx = i;
+    layer.alphaFactor = type.alphaFactor;
+    layer.renderValueData = type.renderValueData;
+    layer.scaleValueToBlockSize = type.scaleValueToBlockSize;
+    layer.colMapper = type.colMapper;
+    layer.renderGrid = type.renderGrid;
+    layer.gridColor = type.gridPen.color();
+    layer.valueBlockCount = (type.renderValueData || type.renderGrid) ? data.valueBlocks.count() : 0;
+    layer.gridBlockCount = type.renderGrid ? data.vectorBlocks.count() + data.affineTFBlocks.count() : 0;
+    if (layer.valueBlockCount > 0 || layer.gridBlockCount > 0)
+      layers.append(layer);
+  }
+  if (layers.isEmpty())
+    return;
+
+  if (lodTile.frameIdx != frameIdx || lodTile.zoomFactor != zoomFactor || lodTile.rect != tileRect || !(lodTile.layers == layers))
+  {
+    lodTile.image = QImage(tileRect.size(), QImage::Format_ARGB32_Premultiplied);
+    lodTile.image.fill(Qt::transparent);
+
+    // Each type is drawn into its own layer which is then blended onto the image. Every block covers at least one
+    // pixel. If multiple blocks fall into the same pixel, the last one determines the color of the pixel.
+    QImage layerImage;
+    if (layers.count() > 1)
+      layerImage = QImage(tileRect.size(), QImage::Format_ARGB32_Premultiplied);
+    QPainter tilePainter(&lodTile.image);
+    for (const lodTileLayer &layer : layers)
+    {
+      StatisticsType &type = statsTypeList[layer.typeIdx];
+      const statisticsData &data = statsCache[type.typeID];
+      QImage &target = (layers.count() > 1) ? layerImage : lodTile.image;
+      if (layers.count() > 1)
+        layerImage.fill(Qt::transparent);
+
+      QColor gridColor = layer.gridColor;
+      gridColor.setAlpha(gridColor.alpha()*((float)layer.alphaFactor / 100.0));
+      const QRgb gridRgb = qPremultiply(gridColor.rgba());
+
+      auto drawBlock = [&](const QRect &rect, const QColor *fillColor)
+      {
+        const int x0 = int(floor(rect.left() * zoomFactor)) - tileRect.left();
+        const int y0 = int(floor(rect.top() * zoomFactor)) - tileRect.top();
+        const int x1 = std::max(int(floor((rect.left() + rect.width()) * zoomFactor)) - tileRect.left(), x0 + 1);
+        const int y1 = std::max(int(floor((rect.top() + rect.height()) * zoomFactor)) - tileRect.top(), y0 + 1);
+        if (fillColor)
+          fillImageRect(target, x0, y0, x1, y1, qPremultiply(fillColor->rgba()));
+        if (layer.renderGrid)
+        {
+          // Only the top and left border of each block. The neighboring blocks draw the other borders.
+          fillImageRect(target, x0, y0, x1, y0 + 1, gridRgb);
+          fillImageRect(target, x0, y0, x0 + 1, y1, gridRgb);
+        }
+      };
+
+      if (layer.valueBlockCount > 0)
+        data.valueBlocks.forEachBlockIn(visibleArea, [&](int b)
+        {
+          const QRect rect = data.valueBlocks.getRect(b);
+          if (!layer.renderValueData)
+          {
+            drawBlock(rect, nullptr);
+            return;
+          }
+          const int value = data.values[b];
+          QColor rectColor;
+          if (layer.scaleValueToBlockSize)
+            rectColor = type.colMapper.getColor(float(value) / (rect.width() * rect.height()));
+          else
+            rectColor = type.colMapper.getColor(value);
+          rectColor.setAlpha(rectColor.alpha()*((float)layer.alphaFactor / 100.0));
+          drawBlock(rect, &rectColor);
+        });
+      if (layer.gridBlockCount > 0)
+      {
+        data.vectorBlocks.forEachBlockIn(visibleArea, [&](int b) { drawBlock(data.vectorBlocks.getRect(b), nullptr); });
+        data.affineTFBlocks.forEachBlockIn(visibleArea, [&](int b) { drawBlock(data.affineTFBlocks.getRect(b), nullptr); });
+      }
+
+      if (layers.count() > 1)
+        tilePainter.drawImage(0, 0, layerImage);
+    }
+
+    lodTile.rect = tileRect;
+    lodTile.frameIdx = frameIdx;
+    lodTile.zoomFactor = zoomFactor;
+    lodTile.layers = layers;
+  }
+
+  painter->drawImage(tileRect.topLeft(), lodTile.image);
+}
+
+void statisticHandler::paintVectorsBinned(QPainter *painter, int statTypeIdx, const statisticsData &data, double zoomFactor, const QRect &vectorArea,
+                                          const int &xMin, const int &xMax, const int &yMin, const int &yMax)
+{
+  if (!statsTypeList[statTypeIdx].renderVectorData)
+    return;
+
+  // The sum of all vectors that start in the bin. Of the lines, only the first one in each bin is drawn.
+  struct vectorBin
+  {
+    float sumX {0};
+    float sumY {0};
+    int count {0};
+    bool hasLine {false};
+    QPoint lineStart, lineEnd;
+  };
+  const int binSize = STATISTICS_LOD_VECTOR_BIN_SIZE;
+  const int binsX = (xMax - xMin) / binSize + 1;
+  const int binsY = (yMax - yMin) / binSize + 1;
+  QVector<vectorBin> bins(binsX * binsY);
+
+  auto getBin = [&](const QRect &rect) -> vectorBin*
+  {
+    const int cx = int((rect.left() + rect.width() / 2.0) * zoomFactor) - xMin;
+    const int cy = int((rect.top() + rect.height() / 2.0) * zoomFactor) - yMin;
+    if (cx < 0 || cy < 0 || cx / binSize >= binsX || cy / binSize >= binsY)
+      return nullptr;
+    return &bins[(cy / binSize) * binsX + cx / binSize];
+  };
+
+  data.vectorBlocks.forEachBlockIn(vectorArea, [&](int b)
+  {
+    const QRect rect = data.vectorBlocks.getRect(b);
+    vectorBin *bin = getBin(rect);
+    if (bin == nullptr)
+      return;
+    if (data.vectorIsLine[b])
+    {
+      if (!bin->hasLine)
+      {
+        bin->hasLine = true;
+        bin->lineStart = QPoint(rect.left() * zoomFactor + zoomFactor * data.vectorPoints0[b].x(), rect.top() * zoomFactor + zoomFactor * data.vectorPoints0[b].y());
+        bin->lineEnd = QPoint(rect.left() * zoomFactor + zoomFactor * data.vectorPoints1[b].x(), rect.top() * zoomFactor + zoomFactor * data.vectorPoints1[b].y());
+      }
+    }
+    else
+    {
+      bin->sumX += data.vectorPoints0[b].x();
+      bin->sumY += data.vectorPoints0[b].y();
+      bin->count++;
+    }
+  });
+
+  // For the affine transforms, the mean of the three control point vectors is used
+  data.affineTFBlocks.forEachBlockIn(vectorArea, [&](int b)
+  {
+    vectorBin *bin = getBin(data.affineTFBlocks.getRect(b));
+    if (bin == nullptr)
+      return;
+    for (int k = 0; k < 3; k++)
+    {
+      bin->sumX += data.affineTFPoints[3*b+k].x() / 3.0f;
+      bin->sumY += data.affineTFPoints[3*b+k].y() / 3.0f;
+    }
+    bin->count++;
+  });
+
+  const int vectorScale = statsTypeList[statTypeIdx].vectorScale;
+  for (int by = 0; by < binsY; by++)
+  {
+    for (int bx = 0; bx < binsX; bx++)
+    {
+      const vectorBin &bin = bins[by * binsX + bx];
+      if (bin.hasLine)
+      {
+        const QPoint &p1 = bin.lineStart;
+        const QPoint &p2 = bin.lineEnd;
+        paintVector(painter, statTypeIdx, zoomFactor, p1.x(), p1.y(), p2.x(), p2.y(),
+                    (float)(p2.x() - p1.x()) / vectorScale, (float)(p2.y() - p1.y()) / vectorScale, true, xMin, xMax, yMin, yMax);
+      }
+      if (bin.count > 0)
+      {
+        // The averaged vector starts at the center of the bin
+        const float vx = bin.sumX / bin.count / vectorScale;
+        const float vy = bin.sumY / bin.count / vectorScale;
+        const int x1 = xMin + bx * binSize + binSize / 2;
+        const int y1 = yMin + by * binSize + binSize / 2;
+        paintVector(painter, statTypeIdx, zoomFactor, x1, y1, x1 + zoomFactor * vx, y1 + zoomFactor * vy, vx, vy, false, xMin, xMax, yMin, yMax);
+      }
+    }
+  }
+}
+
 
 StatisticsType* statisticHandler::getStatisticsType(int typeID)
 {
@@ -926,6 +1262,8 @@ QStringPairList statisticHandler::getValuesAt(const QPoint &pos)
 {
   QStringPairList valueList;
 
+  QMutexLocker lock(&statsCacheAccessMutex);
+  const QRect posArea(pos, QSize(1, 1));
   for (int i = 0; i<statsTypeList.count(); i++)
   {
     if (statsTypeList[i].render)  // only show active values
@@ -935,44 +1273,38 @@ QStringPairList statisticHandler::getValuesAt(const QPoint &pos)
         continue;
 
       const StatisticsType* aType = getStatisticsType(typeID);
+      const statisticsData &data = statsCache[typeID];
 
       // Get all value data entries
       bool foundStats = false;
-      for (const statisticsItem_Value &valueItem : statsCache[typeID].valueData)
+      data.valueBlocks.forEachBlockIn(posArea, [&](int b)
+      {
+        QRect rect = data.valueBlocks.getRect(b);
+        int value = data.values[b];
+        QString valTxt  = statsTypeList[i].getValueTxt(value);
+        if (!statsTypeList[i].valMap.contains(value) && statsTypeList[i].scaleValueToBlockSize)
+          valTxt = QString("%1").arg(float(value) / (rect.width() * rect.height()));
+        valueList.append(QStringPair(aType->typeName, valTxt));
+        foundStats = true;
+      });
+
+      data.vectorBlocks.forEachBlockIn(posArea, [&](int b)
       {
-        QRect rect = QRect(valueItem.pos[0], valueItem.pos[1], valueItem.size[0], valueItem.size[1]);
-        if (rect.contains(pos))
+        float vectorValue1, vectorValue2;
+        if (data.vectorIsLine[b])
         {
-          int value = valueItem.value;
-          QString valTxt  = statsTypeList[i].getValueTxt(value);
-          if (!statsTypeList[i].valMap.contains(value) && statsTypeList[i].scaleValueToBlockSize)
-            valTxt = QString("%1").arg(float(value) / (valueItem.size[0] * valueItem.size[1]));
-          valueList.append(QStringPair(aType->typeName, valTxt));
-          foundStats = true;
+          vectorValue1 = (float)(data.vectorPoints1[b].x() - data.vectorPoints0[b].x()) / statsTypeList[i].vectorScale;
+          vectorValue2 = (float)(data.vectorPoints1[b].y() - data.vectorPoints0[b].y()) / statsTypeList[i].vectorScale;
         }
-      }
-
-      for (const statisticsItem_Vector &vectorItem : statsCache[typeID].vectorData)
-      {
-        QRect rect = QRect(vectorItem.pos[0], vectorItem.pos[1], vectorItem.size[0], vectorItem.size[1]);
-        if (rect.contains(pos))
+        else
         {
-          float vectorValue1, vectorValue2;
-          if (vectorItem.isLine)
-          {
-           vectorValue1 = (float)(vectorItem.point[1].x() - vectorItem.point[0].x()) / statsTypeList[i].vectorScale;
-           vectorValue2 = (float)(vectorItem.point[1].y() - vectorItem.point[0].y()) / statsTypeList[i].vectorScale;
-          }
-          else
-          {
-            vectorValue1 = (float)vectorItem.point[0].x() / statsTypeList[i].vectorScale;
-            vectorValue2 = (float)vectorItem.point[0].y() / statsTypeList[i].vectorScale;
-          }
-          valueList.append(QStringPair(QString("%1[x]").arg(aType->typeName), QString::number(vectorValue1)));
-          valueList.append(QStringPair(QString("%1[y]").arg(aType->typeName), QString::number(vectorValue2)));
-          foundStats = true;
+          vectorValue1 = (float)data.vectorPoints0[b].x() / statsTypeList[i].vectorScale;
+          vectorValue2 = (float)data.vectorPoints0[b].y() / statsTypeList[i].vectorScale;
         }
-      }
+        valueList.append(QStringPair(QString("%1[x]").arg(aType->typeName), QString::number(vectorValue1)));
+        valueList.append(QStringPair(QString("%1[y]").arg(aType->typeName), QString::number(vectorValue2)));
+        foundStats = true;
+      });
 
       if (!foundStats)
         valueList.append(QStringPair(aType->typeName, "-"));
@@ -32,6 +32,8 @@
 
 #pragma once
 
+#include <QImage>
+#include <QMap>
 #include <QPointer>
 #include <QVector>
 #include <QMutex>
@@ -91,6 +93,19 @@ public:
   // data that is needed to render the statistics for the given frame.
   void loadStatistics(int frameIdx);
 
+  // Get the first frame after frameIdx (up to STATISTICS_PREFETCH_FRAMES frames ahead but not after lastFrameIdx)
+  // for which not all rendered statistics are cached. Returns -1 if all these frames are cached.
+  int getNextFrameToPrefetch(int frameIdx, int lastFrameIdx);
+  // Load the statistics for the given frame into the cache without making it the current frame.
+  void prefetchStatistics(int frameIdx);
+
+  // Can the statistics of different types be loaded in parallel (requestStatisticsLoading is emitted from
+  // multiple threads at the same time)? This is only possible if loading one type does not touch the others.
+  void setParallelTypeLoading(bool parallel) { parallelTypeLoading = parallel; }
+
+  // Clear the statistics data of all frames (e.g. if the source was reloaded)
+  void clearStatisticsCache();
+
   // Get the statisticsType with the given typeID from p_statsTypeList
   StatisticsType *getStatisticsType(int typeID);
 
@@ -118,8 +133,9 @@ public:
 signals:
   // Update the item (and maybe redraw it)
   void updateItem(bool redraw);
-  // Request to load the statistics for the given frame index/typeIdx into statsCache.
-  void requestStatisticsLoading(int frameIdx, int typeIdx);
+  // Request to load the statistics for the given frame index/typeIdx into the given cache [statsTypeID].
+  // This is always a direct connection and may be emitted from multiple threads if parallelTypeLoading is set.
+  void requestStatisticsLoading(int frameIdx, int typeIdx, QHash<int, statisticsData> &cache);
 
 private:
 
@@ -129,6 +145,20 @@ private:
   // Make sure that nothing is read from the stats cache while it is being changed.
   QMutex statsCacheAccessMutex;
 
+  // The statistics of previously shown and prefetched frames [frameIdx][statsTypeID]. When one of these frames
+  // becomes the current frame, its data is moved to statsCache.
+  QMap<int, QHash<int, statisticsData>> statsFrameCache;
+  bool parallelTypeLoading {false};
+
+  // Load all rendered statistics of the given frame which are not cached yet and put them into the cache.
+  void loadMissingStatistics(int frameIdx);
+  // Are all rendered statistics of the given frame in the cache? The mutex must be locked.
+  bool isFrameCached(int frameIdx) const;
+  // Move the statistics of the given frame from statsFrameCache to statsCache. The mutex must be locked.
+  void setCurrentCacheFrame(int frameIdx);
+  // Drop frames from statsFrameCache until at most STATISTICS_CACHE_FRAMES are left. The mutex must be locked.
+  void trimFrameCache();
+
   // The list of all statistics that this class can provide (and a backup for updating the list)
   StatisticsTypeList statsTypeList;
   StatisticsTypeList statsTypeListBackup;
@@ -144,6 +174,37 @@ private:
 
   StatisticsStyleControl statisticsStyleUI;
 
+  // Level of detail rendering. If the zoom factor is below STATISTICS_LOD_ZOOM, most blocks are smaller than a pixel.
+  // The block values and grids of all statistics types are then drawn into one image at display resolution. The
+  // image is reused until one of the things that were drawn into it changes.
+  struct lodTileLayer
+  {
+    bool operator==(const lodTileLayer &other) const;
+    int typeIdx;
+    int alphaFactor;
+    bool renderValueData;
+    bool scaleValueToBlockSize;
+    colorMapper colMapper;
+    bool renderGrid;
+    QColor gridColor;
+    int valueBlockCount;
+    int gridBlockCount;
+  };
+  struct lodTileCache
+  {
+    QImage image;
+    QRect rect;
+    int frameIdx {-1};
+    double zoomFactor {0};
+    QList<lodTileLayer> layers;
+  };
+  lodTileCache lodTile;
+  // Draw the block values and grids of all rendered statistics types as an image covering the given display area.
+  void paintStatisticsTile(QPainter *painter, int frameIdx, double zoomFactor, const QRect &visibleArea, const QRect &displayArea);
+  // Draw the vectors of the statistics type averaged over bins of STATISTICS_LOD_VECTOR_BIN_SIZE display pixels.
+  void paintVectorsBinned(QPainter *painter, int statTypeIdx, const statisticsData &data, double zoomFactor, const QRect &vectorArea,
+                          const int &xMin, const int &xMax, const int &yMin, const int &yMax);
+
   // Pointers to the primary and (if created) secondary controls that we added to the properties panel per item
   QList<QCheckBox*>   itemNameCheckBoxes[2];
   QList<QSlider*>     itemOpacitySliders[2];
@@ -32,7 +32,9 @@
 
 #include "statisticsExtensions.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <random>
 
 #include "common/typedef.h"
@@ -312,60 +314,128 @@ QString StatisticsType::getValueTxt(int val)
   return QString("%1").arg(val);
 }
 
+void statisticsBlockList::append(unsigned short x, unsigned short y, unsigned short w, unsigned short h)
+{
+  posX.append(x);
+  posY.append(y);
+  width.append(w);
+  height.append(h);
+
+  maxRight = std::max(maxRight, x + w);
+  maxBottom = std::max(maxBottom, y + h);
+  maxWidth = std::max(maxWidth, int(w));
+  maxHeight = std::max(maxHeight, int(h));
+  gridValid = false;
+}
+
+void statisticsBlockList::setBlocks(const unsigned short *x, const unsigned short *y, const unsigned short *w, const unsigned short *h, int n)
+{
+  posX.resize(n);
+  posY.resize(n);
+  width.resize(n);
+  height.resize(n);
+  std::copy(x, x + n, posX.begin());
+  std::copy(y, y + n, posY.begin());
+  std::copy(w, w + n, width.begin());
+  std::copy(h, h + n, height.begin());
+
+  maxRight = maxBottom = maxWidth = maxHeight = 0;
+  for (int i = 0; i < n; i++)
+  {
+    maxRight = std::max(maxRight, x[i] + w[i]);
+    maxBottom = std::max(maxBottom, y[i] + h[i]);
+    maxWidth = std::max(maxWidth, int(w[i]));
+    maxHeight = std::max(maxHeight, int(h[i]));
+  }
+  gridValid = false;
+}
+
+void statisticsBlockList::buildGrid() const
+{
+  gridWidth = maxRight / gridCellSize + 1;
+  gridHeight = maxBottom / gridCellSize + 1;
+
+  // Count the blocks per cell and sort the block indices by cell (counting sort). Within a cell, the indices stay ascending.
+  gridCellStart.fill(0, gridWidth * gridHeight + 1);
+  for (int i = 0; i < count(); i++)
+    gridCellStart[(posY[i] / gridCellSize) * gridWidth + posX[i] / gridCellSize + 1]++;
+  for (int c = 0; c < gridWidth * gridHeight; c++)
+    gridCellStart[c + 1] += gridCellStart[c];
+
+  QVector<int> cellFill = gridCellStart;
+  gridBlocks.resize(count());
+  for (int i = 0; i < count(); i++)
+    gridBlocks[cellFill[(posY[i] / gridCellSize) * gridWidth + posX[i] / gridCellSize]++] = i;
+
+  gridValid = true;
+}
+
+QVector<int> statisticsBlockList::getBlocksIn(const QRect &area) const
+{
+  if (!gridValid)
+    buildGrid();
+
+  // A block is listed in the cell of its top left corner. So we also have to look into the cells left of / above
+  // the area that a block of the maximum size could reach into the area from.
+  const int cellX0 = std::max(area.left() - maxWidth + 1, 0) / gridCellSize;
+  const int cellY0 = std::max(area.top() - maxHeight + 1, 0) / gridCellSize;
+  const int cellX1 = std::min(std::max(area.right(), 0) / gridCellSize, gridWidth - 1);
+  const int cellY1 = std::min(std::max(area.bottom(), 0) / gridCellSize, gridHeight - 1);
+
+  QVector<int> blocks;
+  for (int cellY = cellY0; cellY <= cellY1; cellY++)
+    for (int cellX = cellX0; cellX <= cellX1; cellX++)
+    {
+      const int c = cellY * gridWidth + cellX;
+      for (int k = gridCellStart[c]; k < gridCellStart[c + 1]; k++)
+      {
+        const int i = gridBlocks[k];
+        if (getRect(i).intersects(area))
+          blocks.append(i);
+      }
+    }
+
+  // Keep the order in which the blocks were added (this is the order in which they are drawn)
+  std::sort(blocks.begin(), blocks.end());
+  return blocks;
+}
+
 void statisticsData::addBlockValue(unsigned short x, unsigned short y, unsigned short w, unsigned short h, int val)
 {
-  statisticsItem_Value value;
-  value.pos[0] = x;
-  value.pos[1] = y;
-  value.size[0] = w;
-  value.size[1] = h;
-  value.value = val;
+  valueBlocks.append(x, y, w, h);
+  values.append(val);
 
   // Always keep the biggest block size updated.
   unsigned int wh = w*h;
   if (wh > maxBlockSize)
     maxBlockSize = wh;
-
-  valueData.append(value);
 }
 
 void statisticsData::addBlockVector(unsigned short x, unsigned short y, unsigned short w, unsigned short h, int vecX, int vecY)
 {
-  statisticsItem_Vector vec;
-  vec.pos[0] = x;
-  vec.pos[1] = y;
-  vec.size[0] = w;
-  vec.size[1] = h;
-  vec.point[0] = QPoint(vecX,vecY);
-  vec.isLine = false;
-  vectorData.append(vec);
+  vectorBlocks.append(x, y, w, h);
+  vectorPoints0.append(QPoint(vecX, vecY));
+  vectorPoints1.append(QPoint());
+  vectorIsLine.append(false);
+  maxVectorComponent = std::max({maxVectorComponent, std::abs(vecX), std::abs(vecY)});
 }
 
 void statisticsData::addBlockAffineTF(unsigned short x, unsigned short y, unsigned short w, unsigned short h, int vecX0, int vecY0, int vecX1, int vecY1, int vecX2, int vecY2)
 {
-  statisticsItem_AffineTF affineTF;
-  affineTF.pos[0] = x;
-  affineTF.pos[1] = y;
-  affineTF.size[0] = w;
-  affineTF.size[1] = h;
-  affineTF.point[0] = QPoint(vecX0,vecY0);
-  affineTF.point[1] = QPoint(vecX1,vecY1);
-  affineTF.point[2] = QPoint(vecX2,vecY2);
-  affineTFData.append(affineTF);
+  affineTFBlocks.append(x, y, w, h);
+  affineTFPoints.append(QPoint(vecX0, vecY0));
+  affineTFPoints.append(QPoint(vecX1, vecY1));
+  affineTFPoints.append(QPoint(vecX2, vecY2));
+  maxVectorComponent = std::max({maxVectorComponent, std::abs(vecX0), std::abs(vecY0), std::abs(vecX1), std::abs(vecY1), std::abs(vecX2), std::abs(vecY2)});
 }
 
-
 void statisticsData::addLine(unsigned short x, unsigned short y, unsigned short w, unsigned short h, int x1, int y1, int x2, int y2)
 {
-  statisticsItem_Vector vec;
-  vec.pos[0] = x;
-  vec.pos[1] = y;
-  vec.size[0] = w;
-  vec.size[1] = h;
-  vec.point[0] = QPoint(x1,y1);
-  vec.point[1] = QPoint(x2,y2);
-  vec.isLine = true;
-  vectorData.append(vec);
+  vectorBlocks.append(x, y, w, h);
+  vectorPoints0.append(QPoint(x1, y1));
+  vectorPoints1.append(QPoint(x2, y2));
+  vectorIsLine.append(true);
+  maxVectorComponent = std::max({maxVectorComponent, std::abs(x1), std::abs(y1), std::abs(x2), std::abs(y2)});
 }
 
 void statisticsData::addPolygonValue(const QVector<QPoint> &points, int val)
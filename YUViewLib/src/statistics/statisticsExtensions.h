@@ -35,6 +35,9 @@
 #include <QColor>
 #include <QMap>
 #include <QPen>
+#include <QPolygon>
+#include <QRect>
+#include <QVector>
 
 class YUViewDomElement;
 
@@ -179,37 +182,59 @@ private:
   initialState init;
 };
 
-struct statisticsItem_Value
+// The position and size of the blocks of one kind of statistics data. The blocks are stored as a structure of arrays:
+// The i-th entry of posX, posY, width and height belongs to the i-th block. In order to quickly find the blocks in a
+// part of the frame (the visible area when zoomed in or the position of the mouse), a grid of cells is built on first use.
+// Every block is listed in the cell that contains its top left corner.
+class statisticsBlockList
 {
-  // The position and size of the item. (max 65535)
-  unsigned short pos[2];
-  unsigned short size[2];
+public:
+  void append(unsigned short x, unsigned short y, unsigned short w, unsigned short h);
+  // Replace all blocks with the n blocks from the given arrays
+  void setBlocks(const unsigned short *x, const unsigned short *y, const unsigned short *w, const unsigned short *h, int n);
+  int count() const { return posX.count(); }
+  QRect getRect(int i) const { return QRect(posX[i], posY[i], width[i], height[i]); }
+  // The rect that contains all blocks
+  QRect getBoundingRect() const { return QRect(0, 0, maxRight, maxBottom); }
 
-  // The actual value
-  int value;
-};
+  // Call visit(i) for every block i that intersects the given area (in samples of the frame). The blocks are visited
+  // in the order in which they were added.
+  template<typename F> void forEachBlockIn(const QRect &area, F visit) const;
 
-struct statisticsItem_Vector
-{
-  // The position and size of the item. (max 65535)
-  unsigned short pos[2];
-  unsigned short size[2];
+  // The position and size of the blocks (max 65535)
+  QVector<unsigned short> posX, posY, width, height;
 
-  bool isLine; // the vector is specified by two points
-  // The actual vector value
-  QPoint point[2];
+private:
+  // Get the indices (ascending) of all blocks that intersect the given area using the grid.
+  QVector<int> getBlocksIn(const QRect &area) const;
+  void buildGrid() const;
+
+  int maxRight {0}, maxBottom {0};
+  int maxWidth {0}, maxHeight {0};
+
+  // The grid of cells. The blocks of cell c are gridBlocks[gridCellStart[c]] to gridBlocks[gridCellStart[c+1]-1].
+  static const int gridCellSize = 64;
+  mutable bool gridValid {false};
+  mutable int gridWidth {0};
+  mutable int gridHeight {0};
+  mutable QVector<int> gridCellStart;
+  mutable QVector<int> gridBlocks;
 };
 
-struct statisticsItem_AffineTF
+template<typename F> void statisticsBlockList::forEachBlockIn(const QRect &area, F visit) const
 {
-  // The position and size of the item. (max 65535)
-  unsigned short pos[2];
-  unsigned short size[2];
-
-  // the vector is specified by two points
-  // The actual vector value
-  QPoint point[3];
-};
+  if (count() == 0 || !area.intersects(getBoundingRect()))
+    return;
+  if (area.contains(getBoundingRect()))
+  {
+    // Everything is in the area. No need to use the grid.
+    for (int i = 0; i < count(); i++)
+      visit(i);
+    return;
+  }
+  for (int i : getBlocksIn(area))
+    visit(i);
+}
 
 struct statisticsItemPolygon_Value
 {
@@ -242,12 +267,26 @@ public:
   void addPolygonVector(const QVector<QPoint> &points, int vecX, int vecY);
   void addPolygonValue(const QVector<QPoint> &points, int val);
 
-  QList<statisticsItem_Value> valueData;
-  QList<statisticsItem_Vector> vectorData;
-  QList<statisticsItem_AffineTF> affineTFData;
+  // Block values (one value per block)
+  statisticsBlockList valueBlocks;
+  QVector<int> values;
+
+  // Block vectors. A vector starts in the center of the block. If vectorIsLine is set, it is a line from
+  // vectorPoints0 to vectorPoints1 (relative to the top left of the block).
+  statisticsBlockList vectorBlocks;
+  QVector<QPoint> vectorPoints0;
+  QVector<QPoint> vectorPoints1;
+  QVector<bool> vectorIsLine;
+
+  // Affine transforms (three vectors per block: affineTFPoints[3*i] to affineTFPoints[3*i+2])
+  statisticsBlockList affineTFBlocks;
+  QVector<QPoint> affineTFPoints;
+
   QList<statisticsItemPolygon_Value> polygonValueData;
   QList<statisticsItemPolygon_Vector> polygonVectorData;
 
   // What is the size (area) of the biggest block)? This is needed for scaling the blocks according to their size.
   unsigned int maxBlockSize;
+  // The biggest absolute x or y component of all vectors/lines. Vectors can reach outside of their block by this much.
+  int maxVectorComponent {0};
 };
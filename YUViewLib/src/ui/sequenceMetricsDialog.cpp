@@ -0,0 +1,150 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "sequenceMetricsDialog.h"
+
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+
+namespace
+{
+
+using Metric = SequenceMetricsPlotModel::Metric;
+
+// The entries of the metric combo box
+const QList<QPair<Metric, int>> plottedMetrics =
+{
+  {Metric::PSNR, 0}, {Metric::PSNR, 1}, {Metric::PSNR, 2},
+  {Metric::MSE, 0}, {Metric::MSE, 1}, {Metric::MSE, 2}, {Metric::MSE, 3},
+  {Metric::SSIM, 0}, {Metric::SSIM, 1}, {Metric::SSIM, 2}
+};
+
+}
+
+SequenceMetricsDialog::SequenceMetricsDialog(SequenceMetricsJob *job, const QString &csvFilePath, QWidget *parent)
+  : QDialog(parent), job(job)
+{
+  this->setWindowTitle("Metrics of all frames");
+  this->resize(800, 450);
+
+  for (const auto &metric : plottedMetrics)
+    this->metricComboBox.addItem(SequenceMetricsPlotModel::getMetricName(metric.first, metric.second));
+
+  this->progressBar.setRange(0, job->getNrFrames());
+  this->progressBar.setValue(job->getNrFramesDone());
+  this->statusLabel.setText(csvFilePath.isEmpty() ? QString() : QString("Writing to %1").arg(csvFilePath));
+  this->statusLabel.setWordWrap(true);
+  this->cancelButton.setText("Cancel");
+
+  auto topLayout = new QHBoxLayout;
+  topLayout->addWidget(new QLabel("Plot"));
+  topLayout->addWidget(&this->metricComboBox);
+  topLayout->addStretch(1);
+  auto bottomLayout = new QHBoxLayout;
+  bottomLayout->addWidget(&this->progressBar, 1);
+  bottomLayout->addWidget(&this->cancelButton);
+  auto layout = new QVBoxLayout(this);
+  layout->addLayout(topLayout);
+  layout->addWidget(&this->plotView, 1);
+  layout->addWidget(&this->statusLabel);
+  layout->addLayout(bottomLayout);
+
+  this->plotView.setModel(job->getPlotModel());
+
+  // The signals of the job are emitted from its background thread
+  connect(job, &SequenceMetricsJob::progressChanged, this, &SequenceMetricsDialog::jobProgressChanged, Qt::QueuedConnection);
+  connect(job, &SequenceMetricsJob::jobFinished, this, &SequenceMetricsDialog::jobFinished, Qt::QueuedConnection);
+  connect(job, &QObject::destroyed, this, [this]()
+  {
+    this->plotView.setModel(nullptr);
+    this->close();
+  });
+  connect(&this->metricComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SequenceMetricsDialog::plottedMetricChanged);
+  connect(&this->cancelButton, &QPushButton::clicked, this, &SequenceMetricsDialog::cancelOrClose);
+
+  if (!job->isRunning())
+    this->jobFinished(job->getErrorMessage().isEmpty());
+}
+
+void SequenceMetricsDialog::jobProgressChanged(int nrFramesDone, int nrFrames)
+{
+  this->progressBar.setRange(0, nrFrames);
+  this->progressBar.setValue(nrFramesDone);
+}
+
+void SequenceMetricsDialog::jobFinished(bool success)
+{
+  if (!this->job)
+    return;
+
+  this->progressBar.setValue(this->job->getNrFramesDone());
+  this->cancelButton.setText("Close");
+
+  if (!success)
+  {
+    this->statusLabel.setText(this->job->getErrorMessage());
+    return;
+  }
+
+  // Show the mean values of the sequence
+  const auto frameMetrics = this->job->getFrameMetrics();
+  if (frameMetrics.isEmpty())
+    return;
+  const int nrComponents = frameMetrics.first().nrComponents;
+  QStringList means;
+  for (const auto &metric : plottedMetrics)
+  {
+    if (metric.second >= nrComponents && !(metric.first == Metric::MSE && metric.second == 3))
+      continue;
+    double sum = 0;
+    for (const auto &frame : frameMetrics)
+      sum += (metric.first == Metric::PSNR) ? frame.psnr[metric.second] : (metric.first == Metric::MSE) ? frame.mse[metric.second] : frame.ssim[metric.second];
+    means.append(QString("%1: %2").arg(SequenceMetricsPlotModel::getMetricName(metric.first, metric.second)).arg(sum / frameMetrics.size()));
+  }
+  this->statusLabel.setText(QString("Mean of %1 frames - %2").arg(frameMetrics.size()).arg(means.join(", ")));
+}
+
+void SequenceMetricsDialog::plottedMetricChanged(int index)
+{
+  if (this->job && index >= 0 && index < plottedMetrics.size())
+    this->job->getPlotModel()->setPlottedMetric(plottedMetrics[index].first, plottedMetrics[index].second);
+}
+
+void SequenceMetricsDialog::cancelOrClose()
+{
+  if (this->job && this->job->isRunning())
+    // The results so far are kept. jobFinished is called when the job stopped.
+    this->job->cancel();
+  else
+    this->close();
+}
@@ -119,6 +119,9 @@ SettingsDialog::SettingsDialog(QWidget *parent) :
   else
     ui.spinBoxNrThreads->setValue(functions::getOptimalThreadCount());
   ui.spinBoxNrThreads->setEnabled(ui.checkBoxNrThreads->isChecked());
+  ui.checkBoxCacheRawData->setChecked(settings.value("CacheRawData", false).toBool());
+  ui.checkBoxMemoryMapFiles->setChecked(settings.value("MemoryMapFiles", false).toBool());
+  ui.spinBoxConversionThreads->setValue(settings.value("ConversionThreads", functions::getOptimalThreadCount()).toInt());
   // Playback
   ui.checkBoxPausPlaybackForCaching->setChecked(settings.value("PlaybackPauseCaching", true).toBool());
   const bool playbackCaching = settings.value("PlaybackCachingEnabled", false).toBool();
@@ -134,6 +137,9 @@ SettingsDialog::SettingsDialog(QWidget *parent) :
   for (int i=0; i<YUView::decoderEngineNum; i++)
     ui.comboBoxDefaultDecoder->addItem(functions::getDecoderEngineName((YUView::decoderEngine)i));
   ui.comboBoxDefaultDecoder->setCurrentIndex(settings.value("DefaultDecoder", 0).toInt());
+  ui.spinBoxDecoderThreadsInteractive->setValue(settings.value("ThreadsInteractive", 0).toInt());
+  ui.spinBoxDecoderThreadsCaching->setValue(settings.value("ThreadsCaching", 0).toInt());
+  ui.spinBoxCachingDecoders->setValue(settings.value("CachingDecoders", 1).toInt());
 
   ui.lineEditLibde265File->setText(settings.value("libde265File", "").toString());
   ui.lineEditLibHMFile->setText(settings.value("libHMFile", "").toString());
@@ -390,6 +396,9 @@ void SettingsDialog::on_pushButtonSave_clicked()
   settings.setValue("ThresholdValueMB", getCacheSizeInMB());
   settings.setValue("SetNrThreads", ui.checkBoxNrThreads->isChecked());
   settings.setValue("NrThreads", ui.spinBoxNrThreads->value());
+  settings.setValue("CacheRawData", ui.checkBoxCacheRawData->isChecked());
+  settings.setValue("MemoryMapFiles", ui.checkBoxMemoryMapFiles->isChecked());
+  settings.setValue("ConversionThreads", ui.spinBoxConversionThreads->value());
   settings.setValue("PlaybackPauseCaching", ui.checkBoxPausPlaybackForCaching->isChecked());
   settings.setValue("PlaybackCachingEnabled", ui.checkBoxEnablePlaybackCaching->isChecked());
   settings.setValue("PlaybackCachingThreadLimit", ui.spinBoxThreadLimit->value());
@@ -399,6 +408,9 @@ void SettingsDialog::on_pushButtonSave_clicked()
   settings.beginGroup("Decoders");
   settings.setValue("SearchPath", ui.lineEditDecoderPath->text());
   settings.setValue("DefaultDecoder", ui.comboBoxDefaultDecoder->currentIndex());
+  settings.setValue("ThreadsInteractive", ui.spinBoxDecoderThreadsInteractive->value());
+  settings.setValue("ThreadsCaching", ui.spinBoxDecoderThreadsCaching->value());
+  settings.setValue("CachingDecoders", ui.spinBoxCachingDecoders->value());
   // Raw coded video files
   settings.setValue("libde265File", ui.lineEditLibde265File->text());
   settings.setValue("libHMFile", ui.lineEditLibHMFile->text());
@@ -0,0 +1,208 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PlotSummaryPyramid.h"
+
+#include <algorithm>
+#include <cmath>
+
+void PlotSummaryPyramid::Summary::add(const PlotModel::Point &point)
+{
+  const auto pointXMin = point.x - point.width / 2;
+  const auto pointXMax = point.x + point.width / 2;
+  if (this->nrPoints == 0)
+  {
+    this->xMin = pointXMin;
+    this->xMax = pointXMax;
+    this->yMin = point.y;
+    this->yMax = point.y;
+  }
+  else
+  {
+    this->xMin = std::min(this->xMin, pointXMin);
+    this->xMax = std::max(this->xMax, pointXMax);
+    this->yMin = std::min(this->yMin, point.y);
+    this->yMax = std::max(this->yMax, point.y);
+  }
+  this->ySum += point.y;
+  this->nrPoints++;
+  this->intra |= point.intra;
+}
+
+void PlotSummaryPyramid::Summary::add(const Summary &summary)
+{
+  if (summary.nrPoints == 0)
+    return;
+  if (this->nrPoints == 0)
+  {
+    *this = summary;
+    return;
+  }
+  this->xMin = std::min(this->xMin, summary.xMin);
+  this->xMax = std::max(this->xMax, summary.xMax);
+  this->yMin = std::min(this->yMin, summary.yMin);
+  this->yMax = std::max(this->yMax, summary.yMax);
+  this->ySum += summary.ySum;
+  this->nrPoints += summary.nrPoints;
+  this->intra |= summary.intra;
+}
+
+PlotModel::PointSummary PlotSummaryPyramid::Summary::toPointSummary() const
+{
+  const auto yAverage = (this->nrPoints > 0) ? this->ySum / this->nrPoints : 0.0;
+  return {this->xMin, this->xMax, this->yMin, this->yMax, yAverage, this->intra};
+}
+
+void PlotSummaryPyramid::clear()
+{
+  this->levels.clear();
+  this->validPoints = 0;
+}
+
+void PlotSummaryPyramid::update(unsigned nrPoints, const std::function<PlotModel::Point(unsigned)> &getPoint)
+{
+  if (this->validPoints == nrPoints && !this->levels.isEmpty())
+    return;
+
+  const auto firstChangedPoint = std::min(this->validPoints, nrPoints);
+  unsigned pointsPerSummary = LevelFactor;
+  for (int levelIndex = 0; ; levelIndex++)
+  {
+    if (levelIndex == this->levels.size())
+      this->levels.append({});
+    auto &level = this->levels[levelIndex];
+
+    // Keep the complete summaries before the first changed point and recalculate the rest
+    level.resize(int(firstChangedPoint / pointsPerSummary));
+    const auto nrSummaries = (nrPoints + pointsPerSummary - 1) / pointsPerSummary;
+    for (auto i = unsigned(level.size()); i < nrSummaries; i++)
+    {
+      Summary summary;
+      if (levelIndex == 0)
+      {
+        for (auto p = i * LevelFactor; p < std::min((i + 1) * LevelFactor, nrPoints); p++)
+          summary.add(getPoint(p));
+      }
+      else
+      {
+        const auto &levelBelow = this->levels[levelIndex - 1];
+        for (auto s = i * LevelFactor; s < std::min((i + 1) * LevelFactor, unsigned(levelBelow.size())); s++)
+          summary.add(levelBelow[s]);
+      }
+      level.append(summary);
+    }
+
+    if (nrSummaries <= 1)
+    {
+      this->levels.resize(levelIndex + 1);
+      break;
+    }
+    pointsPerSummary *= LevelFactor;
+  }
+  this->validPoints = nrPoints;
+}
+
+std::optional<QVector<PlotModel::PointSummary>> PlotSummaryPyramid::getSummaries(unsigned nrPoints, const std::function<PlotModel::Point(unsigned)> &getPoint,
+                                                                                 Range<double> xRange, unsigned maxNrSummaries)
+{
+  if (nrPoints <= maxNrSummaries || maxNrSummaries == 0)
+    return {};
+
+  // Find the first point right of the range start and the last point left of the range end. Also include the
+  // points just outside of the range so that lines are drawn up to the border.
+  auto findFirstPointRightOf = [&](double x)
+  {
+    unsigned left = 0;
+    unsigned right = nrPoints;
+    while (left < right)
+    {
+      const auto middle = left + (right - left) / 2;
+      if (getPoint(middle).x < x)
+        left = middle + 1;
+      else
+        right = middle;
+    }
+    return left;
+  };
+  const auto firstPoint = std::max(findFirstPointRightOf(xRange.min), 1u) - 1;
+  const auto lastPoint = std::min(findFirstPointRightOf(xRange.max), nrPoints - 1);
+  if (lastPoint < firstPoint || lastPoint - firstPoint + 1 <= maxNrSummaries)
+    return {};
+
+  this->update(nrPoints, getPoint);
+
+  // Use the finest level with not more than maxNrSummaries summaries in the range
+  const auto nrPointsInRange = lastPoint - firstPoint + 1;
+  unsigned pointsPerSummary = LevelFactor;
+  int levelIndex = 0;
+  while (nrPointsInRange / pointsPerSummary + 2 > maxNrSummaries && levelIndex + 1 < this->levels.size())
+  {
+    pointsPerSummary *= LevelFactor;
+    levelIndex++;
+  }
+
+  QVector<PlotModel::PointSummary> summaries;
+  const auto &level = this->levels[levelIndex];
+  for (auto i = firstPoint / pointsPerSummary; i <= lastPoint / pointsPerSummary && i < unsigned(level.size()); i++)
+    summaries.append(level[i].toPointSummary());
+  return summaries;
+}
+
+QVector<PlotModel::PointSummary> PlotSummaryPyramid::combinePerPixelColumn(const QVector<PlotModel::PointSummary> &summaries,
+                                                                           const std::function<double(double)> &plotXToPixelX)
+{
+  QVector<PlotModel::PointSummary> columns;
+  double currentColumn = 0;
+  unsigned nrSummariesInColumn = 0;
+  for (const auto &summary : summaries)
+  {
+    const auto column = std::floor(plotXToPixelX((summary.xMin + summary.xMax) / 2));
+    if (!columns.isEmpty() && column == currentColumn)
+    {
+      auto &c = columns.last();
+      c.xMin = std::min(c.xMin, summary.xMin);
+      c.xMax = std::max(c.xMax, summary.xMax);
+      c.yMin = std::min(c.yMin, summary.yMin);
+      c.yMax = std::max(c.yMax, summary.yMax);
+      c.yAverage = (c.yAverage * nrSummariesInColumn + summary.yAverage) / (nrSummariesInColumn + 1);
+      c.intra |= summary.intra;
+      nrSummariesInColumn++;
+    }
+    else
+    {
+      columns.append(summary);
+      currentColumn = column;
+      nrSummariesInColumn = 1;
+    }
+  }
+  return columns;
+}
@@ -0,0 +1,84 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "plotModel.h"
+
+#include <QVector>
+#include <algorithm>
+#include <functional>
+
+/* A multi-resolution summary of the points of a plot. The points must be sorted by their x value.
+ * Level 0 combines LevelFactor consecutive points, every following level combines LevelFactor summaries of
+ * the level below. With this, a plot with any number of points can be drawn with a number of primitives that
+ * only depends on the width of the plot. Only the summaries after the first changed point are updated.
+ */
+class PlotSummaryPyramid
+{
+public:
+  static constexpr unsigned LevelFactor = 4;
+
+  // The points from the given index on changed (or were inserted / removed).
+  void invalidateFrom(unsigned pointIndex) { this->validPoints = std::min(this->validPoints, pointIndex); }
+  void clear();
+
+  // See PlotModel::getPlotSummaries. The points are read with the getPoint function.
+  std::optional<QVector<PlotModel::PointSummary>> getSummaries(unsigned nrPoints, const std::function<PlotModel::Point(unsigned)> &getPoint,
+                                                               Range<double> xRange, unsigned maxNrSummaries);
+
+  // Combine the summaries (sorted by x) that fall into the same pixel column so that there is at most one summary per
+  // column. Each summary belongs to the column of its center pixel. plotXToPixelX converts an x value to a pixel position.
+  static QVector<PlotModel::PointSummary> combinePerPixelColumn(const QVector<PlotModel::PointSummary> &summaries,
+                                                                const std::function<double(double)> &plotXToPixelX);
+
+private:
+  struct Summary
+  {
+    void add(const PlotModel::Point &point);
+    void add(const Summary &summary);
+    PlotModel::PointSummary toPointSummary() const;
+
+    double xMin {0}, xMax {0};
+    double yMin {0}, yMax {0};
+    double ySum {0};
+    unsigned nrPoints {0};
+    bool intra {false};
+  };
+
+  void update(unsigned nrPoints, const std::function<PlotModel::Point(unsigned)> &getPoint);
+
+  // Level i holds summaries of LevelFactor^(i+1) points. The last summary of a level may contain fewer points.
+  QVector<QVector<Summary>> levels;
+  // The number of points that the summaries in levels are up to date for
+  unsigned validPoints {0};
+};
@@ -37,6 +37,15 @@ PlotModel::PlotModel()
   this->connect(&this->eventSubsampler, &EventSubsampler::subsampledEvent, this, &PlotModel::dataChanged);
 }
 
+std::optional<QVector<PlotModel::PointSummary>> PlotModel::getPlotSummaries(unsigned streamIndex, unsigned plotIndex, Range<double> xRange, unsigned maxNrSummaries) const
+{
+  Q_UNUSED(streamIndex);
+  Q_UNUSED(plotIndex);
+  Q_UNUSED(xRange);
+  Q_UNUSED(maxNrSummaries);
+  return {};
+}
+
 std::optional<unsigned> PlotModel::getPointIndex(unsigned streamIndex, unsigned plotIndex, QPointF point) const
 {
   const auto streamParam = this->getStreamParameter(streamIndex);
@@ -37,6 +37,7 @@
 
 #include <QObject>
 #include <QTimer>
+#include <QVector>
 
 #include <optional>
 
@@ -93,6 +94,14 @@ public:
     bool intra;
   };
 
+  // A summary of consecutive points of a plot. For bars, the x range includes the width of the bars.
+  struct PointSummary
+  {
+    double xMin, xMax;
+    double yMin, yMax, yAverage;
+    bool intra;
+  };
+
   virtual unsigned getNrStreams() const = 0;
   virtual StreamParameter getStreamParameter(unsigned streamIndex) const = 0;
   virtual Point getPlotPoint(unsigned streamIndex, unsigned plotIndex, unsigned pointIndex) const = 0;
@@ -100,6 +109,11 @@ public:
   virtual std::optional<unsigned> getReasonabelRangeToShowOnXAxisPer100Pixels() const = 0;
   virtual QString formatValue(Axis axis, double value) const = 0;
 
+  // If there are more than maxNrSummaries points in the given x range, return summaries of consecutive points
+  // (at most maxNrSummaries) so that the plot can be drawn without drawing every point. If the points in the range
+  // should be drawn one by one (or the model can not provide summaries), nothing is returned.
+  virtual std::optional<QVector<PointSummary>> getPlotSummaries(unsigned streamIndex, unsigned plotIndex, Range<double> xRange, unsigned maxNrSummaries) const;
+
   std::optional<unsigned> getPointIndex(unsigned streamIndex, unsigned plotIndex, QPointF point) const;
 
 protected:
@@ -34,9 +34,11 @@
 
 #include <QPainter>
 #include <QTextDocument>
+#include <algorithm>
 #include <cmath>
 
 #include "common/typedef.h"
+#include "PlotSummaryPyramid.h"
 
 #define PLOTVIEW_WIDGET_DEBUG_OUTPUT 0
 #if PLOTVIEW_WIDGET_DEBUG_OUTPUT
@@ -602,6 +604,30 @@ void PlotViewWidget::drawPlot(QPainter &painter) const
   const auto plotXMin = this->convertPixelPosToPlotPos(this->plotRect.bottomLeft()).x() - 0.5;
   const auto plotXMax = this->convertPixelPosToPlotPos(this->plotRect.bottomRight()).x() + 0.5;
 
+  // If there are more points than pixels in the plot, the model is asked for a summary with at most one
+  // summary per pixel. With this, not more than O(width) primitives are drawn no matter how many points there are.
+  const auto maxNrSummaries = unsigned(std::max(this->plotRect.width(), 1.0));
+
+  // We can assume that the points are sorted (i.e. there is not graph that suddenly goes back)
+  auto getStartIndexBinarySearch = [](unsigned nrpoints, PlotModel *model, unsigned streamIndex, unsigned plotIndex, double plotXMin)
+  {
+    unsigned intervalLeft = 0;
+    unsigned intervalRight = nrpoints;
+    if (nrpoints == 0)
+      return intervalLeft;
+    while (true)
+    {
+      unsigned pointToCheck = intervalLeft + (intervalRight - intervalLeft) / 2;
+      auto valuePoint = model->getPlotPoint(streamIndex, plotIndex, pointToCheck);
+      if (valuePoint.x < plotXMin)    // Choose right interval
+        intervalLeft = pointToCheck;
+      else                            // Left interval
+        intervalRight = pointToCheck;
+      if (intervalLeft + 1 >= intervalRight)
+        return intervalLeft;
+    }
+  };
+
   DEBUG_PLOT("PlotViewWidget::drawPlot start");
   for (auto streamIndex : this->showStreamList)
   {
@@ -617,6 +643,12 @@ void PlotViewWidget::drawPlot(QPainter &painter) const
           detailedPainting = true;
       }
 
+      const auto summaries = this->model->getPlotSummaries(streamIndex, plotIndex, {plotXMin, plotXMax}, maxNrSummaries);
+      auto plotXToPixelX = [this](double x) { return this->convertPlotPosToPixelPos(QPointF(x, 0)).x(); };
+      const auto pixelColumns = summaries ? PlotSummaryPyramid::combinePerPixelColumn(*summaries, plotXToPixelX) : QVector<PlotModel::PointSummary>();
+      if (summaries)
+        detailedPainting = false;
+
       if (plotParam.type == PlotModel::PlotType::Bar)
       {
         auto setPainterColor = [&painter, &detailedPainting](bool isIntra, bool isHighlight)
@@ -631,32 +663,45 @@ void PlotViewWidget::drawPlot(QPainter &painter) const
           painter.setBrush(color);
         };
 
+        const bool hasHoveredBar = 
+          this->currentlyHoveredPointPerStreamAndPlot.contains(streamIndex) &&
+          this->currentlyHoveredPointPerStreamAndPlot[streamIndex].contains(plotIndex);
+
         QVector<QRectF> normalBars;
         QVector<QRectF> intraBars;
-        for (unsigned int i = 0; i < plotParam.nrpoints; i++)
+        if (summaries)
         {
-          const auto value = model->getPlotPoint(streamIndex, plotIndex, i);
-
-          if (value.x < plotXMin || value.x > plotXMax)
-            continue;
-
-          const auto halfWidth = value.width / 2;
-          const auto barTopLeft = this->convertPlotPosToPixelPos(QPointF(value.x - halfWidth, value.y));
-          const auto barBottomRight = this->convertPlotPosToPixelPos(QPointF(value.x + halfWidth, 0));
-          
-          const bool isHoveredBar = 
-            this->currentlyHoveredPointPerStreamAndPlot.contains(streamIndex) &&
-            this->currentlyHoveredPointPerStreamAndPlot[streamIndex].contains(plotIndex) &&
-            this->currentlyHoveredPointPerStreamAndPlot[streamIndex][plotIndex] == i;
-          
-          const auto r = QRectF(barTopLeft, barBottomRight);
-          if (isHoveredBar)
+          // Draw one bar per pixel column with the maximum value. Columns with an intra point are drawn as intra.
+          for (const auto &column : pixelColumns)
           {
-            setPainterColor(value.intra, true);
-            painter.drawRect(r);
+            const auto barTopLeft = this->convertPlotPosToPixelPos(QPointF(column.xMin, column.yMax));
+            const auto barBottomRight = this->convertPlotPosToPixelPos(QPointF(column.xMax, 0));
+            const auto r = QRectF(barTopLeft, barBottomRight);
+            if (column.intra)
+              intraBars.append(r);
+            else
+              normalBars.append(r);
           }
-          else
+        }
+        else
+        {
+          const auto startIndex = getStartIndexBinarySearch(plotParam.nrpoints, this->model, streamIndex, plotIndex, plotXMin);
+          for (unsigned int i = startIndex; i < plotParam.nrpoints; i++)
           {
+            const auto value = model->getPlotPoint(streamIndex, plotIndex, i);
+
+            if (value.x < plotXMin)
+              continue;
+            if (value.x > plotXMax)
+              break;
+            if (hasHoveredBar && this->currentlyHoveredPointPerStreamAndPlot[streamIndex][plotIndex] == i)
+              // The hovered bar is drawn separately
+              continue;
+
+            const auto halfWidth = value.width / 2;
+            const auto barTopLeft = this->convertPlotPosToPixelPos(QPointF(value.x - halfWidth, value.y));
+            const auto barBottomRight = this->convertPlotPosToPixelPos(QPointF(value.x + halfWidth, 0));
+            const auto r = QRectF(barTopLeft, barBottomRight);
             if (value.intra)
               intraBars.append(r);
             else
@@ -671,53 +716,62 @@ void PlotViewWidget::drawPlot(QPainter &painter) const
         DEBUG_PLOT("PlotViewWidget::drawPlot Start drawing " << intraBars.size() << " intra bars");
         setPainterColor(true, false);
         painter.drawRects(intraBars);
+
+        if (hasHoveredBar)
+        {
+          const auto index = this->currentlyHoveredPointPerStreamAndPlot[streamIndex][plotIndex];
+          const auto value = model->getPlotPoint(streamIndex, plotIndex, index);
+          const auto halfWidth = value.width / 2;
+          const auto barTopLeft = this->convertPlotPosToPixelPos(QPointF(value.x - halfWidth, value.y));
+          const auto barBottomRight = this->convertPlotPosToPixelPos(QPointF(value.x + halfWidth, 0));
+          setPainterColor(value.intra, true);
+          painter.drawRect(QRectF(barTopLeft, barBottomRight));
+        }
       }
       else if (plotParam.type == PlotModel::PlotType::Line)
       {
-        // We can assume that the points are sorted (i.e. there is not graph that suddenly goes back)
-        auto getStartIndexBinarySearch = [](unsigned nrpoints, PlotModel *model, unsigned streamIndex, unsigned plotIndex, double plotXMin)
+        QPolygonF linePoints;
+        if (summaries)
         {
-          unsigned intervalLeft = 0;
-          unsigned intervalRight = nrpoints;
-          if (nrpoints == 0)
-            return intervalLeft;
-          while (true)
+          // Draw a vertical line from the minimum to the maximum in every pixel column. Start each column at
+          // the end which is closer to the previous column so that the connecting lines are as short as possible.
+          for (const auto &column : pixelColumns)
           {
-            unsigned pointToCheck = intervalLeft + (intervalRight - intervalLeft) / 2;
-            auto valuePoint = model->getPlotPoint(streamIndex, plotIndex, pointToCheck);
-            if (valuePoint.x < plotXMin)    // Choose right interval
-              intervalLeft = pointToCheck;
-            else                            // Left interval
-              intervalRight = pointToCheck;
-            if (intervalLeft + 1 == intervalRight)
-              return intervalLeft;
+            const auto x = (column.xMin + column.xMax) / 2;
+            const auto pointMin = this->convertPlotPosToPixelPos(QPointF(x, column.yMin));
+            const auto pointMax = this->convertPlotPosToPixelPos(QPointF(x, column.yMax));
+            const auto minFirst = linePoints.isEmpty() || std::abs(linePoints.last().y() - pointMin.y()) < std::abs(linePoints.last().y() - pointMax.y());
+            linePoints.append(minFirst ? pointMin : pointMax);
+            if (column.yMin != column.yMax)
+              linePoints.append(minFirst ? pointMax : pointMin);
           }
-        };
-
-        QPolygonF linePoints;
-        QPointF lastPoint;
-        const auto startIndex = getStartIndexBinarySearch(plotParam.nrpoints, this->model, streamIndex, plotIndex, plotXMin);
-        for (unsigned i = startIndex; i < plotParam.nrpoints; i++)
+        }
+        else
         {
-          const auto valueStart = this->model->getPlotPoint(streamIndex, plotIndex, i);
-          const auto linePointStart = this->convertPlotPosToPixelPos(QPointF(valueStart.x, valueStart.y));
-
-          if (valueStart.x < plotXMin)
+          QPointF lastPoint;
+          const auto startIndex = getStartIndexBinarySearch(plotParam.nrpoints, this->model, streamIndex, plotIndex, plotXMin);
+          for (unsigned i = startIndex; i < plotParam.nrpoints; i++)
           {
-            lastPoint = linePointStart;
-            continue;
-          }
+            const auto valueStart = this->model->getPlotPoint(streamIndex, plotIndex, i);
+            const auto linePointStart = this->convertPlotPosToPixelPos(QPointF(valueStart.x, valueStart.y));
+
+            if (valueStart.x < plotXMin)
+            {
+              lastPoint = linePointStart;
+              continue;
+            }
 
-          if (linePoints.size() == 0 && i > 0)
-            linePoints.append(lastPoint);
-          linePoints.append(linePointStart);
+            if (linePoints.size() == 0 && i > 0)
+              linePoints.append(lastPoint);
+            linePoints.append(linePointStart);
 
-          if (valueStart.x > plotXMax)
-            // This means that no graph can "go back" on the x-axis. That is ok for now. 
-            // If we ever need this, this needs to be smarter here.
-            break;
+            if (valueStart.x > plotXMax)
+              // This means that no graph can "go back" on the x-axis. That is ok for now. 
+              // If we ever need this, this needs to be smarter here.
+              break;
 
-          lastPoint = linePointStart;
+            lastPoint = linePointStart;
+          }
         }
 
         DEBUG_PLOT("PlotViewWidget::drawPlot Start drawing line with " << linePoints.size() << " points");
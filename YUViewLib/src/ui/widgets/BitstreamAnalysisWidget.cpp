@@ -249,6 +249,7 @@ void BitstreamAnalysisWidget::createAndConnectNewParser(inputFormat inputFormatT
   else if (inputFormatType == inputLibavformat)
     this->parser.reset(new parserAVFormat(this));
   this->parser->enableModel();
+  this->parser->setLazyPacketModel(true);
   const bool parsingLimitSet = !this->ui.parseEntireFileCheckBox->isChecked();
   this->parser->setParsingLimitEnabled(parsingLimitSet);
 
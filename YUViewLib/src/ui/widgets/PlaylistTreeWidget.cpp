@@ -32,19 +32,25 @@
 
 #include "PlaylistTreeWidget.h"
 
+#include <atomic>
+#include <memory>
 #include <QBuffer>
 #include <QFileDialog>
+#include <QFutureWatcher>
 #include <QHeaderView>
 #include <QInputDialog>
 #include <QMenu>
 #include <QMessageBox>
 #include <QMimeData>
 #include <QPainter>
+#include <QProgressDialog>
+#include <QtConcurrent>
 #include <QScopedValueRollback>
 #include <QSettings>
 #include <QHeaderView>
 
 #include "playlistitem/playlistItems.h"
+#include "ui/sequenceMetricsDialog.h"
 
 // Activate this if you want to know when which signals/slots are handled
 #define PLAYLISTTREEWIDGET_DEBUG_EVENTS 0
@@ -380,6 +386,13 @@ void PlaylistTreeWidget::contextMenuEvent(QContextMenuEvent * event)
     playlistItemText *txt = dynamic_cast<playlistItemText*>(itemAtPoint);
     if (txt)
       menu.addAction("Clone Item...", this, &PlaylistTreeWidget::cloneSelectedItem);
+
+    playlistItemStatisticsFile *stat = dynamic_cast<playlistItemStatisticsFile*>(itemAtPoint);
+    if (stat && !dynamic_cast<playlistItemStatisticsBinaryFile*>(stat))
+      menu.addAction("Convert to Binary Statistics...", this, &PlaylistTreeWidget::convertSelectedStatisticsToBinary);
+
+    if (dynamic_cast<playlistItemDifference*>(itemAtPoint))
+      menu.addAction("Calculate Metrics of All Frames...", this, &PlaylistTreeWidget::calculateSequenceMetricsOfSelectedItem);
   }
 
   menu.exec(event->globalPos());
@@ -979,6 +992,100 @@ void PlaylistTreeWidget::cloneSelectedItem()
   }
 }
 
+void PlaylistTreeWidget::convertSelectedStatisticsToBinary()
+{
+  auto stat = dynamic_cast<playlistItemStatisticsFile*>(currentItem());
+  if (stat == nullptr)
+    return;
+
+  const QFileInfo sourceInfo(stat->getName());
+  const QString targetFile = QFileDialog::getSaveFileName(this, "Save binary statistics file", sourceInfo.dir().filePath(sourceInfo.completeBaseName() + ".yuvstats"), "Binary Statistics File (*.yuvstats)");
+  if (targetFile.isEmpty())
+    return;
+
+  // The source item must be created in the GUI thread. It is deleted (in the GUI thread) when the conversion is done.
+  QString errorMessage;
+  auto source = playlistItemStatisticsBinaryFile::openConversionSource(sourceInfo.absoluteFilePath(), errorMessage);
+  if (source == nullptr)
+  {
+    QMessageBox::critical(this, "Error converting statistics file", errorMessage);
+    return;
+  }
+
+  // Convert in the background. The source file may have to be parsed completely first which can take a while.
+  // The worker only reports the progress and polls the cancel flag. The new item is added when the conversion finished.
+  struct ConversionState
+  {
+    std::atomic_int percent {0};
+    std::atomic_bool canceled {false};
+    bool success {false};
+    QString errorMessage;
+  };
+  auto state = std::make_shared<ConversionState>();
+
+  auto progressDialog = new QProgressDialog("Converting statistics file...", "Cancel", 0, 100, this);
+  progressDialog->setAttribute(Qt::WA_DeleteOnClose);
+  progressDialog->setMinimumDuration(1000);  // Show after 1s
+  progressDialog->setAutoClose(false);
+  progressDialog->setAutoReset(false);
+  connect(progressDialog, &QProgressDialog::canceled, [state]() { state->canceled = true; });
+  auto progressTimer = new QTimer(progressDialog);
+  connect(progressTimer, &QTimer::timeout, progressDialog, [progressDialog, state]() { progressDialog->setValue(state->percent); });
+  progressTimer->start(100);
+
+  QPointer<QProgressDialog> progressDialogPointer(progressDialog);
+  auto watcher = new QFutureWatcher<void>(this);
+  connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher, progressDialogPointer, state, targetFile]()
+  {
+    watcher->deleteLater();
+    if (progressDialogPointer)
+      progressDialogPointer->close();
+
+    if (state->canceled)
+      return;
+    if (!state->success)
+    {
+      QMessageBox::critical(this, "Error converting statistics file", state->errorMessage);
+      return;
+    }
+    appendNewItem(new playlistItemStatisticsBinaryFile(targetFile));
+  });
+  watcher->setFuture(QtConcurrent::run([source, targetFile, state]()
+  {
+    state->success = playlistItemStatisticsBinaryFile::convertStatisticsFile(source, targetFile, state->errorMessage, [state](int percent)
+    {
+      state->percent = percent;
+      return !state->canceled;
+    });
+    source->deleteLater();
+  }));
+}
+
+void PlaylistTreeWidget::calculateSequenceMetricsOfSelectedItem()
+{
+  auto diff = dynamic_cast<playlistItemDifference*>(currentItem());
+  if (diff == nullptr)
+    return;
+
+  QSettings settings;
+  const QString targetFile = QFileDialog::getSaveFileName(this, "Save metrics of all frames", QDir(settings.value("lastFilePath").toString()).filePath("metrics.csv"), "CSV File (*.csv)");
+  if (targetFile.isEmpty())
+    return;
+
+  QString errorMessage;
+  auto job = diff->startSequenceMetrics(targetFile, errorMessage);
+  if (job == nullptr)
+  {
+    QMessageBox::critical(this, "Error calculating metrics", errorMessage);
+    return;
+  }
+
+  // The dialog is closed if the job is deleted (with the difference item)
+  auto dialog = new SequenceMetricsDialog(job, targetFile, this);
+  dialog->setAttribute(Qt::WA_DeleteOnClose);
+  dialog->show();
+}
+
 void PlaylistTreeWidget::autoSavePlaylist()
 {
   QSettings settings;
@@ -200,6 +200,12 @@ private:
   // Clone the selected item as often as the user wants
   void cloneSelectedItem();
 
+  // Convert the selected CSV/VTMBMS statistics item to a binary statistics file and add it to the playlist
+  void convertSelectedStatisticsToBinary();
+
+  // Calculate the metrics of all frames of the selected difference item in the background and show them in a dialog
+  void calculateSequenceMetricsOfSelectedItem();
+
   // We have a pointer to the ViewStateHandler to load/save the view states to playlist
   QPointer<ViewStateHandler> stateHandler;
 
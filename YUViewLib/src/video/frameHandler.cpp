@@ -189,7 +189,7 @@ void frameHandler::drawFrame(QPainter *painter, double zoomFactor, bool drawRawV
   videoRect.moveCenter(QPoint(0,0));
 
   // Draw the current image (currentFrame)
-  painter->drawImage(videoRect, currentImage);
+  imagePyramid.drawImage(painter, currentImage, videoRect, zoomFactor);
 
   if (drawRawValues && zoomFactor >= SPLITVIEW_DRAW_VALUES_ZOOMFACTOR)
   {
@@ -38,6 +38,7 @@
 
 #include "common/saveUi.h"
 #include "common/typedef.h"
+#include "video/imagePyramid.h"
 
 #include "ui_frameHandler.h"
 
@@ -115,6 +116,9 @@ protected:
   QImage currentImage;
   QSize  frameSize;
 
+  // Downscaled versions of the currentImage for drawing it zoomed out. Only used from the drawing (main) thread.
+  ImagePyramid imagePyramid;
+
   // Get the pixel value from currentImage. Make sure that currentImage is the correct image.
   QRgb getPixelVal(const QPoint &pos)    { return getPixelVal(pos.x(), pos.y()); }
   virtual QRgb getPixelVal(int x, int y) { return currentImage.pixel(x, y); }
@@ -0,0 +1,176 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "imagePyramid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <QPainter>
+#include <QPaintDevice>
+#include <QtConcurrent>
+#include <QVector>
+
+#include "common/functions.h"
+#include "common/typedef.h"
+
+// Bands of fewer rows than this are not worth starting a thread for
+const int MIN_ROWS_PER_BAND = 32;
+
+void ImagePyramid::drawImage(QPainter *painter, const QImage &image, const QRect &videoRect, double zoomFactor)
+{
+  if (image.isNull() || videoRect.isEmpty())
+    return;
+
+  const double scale = zoomFactor * painter->device()->devicePixelRatioF();
+  const int level = getLevelForScale(scale);
+  const QImage &levelImage = this->getLevel(image, level);
+  if (levelImage.isNull())
+    return;
+
+  // The part of the videoRect that is visible (in the coordinates of the painter)
+  const QRectF visibleRect = functions::getVisiblePaintRect(painter) & QRectF(videoRect);
+  if (visibleRect.isEmpty())
+    return;
+
+  // The size of one pixel of the level on screen. For level 0, this is identical to drawing the image into the videoRect.
+  const int factor = 1 << level;
+  const double pixelWidth = double(videoRect.width()) / image.width() * factor;
+  const double pixelHeight = double(videoRect.height()) / image.height() * factor;
+
+  // Get the visible pixels of the level. The source rect is aligned to full pixels so that the pixels are drawn
+  // at the same positions no matter which part of the image is visible.
+  const int x0 = clip(int(std::floor((visibleRect.left() - videoRect.left()) / pixelWidth)), 0, levelImage.width() - 1);
+  const int y0 = clip(int(std::floor((visibleRect.top() - videoRect.top()) / pixelHeight)), 0, levelImage.height() - 1);
+  const int x1 = clip(int(std::ceil((visibleRect.right() - videoRect.left()) / pixelWidth)), x0 + 1, levelImage.width());
+  const int y1 = clip(int(std::ceil((visibleRect.bottom() - videoRect.top()) / pixelHeight)), y0 + 1, levelImage.height());
+
+  const QRect sourceRect(x0, y0, x1 - x0, y1 - y0);
+  const QRectF targetRect(videoRect.left() + x0 * pixelWidth, videoRect.top() + y0 * pixelHeight, (x1 - x0) * pixelWidth, (y1 - y0) * pixelHeight);
+  painter->drawImage(targetRect, levelImage, sourceRect);
+}
+
+void ImagePyramid::clear()
+{
+  this->imageCacheKey = 0;
+  for (auto &l : this->levels)
+    l = QImage();
+}
+
+int ImagePyramid::getLevelForScale(double scale)
+{
+  int level = 0;
+  while (level < NrLevels - 1 && scale * (1 << (level + 1)) <= 1.0)
+    level++;
+  return level;
+}
+
+const QImage &ImagePyramid::getLevel(const QImage &image, int level)
+{
+  if (level == 0)
+    return image;
+
+  if (image.cacheKey() != this->imageCacheKey)
+  {
+    this->clear();
+    this->imageCacheKey = image.cacheKey();
+  }
+
+  // Each level is created from the level above
+  for (int l = 1; l <= level; l++)
+    if (this->levels[l - 1].isNull())
+      this->levels[l - 1] = downscaleByTwo(l == 1 ? image : this->levels[l - 2]);
+  return this->levels[level - 1];
+}
+
+QImage ImagePyramid::downscaleByTwo(const QImage &image)
+{
+  if (image.isNull())
+    return {};
+
+  const int width = (image.width() + 1) / 2;
+  const int height = (image.height() + 1) / 2;
+  const auto format = image.format();
+  if (format != QImage::Format_RGB32 && format != QImage::Format_ARGB32 && format != QImage::Format_ARGB32_Premultiplied)
+    return image.scaled(width, height, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+  QImage output(width, height, format);
+  if (output.isNull())
+    return {};
+
+  // Get the pointers before the bands are processed in parallel. bits() may detach the image.
+  const uchar *src = image.constBits();
+  const auto srcStride = image.bytesPerLine();
+  uchar *dst = output.bits();
+  const auto dstStride = output.bytesPerLine();
+  const int srcWidth = image.width();
+  const int srcHeight = image.height();
+
+  auto downscaleRows = [=](int yStart, int yEnd)
+  {
+    for (int y = yStart; y < yEnd; y++)
+    {
+      const uint32_t *row0 = reinterpret_cast<const uint32_t*>(src + srcStride * (2 * y));
+      const uint32_t *row1 = reinterpret_cast<const uint32_t*>(src + srcStride * std::min(2 * y + 1, srcHeight - 1));
+      uint32_t *out = reinterpret_cast<uint32_t*>(dst + dstStride * y);
+      for (int x = 0; x < width; x++)
+      {
+        const int x0 = 2 * x;
+        const int x1 = std::min(2 * x + 1, srcWidth - 1);
+        const uint32_t p[4] = {row0[x0], row0[x1], row1[x0], row1[x1]};
+        // Average two channels at once. The sum of 4 values needs 10 bits so the channels in the masks do not overlap.
+        uint32_t sumRB = 0x00020002;
+        uint32_t sumAG = 0x00020002;
+        for (int i = 0; i < 4; i++)
+        {
+          sumRB += p[i] & 0x00FF00FF;
+          sumAG += (p[i] >> 8) & 0x00FF00FF;
+        }
+        out[x] = ((sumRB >> 2) & 0x00FF00FF) | (((sumAG >> 2) & 0x00FF00FF) << 8);
+      }
+    }
+  };
+
+  const int nrBands = clip(height / MIN_ROWS_PER_BAND, 1, int(functions::getOptimalThreadCount()));
+  if (nrBands == 1)
+    downscaleRows(0, height);
+  else
+  {
+    QVector<int> bands(nrBands);
+    std::iota(bands.begin(), bands.end(), 0);
+    QtConcurrent::blockingMap(bands, [&](int band) {
+      downscaleRows(height * band / nrBands, height * (band + 1) / nrBands);
+    });
+  }
+  return output;
+}
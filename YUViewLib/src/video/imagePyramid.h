@@ -0,0 +1,73 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QImage>
+#include <QRect>
+
+class QPainter;
+
+/* Downscaled versions (1/2, 1/4, 1/8) of an image for drawing it zoomed out.
+ * If an image is drawn at a fraction of its resolution, QPainter samples the full resolution image on every repaint.
+ * Instead, the smallest level which still has at least the resolution on screen is drawn. Only the visible part of
+ * the level is drawn. The levels are created when they are needed for the first time and are discarded when a different
+ * image is drawn.
+*/
+class ImagePyramid
+{
+public:
+  ImagePyramid() = default;
+
+  // The number of levels including the full resolution image (level 0). Level n has 1/2^n of the resolution.
+  static const int NrLevels = 4;
+
+  // Draw the image into the videoRect (the size of the image multiplied by the zoomFactor).
+  void drawImage(QPainter *painter, const QImage &image, const QRect &videoRect, double zoomFactor);
+
+  // Discard all levels
+  void clear();
+
+  // Get the level that is drawn if the image is scaled by the given factor on screen
+  static int getLevelForScale(double scale);
+
+  // Scale the image down by a factor of 2 in each direction. Each output pixel is the average of 2x2 input pixels.
+  // For odd sizes, the last row/column is repeated.
+  static QImage downscaleByTwo(const QImage &image);
+
+private:
+  const QImage &getLevel(const QImage &image, int level);
+
+  // The cacheKey of the image that the levels were created from
+  qint64 imageCacheKey {0};
+  QImage levels[NrLevels - 1];
+};
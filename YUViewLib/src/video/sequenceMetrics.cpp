@@ -0,0 +1,460 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "sequenceMetrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QSettings>
+#include <QtConcurrent>
+
+#include "common/functions.h"
+#include "playlistitem/playlistItem.h"
+#include "video/videoHandlerYUV.h"
+#include "video/yuvDifference.h"
+
+#define SEQUENCE_METRICS_DEBUG 0
+#if SEQUENCE_METRICS_DEBUG && !NDEBUG
+#include <QDebug>
+#define DEBUG_METRICS qDebug
+#else
+#define DEBUG_METRICS(fmt,...) ((void)0)
+#endif
+
+namespace
+{
+
+const QStringList componentNames = QStringList() << "Y" << "U" << "V" << "All";
+
+// The CSV file uses the same separator as the CSV statistics files
+const QString CSV_SEPARATOR = ";";
+
+}
+
+PlotModel::StreamParameter SequenceMetricsPlotModel::getStreamParameter(unsigned streamIndex) const
+{
+  if (streamIndex > 0)
+    return {};
+
+  QMutexLocker locker(&this->dataMutex);
+
+  PlotModel::StreamParameter streamParameter;
+  if (!this->data.empty())
+    streamParameter.xRange = {double(this->data.first().frameIdx), double(this->data.last().frameIdx)};
+
+  // The PSNR and MSE start at 0. The SSIM is at most 1 but can be negative.
+  if (this->plottedMetric == Metric::SSIM)
+    streamParameter.yRange = {std::min(this->plottedValueRange.min, 0.0), 1.0};
+  else
+    streamParameter.yRange = {0.0, std::max(this->plottedValueRange.max, 1.0)};
+
+  streamParameter.plotParameters.append({PlotType::Line, unsigned(this->data.size())});
+  return streamParameter;
+}
+
+PlotModel::Point SequenceMetricsPlotModel::getPlotPoint(unsigned streamIndex, unsigned plotIndex, unsigned pointIndex) const
+{
+  Q_UNUSED(plotIndex);
+
+  if (streamIndex > 0)
+    return {};
+
+  QMutexLocker locker(&this->dataMutex);
+  return this->getPlotPointInternal(pointIndex);
+}
+
+std::optional<QVector<PlotModel::PointSummary>> SequenceMetricsPlotModel::getPlotSummaries(unsigned streamIndex, unsigned plotIndex, Range<double> xRange, unsigned maxNrSummaries) const
+{
+  Q_UNUSED(plotIndex);
+
+  if (streamIndex > 0)
+    return {};
+
+  QMutexLocker locker(&this->dataMutex);
+  auto getPoint = [this](unsigned pointIndex) { return this->getPlotPointInternal(pointIndex); };
+  return this->summary.getSummaries(unsigned(this->data.size()), getPoint, xRange, maxNrSummaries);
+}
+
+PlotModel::Point SequenceMetricsPlotModel::getPlotPointInternal(unsigned pointIndex) const
+{
+  if (pointIndex >= unsigned(this->data.size()))
+    return {};
+
+  const auto &metrics = this->data[pointIndex];
+  PlotModel::Point point;
+  point.x = metrics.frameIdx;
+  point.y = this->getPlottedValue(metrics);
+  point.width = 0;
+  point.intra = false;
+  return point;
+}
+
+QString SequenceMetricsPlotModel::getPointInfo(unsigned streamIndex, unsigned plotIndex, unsigned pointIndex) const
+{
+  Q_UNUSED(plotIndex);
+
+  if (streamIndex > 0)
+    return {};
+
+  QMutexLocker locker(&this->dataMutex);
+  if (pointIndex >= unsigned(this->data.size()))
+    return {};
+
+  const auto &metrics = this->data[pointIndex];
+  QString info = QString("<h4>Frame %1</h4><table width=\"100%\">").arg(metrics.frameIdx);
+  auto addRow = [&info](const QString &name, const QString &value)
+  {
+    info += QString("<tr><td>%1:</td><td align=\"right\">%2</td></tr>").arg(name, value);
+  };
+  for (int c = 0; c < metrics.nrComponents; c++)
+    addRow(getMetricName(Metric::PSNR, c), QString("%1&nbsp;dB").arg(metrics.psnr[c], 0, 'f', 3));
+  for (int c = 0; c < metrics.nrComponents; c++)
+    addRow(getMetricName(Metric::MSE, c), QString::number(metrics.mse[c]));
+  addRow(getMetricName(Metric::MSE, 3), QString::number(metrics.mse[3]));
+  for (int c = 0; c < metrics.nrComponents; c++)
+    addRow(getMetricName(Metric::SSIM, c), QString::number(metrics.ssim[c], 'f', 5));
+  info += "</table>";
+  return info;
+}
+
+QString SequenceMetricsPlotModel::formatValue(Axis axis, double value) const
+{
+  if (axis == Axis::X)
+    return QString::number(int(value));
+  if (this->plottedMetric == Metric::PSNR)
+    return QString("%1 dB").arg(value, 0, 'f', 1);
+  if (this->plottedMetric == Metric::SSIM)
+    return QString::number(value, 'f', 3);
+  return QString::number(value);
+}
+
+void SequenceMetricsPlotModel::setPlottedMetric(Metric metric, int component)
+{
+  {
+    QMutexLocker locker(&this->dataMutex);
+    this->plottedMetric = metric;
+    this->plottedComponent = component;
+
+    this->summary.clear();
+    this->plottedValueRange = {0, 0};
+    for (const auto &metrics : this->data)
+    {
+      const auto value = this->getPlottedValue(metrics);
+      this->plottedValueRange.min = std::min(this->plottedValueRange.min, value);
+      this->plottedValueRange.max = std::max(this->plottedValueRange.max, value);
+    }
+  }
+  emit dataChanged();
+}
+
+void SequenceMetricsPlotModel::addFrameMetrics(const FrameMetrics &metrics)
+{
+  bool firstFrame;
+  {
+    QMutexLocker locker(&this->dataMutex);
+    this->data.append(metrics);
+    const auto value = this->getPlottedValue(metrics);
+    this->plottedValueRange.min = std::min(this->plottedValueRange.min, value);
+    this->plottedValueRange.max = std::max(this->plottedValueRange.max, value);
+    firstFrame = (this->data.size() == 1);
+  }
+
+  // The frames are added from the background thread of the job. The event subsampler uses a timer, so it has to
+  // be triggered in its own thread.
+  QMetaObject::invokeMethod(&this->eventSubsampler, "postEvent", Qt::QueuedConnection);
+  if (firstFrame)
+    // Technically the number of streams did not change but with this we can inform the view to start drawing.
+    emit nrStreamsChanged();
+}
+
+void SequenceMetricsPlotModel::clear()
+{
+  {
+    QMutexLocker locker(&this->dataMutex);
+    this->data.clear();
+    this->summary.clear();
+    this->plottedValueRange = {0, 0};
+  }
+  emit dataChanged();
+}
+
+QString SequenceMetricsPlotModel::getMetricName(Metric metric, int component)
+{
+  const QString metricName = (metric == Metric::PSNR) ? "PSNR" : (metric == Metric::MSE) ? "MSE" : "SSIM";
+  return metricName + " " + componentNames[component];
+}
+
+double SequenceMetricsPlotModel::getPlottedValue(const FrameMetrics &metrics) const
+{
+  if (this->plottedMetric == Metric::MSE)
+    return (this->plottedComponent < metrics.nrComponents || this->plottedComponent == 3) ? metrics.mse[this->plottedComponent] : 0.0;
+  if (this->plottedComponent >= metrics.nrComponents)
+    return 0.0;
+  if (this->plottedMetric == Metric::SSIM)
+    return metrics.ssim[this->plottedComponent];
+  return std::min(metrics.psnr[this->plottedComponent], MaxPlottedPSNR);
+}
+
+SequenceMetricsJob::SequenceMetricsJob(playlistItem *item0, playlistItem *item1, indexRange frameRange)
+  : frameRange(frameRange)
+{
+  this->items[0] = item0;
+  this->items[1] = item1;
+
+  // The job itself, the loading of the next frame and the loading of the second item
+  this->threadPool.setMaxThreadCount(3);
+
+  QSettings settings;
+  this->nrConversionThreads = settings.value("VideoCache/ConversionThreads", functions::getOptimalThreadCount()).toInt();
+}
+
+SequenceMetricsJob::~SequenceMetricsJob()
+{
+  this->cancel();
+}
+
+bool SequenceMetricsJob::prepare(const QString &csvFilePath, QString &errorMessage)
+{
+  for (int i = 0; i < 2; i++)
+  {
+    this->video[i] = (this->items[i] != nullptr) ? dynamic_cast<videoHandlerYUV*>(this->items[i]->getFrameHandler()) : nullptr;
+    if (this->video[i] == nullptr || !this->video[i]->isFormatValid())
+    {
+      errorMessage = "The metrics can only be calculated for two items with a valid YUV format.";
+      return false;
+    }
+    this->sourceFormat[i] = this->video[i]->getFormatAsString();
+  }
+  if (this->getNrFrames() <= 0)
+  {
+    errorMessage = "There are no frames to compare.";
+    return false;
+  }
+
+  if (!csvFilePath.isEmpty())
+  {
+    this->csvFile.setFileName(csvFilePath);
+    if (!this->csvFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+      errorMessage = QString("Error opening the file %1 for writing.").arg(csvFilePath);
+      return false;
+    }
+    this->csvStream.setDevice(&this->csvFile);
+    this->writeCSVHeader();
+  }
+  return true;
+}
+
+void SequenceMetricsJob::start()
+{
+  this->cancel();
+  this->canceled = false;
+  this->running = true;
+  this->jobFuture = QtConcurrent::run(&this->threadPool, [this]() { return this->run(); });
+}
+
+bool SequenceMetricsJob::run()
+{
+  this->running = true;
+
+  const int nrFrames = this->getNrFrames();
+  DEBUG_METRICS("SequenceMetricsJob::run %d frames", nrFrames);
+
+  YUV_Internals::DifferenceSettings settings;
+  settings.calculateSSIM = true;
+  QByteArray differenceBuffer;
+
+  // While a frame is compared, the next frame is loaded
+  const int firstFrameIdx = this->frameRange.first;
+  auto nextFrames = QtConcurrent::run(&this->threadPool, [this, firstFrameIdx]() { return this->loadInputFrames(firstFrameIdx); });
+  bool success = true;
+  for (int frameIdx = this->frameRange.first; frameIdx <= this->frameRange.second; frameIdx++)
+  {
+    const InputFrames frames = nextFrames.result();
+    if (this->canceled)
+    {
+      this->setErrorMessage("The calculation was canceled.");
+      success = false;
+      break;
+    }
+    if (frameIdx < this->frameRange.second)
+      nextFrames = QtConcurrent::run(&this->threadPool, [this, frameIdx]() { return this->loadInputFrames(frameIdx + 1); });
+
+    if (!frames.loaded[0] || !frames.loaded[1])
+    {
+      const int failedItem = frames.loaded[0] ? 1 : 0;
+      this->setErrorMessage(QString("Loading frame %1 of item %2 failed.").arg(this->items[failedItem]->getFrameIdxInternal(frameIdx)).arg(this->items[failedItem]->getName()));
+      success = false;
+      break;
+    }
+    if (this->video[0]->getFormatAsString() != this->sourceFormat[0] || this->video[1]->getFormatAsString() != this->sourceFormat[1])
+    {
+      this->setErrorMessage("The format of one of the items changed.");
+      success = false;
+      break;
+    }
+
+    YUV_Internals::DifferenceResult result;
+    if (!YUV_Internals::calculateDifference(frames.data[0], frames.format[0], frames.size[0], frames.data[1], frames.format[1], frames.size[1],
+                                            differenceBuffer, result, settings, this->nrConversionThreads, &videoHandler::runConversionInParallel))
+    {
+      this->setErrorMessage("The formats of the two items can not be compared. The subsampling must be identical.");
+      success = false;
+      break;
+    }
+
+    SequenceMetricsPlotModel::FrameMetrics metrics;
+    metrics.frameIdx = frameIdx;
+    metrics.nrComponents = result.nrComponents;
+    for (int c = 0; c < result.nrComponents; c++)
+    {
+      metrics.psnr[c] = result.components[c].getPSNR();
+      metrics.mse[c] = result.components[c].getMSE();
+      metrics.ssim[c] = result.components[c].getSSIM();
+    }
+    metrics.mse[3] = result.getCombinedMetrics().getMSE();
+
+    {
+      QMutexLocker locker(&this->resultMutex);
+      this->frameMetrics.append(metrics);
+    }
+    this->writeCSVLine(metrics);
+    this->plotModel.addFrameMetrics(metrics);
+
+    this->nrFramesDone++;
+    emit progressChanged(this->nrFramesDone, nrFrames);
+  }
+
+  // Wait for a loading that may still be running
+  nextFrames.waitForFinished();
+
+  if (this->csvFile.isOpen())
+  {
+    this->csvStream.flush();
+    if (this->csvStream.status() != QTextStream::Ok)
+    {
+      this->setErrorMessage(QString("Error writing to the file %1.").arg(this->csvFile.fileName()));
+      success = false;
+    }
+    this->csvFile.close();
+  }
+
+  DEBUG_METRICS("SequenceMetricsJob::run done %d frames %s", int(this->nrFramesDone), success ? "success" : "error");
+  this->running = false;
+  emit jobFinished(success);
+  return success;
+}
+
+void SequenceMetricsJob::cancel()
+{
+  this->canceled = true;
+  this->jobFuture.waitForFinished();
+}
+
+QString SequenceMetricsJob::getErrorMessage() const
+{
+  QMutexLocker locker(&this->resultMutex);
+  return this->errorMessage;
+}
+
+QVector<SequenceMetricsPlotModel::FrameMetrics> SequenceMetricsJob::getFrameMetrics() const
+{
+  QMutexLocker locker(&this->resultMutex);
+  return this->frameMetrics;
+}
+
+SequenceMetricsJob::InputFrames SequenceMetricsJob::loadInputFrames(int frameIdx)
+{
+  InputFrames frames;
+  if (this->canceled)
+    return frames;
+
+  // The second item is loaded in parallel. The items may be decoded by different decoders or read from different files.
+  auto loadItem = [this, frameIdx, &frames](int i)
+  {
+    const int frameIdxInternal = this->items[i]->getFrameIdxInternal(frameIdx);
+    frames.loaded[i] = this->video[i]->loadPlanarFrame(frameIdxInternal, frames.data[i], frames.format[i], frames.size[i]);
+  };
+  auto loadingSecondItem = QtConcurrent::run(&this->threadPool, [&loadItem]() { loadItem(1); });
+  loadItem(0);
+  loadingSecondItem.waitForFinished();
+  return frames;
+}
+
+void SequenceMetricsJob::writeCSVHeader()
+{
+  using Metric = SequenceMetricsPlotModel::Metric;
+  QStringList columns;
+  columns << "Frame";
+  for (int c = 0; c < 3; c++)
+    columns << SequenceMetricsPlotModel::getMetricName(Metric::PSNR, c);
+  for (int c = 0; c < 4; c++)
+    columns << SequenceMetricsPlotModel::getMetricName(Metric::MSE, c);
+  for (int c = 0; c < 3; c++)
+    columns << SequenceMetricsPlotModel::getMetricName(Metric::SSIM, c);
+  this->csvStream << columns.join(CSV_SEPARATOR) << "\n";
+  this->csvStream.flush();
+}
+
+void SequenceMetricsJob::writeCSVLine(const SequenceMetricsPlotModel::FrameMetrics &metrics)
+{
+  if (!this->csvFile.isOpen())
+    return;
+
+  // Components that the format does not have (4:0:0) are left empty
+  auto valueOrEmpty = [&metrics](double value, int component, int precision)
+  {
+    return (component < metrics.nrComponents) ? QString::number(value, 'f', precision) : QString();
+  };
+
+  QStringList columns;
+  columns << QString::number(metrics.frameIdx);
+  for (int c = 0; c < 3; c++)
+    columns << ((std::isinf(metrics.psnr[c]) && c < metrics.nrComponents) ? QString("inf") : valueOrEmpty(metrics.psnr[c], c, 4));
+  for (int c = 0; c < 3; c++)
+    columns << valueOrEmpty(metrics.mse[c], c, 4);
+  columns << QString::number(metrics.mse[3], 'f', 4);
+  for (int c = 0; c < 3; c++)
+    columns << valueOrEmpty(metrics.ssim[c], c, 6);
+
+  // Flush every line so that the file can be followed while the job runs
+  this->csvStream << columns.join(CSV_SEPARATOR) << "\n";
+  this->csvStream.flush();
+}
+
+void SequenceMetricsJob::setErrorMessage(const QString &message)
+{
+  QMutexLocker locker(&this->resultMutex);
+  this->errorMessage = message;
+}
@@ -0,0 +1,193 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <atomic>
+
+#include <QFile>
+#include <QFuture>
+#include <QMutex>
+#include <QSize>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QVector>
+
+#include "common/typedef.h"
+#include "ui/views/plotModel.h"
+#include "ui/views/PlotSummaryPyramid.h"
+#include "video/yuvPixelFormat.h"
+
+class playlistItem;
+class videoHandlerYUV;
+
+// The objective metrics of the frames of a sequence (see SequenceMetricsJob) as a plot over the frame index.
+// Only one metric of one component is plotted at a time.
+class SequenceMetricsPlotModel : public PlotModel
+{
+public:
+  SequenceMetricsPlotModel() = default;
+  virtual ~SequenceMetricsPlotModel() = default;
+
+  enum class Metric
+  {
+    PSNR,
+    MSE,
+    SSIM
+  };
+
+  // The metrics of the Y, U and V component of one frame. mse[3] is the MSE of all samples of all components.
+  struct FrameMetrics
+  {
+    int frameIdx {0};
+    int nrComponents {0};
+    double psnr[3] {0, 0, 0};
+    double mse[4] {0, 0, 0, 0};
+    double ssim[3] {0, 0, 0};
+  };
+
+  unsigned getNrStreams() const override { return 1; }
+  PlotModel::StreamParameter getStreamParameter(unsigned streamIndex) const override;
+  PlotModel::Point getPlotPoint(unsigned streamIndex, unsigned plotIndex, unsigned pointIndex) const override;
+  std::optional<QVector<PlotModel::PointSummary>> getPlotSummaries(unsigned streamIndex, unsigned plotIndex, Range<double> xRange, unsigned maxNrSummaries) const override;
+  QString getPointInfo(unsigned streamIndex, unsigned plotIndex, unsigned pointIndex) const override;
+  std::optional<unsigned> getReasonabelRangeToShowOnXAxisPer100Pixels() const override { return 10; }
+  QString formatValue(Axis axis, double value) const override;
+
+  // Select the plotted metric and component (0: Y, 1: U, 2: V). For the MSE, component 3 is the MSE of all components.
+  void setPlottedMetric(Metric metric, int component);
+
+  // Add the metrics of the next frame. The frames must be added in increasing order. This is thread-safe.
+  void addFrameMetrics(const FrameMetrics &metrics);
+  void clear();
+
+  // The name of a metric/component (e.g. "PSNR Y")
+  static QString getMetricName(Metric metric, int component);
+
+private:
+  // The value of the plotted metric of the given frame. An infinite PSNR (no difference) is plotted as MaxPlottedPSNR.
+  double getPlottedValue(const FrameMetrics &metrics) const;
+  PlotModel::Point getPlotPointInternal(unsigned pointIndex) const;
+
+  static constexpr double MaxPlottedPSNR = 100.0;
+
+  QVector<FrameMetrics> data;
+  mutable QMutex dataMutex;
+
+  Metric plottedMetric {Metric::PSNR};
+  int plottedComponent {0};
+  // The minimum and maximum of the plotted values
+  Range<double> plottedValueRange {0, 0};
+
+  // Summary of the plotted values for drawing when zoomed out. Cleared when the plotted metric changes.
+  mutable PlotSummaryPyramid summary;
+};
+
+/* Calculate PSNR, MSE and SSIM of all frames of two YUV items in the background. The frames are compared with the YUV
+ * difference engine (see yuvDifference.h) which splits each frame into bands that are processed in parallel. While one
+ * frame is compared, the next frame of both items is loaded (in parallel). Frames that are in the raw data cache of an
+ * item are taken from there. All other frames are requested like for caching (see videoHandler::loadRawFrame), so a
+ * compressed item uses its caching decoders (caching must be enabled) and does not disturb the frame on screen.
+ * The results are added to a plot model and streamed to a CSV file (one line per frame).
+ */
+class SequenceMetricsJob : public QObject
+{
+  Q_OBJECT
+
+public:
+  // Compare the frames of the given range. For a frame index of this range, the frame of an item is
+  // item->getFrameIdxInternal(frameIdx).
+  SequenceMetricsJob(playlistItem *item0, playlistItem *item1, indexRange frameRange);
+  // The job is canceled if it is still running
+  ~SequenceMetricsJob();
+
+  // Check the items and open the CSV file (if a path is given). Returns false if the job can not be run.
+  bool prepare(const QString &csvFilePath, QString &errorMessage);
+  // Run the job in a background thread. The signals are emitted from this thread.
+  void start();
+  // Run the job in the calling thread. Returns false if an error occurred or the job was canceled.
+  bool run();
+  // Stop the job and wait until the background thread returned. The results so far are kept.
+  void cancel();
+  bool isRunning() const { return running; }
+
+  int getNrFrames() const { return frameRange.second - frameRange.first + 1; }
+  int getNrFramesDone() const { return nrFramesDone; }
+  QString getErrorMessage() const;
+
+  SequenceMetricsPlotModel *getPlotModel() { return &plotModel; }
+
+  // The metrics of all frames so far (for the mean values)
+  QVector<SequenceMetricsPlotModel::FrameMetrics> getFrameMetrics() const;
+
+signals:
+  void progressChanged(int nrFramesDone, int nrFrames);
+  void jobFinished(bool success);
+
+private:
+  // The planar data of one frame of both items
+  struct InputFrames
+  {
+    QByteArray data[2];
+    YUV_Internals::yuvPixelFormat format[2];
+    QSize size[2];
+    bool loaded[2] {false, false};
+  };
+  InputFrames loadInputFrames(int frameIdx);
+
+  void writeCSVHeader();
+  void writeCSVLine(const SequenceMetricsPlotModel::FrameMetrics &metrics);
+  void setErrorMessage(const QString &message);
+
+  playlistItem *items[2];
+  videoHandlerYUV *video[2] {nullptr, nullptr};
+  // The format (and size) of the items when the job was started. If this changes while the job runs, the job is stopped.
+  QString sourceFormat[2];
+  indexRange frameRange;
+  int nrConversionThreads {1};
+
+  QFile csvFile;
+  QTextStream csvStream;
+
+  SequenceMetricsPlotModel plotModel;
+  QVector<SequenceMetricsPlotModel::FrameMetrics> frameMetrics;
+  mutable QMutex resultMutex;
+  QString errorMessage;
+
+  // The job, the loading of the next frame and the loading of the second item run in this pool
+  QThreadPool threadPool;
+  QFuture<bool> jobFuture;
+  std::atomic_bool running {false};
+  std::atomic_bool canceled {false};
+  std::atomic_int nrFramesDone {0};
+};
@@ -858,6 +858,20 @@ void videoCache::enqueueCacheJob(playlistItem* item, indexRange range)
 {
   // Only schedule frames for caching that were not yet cached.
   QList<int> cachedFrames = item->getCachedFrames();
+  QList<indexRange> segments = item->getCachingSegments(range);
+  if (!segments.isEmpty())
+  {
+    // Enqueue one job per segment. These will be cached in parallel.
+    for (indexRange segment : segments)
+    {
+      while (cachedFrames.contains(segment.first) && segment.first < segment.second)
+        segment.first++;
+      if (!cachedFrames.contains(segment.first))
+        cacheQueue.append(cacheJob(item, segment, true));
+    }
+    return;
+  }
+
   int i = range.first;
   while (cachedFrames.contains(i) && i < range.second)
     range.first = ++i;
@@ -942,6 +956,8 @@ void videoCache::threadCachingFinished()
       if (!jobsRunning)
       {
         DEBUG_CACHING("videoCache::threadCachingFinished Start test now");
+        if (testItem)
+          testItem->resetCachingDurations();
         testDuration.start();
         startCaching();
       }
@@ -1186,6 +1202,17 @@ bool videoCache::pushNextJobToCachingThread(loadingThread *thread)
           continue;
       }
 
+      if (job.isSegment)
+      {
+        // The frames of a segment are cached in order by one thread. Is a thread still caching a frame of it?
+        bool segmentBusy = false;
+        for (loadingThread *t : cachingThreadList)
+          if (t->worker()->isWorking() && t->worker()->getCacheItem() == job.plItem && t->worker()->getCacheFrame() >= job.segmentStart && t->worker()->getCacheFrame() <= job.frameRange.second)
+            segmentBusy = true;
+        if (segmentBusy)
+          continue;
+      }
+
       // We can start another thread for this item
       plItem = job.plItem;
       range = job.frameRange;
@@ -1358,6 +1385,7 @@ void videoCache::testConversionSpeed()
   if (workersState == workersIdle)
   {
     // Start caching (in test mode)
+    testItem->resetCachingDurations();
     testDuration.start();
     startCaching();
   }
@@ -1408,7 +1436,16 @@ void videoCache::testFinished()
   // Calculate and report the time
   int64_t msec = testDuration.elapsed();
   double rate = 1000.0 * 1000 / msec;
-  QMessageBox::information(parentWidget, "Test results", QString("We cached 1000 frames in %1 msec. The conversion rate is %2 frames per second.").arg(msec).arg(rate));
+  QString result = QString("We cached 1000 frames in %1 msec. The conversion rate is %2 frames per second.").arg(msec).arg(rate);
+  int64_t loadingNsec, totalNsec;
+  if (!testItem.isNull() && testItem->getCachingDurations(loadingNsec, totalNsec))
+  {
+    // These are summed over all caching threads
+    int64_t loadingMsec = loadingNsec / 1000000;
+    int64_t conversionMsec = (totalNsec - loadingNsec) / 1000000;
+    result += QString("\n\nSummed over all %1 caching threads, %2 msec were spent loading the data (reading/decoding) and %3 msec converting it.").arg(cachingThreadList.count()).arg(loadingMsec).arg(conversionMsec);
+  }
+  QMessageBox::information(parentWidget, "Test results", result);
 }
 
 #include "videoCache.moc"
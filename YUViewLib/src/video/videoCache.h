@@ -105,12 +105,15 @@ private slots:
  
 private:
   // A cache job. Has a pointer to a playlist item and a range of frames to be cached.
+  // If the job is a segment (see playlistItem::getCachingSegments), only one thread may work on it at a time.
   struct cacheJob
   {
     cacheJob() {}
-    cacheJob(playlistItem *item, indexRange range) { plItem = item; frameRange = range; }
+    cacheJob(playlistItem *item, indexRange range, bool segment=false) { plItem = item; frameRange = range; isSegment = segment; segmentStart = range.first; }
     QPointer<playlistItem> plItem;
     indexRange frameRange;
+    bool isSegment {false};
+    int segmentStart {-1};
   };
   typedef QPair<QPointer<playlistItem>, int> plItemFrame;
 
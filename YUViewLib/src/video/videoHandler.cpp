@@ -32,7 +32,11 @@
 
 #include "videoHandler.h"
 
+#include <QElapsedTimer>
 #include <QPainter>
+#include <QSettings>
+#include <QThreadPool>
+#include <QtConcurrent>
 
 #include "common/functions.h"
 
@@ -53,6 +57,29 @@ videoHandler::videoHandler()
   cacheValid = true;
   currentFrameRawData_frameIdx = -1;
   rawData_frameIdx = -1;
+
+  QSettings settings;
+  cacheRawData = settings.value("VideoCache/CacheRawData", false).toBool();
+  nrConversionThreads = settings.value("VideoCache/ConversionThreads", functions::getOptimalThreadCount()).toInt();
+}
+
+void videoHandler::updateSettings()
+{
+  QSettings settings;
+  nrConversionThreads = settings.value("VideoCache/ConversionThreads", functions::getOptimalThreadCount()).toInt();
+
+  const bool newCacheRawData = settings.value("VideoCache/CacheRawData", false).toBool();
+  if (newCacheRawData == cacheRawData)
+    return;
+
+  const bool wasCachingRawData = isCachingRawData();
+  cacheRawData = newCacheRawData;
+  if (wasCachingRawData != isCachingRawData())
+  {
+    // All frames in the cache were cached in the other mode. Clear the cache and recache.
+    setCacheInvalid();
+    emit signalHandlerChanged(false, RECACHE_CLEAR);
+  }
 }
 
 void videoHandler::slotVideoControlChanged()
@@ -84,6 +111,7 @@ void videoHandler::setFrameSize(const QSize &size)
   {
     currentFrameRawData_frameIdx = -1;
     currentImageIdx = -1;
+    formatGeneration++;
   }
 
   frameHandler::setFrameSize(size);
@@ -111,7 +139,7 @@ itemLoadingState videoHandler::needsLoading(int frameIdx, bool loadRawValues)
       DEBUG_VIDEO("videoHandler::needsLoading %d is current and %d found in double buffer", frameIdx, frameIdx+1);
       return LoadingNotNeeded;
     }
-    else if (cacheValid && imageCache.contains(frameIdx + 1))
+    else if (cacheValid && cacheContains(frameIdx + 1))
     {
       DEBUG_VIDEO("videoHandler::needsLoading %d is current and %d found in cache", frameIdx, frameIdx+1);
       return LoadingNotNeeded;
@@ -128,7 +156,7 @@ itemLoadingState videoHandler::needsLoading(int frameIdx, bool loadRawValues)
   if (doubleBufferImageFrameIdx == frameIdx)
   {
     // The frame in question is in the double buffer...
-    if (cacheValid && imageCache.contains(frameIdx + 1))
+    if (cacheValid && cacheContains(frameIdx + 1))
     {
       // ... and the one after that is in the cache.
       DEBUG_VIDEO("videoHandler::needsLoading %d found in double buffer. Next frame in cache.", frameIdx);
@@ -145,7 +173,7 @@ itemLoadingState videoHandler::needsLoading(int frameIdx, bool loadRawValues)
   }
 
   // Check the cache
-  if (cacheValid && imageCache.contains(frameIdx))
+  if (cacheValid && cacheContains(frameIdx))
   {
     // What about the next frame? Is it also in the cache or in the double buffer?
     if (doubleBufferImageFrameIdx == frameIdx + 1)
@@ -153,7 +181,7 @@ itemLoadingState videoHandler::needsLoading(int frameIdx, bool loadRawValues)
       DEBUG_VIDEO("videoHandler::needsLoading %d in cache and %d found in double buffer", frameIdx, frameIdx+1);
       return LoadingNotNeeded;
     }
-    else if (cacheValid && imageCache.contains(frameIdx + 1))
+    else if (cacheValid && cacheContains(frameIdx + 1))
     {
       DEBUG_VIDEO("videoHandler::needsLoading %d in cache and %d found in cache", frameIdx, frameIdx+1);
       return LoadingNotNeeded;
@@ -194,6 +222,21 @@ void videoHandler::drawFrame(QPainter *painter, int frameIdx, double zoomFactor,
         currentImageIdx = frameIdx;
         DEBUG_VIDEO("videoHandler::drawFrame %d loaded from cache", frameIdx);
       }
+      else if (cacheValid && rawDataCache.contains(frameIdx))
+      {
+        // Convert the cached raw data now
+        const QByteArray cachedRawData = rawDataCache[frameIdx];
+        lock.unlock();
+        QImage newImage;
+        convertRawFrameToImage(cachedRawData, newImage);
+        if (!newImage.isNull())
+        {
+          QMutexLocker imageLock(&currentImageSetMutex);
+          currentImage = newImage;
+          currentImageIdx = frameIdx;
+          DEBUG_VIDEO("videoHandler::drawFrame %d converted from raw data in cache", frameIdx);
+        }
+      }
     }
   }
 
@@ -202,9 +245,25 @@ void videoHandler::drawFrame(QPainter *painter, int frameIdx, double zoomFactor,
   videoRect.setSize(frameSize * zoomFactor);
   videoRect.moveCenter(QPoint(0,0));
 
+  // Get the part of the frame that is visible. If only a region of the current frame was converted and
+  // the visible part is not in there, the complete frame must be converted now.
+  const QRectF visibleRect = functions::getVisiblePaintRect(painter) & QRectF(videoRect);
+  QRect visibleFrameRect;
+  if (!visibleRect.isEmpty())
+  {
+    const QRectF frameRect((visibleRect.topLeft() - videoRect.topLeft()) / zoomFactor, visibleRect.size() / zoomFactor);
+    visibleFrameRect = frameRect.toAlignedRect() & QRect(QPoint(0, 0), frameSize);
+  }
+  currentImageSetMutex.lock();
+  lastVisibleFrameRect = visibleFrameRect;
+  const bool convertComplete = isCurrentImagePartial() && !visibleFrameRect.isEmpty() && !currentImageRegion.contains(visibleFrameRect);
+  currentImageSetMutex.unlock();
+  if (convertComplete)
+    convertCompleteCurrentImage();
+
   // Draw the current image (currentImage)
   currentImageSetMutex.lock();
-  painter->drawImage(videoRect, currentImage);
+  imagePyramid.drawImage(painter, currentImage, videoRect, zoomFactor);
   currentImageSetMutex.unlock();
 
   if (drawRawValues && zoomFactor >= SPLITVIEW_DRAW_VALUES_ZOOMFACTOR)
@@ -223,6 +282,8 @@ QImage videoHandler::calculateDifference(frameHandler *item2, const int frameIdx
     // The item2 is not a videoItem but this one is.
     if (currentImageIdx != frameIdxItem0)
       loadFrame(frameIdxItem0);
+    if (isCurrentImagePartial())
+      convertCompleteCurrentImage();
     // Call the frameHandler implementation to calculate the difference
     return frameHandler::calculateDifference(item2, frameIdxItem0, frameIdxItem1, differenceInfoList, amplificationFactor, markDifference);
   }
@@ -233,6 +294,12 @@ QImage videoHandler::calculateDifference(frameHandler *item2, const int frameIdx
   if (videoItem2->currentImageIdx != frameIdxItem1)
     videoItem2->loadFrame(frameIdxItem1);
 
+  // The difference is calculated for all pixels
+  if (isCurrentImagePartial())
+    convertCompleteCurrentImage();
+  if (videoItem2->isCurrentImagePartial())
+    videoItem2->convertCompleteCurrentImage();
+
   return frameHandler::calculateDifference(item2, frameIdxItem0, frameIdxItem1, differenceInfoList, amplificationFactor, markDifference);
 }
 
@@ -244,7 +311,7 @@ QRgb videoHandler::getPixelVal(int x, int y)
 int videoHandler::getNrFramesCached() const
 {
   QMutexLocker lock(&imageCacheAccess);
-  return imageCache.size();
+  return imageCache.size() + rawDataCache.size();
 }
 
 // Put the frame into the cache (if it is not already in there)
@@ -259,24 +326,83 @@ void videoHandler::cacheFrame(int frameIdx, bool testMode)
     return;
   }
 
+  // Frames that were loaded while the format changed are not put into the cache
+  const int loadingFormatGeneration = formatGeneration;
+  QElapsedTimer cachingTimer;
+  cachingTimer.start();
+
+  if (isCachingRawData())
+  {
+    // Only load the raw data. It is converted when the frame is drawn.
+    QByteArray cacheData;
+    loadRawFrameForCaching(frameIdx, cacheData);
+    cachingTotalNsec += cachingTimer.nsecsElapsed();
+    if (!cacheData.isEmpty())
+    {
+      DEBUG_VIDEO("videoHandler::cacheFrame insert raw data of frame %i into cache", frameIdx);
+      QMutexLocker imageCacheLock(&imageCacheAccess);
+      if (cacheValid && !testMode && loadingFormatGeneration == formatGeneration)
+        rawDataCache.insert(frameIdx, cacheData);
+    }
+    else
+      DEBUG_VIDEO("videoHandler::cacheFrame loading raw data of frame %i for caching failed", frameIdx);
+    return;
+  }
+
   // Load the frame. While this is happening in the background the frame size must not change.
   QImage cacheImage;
   loadFrameForCaching(frameIdx, cacheImage);
+  cachingTotalNsec += cachingTimer.nsecsElapsed();
 
   // Put it into the cache
   if (!cacheImage.isNull())
   {
     DEBUG_VIDEO("videoHandler::cacheFrame insert frame %i into cache", frameIdx);
     QMutexLocker imageCacheLock(&imageCacheAccess);
-    if (cacheValid && !testMode)
+    if (cacheValid && !testMode && loadingFormatGeneration == formatGeneration)
       imageCache.insert(frameIdx, cacheImage);
   }
   else
     DEBUG_VIDEO("videoHandler::cacheFrame loading frame %i for caching failed", frameIdx);
 }
 
+bool videoHandler::cacheRawFrame(int frameIdx, const QByteArray &frameRawData)
+{
+  DEBUG_VIDEO("videoHandler::cacheRawFrame %d", frameIdx);
+
+  if (frameRawData.isEmpty() || !cacheValid || isInCache(frameIdx))
+    return false;
+
+  if (isCachingRawData())
+  {
+    if (frameRawData.size() < getBytesPerFrame())
+      return false;
+    QMutexLocker imageCacheLock(&imageCacheAccess);
+    if (!cacheValid)
+      return false;
+    rawDataCache.insert(frameIdx, frameRawData);
+    return true;
+  }
+
+  QImage cacheImage;
+  convertRawFrameToImage(frameRawData, cacheImage);
+  if (cacheImage.isNull())
+  {
+    DEBUG_VIDEO("videoHandler::cacheRawFrame converting frame %i failed", frameIdx);
+    return false;
+  }
+
+  QMutexLocker imageCacheLock(&imageCacheAccess);
+  if (!cacheValid)
+    return false;
+  imageCache.insert(frameIdx, cacheImage);
+  return true;
+}
+
 unsigned int videoHandler::getCachingFrameSize() const
 {
+  if (isCachingRawData())
+    return (unsigned int)getBytesPerFrame();
   auto bytes = functions::bytesPerPixel(functions::platformImageFormat());
   return frameSize.width() * frameSize.height() * bytes;
 }
@@ -284,19 +410,19 @@ unsigned int videoHandler::getCachingFrameSize() const
 QList<int> videoHandler::getCachedFrames() const
 {
   QMutexLocker lock(&imageCacheAccess);
-  return imageCache.keys();
+  return imageCache.keys() + rawDataCache.keys();
 }
 
 int videoHandler::getNumberCachedFrames() const
 {
   QMutexLocker lock(&imageCacheAccess);
-  return imageCache.size();
+  return imageCache.size() + rawDataCache.size();
 }
 
 bool videoHandler::isInCache(int idx) const
 {
   QMutexLocker lock(&imageCacheAccess);
-  return imageCache.contains(idx);
+  return cacheContains(idx);
 }
 
 void videoHandler::removeFrameFromCache(int frameIdx)
@@ -304,6 +430,7 @@ void videoHandler::removeFrameFromCache(int frameIdx)
   DEBUG_VIDEO("removeFrameFromCache %d", frameIdx);
   QMutexLocker lock(&imageCacheAccess);
   imageCache.remove(frameIdx);
+  rawDataCache.remove(frameIdx);
   lock.unlock();
 }
 
@@ -312,6 +439,7 @@ void videoHandler::removeAllFrameFromCache()
   DEBUG_VIDEO("removeAllFrameFromCache");
   QMutexLocker lock(&imageCacheAccess);
   imageCache.clear();
+  rawDataCache.clear();
   cacheValid = true;
   lock.unlock();
 }
@@ -364,6 +492,77 @@ void videoHandler::loadFrameForCaching(int frameIndex, QImage &frameToCache)
   frameToCache = requestedFrame;
 }
 
+void videoHandler::loadRawFrameForCaching(int frameIndex, QByteArray &rawFrameToCache)
+{
+  DEBUG_VIDEO("videoHandler::loadRawFrameForCaching %d", frameIndex);
+
+  QByteArray frameRawData;
+  if (!requestRawDataForCaching(frameIndex, frameRawData) || frameRawData.size() < getBytesPerFrame())
+    // Loading failed
+    return;
+
+  rawFrameToCache = frameRawData;
+}
+
+bool videoHandler::requestRawDataForCaching(int frameIndex, QByteArray &targetBuffer, bool countLoadingTime)
+{
+  QElapsedTimer loadingTimer;
+  loadingTimer.start();
+
+  bool loadingOk;
+  if (concurrentRawDataRequests)
+  {
+    targetBuffer.clear();
+    emit signalRequestRawDataConcurrent(frameIndex, targetBuffer);
+    loadingOk = !targetBuffer.isEmpty();
+  }
+  else
+  {
+    QMutexLocker lock(&requestDataMutex);
+    emit signalRequestRawData(frameIndex, true);
+    loadingOk = (frameIndex == rawData_frameIdx);
+    if (loadingOk)
+      targetBuffer = rawData;
+  }
+
+  if (countLoadingTime)
+    cachingLoadingNsec += loadingTimer.nsecsElapsed();
+  return loadingOk;
+}
+
+bool videoHandler::loadRawFrame(int frameIdx, QByteArray &frameRawData)
+{
+  DEBUG_VIDEO("videoHandler::loadRawFrame %d", frameIdx);
+
+  {
+    QMutexLocker imageCacheLock(&imageCacheAccess);
+    if (cacheValid && rawDataCache.contains(frameIdx))
+    {
+      frameRawData = rawDataCache[frameIdx];
+      return true;
+    }
+  }
+
+  // Never fall back to the interactive loading. It is not thread-safe and would disturb the frame on screen.
+  return requestRawDataForCaching(frameIdx, frameRawData, false) && frameRawData.size() >= getBytesPerFrame();
+}
+
+void videoHandler::runConversionInParallel(int nrBands, const std::function<void(int)> &convertBand)
+{
+  // We use our own pool so that the conversion does not wait for long running jobs in the global pool (e.g. the parsing of files).
+  static QThreadPool conversionThreadPool;
+
+  QList<QFuture<void>> bandFutures;
+  for (int band = 1; band < nrBands; band++)
+    bandFutures.append(QtConcurrent::run(&conversionThreadPool, [&convertBand, band]() { convertBand(band); }));
+
+  if (nrBands > 0)
+    convertBand(0);
+
+  for (auto &f : bandFutures)
+    f.waitForFinished();
+}
+
 void videoHandler::invalidateAllBuffers()
 {
   currentFrameRawData_frameIdx = -1;
@@ -381,6 +580,7 @@ void videoHandler::invalidateAllBuffers()
   requestedFrame_idx = -1;
 
   imageCache.clear();
+  rawDataCache.clear();
   cacheValid = true;
 }
 
@@ -32,6 +32,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+
 #include <QBasicTimer>
 #include <QFileInfo>
 #include <QMutex>
@@ -64,6 +67,37 @@ public:
   bool isInCache(int idx) const;
   virtual void removeFrameFromCache(int frameIdx);
   virtual void removeAllFrameFromCache();
+  // This is incremented whenever the format changes. A frame that is loaded while the format changes must be discarded.
+  int getFormatGeneration() const { return formatGeneration; }
+  // Cache the raw (YUV/RGB) data of frames instead of the converted images? In this mode, frames from the cache are converted
+  // when they are drawn. This needs less memory and changing a display option (color conversion, YUV math, ...) does not
+  // invalidate the cache. The mode is set in the settings ("VideoCache/CacheRawData") and only used if the handler
+  // supports it. getCachingFrameSize() reflects the active mode.
+  bool isCachingRawData() const { return cacheRawData && supportsRawDataCaching(); }
+  // Reload the caching mode and the number of conversion threads from the settings. If the caching mode changed, the cache is cleared.
+  void updateSettings();
+
+  // The source of the raw data can handle multiple signalRequestRawDataConcurrent calls at the same time (e.g. a raw file).
+  // If this is set, the caching threads read the raw data into their own buffers instead of waiting for each other.
+  void setConcurrentRawDataRequests(bool enabled) { concurrentRawDataRequests = enabled; }
+
+  // For the conversion speed test: The time that all caching threads together spent in cacheFrame and how much of it
+  // was spent loading the raw data (reading / decoding). The rest is the conversion.
+  void resetCachingDurations() { cachingLoadingNsec = 0; cachingTotalNsec = 0; }
+  void getCachingDurations(int64_t &loadingNsec, int64_t &totalNsec) const { loadingNsec = cachingLoadingNsec; totalNsec = cachingTotalNsec; }
+
+  // Put a frame into the cache for which the raw data is already available (e.g. a frame that a decoder had to decode
+  // on the way to the requested frame). Returns true if the frame was added to the cache.
+  bool cacheRawFrame(int frameIdx, const QByteArray &frameRawData);
+
+  // Get the raw data of the given frame without changing the current frame of the handler (e.g. to process all frames of
+  // a sequence in the background). If the frame is in the raw data cache, the cached data is returned. Otherwise the frame
+  // is requested like for caching (this does not count towards the caching durations). This is thread-safe. Returns false
+  // if loading failed (e.g. if the source can not load frames for caching).
+  bool loadRawFrame(int frameIdx, QByteArray &frameRawData);
+  // Convert raw data from loadRawFrame to an image with the current format and display settings. This is thread-safe.
+  // The returned image is null if the handler does not work on raw data or if the data does not hold a full frame.
+  QImage convertRawFrame(const QByteArray &frameRawData) { QImage image; convertRawFrameToImage(frameRawData, image); return image; }
 
   // Get the number of bytes for one frame (RGB or YUV) with the current format (if this video handler uses raw data)
   virtual int64_t getBytesPerFrame() const { return -1; }
@@ -126,6 +160,10 @@ public:
 
   // Scale a value with limited mpeg range (16 ... 245) to the full range (0 ... 255) for output.
   static int convScaleLimitedRange(int value);
+
+  // Call convertBand for all band indices (0 ... nrBands-1) in parallel and return when all bands are converted.
+  // The calling thread converts band 0 while the others are processed by a thread pool which is shared by all handlers.
+  static void runConversionInParallel(int nrBands, const std::function<void(int)> &convertBand);
   
 signals:
 
@@ -141,6 +179,11 @@ signals:
   // frameIndex. caching will signal if this call comes from a caching thread or not. If it does come
   // from a caching thread, the result must be ready when the call to this function returns.
   void signalRequestRawData(int frameIndex, bool caching);
+
+  // Same as signalRequestRawData for caching, but the data has to be read into targetBuffer (rawData is not touched).
+  // This is emitted from multiple caching threads at the same time without locking requestDataMutex.
+  // It is only used if enabled with setConcurrentRawDataRequests(). If loading fails, targetBuffer must be left empty.
+  void signalRequestRawDataConcurrent(int frameIndex, QByteArray &targetBuffer);
     
 protected:
 
@@ -162,6 +205,28 @@ protected:
   // the requested frame. No other internal state of the specific video format handler should be changed.
   // currentFrame/currentFrameIdx is still the frame on screen. This is called from a background thread.
   virtual void loadFrameForCaching(int frameIndex, QImage &frameToCache);
+
+  // Convert the given raw data (in the current raw format of the handler) to an image that can be cached.
+  // Only video handlers that work on raw data (YUV/RGB) reimplement this. The default implementation does nothing.
+  virtual void convertRawFrameToImage(const QByteArray &frameRawData, QImage &outputImage) { Q_UNUSED(frameRawData); Q_UNUSED(outputImage); }
+  // Can the raw data be cached instead of the converted images? This requires convertRawFrameToImage to be implemented.
+  virtual bool supportsRawDataCaching() const { return false; }
+
+  // The conversion of a frame for interactive loading (not caching) can be split into bands of rows which are converted
+  // in parallel. This is the number of bands to use ("VideoCache/ConversionThreads"). 1 disables the parallel conversion.
+  int nrConversionThreads;
+
+  // Request the raw data of the given frame (signalRequestRawData) and return a copy of it in rawFrameToCache.
+  // This is used to fill the cache if raw data is cached (isCachingRawData()).
+  void loadRawFrameForCaching(int frameIndex, QByteArray &rawFrameToCache);
+
+  // Get the raw data of the given frame for caching. Depending on concurrentRawDataRequests, this either uses
+  // signalRequestRawDataConcurrent or signalRequestRawData (with requestDataMutex locked). Returns false if loading failed.
+  // If countLoadingTime is set, the loading time is added to the caching loading duration.
+  bool requestRawDataForCaching(int frameIndex, QByteArray &targetBuffer, bool countLoadingTime = true);
+  bool concurrentRawDataRequests {false};
+  std::atomic<int64_t> cachingLoadingNsec {0};
+  std::atomic<int64_t> cachingTotalNsec {0};
     
   // Only one thread at a time should request something to be loaded. 
   QMutex requestDataMutex;
@@ -172,16 +237,35 @@ protected:
   // Don't let the background loading thread set the image while we are drawing it.
   QMutex currentImageSetMutex;
 
+  // --- Region of interest: At high zoom factors, only a small part of the frame is visible. A handler may then convert
+  // only the visible part (plus a margin) of the frame to currentImage (see videoHandlerYUV::loadFrame). In this case, only
+  // currentImageRegion (in frame coordinates) is valid in the image with the cacheKey currentImageRegionKey.
+  // If currentImage is any other image, it is complete.
+  QRect  currentImageRegion;
+  qint64 currentImageRegionKey {0};
+  bool isCurrentImagePartial() const { return currentImageRegionKey != 0 && currentImage.cacheKey() == currentImageRegionKey; }
+  // The part of the frame (in frame coordinates) that was visible when the frame was drawn the last time
+  QRect lastVisibleFrameRect;
+  // If only a region of the currentImage was converted, convert the complete frame. The default implementation does nothing.
+  virtual void convertCompleteCurrentImage() {}
+
   // Double buffering
   QImage doubleBufferImage;
   int    doubleBufferImageFrameIdx;
 
   // Set the cache to be invalid until a call to removefromCache(-1) clears it.
-  void setCacheInvalid() { cacheValid = false; }
+  void setCacheInvalid() { cacheValid = false; formatGeneration++; }
+  std::atomic<int> formatGeneration {0};
 
   // --- Caching
   QMutex mutable     imageCacheAccess;
   QMap<int, QImage>  imageCache;
+  // If raw data is cached (isCachingRawData()), the raw frames are kept here instead of in the imageCache.
+  // This is also protected by the imageCacheAccess mutex.
+  QMap<int, QByteArray> rawDataCache;
+  bool cacheRawData;
+  // Is the given frame in the cache (either as an image or as raw data)? The imageCacheAccess mutex must be locked.
+  bool cacheContains(int frameIdx) const { return imageCache.contains(frameIdx) || rawDataCache.contains(frameIdx); }
   // Is the cache valid? The cache can be ivalid in the following scenario:
   // Somethign about how an item is shown changes (e.g. the resolution) but caching of the item is currently performed.
   // If we just cleared the cache, the wrong (currently being cached) frames would still end up in the cache. So we emit
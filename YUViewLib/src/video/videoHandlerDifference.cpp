@@ -88,7 +88,7 @@ void videoHandlerDifference::drawDifferenceFrame(QPainter *painter, int frameIdx
 
   // Draw the current image (currentImage)
   currentImageSetMutex.lock();
-  painter->drawImage(videoRect, currentImage);
+  imagePyramid.drawImage(painter, currentImage, videoRect, zoomFactor);
   currentImageSetMutex.unlock();
 
   if (drawRawValues && zoomFactor >= SPLITVIEW_DRAW_VALUES_ZOOMFACTOR)
@@ -127,6 +127,27 @@ void videoHandlerDifference::loadFrameDifference(int frameIndex, int frameIndex0
     currentImage = newFrame;
     currentImageSetMutex.unlock();
   }
+
+  // If both inputs are YUV, the difference also provides the SSIM per block
+  videoHandlerYUV *yuvVideo0 = dynamic_cast<videoHandlerYUV*>(inputVideo[0].data());
+  QMutexLocker lock(&currentImageSetMutex);
+  if (!newFrame.isNull() && yuvVideo0 != nullptr && yuvVideo0->getIs_YUV_diff())
+  {
+    ssimMap = yuvVideo0->getDiffSSIMMap();
+    ssimMapFrameIdx = frameIndex;
+  }
+  else
+  {
+    ssimMap = YUV_Internals::SSIMMap();
+    ssimMapFrameIdx = -1;
+  }
+}
+
+YUV_Internals::SSIMMap videoHandlerDifference::getSSIMMap(int &frameIndex)
+{
+  QMutexLocker lock(&currentImageSetMutex);
+  frameIndex = ssimMapFrameIdx;
+  return ssimMap;
 }
 
 bool videoHandlerDifference::inputsValid() const
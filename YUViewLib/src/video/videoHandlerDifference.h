@@ -71,6 +71,10 @@ public:
 
   // Calculate the position of the first difference and add the info to the list
   void reportFirstDifferencePosition(QList<infoItem> &infoList) const;
+
+  // Get the SSIM per block of the luma component of the last calculated difference. This is only available if both
+  // inputs are YUV. The frame index is -1 if there is no map.
+  YUV_Internals::SSIMMap getSSIMMap(int &frameIndex);
     
 private slots:
   void slotDifferenceControlChanged();
@@ -90,6 +94,10 @@ private:
   // The two videos that the difference will be calculated from
   QPointer<frameHandler> inputVideo[2];  
 
+  // The SSIM map of the last calculated difference (protected by currentImageSetMutex)
+  YUV_Internals::SSIMMap ssimMap;
+  int ssimMapFrameIdx {-1};
+
   // Recursively scan the LCU
   bool hierarchicalPosition(int x, int y, int blockSize, int &firstX, int &firstY, int &partIndex, const QImage &diffImg) const;
   bool hierarchicalPositionYUV(int x, int y, int blockSize, int &firstX, int &firstY, int &partIndex, const QByteArray &diffYUV, const YUV_Internals::yuvPixelFormat &diffYUVFormat) const;
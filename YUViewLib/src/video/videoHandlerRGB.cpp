@@ -280,11 +280,20 @@ void videoHandlerRGB::slotDisplayOptionsChanged()
   componentInvert[2] = ui.BInvertCheckBox->isChecked();
   limitedRange = ui.limitedRangeCheckBox->isChecked();
 
-  // Set the current frame in the buffer to be invalid and clear the cache.
-  // Emit that this item needs redraw and the cache needs updating.
+  // Set the current frame in the buffer to be invalid.
   currentImageIdx = -1;
-  setCacheInvalid();
-  emit signalHandlerChanged(true, RECACHE_CLEAR);
+  if (isCachingRawData())
+  {
+    // The cache holds the raw RGB data which is converted when drawing. Only the converted images are out of date.
+    doubleBufferImageFrameIdx = -1;
+    emit signalHandlerChanged(true, RECACHE_NONE);
+  }
+  else
+  {
+    // Clear the cache. Emit that this item needs redraw and the cache needs updating.
+    setCacheInvalid();
+    emit signalHandlerChanged(true, RECACHE_CLEAR);
+  }
 }
 
 void videoHandlerRGB::slotRGBFormatControlChanged()
@@ -391,12 +400,7 @@ void videoHandlerRGB::loadFrameForCaching(int frameIndex, QImage &frameToCache)
   // before the RGB format can change.
   rgbFormatMutex.lock();
 
-  requestDataMutex.lock();
-  emit signalRequestRawData(frameIndex, true);
-  tmpBufferRawRGBDataCaching = rawData;
-  requestDataMutex.unlock();
-
-  if (frameIndex != rawData_frameIdx)
+  if (!requestRawDataForCaching(frameIndex, tmpBufferRawRGBDataCaching))
   {
     // Loading failed
     currentImageIdx = -1;
@@ -410,6 +414,20 @@ void videoHandlerRGB::loadFrameForCaching(int frameIndex, QImage &frameToCache)
   rgbFormatMutex.unlock();
 }
 
+void videoHandlerRGB::convertRawFrameToImage(const QByteArray &frameRawData, QImage &outputImage)
+{
+  // Lock the mutex for the rgbFormat so that it can not change during the conversion.
+  QMutexLocker lock(&rgbFormatMutex);
+
+  if (frameRawData.size() < getBytesPerFrame())
+  {
+    DEBUG_RGB("videoHandlerRGB::convertRawFrameToImage Not enough data for one frame");
+    return;
+  }
+
+  convertRGBToImage(frameRawData, outputImage);
+}
+
 // Load the raw RGB data for the given frame index into currentFrameRawData.
 bool videoHandlerRGB::loadRawRGBData(int frameIndex)
 {
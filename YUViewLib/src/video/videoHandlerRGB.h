@@ -142,6 +142,10 @@ protected:
   // will not be modified.
   virtual void loadFrameForCaching(int frameIndex, QImage &frameToCache) Q_DECL_OVERRIDE;
 
+  // Convert the given raw frame in the current pixel format to an image for the cache.
+  virtual void convertRawFrameToImage(const QByteArray &frameRawData, QImage &outputImage) Q_DECL_OVERRIDE;
+  virtual bool supportsRawDataCaching() const Q_DECL_OVERRIDE { return true; }
+
 private:
 
   // Load the raw RGB data for the given frame index into currentFrameRawRGBData.
@@ -34,6 +34,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
 #if SSE_CONVERSION_420_ALT
 #include <xmmintrin.h>
 #endif
@@ -41,6 +42,9 @@
 #include <QPainter>
 
 #include "videoHandlerYUVCustomFormatDialog.h"
+#include "yuvConversion.h"
+#include "yuvConversionHelpers.h"
+#include "yuvDifference.h"
 #include "yuvPixelFormatGuess.h"
 #include "common/fileInfo.h"
 #include "common/functions.h"
@@ -56,21 +60,6 @@ using namespace YUV_Internals;
 #define DEBUG_YUV(message) ((void)0)
 #endif
 
-// Restrict is basically a promise to the compiler that for the scope of the pointer, the target of the pointer will only be accessed through that pointer (and pointers copied from it).
-#if __STDC__ != 1
-#    define restrict __restrict /* use implementation __ format */
-#else
-#    ifndef __STDC_VERSION__
-#        define restrict __restrict /* use implementation __ format */
-#    else
-#        if __STDC_VERSION__ < 199901L
-#            define restrict __restrict /* use implementation __ format */
-#        else
-#            /* all ok */
-#        endif
-#    endif
-#endif
-
 // Compute the MSE between the given char sources for numPixels bytes
 template<typename T>
 double computeMSE(T ptr, T ptr2, int numPixels)
@@ -88,6 +77,63 @@ double computeMSE(T ptr, T ptr2, int numPixels)
   return (double)sad / numPixels;
 }
 
+namespace
+{
+
+// If only a region of a frame is converted (see videoHandlerYUV::loadFrame), this margin is added around the visible
+// part so that small pans do not require a new conversion.
+const int PARTIAL_CONVERSION_MIN_MARGIN = 64;
+// The region is aligned to this many luma samples so that it starts on a full chroma sample for all subsamplings.
+const int PARTIAL_CONVERSION_ALIGNMENT = 8;
+
+// Copy the given region of a planar YUV frame into a new planar frame with the size of the region.
+// The region must be aligned to the chroma subsampling.
+QByteArray cropPlanarYUVFrame(const QByteArray &sourceBuffer, const yuvPixelFormat &format, const QSize &frameSize, const QRect &region)
+{
+  const int bytesPerSample = (format.bitsPerSample + 7) / 8;
+  QByteArray croppedBuffer;
+  croppedBuffer.resize(format.bytesPerFrame(region.size()));
+
+  const char *src = sourceBuffer.constData();
+  char *dst = croppedBuffer.data();
+  auto copyPlane = [&](int subX, int subY, int samplesPerValue)
+  {
+    const int srcStride = (frameSize.width() / subX) * samplesPerValue * bytesPerSample;
+    const int dstStride = (region.width() / subX) * samplesPerValue * bytesPerSample;
+    const int srcOffsetX = (region.x() / subX) * samplesPerValue * bytesPerSample;
+    const int nrLines = region.height() / subY;
+    const char *srcLine = src + (region.y() / subY) * srcStride + srcOffsetX;
+    for (int y = 0; y < nrLines; y++)
+    {
+      std::memcpy(dst, srcLine, dstStride);
+      srcLine += srcStride;
+      dst += dstStride;
+    }
+    src += srcStride * (frameSize.height() / subY);
+  };
+
+  // Luma
+  copyPlane(1, 1, 1);
+  if (format.subsampling != Subsampling::YUV_400)
+  {
+    const int subX = format.getSubsamplingHor();
+    const int subY = format.getSubsamplingVer();
+    if (format.uvInterleaved)
+      copyPlane(subX, subY, 2);
+    else
+    {
+      copyPlane(subX, subY, 1);
+      copyPlane(subX, subY, 1);
+    }
+  }
+  if (format.planeOrder == PlaneOrder::YUVA || format.planeOrder == PlaneOrder::YVUA)
+    copyPlane(1, 1, 1);
+
+  return croppedBuffer;
+}
+
+} // namespace
+
 videoHandlerYUV::videoHandlerYUV() : videoHandler()
 {
   // preset internal values
@@ -485,12 +531,21 @@ void videoHandlerYUV::slotYUVControlChanged()
     mathParameters[Component::Chroma].offset = ui.chromaOffsetSpinBox->value();
     mathParameters[Component::Chroma].invert = ui.chromaInvertCheckBox->isChecked();
 
-    // Set the current frame in the buffer to be invalid and clear the cache.
-    // Emit that this item needs redraw and the cache needs updating.
+    // Set the current frame in the buffer to be invalid.
     currentImageIdx = -1;
     currentImage_frameIndex = -1;
-    setCacheInvalid();
-    emit signalHandlerChanged(true, RECACHE_CLEAR);
+    if (isCachingRawData())
+    {
+      // The cache holds the raw YUV data which is converted when drawing. Only the converted images are out of date.
+      doubleBufferImageFrameIdx = -1;
+      emit signalHandlerChanged(true, RECACHE_NONE);
+    }
+    else
+    {
+      // Clear the cache. Emit that this item needs redraw and the cache needs updating.
+      setCacheInvalid();
+      emit signalHandlerChanged(true, RECACHE_CLEAR);
+    }
   }
   else if (sender == ui.yuvFormatComboBox)
   {
@@ -987,17 +1042,103 @@ void videoHandlerYUV::loadFrame(int frameIndex, bool loadToDoubleBuffer)
   if (loadToDoubleBuffer)
   {
     QImage newImage;
-    convertYUVToImage(currentFrameRawData, newImage, srcPixelFormat, frameSize);
+    convertYUVToImage(currentFrameRawData, newImage, srcPixelFormat, frameSize, nrConversionThreads);
     doubleBufferImage = newImage;
     doubleBufferImageFrameIdx = frameIndex;
   }
   else if (currentImageIdx != frameIndex)
   {
-    QImage newImage;
-    convertYUVToImage(currentFrameRawData, newImage, srcPixelFormat, frameSize);
-    QMutexLocker setLock(&currentImageSetMutex);    
+    // If the frame is drawn zoomed in, only convert the visible part (plus a margin). The complete
+    // frame is converted later if another part becomes visible (see videoHandler::drawFrame).
+    const QRect region = getPartialConversionRegion();
+    if (region.isValid())
+    {
+      const QByteArray croppedData = cropPlanarYUVFrame(currentFrameRawData, srcPixelFormat, frameSize, region);
+      QImage regionImage;
+      convertYUVToImage(croppedData, regionImage, srcPixelFormat, region.size(), nrConversionThreads);
+
+      // The image has the size of the frame but only the region contains valid data. Clear the rest so that
+      // no uninitialized memory is shown before the complete frame is converted.
+      QImage newImage(frameSize, regionImage.format());
+      newImage.fill(Qt::black);
+      const int bytesPerLine = region.width() * (regionImage.depth() / 8);
+      const int offsetX = region.x() * (regionImage.depth() / 8);
+      for (int y = 0; y < region.height(); y++)
+        std::memcpy(newImage.scanLine(region.y() + y) + offsetX, regionImage.constScanLine(y), bytesPerLine);
+
+      QMutexLocker setLock(&currentImageSetMutex);
+      currentImage = newImage;
+      currentImageIdx = frameIndex;
+      currentImageRegion = region;
+      currentImageRegionKey = currentImage.cacheKey();
+      currentImageRegionRawData = currentFrameRawData;
+      DEBUG_YUV("videoHandlerYUV::loadFrame " << frameIndex << " converted region " << region);
+    }
+    else
+    {
+      QImage newImage;
+      convertYUVToImage(currentFrameRawData, newImage, srcPixelFormat, frameSize, nrConversionThreads);
+      QMutexLocker setLock(&currentImageSetMutex);
+      currentImage = newImage;
+      currentImageIdx = frameIndex;
+      currentImageRegionRawData.clear();
+    }
+  }
+}
+
+QRect videoHandlerYUV::getPartialConversionRegion()
+{
+  // Only planar formats can be cropped without repacking. Interleaved UV planes with alpha are not supported.
+  const bool hasAlpha = srcPixelFormat.planeOrder == PlaneOrder::YUVA || srcPixelFormat.planeOrder == PlaneOrder::YVUA;
+  if (!srcPixelFormat.planar || (hasAlpha && srcPixelFormat.uvInterleaved))
+    return QRect();
+  if (currentFrameRawData.size() < getBytesPerFrame())
+    return QRect();
+
+  currentImageSetMutex.lock();
+  const QRect visibleRect = lastVisibleFrameRect;
+  currentImageSetMutex.unlock();
+
+  // Only worth it if a small part of the frame is visible
+  if (visibleRect.isEmpty() || int64_t(visibleRect.width()) * visibleRect.height() * 4 >= int64_t(frameSize.width()) * frameSize.height())
+    return QRect();
+
+  const int marginX = std::max(visibleRect.width() / 2, PARTIAL_CONVERSION_MIN_MARGIN);
+  const int marginY = std::max(visibleRect.height() / 2, PARTIAL_CONVERSION_MIN_MARGIN);
+  const int align = PARTIAL_CONVERSION_ALIGNMENT;
+  auto alignDown = [align](int v) { return v / align * align; };
+  // The region ends either on an aligned position or at the frame border
+  auto alignUp = [align](int v, int max) { return std::min((v + align - 1) / align * align, max); };
+  const int left = alignDown(std::max(visibleRect.left() - marginX, 0));
+  const int top = alignDown(std::max(visibleRect.top() - marginY, 0));
+  const int right = alignUp(std::min(visibleRect.right() + 1 + marginX, frameSize.width()), frameSize.width());
+  const int bottom = alignUp(std::min(visibleRect.bottom() + 1 + marginY, frameSize.height()), frameSize.height());
+  if (right <= left || bottom <= top)
+    return QRect();
+
+  return QRect(left, top, right - left, bottom - top);
+}
+
+void videoHandlerYUV::convertCompleteCurrentImage()
+{
+  // Convert the raw data that the partial image was converted from. currentFrameRawData may already hold another frame.
+  currentImageSetMutex.lock();
+  const QByteArray rawData = currentImageRegionRawData;
+  const qint64 regionKey = currentImageRegionKey;
+  currentImageSetMutex.unlock();
+
+  if (regionKey == 0 || rawData.size() < getBytesPerFrame())
+    return;
+
+  DEBUG_YUV("videoHandlerYUV::convertCompleteCurrentImage " << currentImageIdx);
+  QImage newImage;
+  convertYUVToImage(rawData, newImage, srcPixelFormat, frameSize, nrConversionThreads);
+  QMutexLocker setLock(&currentImageSetMutex);
+  if (currentImage.cacheKey() == regionKey)
+  {
     currentImage = newImage;
-    currentImageIdx = frameIndex;
+    currentImageRegionKey = 0;
+    currentImageRegionRawData.clear();
   }
 }
 
@@ -1009,12 +1150,8 @@ void videoHandlerYUV::loadFrameForCaching(int frameIndex, QImage &frameToCache)
   yuvPixelFormat yuvFormat = srcPixelFormat;
   const QSize curFrameSize = frameSize;
 
-  requestDataMutex.lock();
-  emit signalRequestRawData(frameIndex, true);
-  QByteArray tmpBufferRawYUVDataCaching = rawData;
-  requestDataMutex.unlock();
-
-  if (frameIndex != rawData_frameIdx)
+  QByteArray tmpBufferRawYUVDataCaching;
+  if (!requestRawDataForCaching(frameIndex, tmpBufferRawYUVDataCaching))
   {
     // Loading failed
     DEBUG_YUV("videoHandlerYUV::loadFrameForCaching Loading failed");
@@ -1025,6 +1162,21 @@ void videoHandlerYUV::loadFrameForCaching(int frameIndex, QImage &frameToCache)
   convertYUVToImage(tmpBufferRawYUVDataCaching, frameToCache, yuvFormat, curFrameSize);
 }
 
+void videoHandlerYUV::convertRawFrameToImage(const QByteArray &frameRawData, QImage &outputImage)
+{
+  // Get the YUV format and the size here, so that the conversion does not crash if this changes.
+  yuvPixelFormat yuvFormat = srcPixelFormat;
+  const QSize curFrameSize = frameSize;
+
+  if (frameRawData.size() < getBytesPerFrame())
+  {
+    DEBUG_YUV("videoHandlerYUV::convertRawFrameToImage Not enough data for one frame");
+    return;
+  }
+
+  convertYUVToImage(frameRawData, outputImage, yuvFormat, curFrameSize, nrConversionThreads);
+}
+
 // Load the raw YUV data for the given frame index into currentFrameRawData.
 bool videoHandlerYUV::loadRawYUVData(int frameIndex)
 {
@@ -1055,1120 +1207,23 @@ bool videoHandlerYUV::loadRawYUVData(int frameIndex)
   return true;
 }
 
-inline int clip8Bit(int val)
-{
-  if (val < 0)
-    return 0;
-  if (val > 255)
-    return 255;
-  return val;
-}
-
-/* Apply the given transformation to the YUV sample. If invert is true, the sample is inverted at the value defined by offset.
- * If the scale is greater one, the values will be amplified relative to the offset value.
- * The input can be 8 to 16 bit. The output will be of the same bit depth. The output is clamped to (0...clipMax).
- */
-inline int transformYUV(const bool invert, const int scale, const int offset, const unsigned int value, const int clipMax)
+bool videoHandlerYUV::loadPlanarFrame(int frameIndex, QByteArray &planarData, yuvPixelFormat &format, QSize &size)
 {
-  int newValue = value;
-  if (invert)
-    newValue = -(newValue - offset) * scale + offset;  // Scale + Offset + Invert
-  else
-    newValue = (newValue - offset) * scale + offset;  // Scale + Offset
-
-  // Clip to 8 bit
-  if (newValue < 0)
-    newValue = 0;
-  if (newValue > clipMax)
-    newValue = clipMax;
-
-  return newValue;
-}
-
-inline void convertYUVToRGB8Bit(const unsigned int valY, const unsigned int valU, const unsigned int valV, int &valR, int &valG, int &valB, const int RGBConv[5], const bool fullRange, const int bps)
-{
-  if (bps > 14)
-  {
-    // The bit depth of an int (32) is not enough to perform a YUV -> RGB conversion for a bit depth > 14 bits.
-    // We could use 64 bit values but for what? We are clipping the result to 8 bit anyways so let's just
-    // get rid of 2 of the bits for the YUV values.
-    const int yOffset = (fullRange ? 0 : 16<<(bps-10));
-    const int cZero = 128<<(bps-10);
-
-    const int Y_tmp = ((valY >> 2) - yOffset) * RGBConv[0];
-    const int U_tmp = (valU >> 2) - cZero;
-    const int V_tmp = (valV >> 2) - cZero;
-
-    const int R_tmp = (Y_tmp                      + V_tmp * RGBConv[1]) >> (16 + bps - 10); //32 to 16 bit conversion by right shifting
-    const int G_tmp = (Y_tmp + U_tmp * RGBConv[2] + V_tmp * RGBConv[3]) >> (16 + bps - 10);
-    const int B_tmp = (Y_tmp + U_tmp * RGBConv[4]                     ) >> (16 + bps - 10);
-
-    valR = (R_tmp < 0) ? 0 : (R_tmp > 255) ? 255 : R_tmp;
-    valG = (G_tmp < 0) ? 0 : (G_tmp > 255) ? 255 : G_tmp;
-    valB = (B_tmp < 0) ? 0 : (B_tmp > 255) ? 255 : B_tmp;
-  }
-  else
-  {
-    const int yOffset = (fullRange ? 0 : 16<<(bps-8));
-    const int cZero = 128<<(bps-8);
-
-    const int Y_tmp = (valY - yOffset) * RGBConv[0];
-    const int U_tmp = valU - cZero;
-    const int V_tmp = valV - cZero;
-
-    const int R_tmp = (Y_tmp                      + V_tmp * RGBConv[1]) >> (16 + bps - 8); //32 to 16 bit conversion by right shifting
-    const int G_tmp = (Y_tmp + U_tmp * RGBConv[2] + V_tmp * RGBConv[3]) >> (16 + bps - 8);
-    const int B_tmp = (Y_tmp + U_tmp * RGBConv[4]                     ) >> (16 + bps - 8);
-
-    valR = (R_tmp < 0) ? 0 : (R_tmp > 255) ? 255 : R_tmp;
-    valG = (G_tmp < 0) ? 0 : (G_tmp > 255) ? 255 : G_tmp;
-    valB = (B_tmp < 0) ? 0 : (B_tmp > 255) ? 255 : B_tmp;
-  }
-}
-
-inline int getValueFromSource(const unsigned char * restrict src, const int idx, const int bps, const bool bigEndian)
-{
-  if (bps > 8)
-    // Read two bytes in the right order
-    return (bigEndian) ? src[idx*2] << 8 | src[idx*2+1] : src[idx*2] | src[idx*2+1] << 8;
-  else
-    // Just read one byte
-    return src[idx];
-}
-
-inline void setValueInBuffer(unsigned char * restrict dst, const int val, const int idx, const int bps, const bool bigEndian)
-{
-  if (bps > 8)
-  {
-    // Write two bytes
-    if (bigEndian)
-    {
-      dst[idx*2] = val >> 8;
-      dst[idx*2+1] = val & 0xff;
-    }
-    else
-    {
-      dst[idx*2] = val & 0xff;
-      dst[idx*2+1] = val >> 8;
-    }
-  }
-  else
-    // Write one byte
-    dst[idx] = val;
-}
-
-// For every input sample in src, apply YUV transformation, (scale to 8 bit if required) and set the value as RGB (monochrome).
-// inValSkip: skip this many values in the input for every value. For pure planar formats, this 1. If the UV components are interleaved, this is 2 or 3.
-inline void YUVPlaneToRGBMonochrome_444(const int componentSize, const MathParameters math, const unsigned char * restrict src, unsigned char * restrict dst,
-                                        const int inMax, const int bps, const bool bigEndian, const int inValSkip, const bool fullRange)
-{
-  const bool applyMath = math.mathRequired();
-  const int shiftTo8Bit = bps - 8;
-  for (int i = 0; i < componentSize; ++i)
-  {
-    int newVal = getValueFromSource(src, i*inValSkip, bps, bigEndian);
-    if (applyMath)
-      newVal = transformYUV(math.invert, math.scale, math.offset, newVal, inMax);
-
-    if (shiftTo8Bit > 0)
-      newVal = clip8Bit(newVal >> shiftTo8Bit);
-    if (!fullRange)
-      newVal = videoHandler::convScaleLimitedRange(newVal);
-
-    // Set the value for R, G and B (BGRA)
-    dst[i*4  ] = (unsigned char)newVal;
-    dst[i*4+1] = (unsigned char)newVal;
-    dst[i*4+2] = (unsigned char)newVal;
-    dst[i*4+3] = (unsigned char)255;
-  }
-}
-
-// For every input sample in the YZV 422 src, apply interpolation (sample and hold), apply YUV transformation, (scale to 8 bit if required)
-// and set the value as RGB (monochrome).
-inline void YUVPlaneToRGBMonochrome_422(const int componentSize, const MathParameters math, const unsigned char * restrict src, unsigned char * restrict dst,
-                                        const int inMax, const int bps, const bool bigEndian, const int inValSkip, const bool fullRange)
-{
-  const bool applyMath = math.mathRequired();
-  const int shiftTo8Bit = bps - 8;
-  for (int i = 0; i < componentSize; ++i)
-  {
-    int newVal = getValueFromSource(src, i*inValSkip, bps, bigEndian);
-    if (applyMath)
-      newVal = transformYUV(math.invert, math.scale, math.offset, newVal, inMax);
-
-    if (shiftTo8Bit > 0)
-      newVal = clip8Bit(newVal >> shiftTo8Bit);
-    if (!fullRange)
-      newVal = videoHandler::convScaleLimitedRange(newVal);
-
-    // Set the value for R, G and B of 2 pixels (BGRA)
-    dst[i*8  ] = (unsigned char)newVal;
-    dst[i*8+1] = (unsigned char)newVal;
-    dst[i*8+2] = (unsigned char)newVal;
-    dst[i*8+3] = (unsigned char)255;
-    dst[i*8+4] = (unsigned char)newVal;
-    dst[i*8+5] = (unsigned char)newVal;
-    dst[i*8+6] = (unsigned char)newVal;
-    dst[i*8+7] = (unsigned char)255;
-  }
-}
-
-inline void YUVPlaneToRGBMonochrome_420(const int w, const int h, const MathParameters math, const unsigned char * restrict src, unsigned char * restrict dst,
-                                        const int inMax, const int bps, const bool bigEndian, const int inValSkip, const bool fullRange)
-{
-  const bool applyMath = math.mathRequired();
-  const int shiftTo8Bit = bps - 8;
-  for (int y = 0; y < h/2; y++)
-    for (int x = 0; x < w/2; x++)
-    {
-      const int srcIdx = y*(w/2)+x;
-      int newVal = getValueFromSource(src, srcIdx*inValSkip, bps, bigEndian);
-      if (applyMath)
-        newVal = transformYUV(math.invert, math.scale, math.offset, newVal, inMax);
-
-      if (shiftTo8Bit > 0)
-        newVal = clip8Bit(newVal >> shiftTo8Bit);
-      if (!fullRange)
-        newVal = videoHandler::convScaleLimitedRange(newVal);
-
-      // Set the value for R, G and B of 4 pixels (BGRA)
-      int o = (y*2*w + x*2)*4;
-      dst[o  ] = (unsigned char)newVal;
-      dst[o+1] = (unsigned char)newVal;
-      dst[o+2] = (unsigned char)newVal;
-      dst[o+3] = (unsigned char)255;
-      dst[o+4] = (unsigned char)newVal;
-      dst[o+5] = (unsigned char)newVal;
-      dst[o+6] = (unsigned char)newVal;
-      dst[o+7] = (unsigned char)255;
-      o += w*4;   // Goto next line
-      dst[o  ] = (unsigned char)newVal;
-      dst[o+1] = (unsigned char)newVal;
-      dst[o+2] = (unsigned char)newVal;
-      dst[o+3] = (unsigned char)255;
-      dst[o+4] = (unsigned char)newVal;
-      dst[o+5] = (unsigned char)newVal;
-      dst[o+6] = (unsigned char)newVal;
-      dst[o+7] = (unsigned char)255;
-    }
-}
-
-inline void YUVPlaneToRGBMonochrome_440(const int w, const int h, const MathParameters math, const unsigned char * restrict src, unsigned char * restrict dst,
-                                        const int inMax, const int bps, const bool bigEndian, const int inValSkip, const bool fullRange)
-{
-  const bool applyMath = math.mathRequired();
-  const int shiftTo8Bit = bps - 8;
-  for (int y = 0; y < h/2; y++)
-    for (int x = 0; x < w; x++)
-    {
-      const int srcIdx = y*w+x;
-      int newVal = getValueFromSource(src, srcIdx*inValSkip, bps, bigEndian);
-      if (applyMath)
-        newVal = transformYUV(math.invert, math.scale, math.offset, newVal, inMax);
-
-      if (shiftTo8Bit > 0)
-        newVal = clip8Bit(newVal >> shiftTo8Bit);
-      if (!fullRange)
-        newVal = videoHandler::convScaleLimitedRange(newVal);
-
-      // Set the value for R, G and B of 2 pixels (BGRA)
-      const int pos1 = (y*2*w+x)*4;
-      const int pos2 = pos1 + w*4;  // Next line
-      dst[pos1  ] = (unsigned char)newVal;
-      dst[pos1+1] = (unsigned char)newVal;
-      dst[pos1+2] = (unsigned char)newVal;
-      dst[pos1+3] = (unsigned char)255;
-      dst[pos2  ] = (unsigned char)newVal;
-      dst[pos2+1] = (unsigned char)newVal;
-      dst[pos2+2] = (unsigned char)newVal;
-      dst[pos2+3] = (unsigned char)255;
-    }
-}
-
-inline void YUVPlaneToRGBMonochrome_410(const int w, const int h, const MathParameters math, const unsigned char * restrict src, unsigned char * restrict dst,
-  const int inMax, const int bps, const bool bigEndian, const int inValSkip, const bool fullRange)
-{
-  // Horizontal subsampling by 4, vertical subsampling by 4
-  const bool applyMath = math.mathRequired();
-  const int shiftTo8Bit = bps - 8;
-  for (int y = 0; y < h/4; y++)
-    for (int x = 0; x < w/4; x++)
-    {
-      const int srcIdx = y*(w/4)+x;
-      int newVal = getValueFromSource(src, srcIdx*inValSkip, bps, bigEndian);
-
-      if (applyMath)
-        newVal = transformYUV(math.invert, math.scale, math.offset, newVal, inMax);
-
-      if (shiftTo8Bit > 0)
-        newVal = clip8Bit(newVal >> shiftTo8Bit);
-      if (!fullRange)
-        newVal = videoHandler::convScaleLimitedRange(newVal);
-
-      // Set the value as RGB for 4 pixels in this line and the next 3 lines (BGRA)
-      for (int yo = 0; yo < 4; yo++)
-        for (int xo = 0; xo < 4; xo++)
-        {
-          const int pos = ((y*4+yo)*w+(x*4+xo))*4;
-          dst[pos  ] = (unsigned char)newVal;
-          dst[pos+1] = (unsigned char)newVal;
-          dst[pos+2] = (unsigned char)newVal;
-          dst[pos+3] = (unsigned char)255;
-        }
-    }
-}
-
-inline void YUVPlaneToRGBMonochrome_411(const int componentSize, const MathParameters math, const unsigned char * restrict src, unsigned char * restrict dst,
-                                        const int inMax, const int bps, const bool bigEndian, const int inValSkip, const bool fullRange)
-{
-  // Horizontally U and V are subsampled by 4
-  const bool applyMath = math.mathRequired();
-  const int shiftTo8Bit = bps - 8;
-  for (int i = 0; i < componentSize; ++i)
-  {
-    int newVal = getValueFromSource(src, i*inValSkip, bps, bigEndian);
-    if (applyMath)
-      newVal = transformYUV(math.invert, math.scale, math.offset, newVal, inMax);
-
-    if (shiftTo8Bit > 0)
-      newVal = clip8Bit(newVal >> shiftTo8Bit);
-    if (!fullRange)
-      newVal = videoHandler::convScaleLimitedRange(newVal);
-
-    // Set the value for R, G and B of 4 pixels (BGRA)
-    dst[i*16   ] = (unsigned char)newVal;
-    dst[i*16+1 ] = (unsigned char)newVal;
-    dst[i*16+2 ] = (unsigned char)newVal;
-    dst[i*16+3 ] = (unsigned char)255;
-    dst[i*16+4 ] = (unsigned char)newVal;
-    dst[i*16+5 ] = (unsigned char)newVal;
-    dst[i*16+6 ] = (unsigned char)newVal;
-    dst[i*16+7 ] = (unsigned char)255;
-    dst[i*16+8 ] = (unsigned char)newVal;
-    dst[i*16+9 ] = (unsigned char)newVal;
-    dst[i*16+10] = (unsigned char)newVal;
-    dst[i*16+11] = (unsigned char)255;
-    dst[i*16+12] = (unsigned char)newVal;
-    dst[i*16+13] = (unsigned char)newVal;
-    dst[i*16+14] = (unsigned char)newVal;
-    dst[i*16+15] = (unsigned char)255;
-  }
-}
-
-inline int interpolateUVSample(const ChromaInterpolation mode, const int sample1, const int sample2)
-{
-  if (mode == ChromaInterpolation::Bilinear)
-    // Interpolate linearly between sample1 and sample2
-    return ((sample1 + sample2) + 1) >> 1;
-  return sample1; // Sample and hold
-}
-
-inline int interpolateUVSampleQ(const ChromaInterpolation mode, const int sample1, const int sample2, const int quarterPos)
-{
-  if (mode == ChromaInterpolation::Bilinear)
-  {
-    // Interpolate linearly between sample1 and sample2
-    if (quarterPos == 0)
-      return sample1;
-    if (quarterPos == 1)
-      return ((sample1*3 + sample2) + 1) >> 2;
-    if (quarterPos == 2)
-      return ((sample1 + sample2) + 1) >> 1;
-    if (quarterPos == 3)
-      return ((sample1 + sample2*3) + 1) >> 2;
-  }
-  return sample1; // Sample and hold
-}
-
-// TODO: Consider sample position
-inline int interpolateUVSample2D(const ChromaInterpolation mode, const int sample1, const int sample2, const int sample3, const int sample4)
-{
-  if (mode == ChromaInterpolation::Bilinear)
-    // Interpolate linearly between sample1 - sample 4
-    return ((sample1 + sample2 + sample3 + sample4) + 2) >> 2;
-  return sample1;   // Sample and hold
-}
-
-// Depending on offsetX8 (which can be 1 to 7), interpolate one of the 6 given positions between prev and cur.
-inline int interpolateUV8Pos(int prev, int cur, const int offsetX8)
-{
-  if (offsetX8 == 4)
-    return (prev + cur + 1) / 2;
-  if (offsetX8 == 2)
-    return (prev + cur*3 + 2) / 4;
-  if (offsetX8 == 6)
-    return (prev*3 + cur + 2) / 4;
-  if (offsetX8 == 1)
-    return (prev + cur*7 + 4) / 8;
-  if (offsetX8 == 3)
-    return (prev*3 + cur*5 + 4) / 8;
-  if (offsetX8 == 5)
-    return (prev*5 + cur*3 + 4) / 8;
-  if (offsetX8 == 7)
-    return (prev*7 + cur + 4) / 8;
-  Q_ASSERT(false); // offsetX8 should always be between 1 and 7 (inclusive)
-  return 0;
-}
-
-// Re-sample the chroma component so that the chroma samples and the luma samples are aligned after this operation.
-inline void UVPlaneResamplingChromaOffset(const yuvPixelFormat format, const int w, const int h, 
-                                          const unsigned char * restrict srcU, const unsigned char * restrict srcV, const int inValSkip,
-                                          unsigned char * restrict dstU, unsigned char * restrict dstV)
-{
-  // We can perform linear interpolation for 7 positions (6 in between) two pixels.
-  // Which of these position is needed depends on the chromaOffset and the subsampling.
-  const int possibleValsX = getMaxPossibleChromaOffsetValues(true,  format.subsampling);
-  const int possibleValsY = getMaxPossibleChromaOffsetValues(false, format.subsampling);
-  const int offsetX8 = (possibleValsX == 1) ? format.chromaOffset[0] * 4 : (possibleValsX == 3) ? format.chromaOffset[0] * 2 : format.chromaOffset[0];
-  const int offsetY8 = (possibleValsY == 1) ? format.chromaOffset[1] * 4 : (possibleValsY == 3) ? format.chromaOffset[1] * 2 : format.chromaOffset[1];
-
-  // The format to use for input/output
-  const bool bigEndian = format.bigEndian;
-  const int bps = format.bitsPerSample;
-
-  const int stride = bps > 8 ? w*2 : w;
-  if (offsetX8 != 0)
-  {
-    // Perform horizontal re-sampling
-    for (int y = 0; y < h; y++)
-    {
-      // On the left side, there is no previous sample, so the first value is never changed.
-      const int srcIdx = y * stride * inValSkip;
-      int prevU = getValueFromSource(srcU, srcIdx, bps, bigEndian);
-      int prevV = getValueFromSource(srcV, srcIdx, bps, bigEndian);
-      setValueInBuffer(dstU, prevU, y*stride, bps, bigEndian);
-      setValueInBuffer(dstV, prevV, y*stride, bps, bigEndian);
-
-      for (int x = 0; x < w-1; x++)
-      {
-        // Calculate the new current value using the previous and the current value
-        const int srcIdxInLine = srcIdx + (x+1)*inValSkip;
-        int curU = getValueFromSource(srcU, srcIdxInLine, bps, bigEndian);
-        int curV = getValueFromSource(srcV, srcIdxInLine, bps, bigEndian);
-
-        // Perform interpolation and save the value for the current UV value. Goto next value.
-        int newU = interpolateUV8Pos(prevU, curU, offsetX8);
-        int newV = interpolateUV8Pos(prevV, curV, offsetX8);
-        setValueInBuffer(dstU, newU, y*stride+x, bps, bigEndian);
-        setValueInBuffer(dstV, newV, y*stride+x, bps, bigEndian);
-
-        prevU = curU;
-        prevV = curV;
-      }
-    }
-  }
-
-  // For the second step, use the filtered values (or the source if no filtering was applied)
-  const unsigned char *srcUStep2 = (offsetX8 == 0) ? srcU : dstU;
-  const unsigned char *srcVStep2 = (offsetX8 == 0) ? srcV : dstV;
-  const int valSkipStep2 = (offsetX8 == 0) ? inValSkip : 1;
-
-  if (offsetY8 != 0)
-  {
-    // Perform vertical re-sampling. It works exactly like horizontal up-sampling but x and y are switched.
-    for (int x = 0; x < w; x++)
-    {
-      // On the top, there is no previous sample, so the first value is never changed.
-      int prevU = getValueFromSource(srcUStep2, x*valSkipStep2, bps, bigEndian);
-      int prevV = getValueFromSource(srcVStep2, x*valSkipStep2, bps, bigEndian);
-      setValueInBuffer(dstU, prevU, x, bps, bigEndian);
-      setValueInBuffer(dstV, prevV, x, bps, bigEndian);
-
-      for (int y = 0; y < h-1; y++)
-      {
-        // Calculate the new current value using the previous and the current value
-        const int srcIdx = (y+1) * w + x;
-        int curU = getValueFromSource(srcUStep2, srcIdx*valSkipStep2, bps, bigEndian);
-        int curV = getValueFromSource(srcVStep2, srcIdx*valSkipStep2, bps, bigEndian);
-
-        // Perform interpolation and save the value for the current UV value. Goto next value.
-        int newU = interpolateUV8Pos(prevU, curU, offsetY8);
-        int newV = interpolateUV8Pos(prevV, curV, offsetY8);
-        setValueInBuffer(dstU, newU, srcIdx, bps, bigEndian);
-        setValueInBuffer(dstV, newV, srcIdx, bps, bigEndian);
-
-        prevU = curU;
-        prevV = curV;
-      }
-    }
-  }
-}
-
-inline void YUVPlaneToRGB_444(const int componentSize, const MathParameters mathY, const MathParameters mathC,
-                              const unsigned char * restrict srcY, const unsigned char * restrict srcU, const unsigned char * restrict srcV,
-                              unsigned char * restrict dst, const int RGBConv[5], const bool fullRange, const int inMax, const int bps, const bool bigEndian, const int inValSkip)
-{
-  const bool applyMathLuma = mathY.mathRequired();
-  const bool applyMathChroma = mathC.mathRequired();
-
-  for (int i = 0; i < componentSize; ++i)
-  {
-    unsigned int valY = getValueFromSource(srcY, i, bps, bigEndian);
-    unsigned int valU = getValueFromSource(srcU, i*inValSkip, bps, bigEndian);
-    unsigned int valV = getValueFromSource(srcV, i*inValSkip, bps, bigEndian);
-
-    if (applyMathLuma)
-      valY = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY, inMax);
-    if (applyMathChroma)
-    {
-      valU = transformYUV(mathC.invert, mathC.scale, mathC.offset, valU, inMax);
-      valV = transformYUV(mathC.invert, mathC.scale, mathC.offset, valV, inMax);
-    }
-
-    // Get the RGB values for this sample
-    int valR, valG, valB;
-    convertYUVToRGB8Bit(valY, valU, valV, valR, valG, valB, RGBConv, fullRange, bps);
-
-    // Save the RGB values
-    dst[i*4  ] = valB;
-    dst[i*4+1] = valG;
-    dst[i*4+2] = valR;
-    dst[i*4+3] = 255;
-  }
-}
-
-inline void YUVPlaneToRGB_422(const int w, const int h, const MathParameters mathY, const MathParameters mathC,
-                              const unsigned char * restrict srcY, const unsigned char * restrict srcU, const unsigned char * restrict srcV,
-                              unsigned char * restrict dst, const int RGBConv[5], const bool fullRange, const int inMax, const ChromaInterpolation interpolation, const int bps, const bool bigEndian, const int inValSkip)
-{
-  const bool applyMathLuma = mathY.mathRequired();
-  const bool applyMathChroma = mathC.mathRequired();
-  // Horizontal up-sampling is required. Process two Y values at a time
-  for (int y = 0; y < h; y++)
-  {
-    const int srcIdxUV = y*w/2;
-    int curUSample = getValueFromSource(srcU, srcIdxUV*inValSkip, bps, bigEndian);
-    int curVSample = getValueFromSource(srcV, srcIdxUV*inValSkip, bps, bigEndian);
-    if (applyMathChroma)
-    {
-      curUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curUSample, inMax);
-      curVSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curVSample, inMax);
-    }
-
-    for (int x = 0; x < (w/2)-1; x++)
-    {
-      // Get the next U/V sample
-      const int srcPosLineUV = srcIdxUV + x + 1;
-      int nextUSample = getValueFromSource(srcU, srcPosLineUV*inValSkip, bps, bigEndian);
-      int nextVSample = getValueFromSource(srcV, srcPosLineUV*inValSkip, bps, bigEndian);
-      if (applyMathChroma)
-      {
-        nextUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextUSample, inMax);
-        nextVSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextVSample, inMax);
-      }
-
-      // From the current and the next U/V sample, interpolate the UV sample in between
-      int interpolatedU = interpolateUVSample(interpolation, curUSample, nextUSample);
-      int interpolatedV = interpolateUVSample(interpolation, curVSample, nextVSample);
-
-      // Get the 2 Y samples
-      int valY1 = getValueFromSource(srcY, y*w+x*2,   bps, bigEndian);
-      int valY2 = getValueFromSource(srcY, y*w+x*2+1, bps, bigEndian);
-      if (applyMathLuma)
-      {
-        valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-        valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-      }
-
-      // Convert to 2 RGB values and save them (BGRA)
-      int valR1, valR2, valG1, valG2, valB1, valB2;
-      convertYUVToRGB8Bit(valY1, curUSample   , curVSample   , valR1, valG1, valB1, RGBConv, fullRange, bps);
-      convertYUVToRGB8Bit(valY2, interpolatedU, interpolatedV, valR2, valG2, valB2, RGBConv, fullRange, bps);
-      const int pos = (y*w+x*2)*4;
-      dst[pos  ] = valB1;
-      dst[pos+1] = valG1;
-      dst[pos+2] = valR1;
-      dst[pos+3] = 255;
-      dst[pos+4] = valB2;
-      dst[pos+5] = valG2;
-      dst[pos+6] = valR2;
-      dst[pos+7] = 255;
-
-      // The next one is now the current one
-      curUSample = nextUSample;
-      curVSample = nextVSample;
-    }
-
-    // For the last row, there is no next sample. Just reuse the current one again. No interpolation required either.
-
-    // Get the 2 Y samples
-    int valY1 = getValueFromSource(srcY, (y+1)*w-2, bps, bigEndian);
-    int valY2 = getValueFromSource(srcY, (y+1)*w-1, bps, bigEndian);
-    if (applyMathLuma)
-    {
-      valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-      valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-    }
-
-    // Convert to 2 RGB values and save them
-    int valR1, valR2, valG1, valG2, valB1, valB2;
-    convertYUVToRGB8Bit(valY1, curUSample, curVSample, valR1, valG1, valB1, RGBConv, fullRange, bps);
-    convertYUVToRGB8Bit(valY2, curUSample, curVSample, valR2, valG2, valB2, RGBConv, fullRange, bps);
-    const int pos = ((y+1)*w)*4;
-    dst[pos-8] = valB1;
-    dst[pos-7] = valG1;
-    dst[pos-6] = valR1;
-    dst[pos-5] = 255;
-    dst[pos-4] = valB2;
-    dst[pos-3] = valG2;
-    dst[pos-2] = valR2;
-    dst[pos-1] = 255;
-  }
-}
-
-inline void YUVPlaneToRGB_440(const int w, const int h, const MathParameters mathY, const MathParameters mathC,
-                              const unsigned char * restrict srcY, const unsigned char * restrict srcU, const unsigned char * restrict srcV,
-                              unsigned char * restrict dst, const int RGBConv[5], const bool fullRange,const int inMax, const ChromaInterpolation interpolation, const int bps, const bool bigEndian, const int inValSkip)
-{
-  const bool applyMathLuma = mathY.mathRequired();
-  const bool applyMathChroma = mathC.mathRequired();
-  // Vertical up-sampling is required. Process two Y values at a time
-
-  for (int x = 0; x < w; x++)
-  {
-    int curUSample = getValueFromSource(srcU, x*inValSkip, bps, bigEndian);
-    int curVSample = getValueFromSource(srcV, x*inValSkip, bps, bigEndian);
-    if (applyMathChroma)
-    {
-      curUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curUSample, inMax);
-      curVSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curVSample, inMax);
-    }
-
-    for (int y = 0; y < (h/2)-1; y++)
-    {
-      // Get the next U/V sample
-      const int srcIdxUV = y*w+x;
-      int nextUSample = getValueFromSource(srcU, srcIdxUV*inValSkip, bps, bigEndian);
-      int nextVSample = getValueFromSource(srcV, srcIdxUV*inValSkip, bps, bigEndian);
-      if (applyMathChroma)
-      {
-        nextUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextUSample, inMax);
-        nextVSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextVSample, inMax);
-      }
-
-      // From the current and the next U/V sample, interpolate the UV sample in between
-      int interpolatedU = interpolateUVSample(interpolation, curUSample, nextUSample);
-      int interpolatedV = interpolateUVSample(interpolation, curVSample, nextVSample);
-
-      // Get the 2 Y samples
-      int valY1 = getValueFromSource(srcY,     y*2*w+x, bps, bigEndian);
-      int valY2 = getValueFromSource(srcY, (y*2+1)*w+x, bps, bigEndian);
-      if (applyMathLuma)
-      {
-        valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-        valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-      }
-
-      // Convert to 2 RGB values and save them
-      int valR1, valR2, valG1, valG2, valB1, valB2;
-      convertYUVToRGB8Bit(valY1, curUSample   , curVSample   , valR1, valG1, valB1, RGBConv, fullRange, bps);
-      convertYUVToRGB8Bit(valY2, interpolatedU, interpolatedV, valR2, valG2, valB2, RGBConv, fullRange, bps);
-      const int pos1 = (y*2*w+x)*4;
-      const int pos2 = pos1 + 4*w;
-      dst[pos1  ] = valB1;
-      dst[pos1+1] = valG1;
-      dst[pos1+2] = valR1;
-      dst[pos1+3] = 255;
-      dst[pos2  ] = valB2;
-      dst[pos2+1] = valG2;
-      dst[pos2+2] = valR2;
-      dst[pos2+3] = 255;
-
-      // The next one is now the current one
-      curUSample = nextUSample;
-      curVSample = nextVSample;
-    }
-
-    // For the last column, there is no next sample. Just reuse the current one again. No interpolation required either.
-
-    // Get the 2 Y samples
-    int valY1 = getValueFromSource(srcY, (h-2)*w+x, bps, bigEndian);
-    int valY2 = getValueFromSource(srcY, (h-1)*w+x, bps, bigEndian);
-    if (applyMathLuma)
-    {
-      valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-      valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-    }
-
-    // Convert to 2 RGB values and save them
-    int valR1, valR2, valG1, valG2, valB1, valB2;
-    convertYUVToRGB8Bit(valY1, curUSample, curVSample, valR1, valG1, valB1, RGBConv, fullRange, bps);
-    convertYUVToRGB8Bit(valY2, curUSample, curVSample, valR2, valG2, valB2, RGBConv, fullRange, bps);
-    const int pos1 = ((h-2)*w+x)*4;
-    const int pos2 = pos1 + w*4;
-    dst[pos1  ] = valB1;
-    dst[pos1+1] = valG1;
-    dst[pos1+2] = valR1;
-    dst[pos1+3] = 255;
-    dst[pos2  ] = valB2;
-    dst[pos2+1] = valG2;
-    dst[pos2+2] = valR2;
-    dst[pos2+3] = 255;
-  }
-}
-
-inline void YUVPlaneToRGB_420(const int w, const int h, const MathParameters mathY, const MathParameters mathC,
-                              const unsigned char * restrict srcY, const unsigned char * restrict srcU, const unsigned char * restrict srcV,
-                              unsigned char * restrict dst, const int RGBConv[5], const bool fullRange,const int inMax, const ChromaInterpolation interpolation, const int bps, const bool bigEndian, const int inValSkip)
-{
-  const bool applyMathLuma = mathY.mathRequired();
-  const bool applyMathChroma = mathC.mathRequired();
-  // Format is YUV 4:2:0. Horizontal and vertical up-sampling is required. Process 4 Y positions at a time
-  const int hh = h/2; // The half values
-  const int wh = w/2;
-  for (int y = 0; y < hh-1; y++)
-  {
-    // Get the current U/V samples for this y line and the next one (_NL)
-    const int srcIdxUV0 = y*wh;
-    const int srcIdxUV1 = (y+1)*wh;
-    int curU    = getValueFromSource(srcU, srcIdxUV0*inValSkip, bps, bigEndian);
-    int curV    = getValueFromSource(srcV, srcIdxUV0*inValSkip, bps, bigEndian);
-    int curU_NL = getValueFromSource(srcU, srcIdxUV1*inValSkip, bps, bigEndian);
-    int curV_NL = getValueFromSource(srcV, srcIdxUV1*inValSkip, bps, bigEndian);
-    if (applyMathChroma)
-    {
-      curU    = transformYUV(mathC.invert, mathC.scale, mathC.offset, curU, inMax);
-      curV    = transformYUV(mathC.invert, mathC.scale, mathC.offset, curV, inMax);
-      curU_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, curU_NL, inMax);
-      curV_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, curV_NL, inMax);
-    }
-
-    for (int x = 0; x < wh-1; x++)
-    {
-      // Get the next U/V sample for this line and the next one
-      const int srcIdxUVLine0 = srcIdxUV0 + x + 1;
-      const int srcIdxUVLine1 = srcIdxUV1 + x + 1;
-      int nextU    = getValueFromSource(srcU, srcIdxUVLine0*inValSkip, bps, bigEndian);
-      int nextV    = getValueFromSource(srcV, srcIdxUVLine0*inValSkip, bps, bigEndian);
-      int nextU_NL = getValueFromSource(srcU, srcIdxUVLine1*inValSkip, bps, bigEndian);
-      int nextV_NL = getValueFromSource(srcV, srcIdxUVLine1*inValSkip, bps, bigEndian);
-      if (applyMathChroma)
-      {
-        nextU    = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextU, inMax);
-        nextV    = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextV, inMax);
-        nextU_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextU_NL, inMax);
-        nextV_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextV_NL, inMax);
-      }
-
-      // From the current and the next U/V sample, interpolate the 3 UV samples in between
-      int interpolatedU_Hor = interpolateUVSample(interpolation, curU, nextU);  // Horizontal interpolation
-      int interpolatedV_Hor = interpolateUVSample(interpolation, curV, nextV);
-      int interpolatedU_Ver = interpolateUVSample(interpolation, curU, curU_NL);  // Vertical interpolation
-      int interpolatedV_Ver = interpolateUVSample(interpolation, curV, curV_NL);
-      int interpolatedU_Bi  = interpolateUVSample2D(interpolation, curU, nextU, curU_NL, nextU_NL);   // 2D interpolation
-      int interpolatedV_Bi  = interpolateUVSample2D(interpolation, curV, nextV, curV_NL, nextV_NL);   // 2D interpolation
-
-      // Get the 4 Y samples
-      int valY1 = getValueFromSource(srcY, (y*w+x)*2,   bps, bigEndian);
-      int valY2 = getValueFromSource(srcY, (y*w+x)*2+1, bps, bigEndian);
-      int valY3 = getValueFromSource(srcY, (y*2+1)*w+x*2,   bps, bigEndian);
-      int valY4 = getValueFromSource(srcY, (y*2+1)*w+x*2+1, bps, bigEndian);
-      if (applyMathLuma)
-      {
-        valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-        valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-        valY3 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY3, inMax);
-        valY4 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY4, inMax);
-      }
-
-      // Convert to 4 RGB values and save them
-      int valR1, valR2, valG1, valG2, valB1, valB2;
-      convertYUVToRGB8Bit(valY1, curU             , curV             , valR1, valG1, valB1, RGBConv, fullRange, bps);
-      convertYUVToRGB8Bit(valY2, interpolatedU_Hor, interpolatedV_Hor, valR2, valG2, valB2, RGBConv, fullRange, bps);
-      const int pos1 = (y*2*w+x*2)*4;
-      dst[pos1  ] = valB1;
-      dst[pos1+1] = valG1;
-      dst[pos1+2] = valR1;
-      dst[pos1+3] = 255;
-      dst[pos1+4] = valB2;
-      dst[pos1+5] = valG2;
-      dst[pos1+6] = valR2;
-      dst[pos1+7] = 255;
-      convertYUVToRGB8Bit(valY3, interpolatedU_Ver, interpolatedV_Ver, valR1, valG1, valB1, RGBConv, fullRange, bps);  // Second line
-      convertYUVToRGB8Bit(valY4, interpolatedU_Bi , interpolatedV_Bi , valR2, valG2, valB2, RGBConv, fullRange, bps);
-      const int pos2 = pos1 + w*4;  // Next line
-      dst[pos2  ] = valB1;
-      dst[pos2+1] = valG1;
-      dst[pos2+2] = valR1;
-      dst[pos2+3] = 255;
-      dst[pos2+4] = valB2;
-      dst[pos2+5] = valG2;
-      dst[pos2+6] = valR2;
-      dst[pos2+7] = 255;
-
-      // The next one is now the current one
-      curU = nextU;
-      curV = nextV;
-      curU_NL = nextU_NL;
-      curV_NL = nextV_NL;
-    }
-
-    // For the last x value (the right border), there is no next value. Just sample and hold. Only vertical interpolation is required.
-    int interpolatedU_Ver = interpolateUVSample(interpolation, curU, curU_NL);  // Vertical interpolation
-    int interpolatedV_Ver = interpolateUVSample(interpolation, curV, curV_NL);
-
-    // Get the 4 Y samples
-    int valY1 = getValueFromSource(srcY, (y*2+1)*w-2, bps, bigEndian);
-    int valY2 = getValueFromSource(srcY, (y*2+1)*w-1, bps, bigEndian);
-    int valY3 = getValueFromSource(srcY, (y*2+2)*w-2, bps, bigEndian);
-    int valY4 = getValueFromSource(srcY, (y*2+2)*w-1, bps, bigEndian);
-    if (applyMathLuma)
-    {
-      valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-      valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-      valY3 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY3, inMax);
-      valY4 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY4, inMax);
-    }
-
-    // Convert to 4 RGB values and save them
-    int valR1, valR2, valG1, valG2, valB1, valB2;
-    convertYUVToRGB8Bit(valY1, curU, curV, valR1, valG1, valB1, RGBConv, fullRange, bps);
-    convertYUVToRGB8Bit(valY2, curU, curV, valR2, valG2, valB2, RGBConv, fullRange, bps);
-    const int pos1 = ((y*2+1)*w)*4;
-    dst[pos1-8] = valB1;
-    dst[pos1-7] = valG1;
-    dst[pos1-6] = valR1;
-    dst[pos1-5] = 255;
-    dst[pos1-4] = valB2;
-    dst[pos1-3] = valG2;
-    dst[pos1-2] = valR2;
-    dst[pos1-1] = 255;
-    convertYUVToRGB8Bit(valY3, interpolatedU_Ver, interpolatedV_Ver, valR1, valG1, valB1, RGBConv, fullRange, bps);  // Second line
-    convertYUVToRGB8Bit(valY4, interpolatedU_Ver, interpolatedV_Ver, valR2, valG2, valB2, RGBConv, fullRange, bps);
-    const int pos2 = pos1 + w*4;  // Next line
-    dst[pos2-8] = valB1;
-    dst[pos2-7] = valG1;
-    dst[pos2-6] = valR1;
-    dst[pos2-5] = 255;
-    dst[pos2-4] = valB2;
-    dst[pos2-3] = valG2;
-    dst[pos2-2] = valR2;
-    dst[pos2-1] = 255;
-  }
-
-  // At the last Y line (the bottom line) a similar scenario occurs. There is no next Y line. Just sample and hold. Only horizontal interpolation is required.
-
-  // Get the current U/V samples for this y line
-  const int y = hh-1;  // Just process the last y line
-  const int y2 = (hh-1)*2;
-
-  // Get 2 chroma samples from this line
-  const int srcIdxUV = y*wh;
-  int curU = getValueFromSource(srcU, srcIdxUV*inValSkip, bps, bigEndian);
-  int curV = getValueFromSource(srcV, srcIdxUV*inValSkip, bps, bigEndian);
-  if (applyMathChroma)
-  {
-    curU = transformYUV(mathC.invert, mathC.scale, mathC.offset, curU, inMax);
-    curV = transformYUV(mathC.invert, mathC.scale, mathC.offset, curV, inMax);
-  }
-
-  for (int x = 0; x < (w/2)-1; x++)
-  {
-    // Get the next U/V sample for this line and the next one
-    const int srcIdxLineUV = srcIdxUV + x + 1;
-    int nextU = getValueFromSource(srcU, srcIdxLineUV*inValSkip, bps, bigEndian);
-    int nextV = getValueFromSource(srcV, srcIdxLineUV*inValSkip, bps, bigEndian);
-    if (applyMathChroma)
-    {
-      nextU = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextU, inMax);
-      nextV = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextV, inMax);
-    }
-
-    // From the current and the next U/V sample, interpolate the 3 UV samples in between
-    int interpolatedU_Hor = interpolateUVSample(interpolation, curU, nextU);  // Horizontal interpolation
-    int interpolatedV_Hor = interpolateUVSample(interpolation, curV, nextV);
-
-    // Get the 4 Y samples
-    int valY1 = getValueFromSource(srcY, (y*w+x)*2,      bps, bigEndian);
-    int valY2 = getValueFromSource(srcY, (y*w+x)*2+1,    bps, bigEndian);
-    int valY3 = getValueFromSource(srcY, (y2+1)*w+x*2,   bps, bigEndian);
-    int valY4 = getValueFromSource(srcY, (y2+1)*w+x*2+1, bps, bigEndian);
-    if (applyMathLuma)
-    {
-      valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-      valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-      valY3 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY3, inMax);
-      valY4 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY4, inMax);
-    }
-
-    // Convert to 4 RGB values and save them
-    int valR1, valR2, valG1, valG2, valB1, valB2;
-    convertYUVToRGB8Bit(valY1, curU             , curV             , valR1, valG1, valB1, RGBConv, fullRange, bps);
-    convertYUVToRGB8Bit(valY2, interpolatedU_Hor, interpolatedV_Hor, valR2, valG2, valB2, RGBConv, fullRange, bps);
-    const int pos1 = (y2*w+x*2)*4;
-    dst[pos1  ] = valB1;
-    dst[pos1+1] = valG1;
-    dst[pos1+2] = valR1;
-    dst[pos1+3] = 255;
-    dst[pos1+4] = valB2;
-    dst[pos1+5] = valG2;
-    dst[pos1+6] = valR2;
-    dst[pos1+7] = 255;
-    convertYUVToRGB8Bit(valY3, curU             , curV             , valR1, valG1, valB1, RGBConv, fullRange, bps);  // Second line
-    convertYUVToRGB8Bit(valY4, interpolatedU_Hor, interpolatedV_Hor, valR2, valG2, valB2, RGBConv, fullRange, bps);
-    const int pos2 = pos1 + w*4;  // Next line
-    dst[pos2  ] = valB1;
-    dst[pos2+1] = valG1;
-    dst[pos2+2] = valR1;
-    dst[pos2+3] = 255;
-    dst[pos2+4] = valB2;
-    dst[pos2+5] = valG2;
-    dst[pos2+6] = valR2;
-    dst[pos2+7] = 255;
-
-    // The next one is now the current one
-    curU = nextU;
-    curV = nextV;
-  }
-
-  // For the last x value in the last y row (the right bottom), there is no next value in neither direction.
-  // Just sample and hold. No interpolation is required.
-
-  // Get the 4 Y samples
-  int valY1 = getValueFromSource(srcY, (y2+1)*w-2, bps, bigEndian);
-  int valY2 = getValueFromSource(srcY, (y2+1)*w-1, bps, bigEndian);
-  int valY3 = getValueFromSource(srcY, (y2+2)*w-2, bps, bigEndian);
-  int valY4 = getValueFromSource(srcY, (y2+2)*w-1, bps, bigEndian);
-  if (applyMathLuma)
-  {
-    valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-    valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-    valY3 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY3, inMax);
-    valY4 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY4, inMax);
-  }
-
-  // Convert to 4 RGB values and save them
-  int valR1, valR2, valG1, valG2, valB1, valB2;
-  convertYUVToRGB8Bit(valY1, curU, curV, valR1, valG1, valB1, RGBConv, fullRange, bps);
-  convertYUVToRGB8Bit(valY2, curU, curV, valR2, valG2, valB2, RGBConv, fullRange, bps);
-  const int pos1 = (y2+1)*w*4;
-  dst[pos1-8] = valB1;
-  dst[pos1-7] = valG1;
-  dst[pos1-6] = valR1;
-  dst[pos1-5] = 255;
-  dst[pos1-4] = valB2;
-  dst[pos1-3] = valG2;
-  dst[pos1-2] = valR2;
-  dst[pos1-1] = 255;
-  convertYUVToRGB8Bit(valY3, curU, curV, valR1, valG1, valB1, RGBConv, fullRange, bps);  // Second line
-  convertYUVToRGB8Bit(valY4, curU, curV, valR2, valG2, valB2, RGBConv, fullRange, bps);
-  const int pos2 = pos1 + w*4;  // Next line
-  dst[pos2-8] = valB1;
-  dst[pos2-7] = valG1;
-  dst[pos2-6] = valR1;
-  dst[pos2-5] = 255;
-  dst[pos2-4] = valB2;
-  dst[pos2-3] = valG2;
-  dst[pos2-2] = valR2;
-  dst[pos2-1] = 255;
-}
-
-inline void YUVPlaneToRGB_410(const int w, const int h, const MathParameters mathY, const MathParameters mathC,
-                              const unsigned char * restrict srcY, const unsigned char * restrict srcU, const unsigned char * restrict srcV,
-                              unsigned char * restrict dst, const int RGBConv[5], const bool fullRange,const int inMax, const ChromaInterpolation interpolation, const int bps, const bool bigEndian, const int inValSkip)
-{
-  const bool applyMathLuma = mathY.mathRequired();
-  const bool applyMathChroma = mathC.mathRequired();
-  // Format is YUV 4:1:0. Horizontal and vertical up-sampling is required. Process 4 Y positions of 2 lines at a time
-  // Horizontal subsampling by 4, vertical subsampling by 2
-  const int hq = h/4; // The quarter values
-  const int wq = w/4;
-
-  for (int y = 0; y < hq; y++)
-  {
-    // Get the current U/V samples for this y line and the next one (_NL)
-    const int srcIdxUV0 = y*wq;
-    const int srcIdxUV1 = (y+1)*wq;
-    int curU    = getValueFromSource(srcU, srcIdxUV0*inValSkip, bps, bigEndian);
-    int curV    = getValueFromSource(srcV, srcIdxUV0*inValSkip, bps, bigEndian);
-    int curU_NL = (y < hq-1) ? getValueFromSource(srcU, srcIdxUV1*inValSkip, bps, bigEndian) : curU;
-    int curV_NL = (y < hq-1) ? getValueFromSource(srcV, srcIdxUV1*inValSkip, bps, bigEndian) : curV;
-    if (applyMathChroma)
-    {
-      curU    = transformYUV(mathC.invert, mathC.scale, mathC.offset, curU, inMax);
-      curV    = transformYUV(mathC.invert, mathC.scale, mathC.offset, curV, inMax);
-      curU_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, curU_NL, inMax);
-      curV_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, curV_NL, inMax);
-    }
-
-    for (int x = 0; x < wq; x++)
-    {
-      // We process 4*4 values per U/V value
-
-      // Get the next U/V sample for this line and the next one
-      const int srcIdxUVLine0 = srcIdxUV0 + x + 1;
-      const int srcIdxUVLine1 = srcIdxUV1 + x + 1;
-      int nextU    = (x < wq-1) ? getValueFromSource(srcU, srcIdxUVLine0*inValSkip, bps, bigEndian) : curU;
-      int nextV    = (x < wq-1) ? getValueFromSource(srcV, srcIdxUVLine0*inValSkip, bps, bigEndian) : curV;
-      int nextU_NL = (x < wq-1) ? getValueFromSource(srcU, srcIdxUVLine1*inValSkip, bps, bigEndian) : curU_NL;
-      int nextV_NL = (x < wq-1) ? getValueFromSource(srcV, srcIdxUVLine1*inValSkip, bps, bigEndian) : curV_NL;
-      if (applyMathChroma)
-      {
-        nextU    = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextU, inMax);
-        nextV    = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextV, inMax);
-        nextU_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextU_NL, inMax);
-        nextV_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextV_NL, inMax);
-      }
-
-      // Now we interpolate and set the RGB values for the 4x4 pixels
-      for (int yo = 0; yo < 4; yo++)
-      {
-        // Interpolate vertically
-        int curU_INT = interpolateUVSampleQ(interpolation, curU, curU_NL, yo);
-        int curV_INT = interpolateUVSampleQ(interpolation, curV, curV_NL, yo);
-        int nextU_INT = interpolateUVSampleQ(interpolation, nextU, nextU_NL, yo);
-        int nextV_INT = interpolateUVSampleQ(interpolation, nextV, nextV_NL, yo);
-
-        for (int xo = 0; xo < 4; xo++)
-        {
-          // Interpolate horizontally
-          int U = interpolateUVSampleQ(interpolation, curU_INT, nextU_INT, xo);
-          int V = interpolateUVSampleQ(interpolation, curV_INT, nextV_INT, xo);
-          // Get the Y sample
-          int Y = getValueFromSource(srcY, (y*4+yo)*w+x*4+xo, bps, bigEndian);
-          if (applyMathLuma)
-            Y = transformYUV(mathY.invert, mathY.scale, mathY.offset, Y, inMax);
-
-          // Convert to RGB and save (BGRA)
-          int R, G, B;
-          const int pos = ((y*4+yo)*w+x*4+xo)*4;
-          convertYUVToRGB8Bit(Y, U, V, R, G, B, RGBConv, fullRange, bps);
-          dst[pos  ] = B;
-          dst[pos+1] = G;
-          dst[pos+2] = R;
-          dst[pos+3] = 255;
-        }
-      }
-
-      curU = nextU;
-      curV = nextV;
-      curU_NL = nextU_NL;
-      curV_NL = nextV_NL;
-    }
-  }
-}
+  format = srcPixelFormat;
+  size = frameSize;
+  if (!format.isValid() || !size.isValid())
+    return false;
 
-inline void YUVPlaneToRGB_411(const int w, const int h, const MathParameters mathY, const MathParameters mathC,
-  const unsigned char * restrict srcY, const unsigned char * restrict srcU, const unsigned char * restrict srcV,
-  unsigned char * restrict dst, const int RGBConv[5], const bool fullRange,const int inMax, const ChromaInterpolation interpolation, const int bps, const bool bigEndian, const int inValSkip)
-{
-  // Chroma: quarter horizontal resolution
-  const bool applyMathLuma = mathY.mathRequired();
-  const bool applyMathChroma = mathC.mathRequired();
+  QByteArray frameRawData;
+  if (!loadRawFrame(frameIndex, frameRawData) || frameRawData.size() < format.bytesPerFrame(size))
+    return false;
 
-  // Horizontal up-sampling is required. Process four Y values at a time.
-  for (int y = 0; y < h; y++)
+  if (format.planar)
   {
-    const int srcIdxUV = y*w/4;
-    int curUSample = getValueFromSource(srcU, srcIdxUV*inValSkip, bps, bigEndian);
-    int curVSample = getValueFromSource(srcV, srcIdxUV*inValSkip, bps, bigEndian);
-    if (applyMathChroma)
-    {
-      curUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curUSample, inMax);
-      curVSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curVSample, inMax);
-    }
-
-    for (int x = 0; x < (w/4)-1; x++)
-    {
-      // Get the next U/V sample
-      const int srcIdxUVLine = srcIdxUV + x + 1;
-      int nextUSample = getValueFromSource(srcU, srcIdxUVLine*inValSkip, bps, bigEndian);
-      int nextVSample = getValueFromSource(srcV, srcIdxUVLine*inValSkip, bps, bigEndian);
-      if (applyMathChroma)
-      {
-        nextUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextUSample, inMax);
-        nextVSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextVSample, inMax);
-      }
-
-      // From the current and the next U/V sample, interpolate the UV sample in between
-      int interpolatedU1 = interpolateUVSampleQ(interpolation, curUSample, nextUSample, 1);
-      int interpolatedV1 = interpolateUVSampleQ(interpolation, curVSample, nextVSample, 1);
-      int interpolatedU2 = interpolateUVSample(interpolation, curUSample, nextUSample);
-      int interpolatedV2 = interpolateUVSample(interpolation, curVSample, nextVSample);
-      int interpolatedU3 = interpolateUVSampleQ(interpolation, curUSample, nextUSample, 3);
-      int interpolatedV3 = interpolateUVSampleQ(interpolation, curVSample, nextVSample, 3);
-
-      // Get the 4 Y samples
-      int valY1 = getValueFromSource(srcY, y*w+x*4,   bps, bigEndian);
-      int valY2 = getValueFromSource(srcY, y*w+x*4+1, bps, bigEndian);
-      int valY3 = getValueFromSource(srcY, y*w+x*4+2, bps, bigEndian);
-      int valY4 = getValueFromSource(srcY, y*w+x*4+3, bps, bigEndian);
-      if (applyMathLuma)
-      {
-        valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-        valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-        valY3 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY3, inMax);
-        valY4 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY4, inMax);
-      }
-
-      // Convert to 4 RGB values and save them
-      int valR, valG, valB;
-      const int pos = (y*w+x*4)*4;
-      convertYUVToRGB8Bit(valY1, curUSample, curVSample, valR, valG, valB, RGBConv, fullRange, bps);
-      dst[pos  ] = valB;
-      dst[pos+1] = valG;
-      dst[pos+2] = valR;
-      dst[pos+3] = 255;
-      convertYUVToRGB8Bit(valY2, interpolatedU1, interpolatedV1, valR, valG, valB, RGBConv, fullRange, bps);
-      dst[pos+4] = valB;
-      dst[pos+5] = valG;
-      dst[pos+6] = valR;
-      dst[pos+7] = 255;
-      convertYUVToRGB8Bit(valY3, interpolatedU2, interpolatedV2, valR, valG, valB, RGBConv, fullRange, bps);
-      dst[pos+8] = valB;
-      dst[pos+9] = valG;
-      dst[pos+10] = valR;
-      dst[pos+11] = 255;
-      convertYUVToRGB8Bit(valY4, interpolatedU3, interpolatedV3, valR, valG, valB, RGBConv, fullRange, bps);
-      dst[pos+12] = valB;
-      dst[pos+13] = valG;
-      dst[pos+14] = valR;
-      dst[pos+15] = 255;
-
-      // The next one is now the current one
-      curUSample = nextUSample;
-      curVSample = nextVSample;
-    }
-
-    // For the last row, there is no next sample. Just reuse the current one again. No interpolation required either.
-
-    // Get the 2 Y samples
-    int valY1 = getValueFromSource(srcY, (y+1)*w-4, bps, bigEndian);
-    int valY2 = getValueFromSource(srcY, (y+1)*w-3, bps, bigEndian);
-    int valY3 = getValueFromSource(srcY, (y+1)*w-2, bps, bigEndian);
-    int valY4 = getValueFromSource(srcY, (y+1)*w-1, bps, bigEndian);
-    if (applyMathLuma)
-    {
-      valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
-      valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
-      valY3 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY3, inMax);
-      valY4 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY4, inMax);
-    }
-
-    // Convert to 4 RGB values and save them
-    int valR, valG, valB;
-    const int pos = ((y+1)*w)*4;
-    convertYUVToRGB8Bit(valY1, curUSample, curVSample, valR, valG, valB, RGBConv, fullRange, bps);
-    dst[pos-16] = valB;
-    dst[pos-15] = valG;
-    dst[pos-14] = valR;
-    dst[pos-13] = 255;
-    convertYUVToRGB8Bit(valY2, curUSample, curVSample, valR, valG, valB, RGBConv, fullRange, bps);
-    dst[pos-12] = valB;
-    dst[pos-11] = valG;
-    dst[pos-10] = valR;
-    dst[pos-9] = 255;
-    convertYUVToRGB8Bit(valY3, curUSample, curVSample, valR, valG, valB, RGBConv, fullRange, bps);
-    dst[pos-8] = valB;
-    dst[pos-7] = valG;
-    dst[pos-6] = valR;
-    dst[pos-5] = 255;
-    convertYUVToRGB8Bit(valY4, curUSample, curVSample, valR, valG, valB, RGBConv, fullRange, bps);
-    dst[pos-4] = valB;
-    dst[pos-3] = valG;
-    dst[pos-2] = valR;
-    dst[pos-1] = 255;
+    planarData = frameRawData;
+    return true;
   }
+  return convertYUVPackedToPlanar(frameRawData, planarData, size, format);
 }
 
 bool videoHandlerYUV::convertYUVPackedToPlanar(const QByteArray &sourceBuffer, QByteArray &targetBuffer, const QSize &curFrameSize, yuvPixelFormat &sourceBufferFormat)
@@ -2284,167 +1339,26 @@ bool videoHandlerYUV::convertYUVPackedToPlanar(const QByteArray &sourceBuffer, Q
   return true;
 }
 
-bool videoHandlerYUV::convertYUVPlanarToRGB(const QByteArray &sourceBuffer, uchar *targetBuffer, const QSize &curFrameSize, const yuvPixelFormat &sourceBufferFormat) const
+bool videoHandlerYUV::convertYUVPlanarToRGB(const QByteArray &sourceBuffer, uchar *targetBuffer, const QSize &curFrameSize, const yuvPixelFormat &sourceBufferFormat, const int nrThreads) const
 {
-  // These are constant for the runtime of this function. This way, the compiler can optimize the
-  // hell out of this function.
-  const auto format = sourceBufferFormat;
-  const auto interpolation = chromaInterpolation;
-  const auto component = componentDisplayMode;
-  const auto conversion = yuvColorConversionType;
-  const auto w = curFrameSize.width();
-  const auto h = curFrameSize.height();
-
-  // Do we have to apply YUV math?
-  const auto mathY = mathParameters[Component::Luma];
-  const auto mathC = mathParameters[Component::Chroma];
-  const auto applyMathLuma   = mathY.mathRequired();
-  const auto applyMathChroma = mathC.mathRequired();
-  Q_UNUSED(applyMathLuma);
-  Q_UNUSED(applyMathChroma);
-
-  const auto bps = format.bitsPerSample;
-  const bool fullRange = (conversion == ColorConversion::BT709_FullRange || conversion == ColorConversion::BT601_FullRange || conversion == ColorConversion::BT2020_FullRange);
-  const auto yOffset = 16<<(bps-8);
-  const auto cZero = 128<<(bps-8);
-  const auto inputMax = (1<<bps)-1;
-  Q_UNUSED(yOffset);
-  Q_UNUSED(cZero);
-
-  // The luma component has full resolution. The size of each chroma components depends on the subsampling.
-  const auto componentSizeLuma = (w * h);
-  const auto componentSizeChroma = (w / format.getSubsamplingHor()) * (h / format.getSubsamplingVer());
-
-  // How many bytes are in each component?
-  const auto nrBytesLumaPlane = (bps > 8) ? componentSizeLuma * 2 : componentSizeLuma;
-  const auto nrBytesChromaPlane = (bps > 8) ? componentSizeChroma * 2 : componentSizeChroma;
-
-  // If the U and V (and A if present) components are interlevaed, we have to skip every nth value in the input when reading U and V
-  const auto inputValSkip = format.uvInterleaved ? ((format.planeOrder == PlaneOrder::YUV || format.planeOrder == PlaneOrder::YVU) ? 2 : 3) : 1;
-
-  // A pointer to the output
-  unsigned char * restrict dst = targetBuffer;
-
-  if (component != DisplayAll || format.subsampling == Subsampling::YUV_400)
-  {
-    // We only display (or there is only) one of the color components (possibly with YUV math)
-    if (component == DisplayY || format.subsampling == Subsampling::YUV_400)
-    {
-      // Luma only. The chroma subsampling does not matter.
-      const unsigned char * restrict srcY = (unsigned char*)sourceBuffer.data();
-      YUVPlaneToRGBMonochrome_444(componentSizeLuma, mathY, srcY, dst, inputMax, bps, format.bigEndian, 1, fullRange);
-    }
-    else
-    {
-      // Display only the U or V component
-      bool firstComponent = (((format.planeOrder == PlaneOrder::YUV || format.planeOrder == PlaneOrder::YUVA) && component == DisplayCb) ||
-                             ((format.planeOrder == PlaneOrder::YVU || format.planeOrder == PlaneOrder::YVUA) && component == DisplayCr));
-      
-      int srcOffset = nrBytesLumaPlane;
-      if (!firstComponent)
-      {
-        if (format.uvInterleaved)
-          srcOffset += (bps > 8) ? 2 : 1;
-        else
-          srcOffset += nrBytesChromaPlane;
-      }
-
-      const unsigned char * restrict srcC = (unsigned char*)sourceBuffer.data() + srcOffset;
-      if (format.subsampling == Subsampling::YUV_444)
-        YUVPlaneToRGBMonochrome_444(componentSizeChroma, mathC, srcC, dst, inputMax, bps, format.bigEndian, inputValSkip, fullRange);
-      else if (format.subsampling == Subsampling::YUV_422)
-        YUVPlaneToRGBMonochrome_422(componentSizeChroma, mathC, srcC, dst, inputMax, bps, format.bigEndian, inputValSkip, fullRange);
-      else if (format.subsampling == Subsampling::YUV_420)
-        YUVPlaneToRGBMonochrome_420(w, h, mathC, srcC, dst, inputMax, bps, format.bigEndian, inputValSkip, fullRange);
-      else if (format.subsampling == Subsampling::YUV_440)
-        YUVPlaneToRGBMonochrome_440(w, h, mathC, srcC, dst, inputMax, bps, format.bigEndian, inputValSkip, fullRange);
-      else if (format.subsampling == Subsampling::YUV_410)
-        YUVPlaneToRGBMonochrome_410(w, h, mathC, srcC, dst, inputMax, bps, format.bigEndian, inputValSkip, fullRange);
-      else if (format.subsampling == Subsampling::YUV_411)
-        YUVPlaneToRGBMonochrome_411(componentSizeChroma, mathC, srcC, dst, inputMax, bps, format.bigEndian, inputValSkip, fullRange);
-      else
-        return false;
-    }
-  }
-  else
-  {
-    // Is the U plane the first or the second?
-    const bool uPlaneFirst = (format.planeOrder == PlaneOrder::YUV || format.planeOrder == PlaneOrder::YUVA);
-
-    // In case the U and V (and A if present) components are interleaved, the skip to the next plane is just 1 (or 2) bytes
-    int nrBytesToNextChromaPlane = nrBytesChromaPlane;
-    if (format.uvInterleaved)
-      nrBytesToNextChromaPlane = (bps > 8) ? 2 : 1;
-
-    // Get/set the parameters used for YUV -> RGB conversion
-    int RGBConv[5];
-    getColorConversionCoefficients(yuvColorConversionType, RGBConv);
-
-    // We are displaying all components, so we have to perform conversion to RGB (possibly including interpolation and YUV math)
-    if (format.subsampling != Subsampling::YUV_400 && (format.chromaOffset[0] != 0 || format.chromaOffset[1] != 0))
-    {
-      // If there is a chroma offset, we must resample the chroma components before we convert them to RGB.
-      // If so, the resampled chroma values are saved in these arrays.
-      QByteArray uvPlaneChromaResampled[2];
-      uvPlaneChromaResampled[0].resize(nrBytesChromaPlane);
-      uvPlaneChromaResampled[1].resize(nrBytesChromaPlane);
-
-      // We have to perform pre-filtering for the U and V positions, because there is an offset between the pixel positions of Y and U/V
-      unsigned char *restrict dstU = (unsigned char*)uvPlaneChromaResampled[0].data();
-      unsigned char *restrict dstV = (unsigned char*)uvPlaneChromaResampled[1].data();
-
-      unsigned char * restrict srcY = (unsigned char*)sourceBuffer.data();
-      unsigned char * restrict srcU = uPlaneFirst ? srcY + nrBytesLumaPlane : srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane;
-      unsigned char * restrict srcV = uPlaneFirst ? srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane: srcY + nrBytesLumaPlane;
-      UVPlaneResamplingChromaOffset(format, w / format.getSubsamplingHor(), h / format.getSubsamplingVer(), srcU, srcV, inputValSkip, dstU, dstV);
-
-      if (format.subsampling == Subsampling::YUV_444)
-        YUVPlaneToRGB_444(componentSizeLuma, mathY, mathC, srcY, dstU, dstV, dst, RGBConv, fullRange, inputMax, bps, format.bigEndian, 1);
-      else if (format.subsampling == Subsampling::YUV_422)
-        YUVPlaneToRGB_422(w, h, mathY, mathC, srcY, dstU, dstV, dst, RGBConv, fullRange, inputMax, interpolation, bps, format.bigEndian, 1);
-      else if (format.subsampling == Subsampling::YUV_420)
-        YUVPlaneToRGB_420(w, h, mathY, mathC, srcY, dstU, dstV, dst, RGBConv, fullRange, inputMax, interpolation, bps, format.bigEndian, 1);
-      else if (format.subsampling == Subsampling::YUV_440)
-        YUVPlaneToRGB_440(w, h, mathY, mathC, srcY, dstU, dstV, dst, RGBConv, fullRange, inputMax, interpolation, bps, format.bigEndian, 1);
-      else if (format.subsampling == Subsampling::YUV_410)
-        YUVPlaneToRGB_410(w, h, mathY, mathC, srcY, dstU, dstV, dst, RGBConv, fullRange, inputMax, interpolation, bps, format.bigEndian, 1);
-      else if (format.subsampling == Subsampling::YUV_411)
-        YUVPlaneToRGB_411(w, h, mathY, mathC, srcY, dstU, dstV, dst, RGBConv, fullRange, inputMax, interpolation, bps, format.bigEndian, 1);
-      else
-        return false;
-    }
-    else
-    {
-      // Get the pointers to the source planes (8 bit per sample)
-      const unsigned char * restrict srcY = (unsigned char*)sourceBuffer.data();
-      const unsigned char * restrict srcU = uPlaneFirst ? srcY + nrBytesLumaPlane : srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane;
-      const unsigned char * restrict srcV = uPlaneFirst ? srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane: srcY + nrBytesLumaPlane;
-
-      if (format.subsampling == Subsampling::YUV_444)
-        YUVPlaneToRGB_444(componentSizeLuma, mathY, mathC, srcY, srcU, srcV, dst, RGBConv, fullRange, inputMax, bps, format.bigEndian, inputValSkip);
-      else if (format.subsampling == Subsampling::YUV_422)
-        YUVPlaneToRGB_422(w, h, mathY, mathC, srcY, srcU, srcV, dst, RGBConv, fullRange, inputMax, interpolation, bps, format.bigEndian, inputValSkip);
-      else if (format.subsampling == Subsampling::YUV_420)
-        YUVPlaneToRGB_420(w, h, mathY, mathC, srcY, srcU, srcV, dst, RGBConv, fullRange, inputMax, interpolation, bps, format.bigEndian, inputValSkip);
-      else if (format.subsampling == Subsampling::YUV_440)
-        YUVPlaneToRGB_440(w, h, mathY, mathC, srcY, srcU, srcV, dst, RGBConv, fullRange, inputMax, interpolation, bps, format.bigEndian, inputValSkip);
-      else if (format.subsampling == Subsampling::YUV_410)
-        YUVPlaneToRGB_410(w, h, mathY, mathC, srcY, srcU, srcV, dst, RGBConv, fullRange, inputMax, interpolation, bps, format.bigEndian, inputValSkip);
-      else if (format.subsampling == Subsampling::YUV_411)
-        YUVPlaneToRGB_411(w, h, mathY, mathC, srcY, srcU, srcV, dst, RGBConv, fullRange, inputMax, interpolation, bps, format.bigEndian, inputValSkip);
-      else if (format.subsampling == Subsampling::YUV_400)
-        YUVPlaneToRGBMonochrome_444(componentSizeLuma, mathY, srcY, dst, fullRange, inputMax, bps, format.bigEndian, 1);
-      else
-        return false;
-    }
-  }
-
-  return true;
+  ConversionSettings settings;
+  settings.chromaInterpolation = chromaInterpolation;
+  settings.colorConversion = yuvColorConversionType;
+  if (componentDisplayMode == DisplayY)
+    settings.component = DisplayComponent::Y;
+  else if (componentDisplayMode == DisplayCb)
+    settings.component = DisplayComponent::Cb;
+  else if (componentDisplayMode == DisplayCr)
+    settings.component = DisplayComponent::Cr;
+  settings.mathY = mathParameters[Component::Luma];
+  settings.mathC = mathParameters[Component::Chroma];
+
+  return YUV_Internals::convertYUVPlanarToRGB(sourceBuffer, targetBuffer, curFrameSize, sourceBufferFormat, settings, nrThreads, &videoHandler::runConversionInParallel);
 }
 
 // Convert the given raw YUV data in sourceBuffer (using srcPixelFormat) to image (RGB-888), using the
 // buffer tmpRGBBuffer for intermediate RGB values.
-void videoHandlerYUV::convertYUVToImage(const QByteArray &sourceBuffer, QImage &outputImage, const yuvPixelFormat &yuvFormat, const QSize &curFrameSize)
+void videoHandlerYUV::convertYUVToImage(const QByteArray &sourceBuffer, QImage &outputImage, const yuvPixelFormat &yuvFormat, const QSize &curFrameSize, const int nrThreads)
 {
   if (!yuvFormat.canConvertToRGB(curFrameSize))
   {
@@ -2486,9 +1400,9 @@ void videoHandlerYUV::convertYUVToImage(const QByteArray &sourceBuffer, QImage &
         !mathParameters[Component::Luma].mathRequired() && !mathParameters[Component::Chroma].mathRequired())
       // 8 bit 4:2:0, nearest neighbor, chroma offset (0,1) (the default for 4:2:0), all components displayed and no yuv math.
       // We can use a specialized function for this.
-      convOK = convertYUV420ToRGB(sourceBuffer, outputImage.bits(), curFrameSize, yuvFormat);
+      convOK = convertYUV420ToRGB(sourceBuffer, outputImage.bits(), curFrameSize, yuvFormat, nrThreads);
     else
-      convOK = convertYUVPlanarToRGB(sourceBuffer, outputImage.bits(), curFrameSize, yuvFormat);
+      convOK = convertYUVPlanarToRGB(sourceBuffer, outputImage.bits(), curFrameSize, yuvFormat, nrThreads);
   }
   else
   {
@@ -2499,7 +1413,7 @@ void videoHandlerYUV::convertYUVToImage(const QByteArray &sourceBuffer, QImage &
     convOK &= convertYUVPackedToPlanar(sourceBuffer, tmpPlanarYUVSource, curFrameSize, bufferPixelFormat);
 
     if (convOK)
-      convOK &= convertYUVPlanarToRGB(tmpPlanarYUVSource, outputImage.bits(), curFrameSize, bufferPixelFormat);
+      convOK &= convertYUVPlanarToRGB(tmpPlanarYUVSource, outputImage.bits(), curFrameSize, bufferPixelFormat, nrThreads);
   }
 
   assert(convOK);
@@ -2614,7 +1528,7 @@ videoHandlerYUV::yuv_t videoHandlerYUV::getPixelValue(const QPoint &pixelPos) co
 #if SSE_CONVERSION
 bool videoHandlerYUV::convertYUV420ToRGB(const byteArrayAligned &sourceBuffer, byteArrayAligned &targetBuffer)
 #else
-bool videoHandlerYUV::convertYUV420ToRGB(const QByteArray &sourceBuffer, unsigned char *targetBuffer, const QSize &size, const yuvPixelFormat format)
+bool videoHandlerYUV::convertYUV420ToRGB(const QByteArray &sourceBuffer, unsigned char *targetBuffer, const QSize &size, const yuvPixelFormat format, const int nrThreads)
 #endif
 {
   const int frameWidth = size.width();
@@ -2746,85 +1660,91 @@ bool videoHandlerYUV::convertYUV420ToRGB(const QByteArray &sourceBuffer, unsigne
   const unsigned char * restrict srcU = uPplaneFirst ? srcY + componentLenghtY : srcY + componentLenghtY + componentLengthUV;
   const unsigned char * restrict srcV = uPplaneFirst ? srcY + componentLenghtY + componentLengthUV : srcY + componentLenghtY;
 
-  int yh;
-  for (yh=0; yh < frameHeight / 2; yh++)
+  // Each band converts a range of line pairs. The bands are independent of each other.
+  const int nrBands = qMax(1, qMin(nrThreads, frameHeight / 2));
+  runConversionInParallel(nrBands, [&](int band)
   {
-    // Process two lines at once, always 4 RGB values at a time (they have the same U/V components)
-
-    int dstAddr1 = yh * 2 * frameWidth * 4;         // The RGB output address of line yh*2
-    int dstAddr2 = (yh * 2 + 1) * frameWidth * 4;   // The RGB output address of line yh*2+1
-    int srcAddrY1 = yh * 2 * frameWidth;            // The Y source address of line yh*2
-    int srcAddrY2 = (yh * 2 + 1) * frameWidth;      // The Y source address of line yh*2+1
-    int srcAddrUV = yh * frameWidth / 2;            // The UV source address of both lines (UV are identical)
-
-    for (int xh=0, x=0; xh < frameWidth / 2; xh++, x+=2)
+    const int yhStart = (frameHeight / 2) * band / nrBands;
+    const int yhEnd = (frameHeight / 2) * (band + 1) / nrBands;
+    for (int yh = yhStart; yh < yhEnd; yh++)
     {
-      // Process four pixels (the ones for which U/V are valid
+      // Process two lines at once, always 4 RGB values at a time (they have the same U/V components)
 
-      // Load UV and pre-multiply
-      const int U_tmp_G = ((int)srcU[srcAddrUV + xh] - cZero) * RGBConv[2];
-      const int U_tmp_B = ((int)srcU[srcAddrUV + xh] - cZero) * RGBConv[4];
-      const int V_tmp_R = ((int)srcV[srcAddrUV + xh] - cZero) * RGBConv[1];
-      const int V_tmp_G = ((int)srcV[srcAddrUV + xh] - cZero) * RGBConv[3];
+      int dstAddr1 = yh * 2 * frameWidth * 4;         // The RGB output address of line yh*2
+      int dstAddr2 = (yh * 2 + 1) * frameWidth * 4;   // The RGB output address of line yh*2+1
+      int srcAddrY1 = yh * 2 * frameWidth;            // The Y source address of line yh*2
+      int srcAddrY2 = (yh * 2 + 1) * frameWidth;      // The Y source address of line yh*2+1
+      int srcAddrUV = yh * frameWidth / 2;            // The UV source address of both lines (UV are identical)
 
-      // Pixel top left
+      for (int xh=0, x=0; xh < frameWidth / 2; xh++, x+=2)
       {
-        const int Y_tmp = ((int)srcY[srcAddrY1 + x] - yOffset) * RGBConv[0];
+        // Process four pixels (the ones for which U/V are valid
 
-        const int R_tmp = (Y_tmp           + V_tmp_R) >> 16;
-        const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
-        const int B_tmp = (Y_tmp + U_tmp_B          ) >> 16;
+        // Load UV and pre-multiply
+        const int U_tmp_G = ((int)srcU[srcAddrUV + xh] - cZero) * RGBConv[2];
+        const int U_tmp_B = ((int)srcU[srcAddrUV + xh] - cZero) * RGBConv[4];
+        const int V_tmp_R = ((int)srcV[srcAddrUV + xh] - cZero) * RGBConv[1];
+        const int V_tmp_G = ((int)srcV[srcAddrUV + xh] - cZero) * RGBConv[3];
 
-        dst[dstAddr1]   = clip_buf[B_tmp];
-        dst[dstAddr1+1] = clip_buf[G_tmp];
-        dst[dstAddr1+2] = clip_buf[R_tmp];
-        dst[dstAddr1+3] = 255;
-        dstAddr1 += 4;
-      }
-      // Pixel top right
-      {
-        const int Y_tmp = ((int)srcY[srcAddrY1 + x + 1] - yOffset) * RGBConv[0];
+        // Pixel top left
+        {
+          const int Y_tmp = ((int)srcY[srcAddrY1 + x] - yOffset) * RGBConv[0];
 
-        const int R_tmp = (Y_tmp           + V_tmp_R) >> 16;
-        const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
-        const int B_tmp = (Y_tmp + U_tmp_B          ) >> 16;
+          const int R_tmp = (Y_tmp           + V_tmp_R) >> 16;
+          const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
+          const int B_tmp = (Y_tmp + U_tmp_B          ) >> 16;
 
-        dst[dstAddr1]   = clip_buf[B_tmp];
-        dst[dstAddr1+1] = clip_buf[G_tmp];
-        dst[dstAddr1+2] = clip_buf[R_tmp];
-        dst[dstAddr1+3] = 255;
-        dstAddr1 += 4;
-      }
-      // Pixel bottom left
-      {
-        const int Y_tmp = ((int)srcY[srcAddrY2 + x] - yOffset) * RGBConv[0];
+          dst[dstAddr1]   = clip_buf[B_tmp];
+          dst[dstAddr1+1] = clip_buf[G_tmp];
+          dst[dstAddr1+2] = clip_buf[R_tmp];
+          dst[dstAddr1+3] = 255;
+          dstAddr1 += 4;
+        }
+        // Pixel top right
+        {
+          const int Y_tmp = ((int)srcY[srcAddrY1 + x + 1] - yOffset) * RGBConv[0];
 
-        const int R_tmp = (Y_tmp           + V_tmp_R) >> 16;
-        const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
-        const int B_tmp = (Y_tmp + U_tmp_B          ) >> 16;
+          const int R_tmp = (Y_tmp           + V_tmp_R) >> 16;
+          const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
+          const int B_tmp = (Y_tmp + U_tmp_B          ) >> 16;
 
-        dst[dstAddr2]   = clip_buf[B_tmp];
-        dst[dstAddr2+1] = clip_buf[G_tmp];
-        dst[dstAddr2+2] = clip_buf[R_tmp];
-        dst[dstAddr2+3] = 255;
-        dstAddr2 += 4;
-      }
-      // Pixel bottom right
-      {
-        const int Y_tmp = ((int)srcY[srcAddrY2 + x + 1] - yOffset) * RGBConv[0];
+          dst[dstAddr1]   = clip_buf[B_tmp];
+          dst[dstAddr1+1] = clip_buf[G_tmp];
+          dst[dstAddr1+2] = clip_buf[R_tmp];
+          dst[dstAddr1+3] = 255;
+          dstAddr1 += 4;
+        }
+        // Pixel bottom left
+        {
+          const int Y_tmp = ((int)srcY[srcAddrY2 + x] - yOffset) * RGBConv[0];
+
+          const int R_tmp = (Y_tmp           + V_tmp_R) >> 16;
+          const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
+          const int B_tmp = (Y_tmp + U_tmp_B          ) >> 16;
 
-        const int R_tmp = (Y_tmp           + V_tmp_R) >> 16;
-        const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
-        const int B_tmp = (Y_tmp + U_tmp_B          ) >> 16;
+          dst[dstAddr2]   = clip_buf[B_tmp];
+          dst[dstAddr2+1] = clip_buf[G_tmp];
+          dst[dstAddr2+2] = clip_buf[R_tmp];
+          dst[dstAddr2+3] = 255;
+          dstAddr2 += 4;
+        }
+        // Pixel bottom right
+        {
+          const int Y_tmp = ((int)srcY[srcAddrY2 + x + 1] - yOffset) * RGBConv[0];
 
-        dst[dstAddr2]   = clip_buf[B_tmp];
-        dst[dstAddr2+1] = clip_buf[G_tmp];
-        dst[dstAddr2+2] = clip_buf[R_tmp];
-        dst[dstAddr2+3] = 255;
-        dstAddr2 += 4;
+          const int R_tmp = (Y_tmp           + V_tmp_R) >> 16;
+          const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
+          const int B_tmp = (Y_tmp + U_tmp_B          ) >> 16;
+
+          dst[dstAddr2]   = clip_buf[B_tmp];
+          dst[dstAddr2+1] = clip_buf[G_tmp];
+          dst[dstAddr2+2] = clip_buf[R_tmp];
+          dst[dstAddr2+3] = 255;
+          dstAddr2 += 4;
+        }
       }
     }
-  }
+  });
 
   return true;
 }
@@ -2926,6 +1846,11 @@ QByteArray videoHandlerYUV::getDiffYUV() const
     return diffYUV;
 }
 
+YUV_Internals::SSIMMap videoHandlerYUV::getDiffSSIMMap() const
+{
+  return diffSSIMMap;
+}
+
 QImage videoHandlerYUV::calculateDifference(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference)
 {
   is_YUV_diff = false;
@@ -2940,24 +1865,6 @@ QImage videoHandlerYUV::calculateDifference(frameHandler *item2, const int frame
     // The two items have different subsampling modes. Compare RGB values instead.
     return videoHandler::calculateDifference(item2, frameIdxItem0, frameIdxItem1, differenceInfoList, amplificationFactor, markDifference);
 
-  // Get/Set the bit depth of the input and output
-  // If the bit depth if the two items is different, we will scale the item with the lower bit depth up.
-  const int bps_in[2] = {srcPixelFormat.bitsPerSample, yuvItem2->srcPixelFormat.bitsPerSample};
-  const int bps_out = std::max(bps_in[0], bps_in[1]);
-  // Which of the two input values has to be scaled up? Only one of these (or neither) can be set.
-  const bool bitDepthScaling[2] = {bps_in[0] != bps_out, bps_in[1] != bps_out};
-  // Scale the input up by this many bits
-  const int depthScale = bps_out - (bitDepthScaling[0] ? bps_in[0] : bps_in[1]);
-  // Add a warning if the bit depths of the two inputs don't agree
-  if (bitDepthScaling[0] || bitDepthScaling[1])
-    differenceInfoList.append(infoItem("Warning", "The bit depth of the two items differs.", "The bit depth of the two input items is different. The lower bit depth will be scaled up and the difference is calculated."));
-  // What are the maximum and middle value for the output bit depth
-  const int diffZero = 128 << (bps_out-8);
-  const int maxVal = (1 << bps_out) - 1;
-
-  // Do we amplify the values?
-  const bool amplification = (amplificationFactor != 1 && !markDifference);
-
   // Load the right raw YUV data (if not already loaded).
   // This will just update the raw YUV data. No conversion to image (RGB) is performed. This is either
   // done on request if the frame is actually shown or has already been done by the caching process.
@@ -2969,136 +1876,45 @@ QImage videoHandlerYUV::calculateDifference(frameHandler *item2, const int frame
   // Both YUV buffers are up to date. Really calculate the difference.
   DEBUG_YUV("videoHandlerYUV::calculateDifference frame idx item 0 " << frameIdxItem0 << " - item 1 " << frameIdxItem1);
 
-  // The items can be of different size (we then calculate the difference of the top left aligned part)
-  const int w_in[2] = {frameSize.width(), yuvItem2->frameSize.width()};
-  const int h_in[2] = {frameSize.height(), yuvItem2->frameSize.height()};
-  const int w_out = qMin(w_in[0], w_in[1]);
-  const int h_out = qMin(h_in[0], h_in[1]);
+  // The difference is calculated on planar data. Packed formats are converted first.
+  QByteArray inputData[2] = {currentFrameRawData, yuvItem2->currentFrameRawData};
+  yuvPixelFormat inputFormat[2] = {srcPixelFormat, yuvItem2->srcPixelFormat};
+  for (int i = 0; i < 2; i++)
+  {
+    if (inputFormat[i].planar)
+      continue;
+    QByteArray planarData;
+    const QSize inputSize = (i == 0) ? frameSize : yuvItem2->frameSize;
+    if (!convertYUVPackedToPlanar(inputData[i], planarData, inputSize, inputFormat[i]))
+      return QImage();
+    inputData[i] = planarData;
+  }
+
+  // Add a warning if the bit depths of the two inputs don't agree
+  if (inputFormat[0].bitsPerSample != inputFormat[1].bitsPerSample)
+    differenceInfoList.append(infoItem("Warning", "The bit depth of the two items differs.", "The bit depth of the two input items is different. The lower bit depth will be scaled up and the difference is calculated."));
   // Append a warning if the frame sizes are different
   if (frameSize != yuvItem2->frameSize)
     differenceInfoList.append(infoItem("Warning", "The size of the two items differs.", "The size of the two input items is different. The difference of the top left aligned part that overlaps will be calculated."));
 
-  yuvPixelFormat tmpDiffYUVFormat(srcPixelFormat.subsampling, bps_out, PlaneOrder::YUV, true);
+  DifferenceSettings settings;
+  // When marking differences, the values are not amplified
+  settings.amplificationFactor = markDifference ? 1 : amplificationFactor;
+  settings.calculateSSIMMap = true;
+  DifferenceResult result;
+  if (!YUV_Internals::calculateDifference(inputData[0], inputFormat[0], frameSize, inputData[1], inputFormat[1], yuvItem2->frameSize,
+                                          diffYUV, result, settings, nrConversionThreads, &videoHandler::runConversionInParallel))
+    return QImage();
+
+  const yuvPixelFormat tmpDiffYUVFormat = result.differenceFormat;
   diffYUVFormat = tmpDiffYUVFormat;
+  diffSSIMMap = result.ssimMap;
+  const int w_out = result.differenceSize.width();
+  const int h_out = result.differenceSize.height();
 
   if (!tmpDiffYUVFormat.canConvertToRGB(QSize(w_out, h_out)))
     return QImage();
 
-
-  // Get subsampling modes (they are identical for both inputs and the output)
-  const int subH = srcPixelFormat.getSubsamplingHor();
-  const int subV = srcPixelFormat.getSubsamplingVer();
-
-  // Get the endianness of the inputs
-  const bool bigEndian[2] = {srcPixelFormat.bigEndian, yuvItem2->srcPixelFormat.bigEndian};
-
-  // Get pointers to the inputs
-  const int componentSizeLuma_In[2] = {w_in[0]*h_in[0], w_in[1]*h_in[1]};
-  const int componentSizeChroma_In[2] = {(w_in[0]/subH)*(h_in[0]/subV), (w_in[1]/subH)*(h_in[1]/subV)};
-  const int nrBytesLumaPlane_In[2] = {bps_in[0] > 8 ? 2 * componentSizeLuma_In[0] : componentSizeLuma_In[0], bps_in[1] > 8 ? 2 * componentSizeLuma_In[1] : componentSizeLuma_In[1]};
-  const int nrBytesChromaPlane_In[2] = {bps_in[0] > 8 ? 2 * componentSizeChroma_In[0] : componentSizeChroma_In[0], bps_in[1] > 8 ? 2 * componentSizeChroma_In[1] : componentSizeChroma_In[1]};
-  // Current item
-  const unsigned char * restrict srcY1 = (unsigned char*)currentFrameRawData.data();
-  const unsigned char * restrict srcU1 = (srcPixelFormat.planeOrder == PlaneOrder::YUV || srcPixelFormat.planeOrder == PlaneOrder::YUVA) ? srcY1 + nrBytesLumaPlane_In[0] : srcY1 + nrBytesLumaPlane_In[0] + nrBytesChromaPlane_In[0];
-  const unsigned char * restrict srcV1 = (srcPixelFormat.planeOrder == PlaneOrder::YUV || srcPixelFormat.planeOrder == PlaneOrder::YUVA) ? srcY1 + nrBytesLumaPlane_In[0] + nrBytesChromaPlane_In[0]: srcY1 + nrBytesLumaPlane_In[0];
-  // The other item
-  const unsigned char * restrict srcY2 = (unsigned char*)yuvItem2->currentFrameRawData.data();
-  const unsigned char * restrict srcU2 = (yuvItem2->srcPixelFormat.planeOrder == PlaneOrder::YUV || yuvItem2->srcPixelFormat.planeOrder == PlaneOrder::YUVA) ? srcY2 + nrBytesLumaPlane_In[1] : srcY2 + nrBytesLumaPlane_In[1] + nrBytesChromaPlane_In[1];
-  const unsigned char * restrict srcV2 = (yuvItem2->srcPixelFormat.planeOrder == PlaneOrder::YUV || yuvItem2->srcPixelFormat.planeOrder == PlaneOrder::YUVA) ? srcY2 + nrBytesLumaPlane_In[1] + nrBytesChromaPlane_In[1]: srcY2 + nrBytesLumaPlane_In[1];
-
-  // Get pointers to the output
-  const int componentSizeLuma_out = w_out*h_out * (bps_out > 8 ? 2 : 1); // Size in bytes
-  const int componentSizeChroma_out = (w_out/subH) * (h_out/subV) * (bps_out > 8 ? 2 : 1);
-  // Resize the output buffer to the right size
-  diffYUV.resize(componentSizeLuma_out + 2*componentSizeChroma_out);
-  unsigned char * restrict dstY = (unsigned char*)diffYUV.data();
-  unsigned char * restrict dstU = dstY + componentSizeLuma_out;
-  unsigned char * restrict dstV = dstU + componentSizeChroma_out;
-
-  // Also calculate the MSE while we're at it (Y,U,V)
-  // TODO: Bug: MSE is not scaled correctly in all YUV format cases
-  int64_t mseAdd[3] = {0, 0, 0};
-
-  // Calculate Luma sample difference
-  const int stride_in[2] = {bps_in[0] > 8 ? w_in[0]*2 : w_in[0], bps_in[1] > 8 ? w_in[1]*2 : w_in[1]};  // How many bytes to the next y line?
-  for (int y = 0; y < h_out; y++)
-  {
-    for (int x = 0; x < w_out; x++)
-    {
-      int val1 = getValueFromSource(srcY1, x, bps_in[0], bigEndian[0]);
-      int val2 = getValueFromSource(srcY2, x, bps_in[1], bigEndian[1]);
-
-      // Scale (if necessary)
-      if (bitDepthScaling[0])
-        val1 = val1 << depthScale;
-      else if (bitDepthScaling[1])
-        val2 = val2 << depthScale;
-
-      // Calculate the difference, add MSE, (amplify) and clip the difference value
-      int diff = val1 - val2;
-      mseAdd[0] += diff * diff;
-      if (amplification)
-        diff *= amplificationFactor;
-      diff = clip(diff + diffZero, 0, maxVal);
-
-      setValueInBuffer(dstY, diff, 0, bps_out, true);
-      dstY += (bps_out > 8) ? 2 : 1;
-    }
-
-    // Goto the next y line
-    srcY1 += stride_in[0];
-    srcY2 += stride_in[1];
-  }
-
-  // Next U/V
-  const int strideC_in[2] = {w_in[0] / subH * (bps_in[0] > 8 ? 2 : 1), w_in[1] / subH * (bps_in[1] > 8 ? 2 : 1)};  // How many bytes to the next U/V y line
-  for (int y = 0; y < h_out / subV; y++)
-  {
-    for (int x = 0; x < w_out / subH; x++)
-    {
-      int valU1 = getValueFromSource(srcU1, x, bps_in[0], bigEndian[0]);
-      int valU2 = getValueFromSource(srcU2, x, bps_in[1], bigEndian[1]);
-      int valV1 = getValueFromSource(srcV1, x, bps_in[0], bigEndian[0]);
-      int valV2 = getValueFromSource(srcV2, x, bps_in[1], bigEndian[1]);
-
-      // Scale (if necessary)
-      if (bitDepthScaling[0])
-      {
-        valU1 = valU1 << depthScale;
-        valV1 = valV1 << depthScale;
-      }
-      else if (bitDepthScaling[1])
-      {
-        valU2 = valU2 << depthScale;
-        valV2 = valV2 << depthScale;
-      }
-
-      // Calculate the difference, add MSE, (amplify) and clip the difference value
-      int diffU = valU1 - valU2;
-      int diffV = valV1 - valV2;
-      mseAdd[1] += diffU * diffU;
-      mseAdd[2] += diffV * diffV;
-      if (amplification)
-      {
-        diffU *= amplificationFactor;
-        diffV *= amplificationFactor;
-      }
-      diffU = clip(diffU + diffZero, 0, maxVal);
-      diffV = clip(diffV + diffZero, 0, maxVal);
-
-      setValueInBuffer(dstU, diffU, 0, bps_out, true);
-      setValueInBuffer(dstV, diffV, 0, bps_out, true);
-      dstU += (bps_out > 8) ? 2 : 1;
-      dstV += (bps_out > 8) ? 2 : 1;
-    }
-
-    // Goto the next y line
-    srcU1 += strideC_in[0];
-    srcV1 += strideC_in[0];
-    srcU2 += strideC_in[1];
-    srcV2 += strideC_in[1];
-  }
-
   // Next we convert the difference YUV image to RGB, either using the normal conversion function or
   // another function that only marks the difference values.
 
@@ -3125,20 +1941,22 @@ QImage videoHandlerYUV::calculateDifference(frameHandler *item2, const int frame
     markDifferencesYUVPlanarToRGB(diffYUV, outputImage.bits(), QSize(w_out, h_out), tmpDiffYUVFormat);
   else
     // Get the format of the tmpDiffYUV buffer and convert it to RGB
-    convertYUVPlanarToRGB(diffYUV, outputImage.bits(), QSize(w_out, h_out), tmpDiffYUVFormat);
+    convertYUVPlanarToRGB(diffYUV, outputImage.bits(), QSize(w_out, h_out), tmpDiffYUVFormat, nrConversionThreads);
 
   // Append the conversion information that will be returned
   QStringList yuvSubsamplings = QStringList() << "4:4:4" << "4:2:2" << "4:2:0" << "4:4:0" << "4:1:0" << "4:1:1" << "4:0:0";
   differenceInfoList.append(infoItem("Difference Type",QString("YUV %1").arg(yuvSubsamplings[subsamplingList.indexOf(srcPixelFormat.subsampling)])));
-  double mse[4];
-  mse[0] = double(mseAdd[0]) / (w_out * h_out);
-  mse[1] = double(mseAdd[1]) / (w_out * h_out);
-  mse[2] = double(mseAdd[2]) / (w_out * h_out);
-  mse[3] = mse[0] + mse[1] + mse[2];
-  differenceInfoList.append(infoItem("MSE Y",QString("%1").arg(mse[0])));
-  differenceInfoList.append(infoItem("MSE U",QString("%1").arg(mse[1])));
-  differenceInfoList.append(infoItem("MSE V",QString("%1").arg(mse[2])));
-  differenceInfoList.append(infoItem("MSE All",QString("%1").arg(mse[3])));
+  const QStringList componentNames = QStringList() << "Y" << "U" << "V";
+  for (int c = 0; c < result.nrComponents; c++)
+    differenceInfoList.append(infoItem(QString("MSE %1").arg(componentNames[c]), QString("%1").arg(result.components[c].getMSE())));
+  const auto combinedMetrics = result.getCombinedMetrics();
+  differenceInfoList.append(infoItem("MSE All", QString("%1").arg(combinedMetrics.getMSE()), "The mean squared error of all samples of all components"));
+  for (int c = 0; c < result.nrComponents; c++)
+    differenceInfoList.append(infoItem(QString("PSNR %1").arg(componentNames[c]), QString("%1 dB").arg(result.components[c].getPSNR(), 0, 'f', 3),
+                                       QString("The PSNR for a peak value of %1 (%2 bit)").arg((1 << result.components[c].bitsPerSample) - 1).arg(result.components[c].bitsPerSample)));
+  for (int c = 0; c < result.nrComponents; c++)
+    differenceInfoList.append(infoItem(QString("SSIM %1").arg(componentNames[c]), QString("%1").arg(result.components[c].getSSIM(), 0, 'f', 5),
+                                       "The mean SSIM of all 8x8 windows (placed every 4 samples)"));
 
   if (is_Q_OS_LINUX)
   {
@@ -33,6 +33,7 @@
 #pragma once
 
 #include "videoHandler.h"
+#include "yuvDifference.h"
 #include "yuvPixelFormat.h"
 
 #include "ui_videoHandlerYUV.h"
@@ -104,6 +105,10 @@ public:
   // contain the frame with the given frame index.
   virtual void loadFrame(int frameIndex, bool loadToDoubleBuffer=false) Q_DECL_OVERRIDE;
 
+  // Get the raw data of the given frame as planar YUV (packed formats are converted) together with its format and size.
+  // Like loadRawFrame, this does not change the current frame and can be used from a background thread.
+  bool loadPlanarFrame(int frameIndex, QByteArray &planarData, YUV_Internals::yuvPixelFormat &format, QSize &size);
+
   // If this is set, the pixel values drawn in the drawPixels function will be scaled according to the bit depth.
   // E.g: The bit depth is 8 and the pixel value is 127, then the value shown will be -1.
   bool showPixelValuesAsDiff {false};
@@ -112,6 +117,9 @@ public:
 
   YUV_Internals::yuvPixelFormat getDiffYUVFormat() const;
 
+  // The SSIM of the luma component per block from the last difference calculation
+  YUV_Internals::SSIMMap getDiffSSIMMap() const;
+
   bool getIs_YUV_diff() const;
 
 protected:
@@ -157,14 +165,28 @@ protected:
   // will not be modified.
   virtual void loadFrameForCaching(int frameIndex, QImage &frameToCache) Q_DECL_OVERRIDE;
 
+  // Convert the given raw frame in the current pixel format to an image for the cache.
+  virtual void convertRawFrameToImage(const QByteArray &frameRawData, QImage &outputImage) Q_DECL_OVERRIDE;
+  virtual bool supportsRawDataCaching() const Q_DECL_OVERRIDE { return true; }
+
+  // Convert the complete frame if only a region of it was converted in loadFrame
+  virtual void convertCompleteCurrentImage() Q_DECL_OVERRIDE;
+
 private:
 
   // Load the raw YUV data for the given frame index into currentFrameRawYUVData.
   // Return false is loading failed.
   bool loadRawYUVData(int frameIndex);
 
-  // Convert from YUV (which ever format is selected) to image (RGB-888)
-  void convertYUVToImage(const QByteArray &sourceBuffer, QImage &outputImage, const YUV_Internals::yuvPixelFormat &yuvFormat, const QSize &curFrameSize);
+  // Get the region of the frame that loadFrame converts if only a small part of the frame was visible in the last
+  // draw call (the visible part plus a margin). Returns an invalid rect if the complete frame should be converted.
+  QRect getPartialConversionRegion();
+  // The raw data of the frame that the partial currentImage was converted from (shared, not copied)
+  QByteArray currentImageRegionRawData;
+
+  // Convert from YUV (which ever format is selected) to image (RGB-888). The conversion is split into nrThreads bands
+  // of rows which are converted in parallel (see videoHandler::runConversionInParallel).
+  void convertYUVToImage(const QByteArray &sourceBuffer, QImage &outputImage, const YUV_Internals::yuvPixelFormat &yuvFormat, const QSize &curFrameSize, const int nrThreads=1);
 
   // Set the new pixel format thread save (lock the mutex). We should also emit that something changed (can be disabled).
   void setSrcPixelFormat(YUV_Internals::yuvPixelFormat newFormat, bool emitChangedSignal=true);
@@ -177,11 +199,11 @@ private:
 #if SSE_CONVERSION
   bool convertYUV420ToRGB(const byteArrayAligned &sourceBuffer, byteArrayAligned &targetBuffer);
 #else
-  bool convertYUV420ToRGB(const QByteArray &sourceBuffer, unsigned char *targetBuffer, const QSize &size, const YUV_Internals::yuvPixelFormat format);
+  bool convertYUV420ToRGB(const QByteArray &sourceBuffer, unsigned char *targetBuffer, const QSize &size, const YUV_Internals::yuvPixelFormat format, const int nrThreads=1);
 #endif
 
   bool convertYUVPackedToPlanar(const QByteArray &sourceBuffer, QByteArray &targetBuffer, const QSize &frameSize, YUV_Internals::yuvPixelFormat &sourceBufferFormat);
-  bool convertYUVPlanarToRGB(const QByteArray &sourceBuffer, unsigned char *targetBuffer, const QSize &frameSize, const YUV_Internals::yuvPixelFormat &sourceBufferFormat) const;
+  bool convertYUVPlanarToRGB(const QByteArray &sourceBuffer, unsigned char *targetBuffer, const QSize &frameSize, const YUV_Internals::yuvPixelFormat &sourceBufferFormat, const int nrThreads=1) const;
   bool markDifferencesYUVPlanarToRGB(const QByteArray &sourceBuffer, unsigned char *targetBuffer, const QSize &frameSize, const YUV_Internals::yuvPixelFormat &sourceBufferFormat) const;
 
 #if SSE_CONVERSION_420_ALT
@@ -196,6 +218,7 @@ private:
   bool is_YUV_diff;
   QByteArray diffYUV;
   YUV_Internals::yuvPixelFormat diffYUVFormat;
+  YUV_Internals::SSIMMap diffSSIMMap;
 
   QList<YUV_Internals::yuvPixelFormat> presetList;
 
@@ -0,0 +1,1068 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "yuvConversion.h"
+
+#include <algorithm>
+
+#include "videoHandler.h"
+#include "yuvConversionHelpers.h"
+#include "yuvConversionSIMD.h"
+
+namespace YUV_Internals
+{
+
+namespace
+{
+
+// The format related parameters that the conversion kernels depend on. The kernels take these from a format object
+// instead of from function arguments. For a StaticFormat, all of them are compile time constants, so every instantiation
+// of a kernel is compiled without the corresponding branches in its inner loops. The DynamicFormat holds the same values
+// at runtime and results in a single generic instantiation (this is how the kernels worked before).
+// The bit depth class is 0 for 8 bit (one byte per sample), 1 for 9 to 14 bit and 2 for 15 and 16 bit.
+template<int bitDepthClass, bool isBigEndian, bool isBilinear, bool withMath, bool isFullRange>
+struct StaticFormat
+{
+  constexpr bool twoBytes() const { return bitDepthClass > 0; }
+  constexpr bool highBitDepth() const { return bitDepthClass > 1; }
+  constexpr bool bigEndian() const { return isBigEndian; }
+  constexpr ChromaInterpolation interpolation() const { return isBilinear ? ChromaInterpolation::Bilinear : ChromaInterpolation::NearestNeighbor; }
+  constexpr bool applyMath() const { return withMath; }
+  constexpr bool fullRange() const { return isFullRange; }
+};
+
+struct DynamicFormat
+{
+  DynamicFormat(const int bps, const bool bigEndian, const ChromaInterpolation interpolation, const bool applyMath, const bool fullRange)
+    : bitDepthClass((bps > 14) ? 2 : (bps > 8) ? 1 : 0), isBigEndian(bigEndian), isBilinear(interpolation == ChromaInterpolation::Bilinear), withMath(applyMath), isFullRange(fullRange) {}
+  bool twoBytes() const { return bitDepthClass > 0; }
+  bool highBitDepth() const { return bitDepthClass > 1; }
+  bool bigEndian() const { return isBigEndian; }
+  ChromaInterpolation interpolation() const { return isBilinear ? ChromaInterpolation::Bilinear : ChromaInterpolation::NearestNeighbor; }
+  bool applyMath() const { return withMath; }
+  bool fullRange() const { return isFullRange; }
+
+  int bitDepthClass;
+  bool isBigEndian;
+  bool isBilinear;
+  bool withMath;
+  bool isFullRange;
+};
+
+// The same as the getValueFromSource/convertYUVToRGB8Bit functions from yuvConversionHelpers.h but all format related
+// decisions are taken from the given format.
+using YUV_Internals::getValueFromSource;
+using YUV_Internals::convertYUVToRGB8Bit;
+
+template<typename Format>
+inline int getValueFromSource(const Format &fmt, const unsigned char * restrict src, const int idx)
+{
+  if (fmt.twoBytes())
+    // Read two bytes in the right order
+    return (fmt.bigEndian()) ? src[idx*2] << 8 | src[idx*2+1] : src[idx*2] | src[idx*2+1] << 8;
+  // Just read one byte
+  return src[idx];
+}
+
+template<typename Format>
+inline void convertYUVToRGB8Bit(const Format &fmt, const unsigned int valY, const unsigned int valU, const unsigned int valV, int &valR, int &valG, int &valB, const int RGBConv[5], const int bps)
+{
+  // For more than 14 bit, two bits of the YUV values are discarded so that the calculation fits into 32 bit.
+  const int bitShift = fmt.highBitDepth() ? 2 : 0;
+  const int bpsShift = fmt.highBitDepth() ? bps - 10 : bps - 8;
+  const int yOffset = (fmt.fullRange() ? 0 : 16<<bpsShift);
+  const int cZero = 128<<bpsShift;
+
+  const int Y_tmp = ((valY >> bitShift) - yOffset) * RGBConv[0];
+  const int U_tmp = (valU >> bitShift) - cZero;
+  const int V_tmp = (valV >> bitShift) - cZero;
+
+  const int R_tmp = (Y_tmp                      + V_tmp * RGBConv[1]) >> (16 + bpsShift); //32 to 16 bit conversion by right shifting
+  const int G_tmp = (Y_tmp + U_tmp * RGBConv[2] + V_tmp * RGBConv[3]) >> (16 + bpsShift);
+  const int B_tmp = (Y_tmp + U_tmp * RGBConv[4]                     ) >> (16 + bpsShift);
+
+  valR = (R_tmp < 0) ? 0 : (R_tmp > 255) ? 255 : R_tmp;
+  valG = (G_tmp < 0) ? 0 : (G_tmp > 255) ? 255 : G_tmp;
+  valB = (B_tmp < 0) ? 0 : (B_tmp > 255) ? 255 : B_tmp;
+}
+
+// Call func with the StaticFormat that matches the given format. Each step selects one of the format parameters.
+template<int bitDepthClass, bool bigEndian, bool bilinear, bool applyMath, typename Func>
+inline void selectFullRange(const DynamicFormat &fmt, const Func &func)
+{
+  if (fmt.fullRange())
+    func(StaticFormat<bitDepthClass, bigEndian, bilinear, applyMath, true>());
+  else
+    func(StaticFormat<bitDepthClass, bigEndian, bilinear, applyMath, false>());
+}
+
+template<int bitDepthClass, bool bigEndian, bool bilinear, typename Func>
+inline void selectApplyMath(const DynamicFormat &fmt, const Func &func)
+{
+  if (fmt.applyMath())
+    selectFullRange<bitDepthClass, bigEndian, bilinear, true>(fmt, func);
+  else
+    selectFullRange<bitDepthClass, bigEndian, bilinear, false>(fmt, func);
+}
+
+template<int bitDepthClass, bool bigEndian, typename Func>
+inline void selectInterpolation(const DynamicFormat &fmt, const Func &func)
+{
+  if (fmt.interpolation() == ChromaInterpolation::Bilinear)
+    selectApplyMath<bitDepthClass, bigEndian, true>(fmt, func);
+  else
+    selectApplyMath<bitDepthClass, bigEndian, false>(fmt, func);
+}
+
+template<int bitDepthClass, typename Func>
+inline void selectEndianness(const DynamicFormat &fmt, const Func &func)
+{
+  // The endianness does not matter for 8 bit
+  if (bitDepthClass > 0 && fmt.bigEndian())
+    selectInterpolation<bitDepthClass, true>(fmt, func);
+  else
+    selectInterpolation<bitDepthClass, false>(fmt, func);
+}
+
+template<typename Func>
+inline void callWithStaticFormat(const DynamicFormat &fmt, const Func &func)
+{
+  if (fmt.bitDepthClass == 2)
+    selectEndianness<2>(fmt, func);
+  else if (fmt.bitDepthClass == 1)
+    selectEndianness<1>(fmt, func);
+  else
+    selectEndianness<0>(fmt, func);
+}
+
+inline int clip8Bit(int val)
+{
+  if (val < 0)
+    return 0;
+  if (val > 255)
+    return 255;
+  return val;
+}
+
+// For every input sample in src, apply YUV transformation, (scale to 8 bit if required) and set the value as RGB (monochrome).
+// inValSkip: skip this many values in the input for every value. For pure planar formats, this 1. If the UV components are interleaved, this is 2 or 3.
+inline void YUVPlaneToRGBMonochrome_444(const int componentSize, const MathParameters math, const unsigned char * restrict src, unsigned char * restrict dst,
+                                        const int inMax, const int bps, const bool bigEndian, const int inValSkip, const bool fullRange)
+{
+  const bool applyMath = math.mathRequired();
+  const int shiftTo8Bit = bps - 8;
+  for (int i = 0; i < componentSize; ++i)
+  {
+    int newVal = getValueFromSource(src, i*inValSkip, bps, bigEndian);
+    if (applyMath)
+      newVal = transformYUV(math.invert, math.scale, math.offset, newVal, inMax);
+
+    if (shiftTo8Bit > 0)
+      newVal = clip8Bit(newVal >> shiftTo8Bit);
+    if (!fullRange)
+      newVal = videoHandler::convScaleLimitedRange(newVal);
+
+    // Set the value for R, G and B (BGRA)
+    dst[i*4  ] = (unsigned char)newVal;
+    dst[i*4+1] = (unsigned char)newVal;
+    dst[i*4+2] = (unsigned char)newVal;
+    dst[i*4+3] = (unsigned char)255;
+  }
+}
+
+// For every input sample in the YZV 422 src, apply interpolation (sample and hold), apply YUV transformation, (scale to 8 bit if required)
+// and set the value as RGB (monochrome).
+inline void YUVPlaneToRGBMonochrome_422(const int componentSize, const MathParameters math, const unsigned char * restrict src, unsigned char * restrict dst,
+                                        const int inMax, const int bps, const bool bigEndian, const int inValSkip, const bool fullRange)
+{
+  const bool applyMath = math.mathRequired();
+  const int shiftTo8Bit = bps - 8;
+  for (int i = 0; i < componentSize; ++i)
+  {
+    int newVal = getValueFromSource(src, i*inValSkip, bps, bigEndian);
+    if (applyMath)
+      newVal = transformYUV(math.invert, math.scale, math.offset, newVal, inMax);
+
+    if (shiftTo8Bit > 0)
+      newVal = clip8Bit(newVal >> shiftTo8Bit);
+    if (!fullRange)
+      newVal = videoHandler::convScaleLimitedRange(newVal);
+
+    // Set the value for R, G and B of 2 pixels (BGRA)
+    dst[i*8  ] = (unsigned char)newVal;
+    dst[i*8+1] = (unsigned char)newVal;
+    dst[i*8+2] = (unsigned char)newVal;
+    dst[i*8+3] = (unsigned char)255;
+    dst[i*8+4] = (unsigned char)newVal;
+    dst[i*8+5] = (unsigned char)newVal;
+    dst[i*8+6] = (unsigned char)newVal;
+    dst[i*8+7] = (unsigned char)255;
+  }
+}
+
+inline void YUVPlaneToRGBMonochrome_420(const int w, const int h, const MathParameters math, const unsigned char * restrict src, unsigned char * restrict dst,
+                                        const int inMax, const int bps, const bool bigEndian, const int inValSkip, const bool fullRange)
+{
+  const bool applyMath = math.mathRequired();
+  const int shiftTo8Bit = bps - 8;
+  for (int y = 0; y < h/2; y++)
+    for (int x = 0; x < w/2; x++)
+    {
+      const int srcIdx = y*(w/2)+x;
+      int newVal = getValueFromSource(src, srcIdx*inValSkip, bps, bigEndian);
+      if (applyMath)
+        newVal = transformYUV(math.invert, math.scale, math.offset, newVal, inMax);
+
+      if (shiftTo8Bit > 0)
+        newVal = clip8Bit(newVal >> shiftTo8Bit);
+      if (!fullRange)
+        newVal = videoHandler::convScaleLimitedRange(newVal);
+
+      // Set the value for R, G and B of 4 pixels (BGRA)
+      int o = (y*2*w + x*2)*4;
+      dst[o  ] = (unsigned char)newVal;
+      dst[o+1] = (unsigned char)newVal;
+      dst[o+2] = (unsigned char)newVal;
+      dst[o+3] = (unsigned char)255;
+      dst[o+4] = (unsigned char)newVal;
+      dst[o+5] = (unsigned char)newVal;
+      dst[o+6] = (unsigned char)newVal;
+      dst[o+7] = (unsigned char)255;
+      o += w*4;   // Goto next line
+      dst[o  ] = (unsigned char)newVal;
+      dst[o+1] = (unsigned char)newVal;
+      dst[o+2] = (unsigned char)newVal;
+      dst[o+3] = (unsigned char)255;
+      dst[o+4] = (unsigned char)newVal;
+      dst[o+5] = (unsigned char)newVal;
+      dst[o+6] = (unsigned char)newVal;
+      dst[o+7] = (unsigned char)255;
+    }
+}
+
+inline void YUVPlaneToRGBMonochrome_440(const int w, const int h, const MathParameters math, const unsigned char * restrict src, unsigned char * restrict dst,
+                                        const int inMax, const int bps, const bool bigEndian, const int inValSkip, const bool fullRange)
+{
+  const bool applyMath = math.mathRequired();
+  const int shiftTo8Bit = bps - 8;
+  for (int y = 0; y < h/2; y++)
+    for (int x = 0; x < w; x++)
+    {
+      const int srcIdx = y*w+x;
+      int newVal = getValueFromSource(src, srcIdx*inValSkip, bps, bigEndian);
+      if (applyMath)
+        newVal = transformYUV(math.invert, math.scale, math.offset, newVal, inMax);
+
+      if (shiftTo8Bit > 0)
+        newVal = clip8Bit(newVal >> shiftTo8Bit);
+      if (!fullRange)
+        newVal = videoHandler::convScaleLimitedRange(newVal);
+
+      // Set the value for R, G and B of 2 pixels (BGRA)
+      const int pos1 = (y*2*w+x)*4;
+      const int pos2 = pos1 + w*4;  // Next line
+      dst[pos1  ] = (unsigned char)newVal;
+      dst[pos1+1] = (unsigned char)newVal;
+      dst[pos1+2] = (unsigned char)newVal;
+      dst[pos1+3] = (unsigned char)255;
+      dst[pos2  ] = (unsigned char)newVal;
+      dst[pos2+1] = (unsigned char)newVal;
+      dst[pos2+2] = (unsigned char)newVal;
+      dst[pos2+3] = (unsigned char)255;
+    }
+}
+
+inline void YUVPlaneToRGBMonochrome_410(const int w, const int h, const MathParameters math, const unsigned char * restrict src, unsigned char * restrict dst,
+  const int inMax, const int bps, const bool bigEndian, const int inValSkip, const bool fullRange)
+{
+  // Horizontal subsampling by 4, vertical subsampling by 4
+  const bool applyMath = math.mathRequired();
+  const int shiftTo8Bit = bps - 8;
+  for (int y = 0; y < h/4; y++)
+    for (int x = 0; x < w/4; x++)
+    {
+      const int srcIdx = y*(w/4)+x;
+      int newVal = getValueFromSource(src, srcIdx*inValSkip, bps, bigEndian);
+
+      if (applyMath)
+        newVal = transformYUV(math.invert, math.scale, math.offset, newVal, inMax);
+
+      if (shiftTo8Bit > 0)
+        newVal = clip8Bit(newVal >> shiftTo8Bit);
+      if (!fullRange)
+        newVal = videoHandler::convScaleLimitedRange(newVal);
+
+      // Set the value as RGB for 4 pixels in this line and the next 3 lines (BGRA)
+      for (int yo = 0; yo < 4; yo++)
+        for (int xo = 0; xo < 4; xo++)
+        {
+          const int pos = ((y*4+yo)*w+(x*4+xo))*4;
+          dst[pos  ] = (unsigned char)newVal;
+          dst[pos+1] = (unsigned char)newVal;
+          dst[pos+2] = (unsigned char)newVal;
+          dst[pos+3] = (unsigned char)255;
+        }
+    }
+}
+
+inline void YUVPlaneToRGBMonochrome_411(const int componentSize, const MathParameters math, const unsigned char * restrict src, unsigned char * restrict dst,
+                                        const int inMax, const int bps, const bool bigEndian, const int inValSkip, const bool fullRange)
+{
+  // Horizontally U and V are subsampled by 4
+  const bool applyMath = math.mathRequired();
+  const int shiftTo8Bit = bps - 8;
+  for (int i = 0; i < componentSize; ++i)
+  {
+    int newVal = getValueFromSource(src, i*inValSkip, bps, bigEndian);
+    if (applyMath)
+      newVal = transformYUV(math.invert, math.scale, math.offset, newVal, inMax);
+
+    if (shiftTo8Bit > 0)
+      newVal = clip8Bit(newVal >> shiftTo8Bit);
+    if (!fullRange)
+      newVal = videoHandler::convScaleLimitedRange(newVal);
+
+    // Set the value for R, G and B of 4 pixels (BGRA)
+    dst[i*16   ] = (unsigned char)newVal;
+    dst[i*16+1 ] = (unsigned char)newVal;
+    dst[i*16+2 ] = (unsigned char)newVal;
+    dst[i*16+3 ] = (unsigned char)255;
+    dst[i*16+4 ] = (unsigned char)newVal;
+    dst[i*16+5 ] = (unsigned char)newVal;
+    dst[i*16+6 ] = (unsigned char)newVal;
+    dst[i*16+7 ] = (unsigned char)255;
+    dst[i*16+8 ] = (unsigned char)newVal;
+    dst[i*16+9 ] = (unsigned char)newVal;
+    dst[i*16+10] = (unsigned char)newVal;
+    dst[i*16+11] = (unsigned char)255;
+    dst[i*16+12] = (unsigned char)newVal;
+    dst[i*16+13] = (unsigned char)newVal;
+    dst[i*16+14] = (unsigned char)newVal;
+    dst[i*16+15] = (unsigned char)255;
+  }
+}
+
+inline int interpolateUVSampleQ(const ChromaInterpolation mode, const int sample1, const int sample2, const int quarterPos)
+{
+  if (mode == ChromaInterpolation::Bilinear)
+  {
+    // Interpolate linearly between sample1 and sample2
+    if (quarterPos == 0)
+      return sample1;
+    if (quarterPos == 1)
+      return ((sample1*3 + sample2) + 1) >> 2;
+    if (quarterPos == 2)
+      return ((sample1 + sample2) + 1) >> 1;
+    if (quarterPos == 3)
+      return ((sample1 + sample2*3) + 1) >> 2;
+  }
+  return sample1; // Sample and hold
+}
+
+// Depending on offsetX8 (which can be 1 to 7), interpolate one of the 6 given positions between prev and cur.
+inline int interpolateUV8Pos(int prev, int cur, const int offsetX8)
+{
+  if (offsetX8 == 4)
+    return (prev + cur + 1) / 2;
+  if (offsetX8 == 2)
+    return (prev + cur*3 + 2) / 4;
+  if (offsetX8 == 6)
+    return (prev*3 + cur + 2) / 4;
+  if (offsetX8 == 1)
+    return (prev + cur*7 + 4) / 8;
+  if (offsetX8 == 3)
+    return (prev*3 + cur*5 + 4) / 8;
+  if (offsetX8 == 5)
+    return (prev*5 + cur*3 + 4) / 8;
+  if (offsetX8 == 7)
+    return (prev*7 + cur + 4) / 8;
+  Q_ASSERT(false); // offsetX8 should always be between 1 and 7 (inclusive)
+  return 0;
+}
+
+// Re-sample the chroma component so that the chroma samples and the luma samples are aligned after this operation.
+inline void UVPlaneResamplingChromaOffset(const yuvPixelFormat format, const int w, const int h, 
+                                          const unsigned char * restrict srcU, const unsigned char * restrict srcV, const int inValSkip,
+                                          unsigned char * restrict dstU, unsigned char * restrict dstV)
+{
+  // We can perform linear interpolation for 7 positions (6 in between) two pixels.
+  // Which of these position is needed depends on the chromaOffset and the subsampling.
+  const int possibleValsX = getMaxPossibleChromaOffsetValues(true,  format.subsampling);
+  const int possibleValsY = getMaxPossibleChromaOffsetValues(false, format.subsampling);
+  const int offsetX8 = (possibleValsX == 1) ? format.chromaOffset[0] * 4 : (possibleValsX == 3) ? format.chromaOffset[0] * 2 : format.chromaOffset[0];
+  const int offsetY8 = (possibleValsY == 1) ? format.chromaOffset[1] * 4 : (possibleValsY == 3) ? format.chromaOffset[1] * 2 : format.chromaOffset[1];
+
+  // The format to use for input/output
+  const bool bigEndian = format.bigEndian;
+  const int bps = format.bitsPerSample;
+
+  const int stride = bps > 8 ? w*2 : w;
+  if (offsetX8 != 0)
+  {
+    // Perform horizontal re-sampling
+    for (int y = 0; y < h; y++)
+    {
+      // On the left side, there is no previous sample, so the first value is never changed.
+      const int srcIdx = y * stride * inValSkip;
+      int prevU = getValueFromSource(srcU, srcIdx, bps, bigEndian);
+      int prevV = getValueFromSource(srcV, srcIdx, bps, bigEndian);
+      setValueInBuffer(dstU, prevU, y*stride, bps, bigEndian);
+      setValueInBuffer(dstV, prevV, y*stride, bps, bigEndian);
+
+      for (int x = 0; x < w-1; x++)
+      {
+        // Calculate the new current value using the previous and the current value
+        const int srcIdxInLine = srcIdx + (x+1)*inValSkip;
+        int curU = getValueFromSource(srcU, srcIdxInLine, bps, bigEndian);
+        int curV = getValueFromSource(srcV, srcIdxInLine, bps, bigEndian);
+
+        // Perform interpolation and save the value for the current UV value. Goto next value.
+        int newU = interpolateUV8Pos(prevU, curU, offsetX8);
+        int newV = interpolateUV8Pos(prevV, curV, offsetX8);
+        setValueInBuffer(dstU, newU, y*stride+x, bps, bigEndian);
+        setValueInBuffer(dstV, newV, y*stride+x, bps, bigEndian);
+
+        prevU = curU;
+        prevV = curV;
+      }
+    }
+  }
+
+  // For the second step, use the filtered values (or the source if no filtering was applied)
+  const unsigned char *srcUStep2 = (offsetX8 == 0) ? srcU : dstU;
+  const unsigned char *srcVStep2 = (offsetX8 == 0) ? srcV : dstV;
+  const int valSkipStep2 = (offsetX8 == 0) ? inValSkip : 1;
+
+  if (offsetY8 != 0)
+  {
+    // Perform vertical re-sampling. It works exactly like horizontal up-sampling but x and y are switched.
+    for (int x = 0; x < w; x++)
+    {
+      // On the top, there is no previous sample, so the first value is never changed.
+      int prevU = getValueFromSource(srcUStep2, x*valSkipStep2, bps, bigEndian);
+      int prevV = getValueFromSource(srcVStep2, x*valSkipStep2, bps, bigEndian);
+      setValueInBuffer(dstU, prevU, x, bps, bigEndian);
+      setValueInBuffer(dstV, prevV, x, bps, bigEndian);
+
+      for (int y = 0; y < h-1; y++)
+      {
+        // Calculate the new current value using the previous and the current value
+        const int srcIdx = (y+1) * w + x;
+        int curU = getValueFromSource(srcUStep2, srcIdx*valSkipStep2, bps, bigEndian);
+        int curV = getValueFromSource(srcVStep2, srcIdx*valSkipStep2, bps, bigEndian);
+
+        // Perform interpolation and save the value for the current UV value. Goto next value.
+        int newU = interpolateUV8Pos(prevU, curU, offsetY8);
+        int newV = interpolateUV8Pos(prevV, curV, offsetY8);
+        setValueInBuffer(dstU, newU, srcIdx, bps, bigEndian);
+        setValueInBuffer(dstV, newV, srcIdx, bps, bigEndian);
+
+        prevU = curU;
+        prevV = curV;
+      }
+    }
+  }
+}
+
+inline LineConversionParameters getLineConversionParameters(const MathParameters mathY, const MathParameters mathC, const int RGBConv[5], const bool fullRange, const int inMax,
+                                                            const ChromaInterpolation interpolation, const int bps, const bool bigEndian, const int inValSkip)
+{
+  LineConversionParameters par;
+  par.bitsPerSample = bps;
+  par.bigEndian = bigEndian;
+  par.inValSkip = inValSkip;
+  par.fullRange = fullRange;
+  for (int i = 0; i < 5; i++)
+    par.RGBConv[i] = RGBConv[i];
+  par.bilinearInterpolation = (interpolation == ChromaInterpolation::Bilinear);
+  par.inMax = inMax;
+  par.applyMathLuma = mathY.mathRequired();
+  par.mathLumaScale = mathY.scale;
+  par.mathLumaOffset = mathY.offset;
+  par.mathLumaInvert = mathY.invert;
+  par.applyMathChroma = mathC.mathRequired();
+  par.mathChromaScale = mathC.scale;
+  par.mathChromaOffset = mathC.offset;
+  par.mathChromaInvert = mathC.invert;
+  return par;
+}
+
+// The 4:4:4, 4:2:2 and 4:2:0 conversions use the vectorized line conversion functions (yuvConversionSIMD.h) if the CPU supports it.
+inline void YUVPlaneToRGB_444(const int componentSize, const MathParameters mathY, const MathParameters mathC,
+                              const unsigned char * restrict srcY, const unsigned char * restrict srcU, const unsigned char * restrict srcV,
+                              unsigned char * restrict dst, const int RGBConv[5], const bool fullRange, const int inMax, const int bps, const bool bigEndian, const int inValSkip)
+{
+  // All values are converted independently of each other. So we can convert all samples as one line.
+  const auto par = getLineConversionParameters(mathY, mathC, RGBConv, fullRange, inMax, ChromaInterpolation::NearestNeighbor, bps, bigEndian, inValSkip);
+  convertLineToRGB_444(par, srcY, srcU, srcV, dst, componentSize);
+}
+
+inline void YUVPlaneToRGB_422(const int w, const int h, const MathParameters mathY, const MathParameters mathC,
+                              const unsigned char * restrict srcY, const unsigned char * restrict srcU, const unsigned char * restrict srcV,
+                              unsigned char * restrict dst, const int RGBConv[5], const bool fullRange, const int inMax, const ChromaInterpolation interpolation, const int bps, const bool bigEndian, const int inValSkip)
+{
+  const auto par = getLineConversionParameters(mathY, mathC, RGBConv, fullRange, inMax, interpolation, bps, bigEndian, inValSkip);
+  const int bytesPerSample = (bps > 8) ? 2 : 1;
+  for (int y = 0; y < h; y++)
+  {
+    const int srcIdxUV = y*w/2;
+    convertLineToRGB_422(par, srcY + y*w*bytesPerSample, srcU + srcIdxUV*inValSkip*bytesPerSample, srcV + srcIdxUV*inValSkip*bytesPerSample, dst + y*w*4, w);
+  }
+}
+
+template<typename Format>
+inline void YUVPlaneToRGB_440(const Format &fmt, const int w, const int h, const MathParameters mathY, const MathParameters mathC,
+                              const unsigned char * restrict srcY, const unsigned char * restrict srcU, const unsigned char * restrict srcV,
+                              unsigned char * restrict dst, const int RGBConv[5], const int inMax, const int bps, const int inValSkip)
+{
+  const bool applyMathLuma = fmt.applyMath() && mathY.mathRequired();
+  const bool applyMathChroma = fmt.applyMath() && mathC.mathRequired();
+  const ChromaInterpolation interpolation = fmt.interpolation();
+  // Vertical up-sampling is required. Process two Y values at a time
+
+  for (int x = 0; x < w; x++)
+  {
+    int curUSample = getValueFromSource(fmt, srcU, x*inValSkip);
+    int curVSample = getValueFromSource(fmt, srcV, x*inValSkip);
+    if (applyMathChroma)
+    {
+      curUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curUSample, inMax);
+      curVSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curVSample, inMax);
+    }
+
+    for (int y = 0; y < (h/2)-1; y++)
+    {
+      // Get the next U/V sample
+      const int srcIdxUV = y*w+x;
+      int nextUSample = getValueFromSource(fmt, srcU, srcIdxUV*inValSkip);
+      int nextVSample = getValueFromSource(fmt, srcV, srcIdxUV*inValSkip);
+      if (applyMathChroma)
+      {
+        nextUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextUSample, inMax);
+        nextVSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextVSample, inMax);
+      }
+
+      // From the current and the next U/V sample, interpolate the UV sample in between
+      int interpolatedU = interpolateUVSample(interpolation, curUSample, nextUSample);
+      int interpolatedV = interpolateUVSample(interpolation, curVSample, nextVSample);
+
+      // Get the 2 Y samples
+      int valY1 = getValueFromSource(fmt, srcY,     y*2*w+x);
+      int valY2 = getValueFromSource(fmt, srcY, (y*2+1)*w+x);
+      if (applyMathLuma)
+      {
+        valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
+        valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
+      }
+
+      // Convert to 2 RGB values and save them
+      int valR1, valR2, valG1, valG2, valB1, valB2;
+      convertYUVToRGB8Bit(fmt, valY1, curUSample   , curVSample   , valR1, valG1, valB1, RGBConv, bps);
+      convertYUVToRGB8Bit(fmt, valY2, interpolatedU, interpolatedV, valR2, valG2, valB2, RGBConv, bps);
+      const int pos1 = (y*2*w+x)*4;
+      const int pos2 = pos1 + 4*w;
+      dst[pos1  ] = valB1;
+      dst[pos1+1] = valG1;
+      dst[pos1+2] = valR1;
+      dst[pos1+3] = 255;
+      dst[pos2  ] = valB2;
+      dst[pos2+1] = valG2;
+      dst[pos2+2] = valR2;
+      dst[pos2+3] = 255;
+
+      // The next one is now the current one
+      curUSample = nextUSample;
+      curVSample = nextVSample;
+    }
+
+    // For the last column, there is no next sample. Just reuse the current one again. No interpolation required either.
+
+    // Get the 2 Y samples
+    int valY1 = getValueFromSource(fmt, srcY, (h-2)*w+x);
+    int valY2 = getValueFromSource(fmt, srcY, (h-1)*w+x);
+    if (applyMathLuma)
+    {
+      valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
+      valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
+    }
+
+    // Convert to 2 RGB values and save them
+    int valR1, valR2, valG1, valG2, valB1, valB2;
+    convertYUVToRGB8Bit(fmt, valY1, curUSample, curVSample, valR1, valG1, valB1, RGBConv, bps);
+    convertYUVToRGB8Bit(fmt, valY2, curUSample, curVSample, valR2, valG2, valB2, RGBConv, bps);
+    const int pos1 = ((h-2)*w+x)*4;
+    const int pos2 = pos1 + w*4;
+    dst[pos1  ] = valB1;
+    dst[pos1+1] = valG1;
+    dst[pos1+2] = valR1;
+    dst[pos1+3] = 255;
+    dst[pos2  ] = valB2;
+    dst[pos2+1] = valG2;
+    dst[pos2+2] = valR2;
+    dst[pos2+3] = 255;
+  }
+}
+
+// Only the chroma lines from chromaLineStart up to (not including) chromaLineEnd are converted. This way, the conversion can
+// be split into bands which give the same result as converting the whole frame at once. A chromaLineEnd of -1 converts all lines.
+inline void YUVPlaneToRGB_420(const int w, const int h, const MathParameters mathY, const MathParameters mathC,
+                              const unsigned char * restrict srcY, const unsigned char * restrict srcU, const unsigned char * restrict srcV,
+                              unsigned char * restrict dst, const int RGBConv[5], const bool fullRange, const int inMax, const ChromaInterpolation interpolation,
+                              const int bps, const bool bigEndian, const int inValSkip, const int chromaLineStart=0, int chromaLineEnd=-1)
+{
+  const auto par = getLineConversionParameters(mathY, mathC, RGBConv, fullRange, inMax, interpolation, bps, bigEndian, inValSkip);
+  const int bytesPerSample = (bps > 8) ? 2 : 1;
+  const int hh = h/2; // The half values
+  const int wh = w/2;
+  if (chromaLineEnd < 0 || chromaLineEnd > hh)
+    chromaLineEnd = hh;
+  for (int y = chromaLineStart; y < chromaLineEnd; y++)
+  {
+    // At the last chroma line (the bottom line), there is no next line. Just sample and hold.
+    const int yNext = std::min(y + 1, hh - 1);
+    const int srcIdxUV0 = y*wh*inValSkip*bytesPerSample;
+    const int srcIdxUV1 = yNext*wh*inValSkip*bytesPerSample;
+    convertLinesToRGB_420(par, srcY + (y*2)*w*bytesPerSample, srcY + (y*2+1)*w*bytesPerSample, srcU + srcIdxUV0, srcV + srcIdxUV0,
+                          srcU + srcIdxUV1, srcV + srcIdxUV1, dst + (y*2)*w*4, dst + (y*2+1)*w*4, w);
+  }
+}
+
+template<typename Format>
+inline void YUVPlaneToRGB_410(const Format &fmt, const int w, const int h, const MathParameters mathY, const MathParameters mathC,
+                              const unsigned char * restrict srcY, const unsigned char * restrict srcU, const unsigned char * restrict srcV,
+                              unsigned char * restrict dst, const int RGBConv[5], const int inMax, const int bps, const int inValSkip)
+{
+  const bool applyMathLuma = fmt.applyMath() && mathY.mathRequired();
+  const bool applyMathChroma = fmt.applyMath() && mathC.mathRequired();
+  const ChromaInterpolation interpolation = fmt.interpolation();
+  // Format is YUV 4:1:0. Horizontal and vertical up-sampling is required. Process 4 Y positions of 2 lines at a time
+  // Horizontal subsampling by 4, vertical subsampling by 2
+  const int hq = h/4; // The quarter values
+  const int wq = w/4;
+
+  for (int y = 0; y < hq; y++)
+  {
+    // Get the current U/V samples for this y line and the next one (_NL)
+    const int srcIdxUV0 = y*wq;
+    const int srcIdxUV1 = (y+1)*wq;
+    int curU    = getValueFromSource(fmt, srcU, srcIdxUV0*inValSkip);
+    int curV    = getValueFromSource(fmt, srcV, srcIdxUV0*inValSkip);
+    int curU_NL = (y < hq-1) ? getValueFromSource(fmt, srcU, srcIdxUV1*inValSkip) : curU;
+    int curV_NL = (y < hq-1) ? getValueFromSource(fmt, srcV, srcIdxUV1*inValSkip) : curV;
+    if (applyMathChroma)
+    {
+      curU    = transformYUV(mathC.invert, mathC.scale, mathC.offset, curU, inMax);
+      curV    = transformYUV(mathC.invert, mathC.scale, mathC.offset, curV, inMax);
+      curU_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, curU_NL, inMax);
+      curV_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, curV_NL, inMax);
+    }
+
+    for (int x = 0; x < wq; x++)
+    {
+      // We process 4*4 values per U/V value
+
+      // Get the next U/V sample for this line and the next one
+      const int srcIdxUVLine0 = srcIdxUV0 + x + 1;
+      const int srcIdxUVLine1 = srcIdxUV1 + x + 1;
+      int nextU    = (x < wq-1) ? getValueFromSource(fmt, srcU, srcIdxUVLine0*inValSkip) : curU;
+      int nextV    = (x < wq-1) ? getValueFromSource(fmt, srcV, srcIdxUVLine0*inValSkip) : curV;
+      int nextU_NL = (x < wq-1) ? getValueFromSource(fmt, srcU, srcIdxUVLine1*inValSkip) : curU_NL;
+      int nextV_NL = (x < wq-1) ? getValueFromSource(fmt, srcV, srcIdxUVLine1*inValSkip) : curV_NL;
+      if (applyMathChroma)
+      {
+        nextU    = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextU, inMax);
+        nextV    = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextV, inMax);
+        nextU_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextU_NL, inMax);
+        nextV_NL = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextV_NL, inMax);
+      }
+
+      // Now we interpolate and set the RGB values for the 4x4 pixels
+      for (int yo = 0; yo < 4; yo++)
+      {
+        // Interpolate vertically
+        int curU_INT = interpolateUVSampleQ(interpolation, curU, curU_NL, yo);
+        int curV_INT = interpolateUVSampleQ(interpolation, curV, curV_NL, yo);
+        int nextU_INT = interpolateUVSampleQ(interpolation, nextU, nextU_NL, yo);
+        int nextV_INT = interpolateUVSampleQ(interpolation, nextV, nextV_NL, yo);
+
+        for (int xo = 0; xo < 4; xo++)
+        {
+          // Interpolate horizontally
+          int U = interpolateUVSampleQ(interpolation, curU_INT, nextU_INT, xo);
+          int V = interpolateUVSampleQ(interpolation, curV_INT, nextV_INT, xo);
+          // Get the Y sample
+          int Y = getValueFromSource(fmt, srcY, (y*4+yo)*w+x*4+xo);
+          if (applyMathLuma)
+            Y = transformYUV(mathY.invert, mathY.scale, mathY.offset, Y, inMax);
+
+          // Convert to RGB and save (BGRA)
+          int R, G, B;
+          const int pos = ((y*4+yo)*w+x*4+xo)*4;
+          convertYUVToRGB8Bit(fmt, Y, U, V, R, G, B, RGBConv, bps);
+          dst[pos  ] = B;
+          dst[pos+1] = G;
+          dst[pos+2] = R;
+          dst[pos+3] = 255;
+        }
+      }
+
+      curU = nextU;
+      curV = nextV;
+      curU_NL = nextU_NL;
+      curV_NL = nextV_NL;
+    }
+  }
+}
+
+template<typename Format>
+inline void YUVPlaneToRGB_411(const Format &fmt, const int w, const int h, const MathParameters mathY, const MathParameters mathC,
+  const unsigned char * restrict srcY, const unsigned char * restrict srcU, const unsigned char * restrict srcV,
+  unsigned char * restrict dst, const int RGBConv[5], const int inMax, const int bps, const int inValSkip)
+{
+  // Chroma: quarter horizontal resolution
+  const bool applyMathLuma = fmt.applyMath() && mathY.mathRequired();
+  const bool applyMathChroma = fmt.applyMath() && mathC.mathRequired();
+  const ChromaInterpolation interpolation = fmt.interpolation();
+
+  // Horizontal up-sampling is required. Process four Y values at a time.
+  for (int y = 0; y < h; y++)
+  {
+    const int srcIdxUV = y*w/4;
+    int curUSample = getValueFromSource(fmt, srcU, srcIdxUV*inValSkip);
+    int curVSample = getValueFromSource(fmt, srcV, srcIdxUV*inValSkip);
+    if (applyMathChroma)
+    {
+      curUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curUSample, inMax);
+      curVSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, curVSample, inMax);
+    }
+
+    for (int x = 0; x < (w/4)-1; x++)
+    {
+      // Get the next U/V sample
+      const int srcIdxUVLine = srcIdxUV + x + 1;
+      int nextUSample = getValueFromSource(fmt, srcU, srcIdxUVLine*inValSkip);
+      int nextVSample = getValueFromSource(fmt, srcV, srcIdxUVLine*inValSkip);
+      if (applyMathChroma)
+      {
+        nextUSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextUSample, inMax);
+        nextVSample = transformYUV(mathC.invert, mathC.scale, mathC.offset, nextVSample, inMax);
+      }
+
+      // From the current and the next U/V sample, interpolate the UV sample in between
+      int interpolatedU1 = interpolateUVSampleQ(interpolation, curUSample, nextUSample, 1);
+      int interpolatedV1 = interpolateUVSampleQ(interpolation, curVSample, nextVSample, 1);
+      int interpolatedU2 = interpolateUVSample(interpolation, curUSample, nextUSample);
+      int interpolatedV2 = interpolateUVSample(interpolation, curVSample, nextVSample);
+      int interpolatedU3 = interpolateUVSampleQ(interpolation, curUSample, nextUSample, 3);
+      int interpolatedV3 = interpolateUVSampleQ(interpolation, curVSample, nextVSample, 3);
+
+      // Get the 4 Y samples
+      int valY1 = getValueFromSource(fmt, srcY, y*w+x*4);
+      int valY2 = getValueFromSource(fmt, srcY, y*w+x*4+1);
+      int valY3 = getValueFromSource(fmt, srcY, y*w+x*4+2);
+      int valY4 = getValueFromSource(fmt, srcY, y*w+x*4+3);
+      if (applyMathLuma)
+      {
+        valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
+        valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
+        valY3 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY3, inMax);
+        valY4 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY4, inMax);
+      }
+
+      // Convert to 4 RGB values and save them
+      int valR, valG, valB;
+      const int pos = (y*w+x*4)*4;
+      convertYUVToRGB8Bit(fmt, valY1, curUSample, curVSample, valR, valG, valB, RGBConv, bps);
+      dst[pos  ] = valB;
+      dst[pos+1] = valG;
+      dst[pos+2] = valR;
+      dst[pos+3] = 255;
+      convertYUVToRGB8Bit(fmt, valY2, interpolatedU1, interpolatedV1, valR, valG, valB, RGBConv, bps);
+      dst[pos+4] = valB;
+      dst[pos+5] = valG;
+      dst[pos+6] = valR;
+      dst[pos+7] = 255;
+      convertYUVToRGB8Bit(fmt, valY3, interpolatedU2, interpolatedV2, valR, valG, valB, RGBConv, bps);
+      dst[pos+8] = valB;
+      dst[pos+9] = valG;
+      dst[pos+10] = valR;
+      dst[pos+11] = 255;
+      convertYUVToRGB8Bit(fmt, valY4, interpolatedU3, interpolatedV3, valR, valG, valB, RGBConv, bps);
+      dst[pos+12] = valB;
+      dst[pos+13] = valG;
+      dst[pos+14] = valR;
+      dst[pos+15] = 255;
+
+      // The next one is now the current one
+      curUSample = nextUSample;
+      curVSample = nextVSample;
+    }
+
+    // For the last row, there is no next sample. Just reuse the current one again. No interpolation required either.
+
+    // Get the 2 Y samples
+    int valY1 = getValueFromSource(fmt, srcY, (y+1)*w-4);
+    int valY2 = getValueFromSource(fmt, srcY, (y+1)*w-3);
+    int valY3 = getValueFromSource(fmt, srcY, (y+1)*w-2);
+    int valY4 = getValueFromSource(fmt, srcY, (y+1)*w-1);
+    if (applyMathLuma)
+    {
+      valY1 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY1, inMax);
+      valY2 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY2, inMax);
+      valY3 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY3, inMax);
+      valY4 = transformYUV(mathY.invert, mathY.scale, mathY.offset, valY4, inMax);
+    }
+
+    // Convert to 4 RGB values and save them
+    int valR, valG, valB;
+    const int pos = ((y+1)*w)*4;
+    convertYUVToRGB8Bit(fmt, valY1, curUSample, curVSample, valR, valG, valB, RGBConv, bps);
+    dst[pos-16] = valB;
+    dst[pos-15] = valG;
+    dst[pos-14] = valR;
+    dst[pos-13] = 255;
+    convertYUVToRGB8Bit(fmt, valY2, curUSample, curVSample, valR, valG, valB, RGBConv, bps);
+    dst[pos-12] = valB;
+    dst[pos-11] = valG;
+    dst[pos-10] = valR;
+    dst[pos-9] = 255;
+    convertYUVToRGB8Bit(fmt, valY3, curUSample, curVSample, valR, valG, valB, RGBConv, bps);
+    dst[pos-8] = valB;
+    dst[pos-7] = valG;
+    dst[pos-6] = valR;
+    dst[pos-5] = 255;
+    convertYUVToRGB8Bit(fmt, valY4, curUSample, curVSample, valR, valG, valB, RGBConv, bps);
+    dst[pos-4] = valB;
+    dst[pos-3] = valG;
+    dst[pos-2] = valR;
+    dst[pos-1] = 255;
+  }
+}
+
+
+} // namespace
+
+bool convertYUVPlanarToRGB(const QByteArray &sourceBuffer, unsigned char *targetBuffer, const QSize &frameSize, const yuvPixelFormat &format,
+                           const ConversionSettings &settings, const int nrThreads, const BandRunner &runBands)
+{
+  // These are constant for the runtime of this function. This way, the compiler can optimize the
+  // hell out of this function.
+  const auto interpolation = settings.chromaInterpolation;
+  const auto component = settings.component;
+  const auto conversion = settings.colorConversion;
+  const auto w = frameSize.width();
+  const auto h = frameSize.height();
+
+  // Do we have to apply YUV math?
+  const auto mathY = settings.mathY;
+  const auto mathC = settings.mathC;
+
+  const auto bps = format.bitsPerSample;
+  const bool fullRange = (conversion == ColorConversion::BT709_FullRange || conversion == ColorConversion::BT601_FullRange || conversion == ColorConversion::BT2020_FullRange);
+  const auto inputMax = (1<<bps)-1;
+
+  // The luma component has full resolution. The size of each chroma components depends on the subsampling.
+  const auto componentSizeLuma = (w * h);
+  const auto componentSizeChroma = (w / format.getSubsamplingHor()) * (h / format.getSubsamplingVer());
+
+  // How many bytes are in each component?
+  const auto nrBytesLumaPlane = (bps > 8) ? componentSizeLuma * 2 : componentSizeLuma;
+  const auto nrBytesChromaPlane = (bps > 8) ? componentSizeChroma * 2 : componentSizeChroma;
+
+  // If the U and V (and A if present) components are interlevaed, we have to skip every nth value in the input when reading U and V
+  const auto inputValSkip = format.uvInterleaved ? ((format.planeOrder == PlaneOrder::YUV || format.planeOrder == PlaneOrder::YVU) ? 2 : 3) : 1;
+
+  // A pointer to the output
+  unsigned char * restrict dst = targetBuffer;
+
+  // The conversion can be split into bands of chroma lines which are converted in parallel. The 4:4:0 and 4:1:0 kernels
+  // interpolate across the whole frame and are not split.
+  const auto bytesPerSample = (bps > 8) ? 2 : 1;
+  const auto subH = format.getSubsamplingHor();
+  const auto subV = format.getSubsamplingVer();
+  const bool canSplit = (format.subsampling == Subsampling::YUV_444 || format.subsampling == Subsampling::YUV_422 ||
+                         format.subsampling == Subsampling::YUV_420 || format.subsampling == Subsampling::YUV_411);
+  const auto nrBands = (canSplit && nrThreads > 1) ? std::max(1, std::min(nrThreads, h / subV)) : 1;
+
+  auto runConversionInBands = [&runBands](int nrBands, const std::function<void(int)> &convertBand)
+  {
+    if (runBands && nrBands > 1)
+      runBands(nrBands, convertBand);
+    else
+      for (int band = 0; band < nrBands; band++)
+        convertBand(band);
+  };
+
+  if (component != DisplayComponent::All || format.subsampling == Subsampling::YUV_400)
+  {
+    // We only display (or there is only) one of the color components (possibly with YUV math)
+    if (component == DisplayComponent::Y || format.subsampling == Subsampling::YUV_400)
+    {
+      // Luma only. The chroma subsampling does not matter. Every row is independent, so we can always split.
+      const auto nrLumaBands = std::max(1, std::min(nrThreads, h));
+      runConversionInBands(nrLumaBands, [&](int band)
+      {
+        const int yStart = h * band / nrLumaBands;
+        const int yEnd = h * (band + 1) / nrLumaBands;
+        const unsigned char * restrict srcY = (unsigned char*)sourceBuffer.data() + yStart * w * bytesPerSample;
+        YUVPlaneToRGBMonochrome_444((yEnd - yStart) * w, mathY, srcY, dst + yStart * w * 4, inputMax, bps, format.bigEndian, 1, fullRange);
+      });
+    }
+    else
+    {
+      // Display only the U or V component
+      bool firstComponent = (((format.planeOrder == PlaneOrder::YUV || format.planeOrder == PlaneOrder::YUVA) && component == DisplayComponent::Cb) ||
+                             ((format.planeOrder == PlaneOrder::YVU || format.planeOrder == PlaneOrder::YVUA) && component == DisplayComponent::Cr));
+      
+      int srcOffset = nrBytesLumaPlane;
+      if (!firstComponent)
+      {
+        if (format.uvInterleaved)
+          srcOffset += (bps > 8) ? 2 : 1;
+        else
+          srcOffset += nrBytesChromaPlane;
+      }
+
+      const unsigned char * restrict srcC = (unsigned char*)sourceBuffer.data() + srcOffset;
+      if (format.subsampling == Subsampling::YUV_444)
+        YUVPlaneToRGBMonochrome_444(componentSizeChroma, mathC, srcC, dst, inputMax, bps, format.bigEndian, inputValSkip, fullRange);
+      else if (format.subsampling == Subsampling::YUV_422)
+        YUVPlaneToRGBMonochrome_422(componentSizeChroma, mathC, srcC, dst, inputMax, bps, format.bigEndian, inputValSkip, fullRange);
+      else if (format.subsampling == Subsampling::YUV_420)
+        YUVPlaneToRGBMonochrome_420(w, h, mathC, srcC, dst, inputMax, bps, format.bigEndian, inputValSkip, fullRange);
+      else if (format.subsampling == Subsampling::YUV_440)
+        YUVPlaneToRGBMonochrome_440(w, h, mathC, srcC, dst, inputMax, bps, format.bigEndian, inputValSkip, fullRange);
+      else if (format.subsampling == Subsampling::YUV_410)
+        YUVPlaneToRGBMonochrome_410(w, h, mathC, srcC, dst, inputMax, bps, format.bigEndian, inputValSkip, fullRange);
+      else if (format.subsampling == Subsampling::YUV_411)
+        YUVPlaneToRGBMonochrome_411(componentSizeChroma, mathC, srcC, dst, inputMax, bps, format.bigEndian, inputValSkip, fullRange);
+      else
+        return false;
+    }
+    return true;
+  }
+
+  // Is the U plane the first or the second?
+  const bool uPlaneFirst = (format.planeOrder == PlaneOrder::YUV || format.planeOrder == PlaneOrder::YUVA);
+
+  // In case the U and V (and A if present) components are interleaved, the skip to the next plane is just 1 (or 2) bytes
+  int nrBytesToNextChromaPlane = nrBytesChromaPlane;
+  if (format.uvInterleaved)
+    nrBytesToNextChromaPlane = (bps > 8) ? 2 : 1;
+
+  // Get/set the parameters used for YUV -> RGB conversion
+  int RGBConv[5];
+  getColorConversionCoefficients(conversion, RGBConv);
+
+  // Get the pointers to the source planes (8 bit per sample)
+  const unsigned char * restrict srcY = (unsigned char*)sourceBuffer.data();
+  const unsigned char * restrict srcU = uPlaneFirst ? srcY + nrBytesLumaPlane : srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane;
+  const unsigned char * restrict srcV = uPlaneFirst ? srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane: srcY + nrBytesLumaPlane;
+  int chromaValSkip = inputValSkip;
+
+  // If there is a chroma offset, we must resample the chroma components before we convert them to RGB.
+  // If so, the resampled chroma values are saved in these arrays.
+  QByteArray uvPlaneChromaResampled[2];
+  if (format.chromaOffset[0] != 0 || format.chromaOffset[1] != 0)
+  {
+    uvPlaneChromaResampled[0].resize(nrBytesChromaPlane);
+    uvPlaneChromaResampled[1].resize(nrBytesChromaPlane);
+
+    // We have to perform pre-filtering for the U and V positions, because there is an offset between the pixel positions of Y and U/V
+    unsigned char *restrict dstU = (unsigned char*)uvPlaneChromaResampled[0].data();
+    unsigned char *restrict dstV = (unsigned char*)uvPlaneChromaResampled[1].data();
+    UVPlaneResamplingChromaOffset(format, w / format.getSubsamplingHor(), h / format.getSubsamplingVer(), srcU, srcV, inputValSkip, dstU, dstV);
+
+    srcU = dstU;
+    srcV = dstV;
+    chromaValSkip = 1;
+  }
+
+  // We are displaying all components, so we have to perform conversion to RGB (possibly including interpolation and YUV math).
+  // The 4:4:4, 4:2:2 and 4:2:0 kernels work on lines (yuvConversionSIMD.h) and select the format per line.
+  // Band i converts the chroma lines [getBandStart(i), getBandStart(i + 1)) and the corresponding luma rows.
+  auto getBandStart = [&](int band) { return (h / subV) * band / nrBands; };
+  if (format.subsampling == Subsampling::YUV_444 || format.subsampling == Subsampling::YUV_422 || format.subsampling == Subsampling::YUV_420)
+  {
+    runConversionInBands(nrBands, [&](int band)
+    {
+      const int lineStart = getBandStart(band);
+      const int lineEnd = getBandStart(band + 1);
+      const int yStart = lineStart * subV;
+      const int bandHeight = (lineEnd - lineStart) * subV;
+      const unsigned char * restrict srcYBand = srcY + yStart * w * bytesPerSample;
+      const int chromaOffset = lineStart * (w / subH) * chromaValSkip * bytesPerSample;
+      unsigned char * restrict dstBand = dst + yStart * w * 4;
+
+      if (format.subsampling == Subsampling::YUV_444)
+        YUVPlaneToRGB_444(bandHeight * w, mathY, mathC, srcYBand, srcU + chromaOffset, srcV + chromaOffset, dstBand, RGBConv, fullRange, inputMax, bps, format.bigEndian, chromaValSkip);
+      else if (format.subsampling == Subsampling::YUV_422)
+        YUVPlaneToRGB_422(w, bandHeight, mathY, mathC, srcYBand, srcU + chromaOffset, srcV + chromaOffset, dstBand, RGBConv, fullRange, inputMax, interpolation, bps, format.bigEndian, chromaValSkip);
+      else
+        YUVPlaneToRGB_420(w, h, mathY, mathC, srcY, srcU, srcV, dst, RGBConv, fullRange, inputMax, interpolation, bps, format.bigEndian, chromaValSkip, lineStart, lineEnd);
+    });
+    return true;
+  }
+
+  // The 4:4:0, 4:1:0 and 4:1:1 kernels are compiled for the given format (see StaticFormat).
+  bool formatSupported = true;
+  auto convertFrame = [&](const auto &fmt)
+  {
+    if (format.subsampling == Subsampling::YUV_440)
+      YUVPlaneToRGB_440(fmt, w, h, mathY, mathC, srcY, srcU, srcV, dst, RGBConv, inputMax, bps, chromaValSkip);
+    else if (format.subsampling == Subsampling::YUV_410)
+      YUVPlaneToRGB_410(fmt, w, h, mathY, mathC, srcY, srcU, srcV, dst, RGBConv, inputMax, bps, chromaValSkip);
+    else if (format.subsampling == Subsampling::YUV_411)
+    {
+      runConversionInBands(nrBands, [&](int band)
+      {
+        const int lineStart = getBandStart(band);
+        const int yStart = lineStart * subV;
+        const int chromaOffset = lineStart * (w / subH) * chromaValSkip * bytesPerSample;
+        YUVPlaneToRGB_411(fmt, w, (getBandStart(band + 1) - lineStart) * subV, mathY, mathC, srcY + yStart * w * bytesPerSample, srcU + chromaOffset,
+                          srcV + chromaOffset, dst + yStart * w * 4, RGBConv, inputMax, bps, chromaValSkip);
+      });
+    }
+    else
+      formatSupported = false;
+  };
+
+  const DynamicFormat dynamicFormat(bps, format.bigEndian, interpolation, mathY.mathRequired() || mathC.mathRequired(), fullRange);
+  if (settings.useSpecializedKernels)
+    callWithStaticFormat(dynamicFormat, convertFrame);
+  else
+    convertFrame(dynamicFormat);
+
+  return formatSupported;
+}
+
+} // namespace YUV_Internals
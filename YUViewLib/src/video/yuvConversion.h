@@ -0,0 +1,78 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <functional>
+
+#include <QByteArray>
+#include <QSize>
+
+#include "yuvPixelFormat.h"
+
+namespace YUV_Internals
+{
+
+// Which components are shown. If only one component is shown, it is converted to a gray image.
+enum class DisplayComponent
+{
+  All,
+  Y,
+  Cb,
+  Cr
+};
+
+// All settings besides the pixel format which define how YUV data is converted to RGB
+struct ConversionSettings
+{
+  ChromaInterpolation chromaInterpolation {ChromaInterpolation::NearestNeighbor};
+  ColorConversion colorConversion {ColorConversion::BT709_LimitedRange};
+  DisplayComponent component {DisplayComponent::All};
+  MathParameters mathY;
+  MathParameters mathC;
+  // The 4:4:0, 4:1:0 and 4:1:1 kernels are compiled for each combination of bit depth class, endianness, chroma interpolation,
+  // YUV math and value range so that there are no format related branches in their inner loops. Disabling this uses a single
+  // generic instantiation which checks the format for every sample. This is only useful for benchmarking. The other formats
+  // are converted by the line kernels (yuvConversionSIMD.h) and are not affected by this.
+  bool useSpecializedKernels {true};
+};
+
+// Call convertBand for all band indices (0 ... nrBands-1) and return when all bands are converted.
+typedef std::function<void(int nrBands, const std::function<void(int)> &convertBand)> BandRunner;
+
+// Convert the planar YUV data in sourceBuffer to RGB (BGRA, 8 bit per value) in targetBuffer. If possible, the conversion
+// is split into up to nrThreads bands of rows which are given to runBands (e.g. to convert them in parallel). If no
+// runBands function is given, the bands are converted one after another.
+bool convertYUVPlanarToRGB(const QByteArray &sourceBuffer, unsigned char *targetBuffer, const QSize &frameSize, const yuvPixelFormat &format,
+                           const ConversionSettings &settings, const int nrThreads = 1, const BandRunner &runBands = BandRunner());
+
+} // namespace YUV_Internals
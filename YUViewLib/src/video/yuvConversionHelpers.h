@@ -0,0 +1,167 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "yuvPixelFormat.h"
+
+// Restrict is basically a promise to the compiler that for the scope of the pointer, the target of the pointer will only be accessed through that pointer (and pointers copied from it).
+#if __STDC__ != 1
+#    define restrict __restrict /* use implementation __ format */
+#else
+#    ifndef __STDC_VERSION__
+#        define restrict __restrict /* use implementation __ format */
+#    else
+#        if __STDC_VERSION__ < 199901L
+#            define restrict __restrict /* use implementation __ format */
+#        else
+#            /* all ok */
+#        endif
+#    endif
+#endif
+
+// The scalar functions that are used for the conversion from YUV to RGB. The vectorized conversion functions
+// (yuvConversionSIMD.h) must give the exact same results as these.
+namespace YUV_Internals
+{
+
+/* Apply the given transformation to the YUV sample. If invert is true, the sample is inverted at the value defined by offset.
+ * If the scale is greater one, the values will be amplified relative to the offset value.
+ * The input can be 8 to 16 bit. The output will be of the same bit depth. The output is clamped to (0...clipMax).
+ */
+inline int transformYUV(const bool invert, const int scale, const int offset, const unsigned int value, const int clipMax)
+{
+  int newValue = value;
+  if (invert)
+    newValue = -(newValue - offset) * scale + offset;  // Scale + Offset + Invert
+  else
+    newValue = (newValue - offset) * scale + offset;  // Scale + Offset
+
+  // Clip to 8 bit
+  if (newValue < 0)
+    newValue = 0;
+  if (newValue > clipMax)
+    newValue = clipMax;
+
+  return newValue;
+}
+
+inline void convertYUVToRGB8Bit(const unsigned int valY, const unsigned int valU, const unsigned int valV, int &valR, int &valG, int &valB, const int RGBConv[5], const bool fullRange, const int bps)
+{
+  if (bps > 14)
+  {
+    // The bit depth of an int (32) is not enough to perform a YUV -> RGB conversion for a bit depth > 14 bits.
+    // We could use 64 bit values but for what? We are clipping the result to 8 bit anyways so let's just
+    // get rid of 2 of the bits for the YUV values.
+    const int yOffset = (fullRange ? 0 : 16<<(bps-10));
+    const int cZero = 128<<(bps-10);
+
+    const int Y_tmp = ((valY >> 2) - yOffset) * RGBConv[0];
+    const int U_tmp = (valU >> 2) - cZero;
+    const int V_tmp = (valV >> 2) - cZero;
+
+    const int R_tmp = (Y_tmp                      + V_tmp * RGBConv[1]) >> (16 + bps - 10); //32 to 16 bit conversion by right shifting
+    const int G_tmp = (Y_tmp + U_tmp * RGBConv[2] + V_tmp * RGBConv[3]) >> (16 + bps - 10);
+    const int B_tmp = (Y_tmp + U_tmp * RGBConv[4]                     ) >> (16 + bps - 10);
+
+    valR = (R_tmp < 0) ? 0 : (R_tmp > 255) ? 255 : R_tmp;
+    valG = (G_tmp < 0) ? 0 : (G_tmp > 255) ? 255 : G_tmp;
+    valB = (B_tmp < 0) ? 0 : (B_tmp > 255) ? 255 : B_tmp;
+  }
+  else
+  {
+    const int yOffset = (fullRange ? 0 : 16<<(bps-8));
+    const int cZero = 128<<(bps-8);
+
+    const int Y_tmp = (valY - yOffset) * RGBConv[0];
+    const int U_tmp = valU - cZero;
+    const int V_tmp = valV - cZero;
+
+    const int R_tmp = (Y_tmp                      + V_tmp * RGBConv[1]) >> (16 + bps - 8); //32 to 16 bit conversion by right shifting
+    const int G_tmp = (Y_tmp + U_tmp * RGBConv[2] + V_tmp * RGBConv[3]) >> (16 + bps - 8);
+    const int B_tmp = (Y_tmp + U_tmp * RGBConv[4]                     ) >> (16 + bps - 8);
+
+    valR = (R_tmp < 0) ? 0 : (R_tmp > 255) ? 255 : R_tmp;
+    valG = (G_tmp < 0) ? 0 : (G_tmp > 255) ? 255 : G_tmp;
+    valB = (B_tmp < 0) ? 0 : (B_tmp > 255) ? 255 : B_tmp;
+  }
+}
+
+inline int getValueFromSource(const unsigned char * restrict src, const int idx, const int bps, const bool bigEndian)
+{
+  if (bps > 8)
+    // Read two bytes in the right order
+    return (bigEndian) ? src[idx*2] << 8 | src[idx*2+1] : src[idx*2] | src[idx*2+1] << 8;
+  else
+    // Just read one byte
+    return src[idx];
+}
+
+inline void setValueInBuffer(unsigned char * restrict dst, const int val, const int idx, const int bps, const bool bigEndian)
+{
+  if (bps > 8)
+  {
+    // Write two bytes
+    if (bigEndian)
+    {
+      dst[idx*2] = val >> 8;
+      dst[idx*2+1] = val & 0xff;
+    }
+    else
+    {
+      dst[idx*2] = val & 0xff;
+      dst[idx*2+1] = val >> 8;
+    }
+  }
+  else
+    // Write one byte
+    dst[idx] = val;
+}
+
+inline int interpolateUVSample(const ChromaInterpolation mode, const int sample1, const int sample2)
+{
+  if (mode == ChromaInterpolation::Bilinear)
+    // Interpolate linearly between sample1 and sample2
+    return ((sample1 + sample2) + 1) >> 1;
+  return sample1; // Sample and hold
+}
+
+// TODO: Consider sample position
+inline int interpolateUVSample2D(const ChromaInterpolation mode, const int sample1, const int sample2, const int sample3, const int sample4)
+{
+  if (mode == ChromaInterpolation::Bilinear)
+    // Interpolate linearly between sample1 - sample 4
+    return ((sample1 + sample2 + sample3 + sample4) + 2) >> 2;
+  return sample1;   // Sample and hold
+}
+
+} // namespace YUV_Internals
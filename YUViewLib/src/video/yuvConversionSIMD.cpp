@@ -0,0 +1,465 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "yuvConversionSIMD.h"
+
+#include <algorithm>
+#include <atomic>
+#if YUV_SIMD_X86 && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+#include "yuvConversionHelpers.h"
+
+namespace YUV_Internals
+{
+
+namespace
+{
+
+#if YUV_SIMD_X86
+bool cpuSupportsSSE41()
+{
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 1);
+  return (info[2] & (1 << 19)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+bool cpuSupportsAVX2()
+{
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+    return false;
+  __cpuid(info, 1);
+  // The OS must save the AVX registers (OSXSAVE and the XCR0 bits for the SSE and AVX state)
+  const bool osSupportsAVX = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6);
+  if (!osSupportsAVX)
+    return false;
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+SIMDInstructionSet getBestSupportedInstructionSet()
+{
+#if YUV_SIMD_X86
+  if (cpuSupportsAVX2())
+    return SIMDInstructionSet::AVX2;
+  if (cpuSupportsSSE41())
+    return SIMDInstructionSet::SSE41;
+#elif YUV_SIMD_NEON
+  return SIMDInstructionSet::NEON;
+#endif
+  return SIMDInstructionSet::None;
+}
+
+std::atomic<SIMDInstructionSet> &activeInstructionSet()
+{
+  static std::atomic<SIMDInstructionSet> set(getBestSupportedInstructionSet());
+  return set;
+}
+
+int convertLineToRGB_444_SIMD(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width)
+{
+  switch (activeInstructionSet().load(std::memory_order_relaxed))
+  {
+#if YUV_SIMD_X86
+  case SIMDInstructionSet::SSE41:
+    return SIMD_SSE41::convertLineToRGB_444(par, srcY, srcU, srcV, dst, width);
+  case SIMDInstructionSet::AVX2:
+    return SIMD_AVX2::convertLineToRGB_444(par, srcY, srcU, srcV, dst, width);
+#endif
+#if YUV_SIMD_NEON
+  case SIMDInstructionSet::NEON:
+    return SIMD_NEON::convertLineToRGB_444(par, srcY, srcU, srcV, dst, width);
+#endif
+  default:
+    return 0;
+  }
+}
+
+int convertLineToRGB_422_SIMD(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width)
+{
+  switch (activeInstructionSet().load(std::memory_order_relaxed))
+  {
+#if YUV_SIMD_X86
+  case SIMDInstructionSet::SSE41:
+    return SIMD_SSE41::convertLineToRGB_422(par, srcY, srcU, srcV, dst, width);
+  case SIMDInstructionSet::AVX2:
+    return SIMD_AVX2::convertLineToRGB_422(par, srcY, srcU, srcV, dst, width);
+#endif
+#if YUV_SIMD_NEON
+  case SIMDInstructionSet::NEON:
+    return SIMD_NEON::convertLineToRGB_422(par, srcY, srcU, srcV, dst, width);
+#endif
+  default:
+    return 0;
+  }
+}
+
+int convertLinesToRGB_420_SIMD(const LineConversionParameters &par, const unsigned char *srcY0, const unsigned char *srcY1, const unsigned char *srcU0, const unsigned char *srcV0,
+                               const unsigned char *srcU1, const unsigned char *srcV1, unsigned char *dst0, unsigned char *dst1, const int width)
+{
+  switch (activeInstructionSet().load(std::memory_order_relaxed))
+  {
+#if YUV_SIMD_X86
+  case SIMDInstructionSet::SSE41:
+    return SIMD_SSE41::convertLinesToRGB_420(par, srcY0, srcY1, srcU0, srcV0, srcU1, srcV1, dst0, dst1, width);
+  case SIMDInstructionSet::AVX2:
+    return SIMD_AVX2::convertLinesToRGB_420(par, srcY0, srcY1, srcU0, srcV0, srcU1, srcV1, dst0, dst1, width);
+#endif
+#if YUV_SIMD_NEON
+  case SIMDInstructionSet::NEON:
+    return SIMD_NEON::convertLinesToRGB_420(par, srcY0, srcY1, srcU0, srcV0, srcU1, srcV1, dst0, dst1, width);
+#endif
+  default:
+    return 0;
+  }
+}
+
+int calculateLineDifference_SIMD(const LineDifferenceParameters &par, const unsigned char *src0, const unsigned char *src1, unsigned char *dst, const int width, uint64_t &sumSquaredDiff)
+{
+  switch (activeInstructionSet().load(std::memory_order_relaxed))
+  {
+#if YUV_SIMD_X86
+  case SIMDInstructionSet::SSE41:
+    return SIMD_SSE41::calculateLineDifference(par, src0, src1, dst, width, sumSquaredDiff);
+  case SIMDInstructionSet::AVX2:
+    return SIMD_AVX2::calculateLineDifference(par, src0, src1, dst, width, sumSquaredDiff);
+#endif
+#if YUV_SIMD_NEON
+  case SIMDInstructionSet::NEON:
+    return SIMD_NEON::calculateLineDifference(par, src0, src1, dst, width, sumSquaredDiff);
+#endif
+  default:
+    return 0;
+  }
+}
+
+int calculateSSIMBlockSums_SIMD(const LineDifferenceParameters &par, const unsigned char *src0, const int stride0, const unsigned char *src1, const int stride1, int64_t (*sums)[4], const int nrBlocks)
+{
+  switch (activeInstructionSet().load(std::memory_order_relaxed))
+  {
+#if YUV_SIMD_X86
+  case SIMDInstructionSet::SSE41:
+    return SIMD_SSE41::calculateSSIMBlockSums(par, src0, stride0, src1, stride1, sums, nrBlocks);
+  case SIMDInstructionSet::AVX2:
+    return SIMD_AVX2::calculateSSIMBlockSums(par, src0, stride0, src1, stride1, sums, nrBlocks);
+#endif
+#if YUV_SIMD_NEON
+  case SIMDInstructionSet::NEON:
+    return SIMD_NEON::calculateSSIMBlockSums(par, src0, stride0, src1, stride1, sums, nrBlocks);
+#endif
+  default:
+    return 0;
+  }
+}
+
+} // namespace
+
+SIMDInstructionSet getSIMDInstructionSet()
+{
+  return activeInstructionSet().load();
+}
+
+bool isSIMDInstructionSetSupported(SIMDInstructionSet set)
+{
+  switch (set)
+  {
+  case SIMDInstructionSet::None:
+    return true;
+#if YUV_SIMD_X86
+  case SIMDInstructionSet::SSE41:
+    return cpuSupportsSSE41();
+  case SIMDInstructionSet::AVX2:
+    return cpuSupportsAVX2();
+#endif
+#if YUV_SIMD_NEON
+  case SIMDInstructionSet::NEON:
+    return true;
+#endif
+  default:
+    return false;
+  }
+}
+
+bool setSIMDInstructionSet(SIMDInstructionSet set)
+{
+  if (!isSIMDInstructionSetSupported(set))
+    return false;
+  activeInstructionSet().store(set);
+  return true;
+}
+
+const char *getSIMDInstructionSetName(SIMDInstructionSet set)
+{
+  switch (set)
+  {
+  case SIMDInstructionSet::SSE41:
+    return "SSE4.1";
+  case SIMDInstructionSet::AVX2:
+    return "AVX2";
+  case SIMDInstructionSet::NEON:
+    return "NEON";
+  default:
+    return "None";
+  }
+}
+
+void convertLineToRGB_444(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width)
+{
+  const int bps = par.bitsPerSample;
+  const int inValSkip = par.inValSkip;
+
+  // Convert as much as possible using the vector instructions. Do the rest here.
+  for (int i = convertLineToRGB_444_SIMD(par, srcY, srcU, srcV, dst, width); i < width; ++i)
+  {
+    unsigned int valY = getValueFromSource(srcY, i, bps, par.bigEndian);
+    unsigned int valU = getValueFromSource(srcU, i*inValSkip, bps, par.bigEndian);
+    unsigned int valV = getValueFromSource(srcV, i*inValSkip, bps, par.bigEndian);
+
+    if (par.applyMathLuma)
+      valY = transformYUV(par.mathLumaInvert, par.mathLumaScale, par.mathLumaOffset, valY, par.inMax);
+    if (par.applyMathChroma)
+    {
+      valU = transformYUV(par.mathChromaInvert, par.mathChromaScale, par.mathChromaOffset, valU, par.inMax);
+      valV = transformYUV(par.mathChromaInvert, par.mathChromaScale, par.mathChromaOffset, valV, par.inMax);
+    }
+
+    // Get the RGB values for this sample
+    int valR, valG, valB;
+    convertYUVToRGB8Bit(valY, valU, valV, valR, valG, valB, par.RGBConv, par.fullRange, bps);
+
+    // Save the RGB values
+    dst[i*4  ] = valB;
+    dst[i*4+1] = valG;
+    dst[i*4+2] = valR;
+    dst[i*4+3] = 255;
+  }
+}
+
+void convertLineToRGB_422(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width)
+{
+  const int bps = par.bitsPerSample;
+  const bool bigEndian = par.bigEndian;
+  const int inValSkip = par.inValSkip;
+  const ChromaInterpolation interpolation = par.bilinearInterpolation ? ChromaInterpolation::Bilinear : ChromaInterpolation::NearestNeighbor;
+
+  // Convert as much as possible using the vector instructions. Do the rest here.
+  const int xStart = convertLineToRGB_422_SIMD(par, srcY, srcU, srcV, dst, width) / 2;
+
+  // Horizontal up-sampling is required. Process two Y values at a time
+  int curUSample = getValueFromSource(srcU, xStart*inValSkip, bps, bigEndian);
+  int curVSample = getValueFromSource(srcV, xStart*inValSkip, bps, bigEndian);
+  if (par.applyMathChroma)
+  {
+    curUSample = transformYUV(par.mathChromaInvert, par.mathChromaScale, par.mathChromaOffset, curUSample, par.inMax);
+    curVSample = transformYUV(par.mathChromaInvert, par.mathChromaScale, par.mathChromaOffset, curVSample, par.inMax);
+  }
+
+  for (int x = xStart; x < (width/2)-1; x++)
+  {
+    // Get the next U/V sample
+    const int srcPosLineUV = x + 1;
+    int nextUSample = getValueFromSource(srcU, srcPosLineUV*inValSkip, bps, bigEndian);
+    int nextVSample = getValueFromSource(srcV, srcPosLineUV*inValSkip, bps, bigEndian);
+    if (par.applyMathChroma)
+    {
+      nextUSample = transformYUV(par.mathChromaInvert, par.mathChromaScale, par.mathChromaOffset, nextUSample, par.inMax);
+      nextVSample = transformYUV(par.mathChromaInvert, par.mathChromaScale, par.mathChromaOffset, nextVSample, par.inMax);
+    }
+
+    // From the current and the next U/V sample, interpolate the UV sample in between
+    int interpolatedU = interpolateUVSample(interpolation, curUSample, nextUSample);
+    int interpolatedV = interpolateUVSample(interpolation, curVSample, nextVSample);
+
+    // Get the 2 Y samples
+    int valY1 = getValueFromSource(srcY, x*2,   bps, bigEndian);
+    int valY2 = getValueFromSource(srcY, x*2+1, bps, bigEndian);
+    if (par.applyMathLuma)
+    {
+      valY1 = transformYUV(par.mathLumaInvert, par.mathLumaScale, par.mathLumaOffset, valY1, par.inMax);
+      valY2 = transformYUV(par.mathLumaInvert, par.mathLumaScale, par.mathLumaOffset, valY2, par.inMax);
+    }
+
+    // Convert to 2 RGB values and save them (BGRA)
+    int valR1, valR2, valG1, valG2, valB1, valB2;
+    convertYUVToRGB8Bit(valY1, curUSample   , curVSample   , valR1, valG1, valB1, par.RGBConv, par.fullRange, bps);
+    convertYUVToRGB8Bit(valY2, interpolatedU, interpolatedV, valR2, valG2, valB2, par.RGBConv, par.fullRange, bps);
+    const int pos = (x*2)*4;
+    dst[pos  ] = valB1;
+    dst[pos+1] = valG1;
+    dst[pos+2] = valR1;
+    dst[pos+3] = 255;
+    dst[pos+4] = valB2;
+    dst[pos+5] = valG2;
+    dst[pos+6] = valR2;
+    dst[pos+7] = 255;
+
+    // The next one is now the current one
+    curUSample = nextUSample;
+    curVSample = nextVSample;
+  }
+
+  // For the last row, there is no next sample. Just reuse the current one again. No interpolation required either.
+
+  // Get the 2 Y samples
+  int valY1 = getValueFromSource(srcY, width-2, bps, bigEndian);
+  int valY2 = getValueFromSource(srcY, width-1, bps, bigEndian);
+  if (par.applyMathLuma)
+  {
+    valY1 = transformYUV(par.mathLumaInvert, par.mathLumaScale, par.mathLumaOffset, valY1, par.inMax);
+    valY2 = transformYUV(par.mathLumaInvert, par.mathLumaScale, par.mathLumaOffset, valY2, par.inMax);
+  }
+
+  // Convert to 2 RGB values and save them
+  int valR1, valR2, valG1, valG2, valB1, valB2;
+  convertYUVToRGB8Bit(valY1, curUSample, curVSample, valR1, valG1, valB1, par.RGBConv, par.fullRange, bps);
+  convertYUVToRGB8Bit(valY2, curUSample, curVSample, valR2, valG2, valB2, par.RGBConv, par.fullRange, bps);
+  const int pos = width*4;
+  dst[pos-8] = valB1;
+  dst[pos-7] = valG1;
+  dst[pos-6] = valR1;
+  dst[pos-5] = 255;
+  dst[pos-4] = valB2;
+  dst[pos-3] = valG2;
+  dst[pos-2] = valR2;
+  dst[pos-1] = 255;
+}
+
+void convertLinesToRGB_420(const LineConversionParameters &par, const unsigned char *srcY0, const unsigned char *srcY1, const unsigned char *srcU0, const unsigned char *srcV0,
+                           const unsigned char *srcU1, const unsigned char *srcV1, unsigned char *dst0, unsigned char *dst1, const int width)
+{
+  const int bps = par.bitsPerSample;
+  const bool bigEndian = par.bigEndian;
+  const int inValSkip = par.inValSkip;
+  const ChromaInterpolation interpolation = par.bilinearInterpolation ? ChromaInterpolation::Bilinear : ChromaInterpolation::NearestNeighbor;
+  const int widthChroma = width / 2;
+
+  auto getChroma = [&](const unsigned char *src, const int idx)
+  {
+    const int val = getValueFromSource(src, idx*inValSkip, bps, bigEndian);
+    return par.applyMathChroma ? transformYUV(par.mathChromaInvert, par.mathChromaScale, par.mathChromaOffset, val, par.inMax) : val;
+  };
+  auto getLuma = [&](const unsigned char *src, const int idx)
+  {
+    const int val = getValueFromSource(src, idx, bps, bigEndian);
+    return par.applyMathLuma ? transformYUV(par.mathLumaInvert, par.mathLumaScale, par.mathLumaOffset, val, par.inMax) : val;
+  };
+  auto setRGB = [&](unsigned char *dst, const int idx, const int valY, const int valU, const int valV)
+  {
+    int valR, valG, valB;
+    convertYUVToRGB8Bit(valY, valU, valV, valR, valG, valB, par.RGBConv, par.fullRange, bps);
+    dst[idx*4  ] = valB;
+    dst[idx*4+1] = valG;
+    dst[idx*4+2] = valR;
+    dst[idx*4+3] = 255;
+  };
+
+  // Convert as much as possible using the vector instructions. Do the rest here. Process 4 Y positions at a time.
+  for (int x = convertLinesToRGB_420_SIMD(par, srcY0, srcY1, srcU0, srcV0, srcU1, srcV1, dst0, dst1, width) / 2; x < widthChroma; x++)
+  {
+    // For the last x value (the right border), there is no next value. Just sample and hold.
+    // Interpolating between two identical values gives the same result.
+    const int nextX = std::min(x + 1, widthChroma - 1);
+    const int curU     = getChroma(srcU0, x);
+    const int curV     = getChroma(srcV0, x);
+    const int nextU    = getChroma(srcU0, nextX);
+    const int nextV    = getChroma(srcV0, nextX);
+    const int curU_NL  = getChroma(srcU1, x);
+    const int curV_NL  = getChroma(srcV1, x);
+    const int nextU_NL = getChroma(srcU1, nextX);
+    const int nextV_NL = getChroma(srcV1, nextX);
+
+    setRGB(dst0, x*2,   getLuma(srcY0, x*2),   curU, curV);
+    setRGB(dst0, x*2+1, getLuma(srcY0, x*2+1), interpolateUVSample(interpolation, curU, nextU), interpolateUVSample(interpolation, curV, nextV));
+    setRGB(dst1, x*2,   getLuma(srcY1, x*2),   interpolateUVSample(interpolation, curU, curU_NL), interpolateUVSample(interpolation, curV, curV_NL));
+    setRGB(dst1, x*2+1, getLuma(srcY1, x*2+1), interpolateUVSample2D(interpolation, curU, nextU, curU_NL, nextU_NL), interpolateUVSample2D(interpolation, curV, nextV, curV_NL, nextV_NL));
+  }
+}
+
+uint64_t calculateLineDifference(const LineDifferenceParameters &par, const unsigned char *src0, const unsigned char *src1, unsigned char *dst, const int width)
+{
+  const int bpsOut = par.bitsPerSampleOut;
+  const int diffZero = 1 << (bpsOut - 1);
+  const int maxVal = (1 << bpsOut) - 1;
+
+  // Calculate as much as possible using the vector instructions. Do the rest here.
+  uint64_t sumSquaredDiff = 0;
+  for (int i = calculateLineDifference_SIMD(par, src0, src1, dst, width, sumSquaredDiff); i < width; ++i)
+  {
+    const int val0 = getValueFromSource(src0, i, par.bitsPerSample[0], par.bigEndian[0]) << par.shift[0];
+    const int val1 = getValueFromSource(src1, i, par.bitsPerSample[1], par.bigEndian[1]) << par.shift[1];
+    const int diff = val0 - val1;
+    sumSquaredDiff += uint64_t(int64_t(diff) * diff);
+    setValueInBuffer(dst, std::min(std::max(diff * par.amplificationFactor + diffZero, 0), maxVal), i, bpsOut, false);
+  }
+  return sumSquaredDiff;
+}
+
+void calculateSSIMBlockSums(const LineDifferenceParameters &par, const unsigned char *src0, const int stride0, const unsigned char *src1, const int stride1, int64_t (*sums)[4], const int nrBlocks)
+{
+  for (int b = calculateSSIMBlockSums_SIMD(par, src0, stride0, src1, stride1, sums, nrBlocks); b < nrBlocks; ++b)
+  {
+    int64_t s0 = 0, s1 = 0, ss = 0, s01 = 0;
+    for (int y = 0; y < 4; y++)
+    {
+      for (int x = b * 4; x < b * 4 + 4; x++)
+      {
+        const int64_t val0 = int64_t(getValueFromSource(src0 + y * stride0, x, par.bitsPerSample[0], par.bigEndian[0])) << par.shift[0];
+        const int64_t val1 = int64_t(getValueFromSource(src1 + y * stride1, x, par.bitsPerSample[1], par.bigEndian[1])) << par.shift[1];
+        s0 += val0;
+        s1 += val1;
+        ss += val0 * val0 + val1 * val1;
+        s01 += val0 * val1;
+      }
+    }
+    sums[b][0] = s0;
+    sums[b][1] = s1;
+    sums[b][2] = ss;
+    sums[b][3] = s01;
+  }
+}
+
+} // namespace YUV_Internals
@@ -0,0 +1,160 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// This header is included by the translation units that are compiled for a specific instruction set (e.g.
+// yuvConversionSIMD_AVX2.cpp). So it must not contain any inline functions and must not include any Qt headers.
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define YUV_SIMD_X86 1
+#else
+#define YUV_SIMD_X86 0
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define YUV_SIMD_NEON 1
+#else
+#define YUV_SIMD_NEON 0
+#endif
+
+namespace YUV_Internals
+{
+
+// The instruction sets for which there are vectorized YUV to RGB conversion and difference functions.
+// Which one is used is decided at runtime (see getSIMDInstructionSet).
+enum class SIMDInstructionSet
+{
+  None,   // Only use the scalar code
+  SSE41,
+  AVX2,
+  NEON
+};
+
+// Get the instruction set that is used for the conversion. By default, this is the best one that the CPU supports.
+SIMDInstructionSet getSIMDInstructionSet();
+// Is the given instruction set supported by the CPU (and was the code compiled for it)?
+bool isSIMDInstructionSetSupported(SIMDInstructionSet set);
+// Force the use of the given instruction set (e.g. for testing). Returns false if the set is not supported.
+bool setSIMDInstructionSet(SIMDInstructionSet set);
+const char *getSIMDInstructionSetName(SIMDInstructionSet set);
+
+// All parameters that are needed to convert a line of YUV samples to RGB. The YUV math (scale, offset, invert)
+// is only applied if applyMathLuma/applyMathChroma is set.
+struct LineConversionParameters
+{
+  int  bitsPerSample;
+  bool bigEndian;
+  // Skip this many values in the chroma input for every value (1 for planar, 2 or 3 if the chroma components are interleaved)
+  int  inValSkip;
+  bool fullRange;
+  int  RGBConv[5];
+  // Interpolate the chroma values bilinearly (otherwise sample and hold). Only used for 4:2:2 and 4:2:0.
+  bool bilinearInterpolation;
+  // The maximum input value ((1<<bitsPerSample)-1). The YUV math clips to this value.
+  int  inMax;
+  bool applyMathLuma;
+  int  mathLumaScale, mathLumaOffset;
+  bool mathLumaInvert;
+  bool applyMathChroma;
+  int  mathChromaScale, mathChromaOffset;
+  bool mathChromaInvert;
+};
+
+// Convert one line of 4:4:4 samples to RGB (BGRA, 8 bit per value). The result is bit exact with the scalar conversion.
+// For 4:4:4, a whole frame can be converted at once by giving the number of samples in the frame as the width.
+void convertLineToRGB_444(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width);
+// Convert one line of 4:2:2 samples to RGB (BGRA, 8 bit per value). The chroma values are upsampled horizontally.
+void convertLineToRGB_422(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width);
+// Convert two lines of 4:2:0 samples (srcY0/dst0 and srcY1/dst1) which belong to one line of chroma samples (srcU0/srcV0)
+// to RGB. The chroma values are upsampled horizontally and vertically towards the next line of chroma samples (srcU1/srcV1).
+// For the last line of chroma samples, srcU1/srcV1 must be the same as srcU0/srcV0 (sample and hold).
+void convertLinesToRGB_420(const LineConversionParameters &par, const unsigned char *srcY0, const unsigned char *srcY1, const unsigned char *srcU0, const unsigned char *srcV0,
+                           const unsigned char *srcU1, const unsigned char *srcV1, unsigned char *dst0, unsigned char *dst1, const int width);
+
+// All parameters that are needed to calculate the difference of a line of samples of two planes (A-B).
+struct LineDifferenceParameters
+{
+  int  bitsPerSample[2];
+  bool bigEndian[2];
+  // Scale the input values up by this many bits so that both have bitsPerSampleOut bits
+  int  shift[2];
+  int  bitsPerSampleOut;
+  int  amplificationFactor;
+};
+
+// Calculate the difference (A-B) of one line. The difference is multiplied by the amplificationFactor, moved to the
+// middle of the output value range, clipped and written to dst (bitsPerSampleOut, little endian if more than 8 bit).
+// Returns the sum of the squared differences (before amplification).
+uint64_t calculateLineDifference(const LineDifferenceParameters &par, const unsigned char *src0, const unsigned char *src1, unsigned char *dst, const int width);
+// Calculate the sums that are needed for the SSIM of the nrBlocks 4x4 blocks in a stripe of 4 lines (see yuvDifference.h).
+// For each block, sums gets the sum of A, the sum of B, the sum of A*A+B*B and the sum of A*B (after scaling to bitsPerSampleOut).
+void calculateSSIMBlockSums(const LineDifferenceParameters &par, const unsigned char *src0, const int stride0, const unsigned char *src1, const int stride1, int64_t (*sums)[4], const int nrBlocks);
+
+// The vectorized conversion functions for each instruction set. They convert as much of the line as possible and return
+// the number of luma samples that were converted. The remainder of the line must be converted by the scalar code.
+// The difference functions work the same way and return the number of samples/blocks that were processed. The SSIM
+// sums are only vectorized up to 12 bit because the squares of more bits do not fit into 32 bit lanes.
+#if YUV_SIMD_X86
+namespace SIMD_SSE41
+{
+  int convertLineToRGB_444(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width);
+  int convertLineToRGB_422(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width);
+  int convertLinesToRGB_420(const LineConversionParameters &par, const unsigned char *srcY0, const unsigned char *srcY1, const unsigned char *srcU0, const unsigned char *srcV0,
+                            const unsigned char *srcU1, const unsigned char *srcV1, unsigned char *dst0, unsigned char *dst1, const int width);
+  int calculateLineDifference(const LineDifferenceParameters &par, const unsigned char *src0, const unsigned char *src1, unsigned char *dst, const int width, uint64_t &sumSquaredDiff);
+  int calculateSSIMBlockSums(const LineDifferenceParameters &par, const unsigned char *src0, const int stride0, const unsigned char *src1, const int stride1, int64_t (*sums)[4], const int nrBlocks);
+}
+namespace SIMD_AVX2
+{
+  int convertLineToRGB_444(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width);
+  int convertLineToRGB_422(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width);
+  int convertLinesToRGB_420(const LineConversionParameters &par, const unsigned char *srcY0, const unsigned char *srcY1, const unsigned char *srcU0, const unsigned char *srcV0,
+                            const unsigned char *srcU1, const unsigned char *srcV1, unsigned char *dst0, unsigned char *dst1, const int width);
+  int calculateLineDifference(const LineDifferenceParameters &par, const unsigned char *src0, const unsigned char *src1, unsigned char *dst, const int width, uint64_t &sumSquaredDiff);
+  int calculateSSIMBlockSums(const LineDifferenceParameters &par, const unsigned char *src0, const int stride0, const unsigned char *src1, const int stride1, int64_t (*sums)[4], const int nrBlocks);
+}
+#endif
+#if YUV_SIMD_NEON
+namespace SIMD_NEON
+{
+  int convertLineToRGB_444(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width);
+  int convertLineToRGB_422(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width);
+  int convertLinesToRGB_420(const LineConversionParameters &par, const unsigned char *srcY0, const unsigned char *srcY1, const unsigned char *srcU0, const unsigned char *srcV0,
+                            const unsigned char *srcU1, const unsigned char *srcV1, unsigned char *dst0, unsigned char *dst1, const int width);
+  int calculateLineDifference(const LineDifferenceParameters &par, const unsigned char *src0, const unsigned char *src1, unsigned char *dst, const int width, uint64_t &sumSquaredDiff);
+  int calculateSSIMBlockSums(const LineDifferenceParameters &par, const unsigned char *src0, const int stride0, const unsigned char *src1, const int stride1, int64_t (*sums)[4], const int nrBlocks);
+}
+#endif
+
+} // namespace YUV_Internals
@@ -0,0 +1,264 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#include "yuvConversionSIMD.h"
+
+// The vectorized YUV to RGB conversion kernels. They are written once against a small set of vector operations (Ops)
+// which is implemented for each instruction set in yuvConversionSIMD_<set>.cpp. This header must only be included
+// from these files. Everything is in an anonymous namespace so that no code which is compiled for a specific
+// instruction set can end up being called on a CPU which does not support it.
+//
+// The calculations are the same as in convertYUVToRGB8Bit and transformYUV (yuvConversionHelpers.h) using 32 bit
+// integer lanes. So the result is bit exact with the scalar code.
+//
+// The Ops struct must provide:
+//   typedef Vec                 The vector type with lanes 32 bit integer values
+//   static const int lanes
+//   set1(int), load(const int32_t*), loadU8(const unsigned char*), loadU16(const unsigned char*, bool bigEndian)
+//   add, sub, mul (lower 32 bit), min, max, bitOr, sra(Vec, int), sll(Vec, int)
+//   interleave(a, b, lo, hi)    lo = a0 b0 a1 b1 ..., hi = the second half
+//   store(unsigned char*, Vec)  Store lanes*4 bytes (unaligned)
+
+namespace YUV_Internals
+{
+namespace
+{
+
+template<class Ops>
+class LineConverter
+{
+public:
+  typedef typename Ops::Vec Vec;
+
+  LineConverter(const LineConversionParameters &par) : par(par)
+  {
+    const int bps = par.bitsPerSample;
+    // For more than 14 bits, the two least significant bits are discarded (see convertYUVToRGB8Bit)
+    preShift = (bps > 14) ? 2 : 0;
+    const int bpsShift = (bps > 14) ? bps - 10 : bps - 8;
+    shift = 16 + bpsShift;
+    yOffset = Ops::set1(par.fullRange ? 0 : 16 << bpsShift);
+    cZero = Ops::set1(128 << bpsShift);
+    for (int i = 0; i < 5; i++)
+      coef[i] = Ops::set1(par.RGBConv[i]);
+    zero = Ops::set1(0);
+    one = Ops::set1(1);
+    two = Ops::set1(2);
+    max8Bit = Ops::set1(255);
+    alpha = Ops::set1(int(0xff000000));
+    inMax = Ops::set1(par.inMax);
+    mathLumaScale = Ops::set1(par.mathLumaScale);
+    mathLumaOffset = Ops::set1(par.mathLumaOffset);
+    mathChromaScale = Ops::set1(par.mathChromaScale);
+    mathChromaOffset = Ops::set1(par.mathChromaOffset);
+  }
+
+  // Load lanes samples starting at the given sample index.
+  Vec loadSamples(const unsigned char *src, const int idx, const int valSkip) const
+  {
+    if (valSkip == 1)
+      return (par.bitsPerSample > 8) ? Ops::loadU16(src + idx*2, par.bigEndian) : Ops::loadU8(src + idx);
+
+    // Interleaved values. Gather them.
+    int32_t values[Ops::lanes];
+    for (int i = 0; i < Ops::lanes; i++)
+    {
+      const int srcIdx = (idx + i) * valSkip;
+      if (par.bitsPerSample > 8)
+        values[i] = par.bigEndian ? (src[srcIdx*2] << 8 | src[srcIdx*2+1]) : (src[srcIdx*2] | src[srcIdx*2+1] << 8);
+      else
+        values[i] = src[srcIdx];
+    }
+    return Ops::load(values);
+  }
+
+  Vec loadLuma(const unsigned char *srcY, const int idx) const
+  {
+    Vec val = loadSamples(srcY, idx, 1);
+    if (par.applyMathLuma)
+      val = transform(val, mathLumaScale, mathLumaOffset, par.mathLumaInvert);
+    return val;
+  }
+
+  Vec loadChroma(const unsigned char *srcC, const int idx) const
+  {
+    Vec val = loadSamples(srcC, idx, par.inValSkip);
+    if (par.applyMathChroma)
+      val = transform(val, mathChromaScale, mathChromaOffset, par.mathChromaInvert);
+    return val;
+  }
+
+  // The bilinear interpolation between the samples (see interpolateUVSample)
+  Vec interpolate(const Vec &sample1, const Vec &sample2) const
+  {
+    if (par.bilinearInterpolation)
+      return Ops::sra(Ops::add(Ops::add(sample1, sample2), one), 1);
+    return sample1;
+  }
+
+  // The bilinear interpolation between four samples (see interpolateUVSample2D)
+  Vec interpolate2D(const Vec &sample1, const Vec &sample2, const Vec &sample3, const Vec &sample4) const
+  {
+    if (par.bilinearInterpolation)
+      return Ops::sra(Ops::add(Ops::add(Ops::add(sample1, sample2), Ops::add(sample3, sample4)), two), 2);
+    return sample1;
+  }
+
+  // Convert to RGB and pack the values as BGRA
+  Vec convertToRGB(Vec valY, Vec valU, Vec valV) const
+  {
+    if (preShift > 0)
+    {
+      valY = Ops::sra(valY, preShift);
+      valU = Ops::sra(valU, preShift);
+      valV = Ops::sra(valV, preShift);
+    }
+    const Vec Y_tmp = Ops::mul(Ops::sub(valY, yOffset), coef[0]);
+    const Vec U_tmp = Ops::sub(valU, cZero);
+    const Vec V_tmp = Ops::sub(valV, cZero);
+
+    const Vec R_tmp = Ops::sra(Ops::add(Y_tmp, Ops::mul(V_tmp, coef[1])), shift);
+    const Vec G_tmp = Ops::sra(Ops::add(Ops::add(Y_tmp, Ops::mul(U_tmp, coef[2])), Ops::mul(V_tmp, coef[3])), shift);
+    const Vec B_tmp = Ops::sra(Ops::add(Y_tmp, Ops::mul(U_tmp, coef[4])), shift);
+
+    const Vec valR = clip(R_tmp, max8Bit);
+    const Vec valG = clip(G_tmp, max8Bit);
+    const Vec valB = clip(B_tmp, max8Bit);
+    return Ops::bitOr(Ops::bitOr(valB, Ops::sll(valG, 8)), Ops::bitOr(Ops::sll(valR, 16), alpha));
+  }
+
+private:
+  Vec clip(const Vec &val, const Vec &maxVal) const { return Ops::min(Ops::max(val, zero), maxVal); }
+
+  // See transformYUV
+  Vec transform(const Vec &val, const Vec &scale, const Vec &offset, const bool invert) const
+  {
+    const Vec scaled = Ops::mul(Ops::sub(val, offset), scale);
+    const Vec newValue = invert ? Ops::sub(offset, scaled) : Ops::add(scaled, offset);
+    return clip(newValue, inMax);
+  }
+
+  const LineConversionParameters &par;
+  int preShift, shift;
+  Vec yOffset, cZero, coef[5];
+  Vec zero, one, two, max8Bit, alpha, inMax;
+  Vec mathLumaScale, mathLumaOffset, mathChromaScale, mathChromaOffset;
+};
+
+template<class Ops>
+int convertLine444Kernel(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width)
+{
+  const LineConverter<Ops> converter(par);
+  int x = 0;
+  for (; x + Ops::lanes <= width; x += Ops::lanes)
+  {
+    const auto valY = converter.loadLuma(srcY, x);
+    const auto valU = converter.loadChroma(srcU, x);
+    const auto valV = converter.loadChroma(srcV, x);
+    Ops::store(dst + x*4, converter.convertToRGB(valY, valU, valV));
+  }
+  return x;
+}
+
+template<class Ops>
+int convertLine422Kernel(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width)
+{
+  const LineConverter<Ops> converter(par);
+  const int widthChroma = width / 2;
+  // In each iteration, lanes chroma samples (2*lanes luma samples) are converted. For the interpolation,
+  // the next chroma sample is needed as well. The last chroma sample has no next sample and is handled by
+  // the scalar code.
+  int x = 0;
+  for (; x + Ops::lanes < widthChroma; x += Ops::lanes)
+  {
+    const auto curU = converter.loadChroma(srcU, x);
+    const auto curV = converter.loadChroma(srcV, x);
+    const auto interpolatedU = converter.interpolate(curU, converter.loadChroma(srcU, x + 1));
+    const auto interpolatedV = converter.interpolate(curV, converter.loadChroma(srcV, x + 1));
+
+    typename Ops::Vec valU[2], valV[2];
+    Ops::interleave(curU, interpolatedU, valU[0], valU[1]);
+    Ops::interleave(curV, interpolatedV, valV[0], valV[1]);
+
+    for (int i = 0; i < 2; i++)
+    {
+      const int lumaIdx = x*2 + i*Ops::lanes;
+      const auto valY = converter.loadLuma(srcY, lumaIdx);
+      Ops::store(dst + lumaIdx*4, converter.convertToRGB(valY, valU[i], valV[i]));
+    }
+  }
+  return x * 2;
+}
+
+template<class Ops>
+int convertLines420Kernel(const LineConversionParameters &par, const unsigned char *srcY0, const unsigned char *srcY1, const unsigned char *srcU0, const unsigned char *srcV0,
+                          const unsigned char *srcU1, const unsigned char *srcV1, unsigned char *dst0, unsigned char *dst1, const int width)
+{
+  const LineConverter<Ops> converter(par);
+  const int widthChroma = width / 2;
+  // Like for 4:2:2, lanes chroma samples (2*lanes luma samples of both lines) are converted in each iteration and the
+  // last chroma sample is handled by the scalar code. The first luma line uses the chroma line (interpolated horizontally),
+  // the second luma line is between the chroma line and the next one (interpolated vertically and in 2D).
+  int x = 0;
+  for (; x + Ops::lanes < widthChroma; x += Ops::lanes)
+  {
+    const auto curU = converter.loadChroma(srcU0, x);
+    const auto curV = converter.loadChroma(srcV0, x);
+    const auto nextU = converter.loadChroma(srcU0, x + 1);
+    const auto nextV = converter.loadChroma(srcV0, x + 1);
+    const auto curU_NL = converter.loadChroma(srcU1, x);
+    const auto curV_NL = converter.loadChroma(srcV1, x);
+    const auto nextU_NL = converter.loadChroma(srcU1, x + 1);
+    const auto nextV_NL = converter.loadChroma(srcV1, x + 1);
+
+    typename Ops::Vec valU[2][2], valV[2][2];
+    Ops::interleave(curU, converter.interpolate(curU, nextU), valU[0][0], valU[0][1]);
+    Ops::interleave(curV, converter.interpolate(curV, nextV), valV[0][0], valV[0][1]);
+    Ops::interleave(converter.interpolate(curU, curU_NL), converter.interpolate2D(curU, nextU, curU_NL, nextU_NL), valU[1][0], valU[1][1]);
+    Ops::interleave(converter.interpolate(curV, curV_NL), converter.interpolate2D(curV, nextV, curV_NL, nextV_NL), valV[1][0], valV[1][1]);
+
+    for (int i = 0; i < 2; i++)
+    {
+      const int lumaIdx = x*2 + i*Ops::lanes;
+      Ops::store(dst0 + lumaIdx*4, converter.convertToRGB(converter.loadLuma(srcY0, lumaIdx), valU[0][i], valV[0][i]));
+      Ops::store(dst1 + lumaIdx*4, converter.convertToRGB(converter.loadLuma(srcY1, lumaIdx), valU[1][i], valV[1][i]));
+    }
+  }
+  return x * 2;
+}
+
+} // namespace
+} // namespace YUV_Internals
@@ -0,0 +1,139 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "yuvConversionSIMD.h"
+
+#if YUV_SIMD_X86
+
+#include <cstdint>
+#include <immintrin.h>
+
+// Everything below is compiled for AVX2. It is only called if the CPU supports it (see getSIMDInstructionSet).
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace
+{
+
+struct OpsAVX2
+{
+  typedef __m256i Vec;
+  static const int lanes = 8;
+
+  static Vec set1(int val) { return _mm256_set1_epi32(val); }
+  static Vec load(const int32_t *src) { return _mm256_loadu_si256((const __m256i*)src); }
+  static Vec loadU8(const unsigned char *src) { return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)src)); }
+  static Vec loadU16(const unsigned char *src, const bool bigEndian)
+  {
+    __m128i val = _mm_loadu_si128((const __m128i*)src);
+    if (bigEndian)
+      val = _mm_shuffle_epi8(val, _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+    return _mm256_cvtepu16_epi32(val);
+  }
+  static Vec add(const Vec &a, const Vec &b) { return _mm256_add_epi32(a, b); }
+  static Vec sub(const Vec &a, const Vec &b) { return _mm256_sub_epi32(a, b); }
+  static Vec mul(const Vec &a, const Vec &b) { return _mm256_mullo_epi32(a, b); }
+  static Vec min(const Vec &a, const Vec &b) { return _mm256_min_epi32(a, b); }
+  static Vec max(const Vec &a, const Vec &b) { return _mm256_max_epi32(a, b); }
+  static Vec bitOr(const Vec &a, const Vec &b) { return _mm256_or_si256(a, b); }
+  static Vec sra(const Vec &a, const int shift) { return _mm256_sra_epi32(a, _mm_cvtsi32_si128(shift)); }
+  static Vec sll(const Vec &a, const int shift) { return _mm256_sll_epi32(a, _mm_cvtsi32_si128(shift)); }
+  static void interleave(const Vec &a, const Vec &b, Vec &lo, Vec &hi)
+  {
+    // The unpack instructions work on the 128 bit lanes. Swap the middle parts afterwards.
+    const __m256i unpackedLo = _mm256_unpacklo_epi32(a, b);
+    const __m256i unpackedHi = _mm256_unpackhi_epi32(a, b);
+    lo = _mm256_permute2x128_si256(unpackedLo, unpackedHi, 0x20);
+    hi = _mm256_permute2x128_si256(unpackedLo, unpackedHi, 0x31);
+  }
+  static void store(unsigned char *dst, const Vec &val) { _mm256_storeu_si256((__m256i*)dst, val); }
+  static void storeU8(unsigned char *dst, const Vec &val)
+  {
+    const __m128i val16 = _mm_packus_epi32(_mm256_castsi256_si128(val), _mm256_extracti128_si256(val, 1));
+    _mm_storel_epi64((__m128i*)dst, _mm_packus_epi16(val16, val16));
+  }
+  static void storeU16(unsigned char *dst, const Vec &val)
+  {
+    _mm_storeu_si128((__m128i*)dst, _mm_packus_epi32(_mm256_castsi256_si128(val), _mm256_extracti128_si256(val, 1)));
+  }
+};
+
+} // namespace
+
+#include "yuvConversionSIMDKernel.h"
+#include "yuvDifferenceSIMDKernel.h"
+
+namespace YUV_Internals
+{
+namespace SIMD_AVX2
+{
+
+int convertLineToRGB_444(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width)
+{
+  return convertLine444Kernel<OpsAVX2>(par, srcY, srcU, srcV, dst, width);
+}
+
+int convertLineToRGB_422(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width)
+{
+  return convertLine422Kernel<OpsAVX2>(par, srcY, srcU, srcV, dst, width);
+}
+
+int convertLinesToRGB_420(const LineConversionParameters &par, const unsigned char *srcY0, const unsigned char *srcY1, const unsigned char *srcU0, const unsigned char *srcV0,
+                          const unsigned char *srcU1, const unsigned char *srcV1, unsigned char *dst0, unsigned char *dst1, const int width)
+{
+  return convertLines420Kernel<OpsAVX2>(par, srcY0, srcY1, srcU0, srcV0, srcU1, srcV1, dst0, dst1, width);
+}
+
+int calculateLineDifference(const LineDifferenceParameters &par, const unsigned char *src0, const unsigned char *src1, unsigned char *dst, const int width, uint64_t &sumSquaredDiff)
+{
+  return calculateLineDifferenceKernel<OpsAVX2>(par, src0, src1, dst, width, sumSquaredDiff);
+}
+
+int calculateSSIMBlockSums(const LineDifferenceParameters &par, const unsigned char *src0, const int stride0, const unsigned char *src1, const int stride1, int64_t (*sums)[4], const int nrBlocks)
+{
+  return calculateSSIMBlockSumsKernel<OpsAVX2>(par, src0, stride0, src1, stride1, sums, nrBlocks);
+}
+
+} // namespace SIMD_AVX2
+} // namespace YUV_Internals
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // YUV_SIMD_X86
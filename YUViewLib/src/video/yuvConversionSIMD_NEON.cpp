@@ -0,0 +1,131 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "yuvConversionSIMD.h"
+
+#if YUV_SIMD_NEON
+
+#include <cstdint>
+#include <cstring>
+#include <arm_neon.h>
+
+// NEON is always available on 64 bit ARM. So no special compiler flags are needed here.
+
+namespace
+{
+
+struct OpsNEON
+{
+  typedef int32x4_t Vec;
+  static const int lanes = 4;
+
+  static Vec set1(int val) { return vdupq_n_s32(val); }
+  static Vec load(const int32_t *src) { return vld1q_s32(src); }
+  static Vec loadU8(const unsigned char *src)
+  {
+    uint32_t val;
+    std::memcpy(&val, src, 4);
+    const uint16x8_t val16 = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(val)));
+    return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(val16)));
+  }
+  static Vec loadU16(const unsigned char *src, const bool bigEndian)
+  {
+    uint8x8_t val = vld1_u8(src);
+    if (bigEndian)
+      val = vrev16_u8(val);
+    return vreinterpretq_s32_u32(vmovl_u16(vreinterpret_u16_u8(val)));
+  }
+  static Vec add(const Vec &a, const Vec &b) { return vaddq_s32(a, b); }
+  static Vec sub(const Vec &a, const Vec &b) { return vsubq_s32(a, b); }
+  static Vec mul(const Vec &a, const Vec &b) { return vmulq_s32(a, b); }
+  static Vec min(const Vec &a, const Vec &b) { return vminq_s32(a, b); }
+  static Vec max(const Vec &a, const Vec &b) { return vmaxq_s32(a, b); }
+  static Vec bitOr(const Vec &a, const Vec &b) { return vorrq_s32(a, b); }
+  static Vec sra(const Vec &a, const int shift) { return vshlq_s32(a, vdupq_n_s32(-shift)); }
+  static Vec sll(const Vec &a, const int shift) { return vshlq_s32(a, vdupq_n_s32(shift)); }
+  static void interleave(const Vec &a, const Vec &b, Vec &lo, Vec &hi)
+  {
+    const int32x4x2_t zipped = vzipq_s32(a, b);
+    lo = zipped.val[0];
+    hi = zipped.val[1];
+  }
+  static void store(unsigned char *dst, const Vec &val) { vst1q_u8(dst, vreinterpretq_u8_s32(val)); }
+  static void storeU8(unsigned char *dst, const Vec &val)
+  {
+    const uint16x4_t val16 = vqmovun_s32(val);
+    const uint8x8_t val8 = vqmovn_u16(vcombine_u16(val16, val16));
+    const uint32_t packed = vget_lane_u32(vreinterpret_u32_u8(val8), 0);
+    std::memcpy(dst, &packed, 4);
+  }
+  static void storeU16(unsigned char *dst, const Vec &val) { vst1_u8(dst, vreinterpret_u8_u16(vqmovun_s32(val))); }
+};
+
+} // namespace
+
+#include "yuvConversionSIMDKernel.h"
+#include "yuvDifferenceSIMDKernel.h"
+
+namespace YUV_Internals
+{
+namespace SIMD_NEON
+{
+
+int convertLineToRGB_444(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width)
+{
+  return convertLine444Kernel<OpsNEON>(par, srcY, srcU, srcV, dst, width);
+}
+
+int convertLineToRGB_422(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width)
+{
+  return convertLine422Kernel<OpsNEON>(par, srcY, srcU, srcV, dst, width);
+}
+
+int convertLinesToRGB_420(const LineConversionParameters &par, const unsigned char *srcY0, const unsigned char *srcY1, const unsigned char *srcU0, const unsigned char *srcV0,
+                          const unsigned char *srcU1, const unsigned char *srcV1, unsigned char *dst0, unsigned char *dst1, const int width)
+{
+  return convertLines420Kernel<OpsNEON>(par, srcY0, srcY1, srcU0, srcV0, srcU1, srcV1, dst0, dst1, width);
+}
+
+int calculateLineDifference(const LineDifferenceParameters &par, const unsigned char *src0, const unsigned char *src1, unsigned char *dst, const int width, uint64_t &sumSquaredDiff)
+{
+  return calculateLineDifferenceKernel<OpsNEON>(par, src0, src1, dst, width, sumSquaredDiff);
+}
+
+int calculateSSIMBlockSums(const LineDifferenceParameters &par, const unsigned char *src0, const int stride0, const unsigned char *src1, const int stride1, int64_t (*sums)[4], const int nrBlocks)
+{
+  return calculateSSIMBlockSumsKernel<OpsNEON>(par, src0, stride0, src1, stride1, sums, nrBlocks);
+}
+
+} // namespace SIMD_NEON
+} // namespace YUV_Internals
+
+#endif // YUV_SIMD_NEON
@@ -0,0 +1,140 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "yuvConversionSIMD.h"
+
+#if YUV_SIMD_X86
+
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
+// Everything below is compiled for SSE4.1. It is only called if the CPU supports it (see getSIMDInstructionSet).
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse4.1"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+#endif
+
+namespace
+{
+
+struct OpsSSE41
+{
+  typedef __m128i Vec;
+  static const int lanes = 4;
+
+  static Vec set1(int val) { return _mm_set1_epi32(val); }
+  static Vec load(const int32_t *src) { return _mm_loadu_si128((const __m128i*)src); }
+  static Vec loadU8(const unsigned char *src)
+  {
+    int32_t val;
+    std::memcpy(&val, src, 4);
+    return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(val));
+  }
+  static Vec loadU16(const unsigned char *src, const bool bigEndian)
+  {
+    __m128i val = _mm_loadl_epi64((const __m128i*)src);
+    if (bigEndian)
+      val = _mm_shuffle_epi8(val, _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+    return _mm_cvtepu16_epi32(val);
+  }
+  static Vec add(const Vec &a, const Vec &b) { return _mm_add_epi32(a, b); }
+  static Vec sub(const Vec &a, const Vec &b) { return _mm_sub_epi32(a, b); }
+  static Vec mul(const Vec &a, const Vec &b) { return _mm_mullo_epi32(a, b); }
+  static Vec min(const Vec &a, const Vec &b) { return _mm_min_epi32(a, b); }
+  static Vec max(const Vec &a, const Vec &b) { return _mm_max_epi32(a, b); }
+  static Vec bitOr(const Vec &a, const Vec &b) { return _mm_or_si128(a, b); }
+  static Vec sra(const Vec &a, const int shift) { return _mm_sra_epi32(a, _mm_cvtsi32_si128(shift)); }
+  static Vec sll(const Vec &a, const int shift) { return _mm_sll_epi32(a, _mm_cvtsi32_si128(shift)); }
+  static void interleave(const Vec &a, const Vec &b, Vec &lo, Vec &hi)
+  {
+    lo = _mm_unpacklo_epi32(a, b);
+    hi = _mm_unpackhi_epi32(a, b);
+  }
+  static void store(unsigned char *dst, const Vec &val) { _mm_storeu_si128((__m128i*)dst, val); }
+  static void storeU8(unsigned char *dst, const Vec &val)
+  {
+    const __m128i val16 = _mm_packus_epi32(val, val);
+    const int32_t val8 = _mm_cvtsi128_si32(_mm_packus_epi16(val16, val16));
+    std::memcpy(dst, &val8, 4);
+  }
+  static void storeU16(unsigned char *dst, const Vec &val) { _mm_storel_epi64((__m128i*)dst, _mm_packus_epi32(val, val)); }
+};
+
+} // namespace
+
+#include "yuvConversionSIMDKernel.h"
+#include "yuvDifferenceSIMDKernel.h"
+
+namespace YUV_Internals
+{
+namespace SIMD_SSE41
+{
+
+int convertLineToRGB_444(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width)
+{
+  return convertLine444Kernel<OpsSSE41>(par, srcY, srcU, srcV, dst, width);
+}
+
+int convertLineToRGB_422(const LineConversionParameters &par, const unsigned char *srcY, const unsigned char *srcU, const unsigned char *srcV, unsigned char *dst, const int width)
+{
+  return convertLine422Kernel<OpsSSE41>(par, srcY, srcU, srcV, dst, width);
+}
+
+int convertLinesToRGB_420(const LineConversionParameters &par, const unsigned char *srcY0, const unsigned char *srcY1, const unsigned char *srcU0, const unsigned char *srcV0,
+                          const unsigned char *srcU1, const unsigned char *srcV1, unsigned char *dst0, unsigned char *dst1, const int width)
+{
+  return convertLines420Kernel<OpsSSE41>(par, srcY0, srcY1, srcU0, srcV0, srcU1, srcV1, dst0, dst1, width);
+}
+
+int calculateLineDifference(const LineDifferenceParameters &par, const unsigned char *src0, const unsigned char *src1, unsigned char *dst, const int width, uint64_t &sumSquaredDiff)
+{
+  return calculateLineDifferenceKernel<OpsSSE41>(par, src0, src1, dst, width, sumSquaredDiff);
+}
+
+int calculateSSIMBlockSums(const LineDifferenceParameters &par, const unsigned char *src0, const int stride0, const unsigned char *src1, const int stride1, int64_t (*sums)[4], const int nrBlocks)
+{
+  return calculateSSIMBlockSumsKernel<OpsSSE41>(par, src0, stride0, src1, stride1, sums, nrBlocks);
+}
+
+} // namespace SIMD_SSE41
+} // namespace YUV_Internals
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // YUV_SIMD_X86
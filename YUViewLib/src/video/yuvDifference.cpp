@@ -0,0 +1,299 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "yuvDifference.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "yuvConversionSIMD.h"
+
+namespace YUV_Internals
+{
+
+namespace
+{
+
+// The bands of rows start at multiples of this many rows. So an SSIM map block (and the 4x4 blocks for the SSIM
+// windows) is never split between two bands.
+const int BAND_ROW_ALIGNMENT = SSIMMap::blockSize;
+
+struct PlaneInput
+{
+  const unsigned char *data {nullptr};
+  int stride {0};
+};
+
+// Get pointers to the Y, U and V plane of the planar frame. Interleaved U/V planes are copied into separate planes in
+// deinterleavedUV first.
+bool getPlanes(const QByteArray &source, const yuvPixelFormat &format, const QSize &size, QByteArray &deinterleavedUV, PlaneInput planes[3])
+{
+  if (!format.planar || source.size() < format.bytesPerFrame(size))
+    return false;
+
+  const int bytesPerSample = (format.bitsPerSample + 7) / 8;
+  const auto data = (const unsigned char*)source.constData();
+  planes[0].data = data;
+  planes[0].stride = size.width() * bytesPerSample;
+  if (format.subsampling == Subsampling::YUV_400)
+    return true;
+
+  const int widthC = size.width() / format.getSubsamplingHor();
+  const int heightC = size.height() / format.getSubsamplingVer();
+  const int64_t nrBytesLuma = int64_t(planes[0].stride) * size.height();
+  const int64_t nrBytesChroma = int64_t(widthC) * heightC * bytesPerSample;
+  const bool swapUV = (format.planeOrder == PlaneOrder::YVU || format.planeOrder == PlaneOrder::YVUA);
+
+  const unsigned char *chroma = data + nrBytesLuma;
+  if (format.uvInterleaved)
+  {
+    // Split the interleaved samples into two planes
+    deinterleavedUV.resize(int(nrBytesChroma * 2));
+    auto dst = (unsigned char*)deinterleavedUV.data();
+    for (int64_t i = 0; i < int64_t(widthC) * heightC; i++)
+    {
+      std::memcpy(dst + i * bytesPerSample, chroma + i * 2 * bytesPerSample, bytesPerSample);
+      std::memcpy(dst + nrBytesChroma + i * bytesPerSample, chroma + (i * 2 + 1) * bytesPerSample, bytesPerSample);
+    }
+    chroma = dst;
+  }
+
+  planes[1].data = chroma + (swapUV ? nrBytesChroma : 0);
+  planes[2].data = chroma + (swapUV ? 0 : nrBytesChroma);
+  planes[1].stride = planes[2].stride = widthC * bytesPerSample;
+  return true;
+}
+
+// The SSIM of a window of 8x8 samples from the sums of its samples (see calculateSSIMBlockSums)
+double getWindowSSIM(const int64_t sums[4], const double c1, const double c2)
+{
+  const double nrSamples = 64.0;
+  const double mean0 = sums[0] / nrSamples;
+  const double mean1 = sums[1] / nrSamples;
+  const double variances = sums[2] / nrSamples - mean0 * mean0 - mean1 * mean1;
+  const double covariance = sums[3] / nrSamples - mean0 * mean1;
+  return ((2.0 * mean0 * mean1 + c1) * (2.0 * covariance + c2)) / ((mean0 * mean0 + mean1 * mean1 + c1) * (variances + c2));
+}
+
+struct BandResult
+{
+  uint64_t sumSquaredError {0};
+  double ssimSum {0.0};
+  int64_t nrSSIMWindows {0};
+};
+
+// Calculate the SSIM of all windows which start in the rows [rowStart, rowEnd) of the component. The windows have 8x8
+// samples and are placed every 4 samples. For the windows, the sums of 4x4 blocks are calculated once per block row.
+void calculateSSIMInBand(const LineDifferenceParameters &par, const PlaneInput &input0, const PlaneInput &input1, const int width,
+                         const int height, const int rowStart, const int rowEnd, BandResult &result, std::vector<double> *mapSums,
+                         std::vector<int> *mapCounts, const int mapWidth)
+{
+  const int nrBlocksX = width / 4;
+  const int nrBlocksY = height / 4;
+  const int blockRowStart = rowStart / 4;
+  const int blockRowEnd = std::min(rowEnd / 4, nrBlocksY - 1);
+  if (nrBlocksX < 2 || blockRowStart >= blockRowEnd)
+    return;
+
+  const double maxValue = double((1 << par.bitsPerSampleOut) - 1);
+  const double c1 = (0.01 * maxValue) * (0.01 * maxValue);
+  const double c2 = (0.03 * maxValue) * (0.03 * maxValue);
+
+  std::vector<int64_t> blockSums[2] = {std::vector<int64_t>(nrBlocksX * 4), std::vector<int64_t>(nrBlocksX * 4)};
+  auto getBlockSums = [&](int blockRow, std::vector<int64_t> &sums)
+  {
+    const unsigned char *src0 = input0.data + int64_t(blockRow) * 4 * input0.stride;
+    const unsigned char *src1 = input1.data + int64_t(blockRow) * 4 * input1.stride;
+    calculateSSIMBlockSums(par, src0, input0.stride, src1, input1.stride, (int64_t(*)[4])sums.data(), nrBlocksX);
+  };
+
+  getBlockSums(blockRowStart, blockSums[0]);
+  for (int blockRow = blockRowStart; blockRow < blockRowEnd; blockRow++)
+  {
+    // Each window consists of 2x2 blocks from this and the next block row
+    const auto &top = blockSums[(blockRow - blockRowStart) % 2];
+    auto &bottom = blockSums[(blockRow - blockRowStart + 1) % 2];
+    getBlockSums(blockRow + 1, bottom);
+
+    for (int blockX = 0; blockX < nrBlocksX - 1; blockX++)
+    {
+      int64_t windowSums[4];
+      for (int i = 0; i < 4; i++)
+        windowSums[i] = top[blockX * 4 + i] + top[(blockX + 1) * 4 + i] + bottom[blockX * 4 + i] + bottom[(blockX + 1) * 4 + i];
+      const double ssim = getWindowSSIM(windowSums, c1, c2);
+      result.ssimSum += ssim;
+      if (mapSums)
+      {
+        const int mapIdx = (blockRow / 2) * mapWidth + blockX / 2;
+        (*mapSums)[mapIdx] += ssim;
+        (*mapCounts)[mapIdx]++;
+      }
+    }
+    result.nrSSIMWindows += nrBlocksX - 1;
+  }
+}
+
+} // namespace
+
+double DifferenceMetrics::getMSE() const
+{
+  return (nrSamples > 0) ? double(sumSquaredError) / nrSamples : 0.0;
+}
+
+double DifferenceMetrics::getPSNR() const
+{
+  const double mse = getMSE();
+  if (mse <= 0.0)
+    return std::numeric_limits<double>::infinity();
+  const double maxValue = double((1 << bitsPerSample) - 1);
+  return 10.0 * std::log10(maxValue * maxValue / mse);
+}
+
+double DifferenceMetrics::getSSIM() const
+{
+  return (nrSSIMWindows > 0) ? ssimSum / nrSSIMWindows : 1.0;
+}
+
+DifferenceMetrics DifferenceResult::getCombinedMetrics() const
+{
+  DifferenceMetrics combined;
+  combined.bitsPerSample = components[0].bitsPerSample;
+  for (int c = 0; c < nrComponents; c++)
+  {
+    combined.nrSamples += components[c].nrSamples;
+    combined.sumSquaredError += components[c].sumSquaredError;
+    combined.ssimSum += components[c].ssimSum;
+    combined.nrSSIMWindows += components[c].nrSSIMWindows;
+  }
+  return combined;
+}
+
+bool calculateDifference(const QByteArray &source0, const yuvPixelFormat &format0, const QSize &size0,
+                         const QByteArray &source1, const yuvPixelFormat &format1, const QSize &size1,
+                         QByteArray &differenceBuffer, DifferenceResult &result, const DifferenceSettings &settings,
+                         const int nrThreads, const BandRunner &runBands)
+{
+  if (format0.subsampling != format1.subsampling)
+    return false;
+
+  QByteArray deinterleavedUV[2];
+  PlaneInput planes[2][3];
+  if (!getPlanes(source0, format0, size0, deinterleavedUV[0], planes[0]) || !getPlanes(source1, format1, size1, deinterleavedUV[1], planes[1]))
+    return false;
+
+  LineDifferenceParameters par;
+  par.bitsPerSample[0] = format0.bitsPerSample;
+  par.bitsPerSample[1] = format1.bitsPerSample;
+  par.bigEndian[0] = format0.bigEndian;
+  par.bigEndian[1] = format1.bigEndian;
+  par.bitsPerSampleOut = std::max(format0.bitsPerSample, format1.bitsPerSample);
+  par.shift[0] = par.bitsPerSampleOut - format0.bitsPerSample;
+  par.shift[1] = par.bitsPerSampleOut - format1.bitsPerSample;
+  par.amplificationFactor = settings.amplificationFactor;
+
+  const QSize size(std::min(size0.width(), size1.width()), std::min(size0.height(), size1.height()));
+  result = DifferenceResult();
+  result.differenceFormat = yuvPixelFormat(format0.subsampling, par.bitsPerSampleOut, PlaneOrder::YUV, false);
+  result.differenceSize = size;
+  result.nrComponents = (format0.subsampling == Subsampling::YUV_400) ? 1 : 3;
+  differenceBuffer.resize(int(result.differenceFormat.bytesPerFrame(size)));
+
+  const int bytesPerSampleOut = (par.bitsPerSampleOut > 8) ? 2 : 1;
+  auto dst = (unsigned char*)differenceBuffer.data();
+  for (int c = 0; c < result.nrComponents; c++)
+  {
+    const int subH = (c == 0) ? 1 : format0.getSubsamplingHor();
+    const int subV = (c == 0) ? 1 : format0.getSubsamplingVer();
+    const int width = size.width() / subH;
+    const int height = size.height() / subV;
+    const int strideOut = width * bytesPerSampleOut;
+    const PlaneInput &input0 = planes[0][c];
+    const PlaneInput &input1 = planes[1][c];
+
+    // The SSIM map is only calculated for luma
+    const bool calculateMap = (c == 0 && settings.calculateSSIM && settings.calculateSSIMMap);
+    const int mapWidth = (width / 4) / 2;
+    const int mapHeight = (height / 4) / 2;
+    std::vector<double> mapSums(calculateMap ? mapWidth * mapHeight : 0);
+    std::vector<int> mapCounts(calculateMap ? mapWidth * mapHeight : 0);
+
+    // Split the rows into bands which start at multiples of BAND_ROW_ALIGNMENT
+    const int nrAlignedRows = (height + BAND_ROW_ALIGNMENT - 1) / BAND_ROW_ALIGNMENT;
+    const int nrBands = std::max(1, std::min(nrThreads, nrAlignedRows));
+    std::vector<BandResult> bandResults(nrBands);
+    auto calculateBand = [&](int band)
+    {
+      const int rowStart = std::min(height, nrAlignedRows * band / nrBands * BAND_ROW_ALIGNMENT);
+      const int rowEnd = std::min(height, nrAlignedRows * (band + 1) / nrBands * BAND_ROW_ALIGNMENT);
+      BandResult &bandResult = bandResults[band];
+      for (int y = rowStart; y < rowEnd; y++)
+        bandResult.sumSquaredError += calculateLineDifference(par, input0.data + int64_t(y) * input0.stride, input1.data + int64_t(y) * input1.stride,
+                                                              dst + int64_t(y) * strideOut, width);
+      if (settings.calculateSSIM)
+        calculateSSIMInBand(par, input0, input1, width, height, rowStart, rowEnd, bandResult, calculateMap ? &mapSums : nullptr,
+                            calculateMap ? &mapCounts : nullptr, mapWidth);
+    };
+    if (runBands && nrBands > 1)
+      runBands(nrBands, calculateBand);
+    else
+      for (int band = 0; band < nrBands; band++)
+        calculateBand(band);
+
+    DifferenceMetrics &metrics = result.components[c];
+    metrics.bitsPerSample = par.bitsPerSampleOut;
+    metrics.nrSamples = int64_t(width) * height;
+    for (const auto &bandResult : bandResults)
+    {
+      metrics.sumSquaredError += bandResult.sumSquaredError;
+      metrics.ssimSum += bandResult.ssimSum;
+      metrics.nrSSIMWindows += bandResult.nrSSIMWindows;
+    }
+
+    if (calculateMap)
+    {
+      result.ssimMap.size = QSize(mapWidth, mapHeight);
+      result.ssimMap.values.resize(mapWidth * mapHeight);
+      for (int i = 0; i < mapWidth * mapHeight; i++)
+        result.ssimMap.values[i] = float(mapSums[i] / std::max(mapCounts[i], 1));
+    }
+
+    dst += int64_t(strideOut) * height;
+  }
+
+  return true;
+}
+
+} // namespace YUV_Internals
@@ -0,0 +1,111 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+
+#include <QByteArray>
+#include <QSize>
+#include <QVector>
+
+#include "yuvConversion.h"
+#include "yuvPixelFormat.h"
+
+namespace YUV_Internals
+{
+
+// The metrics of the difference of one component (or of all components combined)
+struct DifferenceMetrics
+{
+  // The bit depth at which the difference was calculated. The peak value for the PSNR is (1 << bitsPerSample) - 1.
+  int bitsPerSample {8};
+  int64_t nrSamples {0};
+  uint64_t sumSquaredError {0};
+  // The sum of the SSIM of all 8x8 windows (with a step of 4 samples in both directions)
+  double ssimSum {0.0};
+  int64_t nrSSIMWindows {0};
+
+  double getMSE() const;
+  // The PSNR in dB. This is infinite if there is no difference.
+  double getPSNR() const;
+  // The mean SSIM of all windows. This is 1 if there is no window (the component is smaller than 8x8 samples).
+  double getSSIM() const;
+};
+
+// The SSIM of the luma component per block of blockSize x blockSize samples. The value of a block is the mean SSIM
+// of the windows which start in the block.
+struct SSIMMap
+{
+  static const int blockSize = 8;
+  // The number of blocks in each direction
+  QSize size;
+  QVector<float> values;
+};
+
+struct DifferenceSettings
+{
+  // Multiply the difference values by this factor (only in the difference buffer, not for the metrics)
+  int  amplificationFactor {1};
+  bool calculateSSIM {true};
+  // Also get the SSIM per block of the luma component (needs calculateSSIM)
+  bool calculateSSIMMap {false};
+};
+
+struct DifferenceResult
+{
+  // The metrics of the Y, U and V component (only Y for 4:0:0)
+  DifferenceMetrics components[3];
+  int nrComponents {0};
+  SSIMMap ssimMap;
+  // The format and size of the difference buffer
+  yuvPixelFormat differenceFormat;
+  QSize differenceSize;
+
+  // Get the metrics of all samples of all components
+  DifferenceMetrics getCombinedMetrics() const;
+};
+
+// Calculate the difference (A-B) of two planar YUV frames with the same subsampling. If the frames have different sizes,
+// the top left part that overlaps is compared. If the bit depths differ, the values with fewer bits are scaled up.
+// The difference is written to differenceBuffer as planar YUV (4:0:0 only has luma) with the higher bit depth (little
+// endian). The difference values are multiplied by the amplificationFactor, moved to the middle of the value range and
+// clipped. The metrics are calculated from the difference before amplification.
+// The rows of each component are split into up to nrThreads bands which are given to runBands (see convertYUVPlanarToRGB).
+// Returns false if the formats cannot be compared (packed formats or different subsampling) or if a buffer is too small.
+bool calculateDifference(const QByteArray &source0, const yuvPixelFormat &format0, const QSize &size0,
+                         const QByteArray &source1, const yuvPixelFormat &format1, const QSize &size1,
+                         QByteArray &differenceBuffer, DifferenceResult &result, const DifferenceSettings &settings = DifferenceSettings(),
+                         const int nrThreads = 1, const BandRunner &runBands = BandRunner());
+
+} // namespace YUV_Internals
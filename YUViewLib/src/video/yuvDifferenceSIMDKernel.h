@@ -0,0 +1,146 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+
+#include "yuvConversionSIMD.h"
+
+// The vectorized kernels for the difference of two planes (see calculateLineDifference and calculateSSIMBlockSums).
+// Like the conversion kernels (yuvConversionSIMDKernel.h), they are written against the Ops of an instruction set and
+// must only be included from yuvConversionSIMD_<set>.cpp. The results are identical to the scalar code.
+//
+// In addition to the operations that the conversion kernels use, the Ops struct must provide:
+//   storeU8(unsigned char*, Vec)   Store the lanes as 8 bit values (lanes bytes). The values must be in the range 0...255.
+//   storeU16(unsigned char*, Vec)  Store the lanes as 16 bit little endian values (lanes*2 bytes). The values must be in
+//                                  the range 0...65535.
+
+namespace YUV_Internals
+{
+namespace
+{
+
+template<class Ops>
+typename Ops::Vec loadDifferenceInput(const LineDifferenceParameters &par, const int input, const unsigned char *src, const int idx)
+{
+  const auto val = (par.bitsPerSample[input] > 8) ? Ops::loadU16(src + idx*2, par.bigEndian[input]) : Ops::loadU8(src + idx);
+  return (par.shift[input] > 0) ? Ops::sll(val, par.shift[input]) : val;
+}
+
+template<class Ops>
+uint64_t sumUnsignedLanes(const typename Ops::Vec &val)
+{
+  uint32_t values[Ops::lanes];
+  Ops::store((unsigned char*)values, val);
+  uint64_t sum = 0;
+  for (int i = 0; i < Ops::lanes; i++)
+    sum += values[i];
+  return sum;
+}
+
+template<class Ops>
+int calculateLineDifferenceKernel(const LineDifferenceParameters &par, const unsigned char *src0, const unsigned char *src1, unsigned char *dst, const int width, uint64_t &sumSquaredDiff)
+{
+  typedef typename Ops::Vec Vec;
+  const int bpsOut = par.bitsPerSampleOut;
+  const Vec zero = Ops::set1(0);
+  const Vec diffZero = Ops::set1(1 << (bpsOut - 1));
+  const Vec maxVal = Ops::set1((1 << bpsOut) - 1);
+  const Vec amplification = Ops::set1(par.amplificationFactor);
+
+  // The squared differences are summed up in the (unsigned) 32 bit lanes. Move the sum out before it can overflow.
+  const uint64_t maxSquare = uint64_t((1 << bpsOut) - 1) * uint64_t((1 << bpsOut) - 1);
+  const uint64_t maxIterations = uint64_t(UINT32_MAX) / maxSquare;
+  uint64_t iterations = 0;
+  Vec sum = zero;
+
+  int x = 0;
+  for (; x + Ops::lanes <= width; x += Ops::lanes)
+  {
+    const Vec diff = Ops::sub(loadDifferenceInput<Ops>(par, 0, src0, x), loadDifferenceInput<Ops>(par, 1, src1, x));
+    sum = Ops::add(sum, Ops::mul(diff, diff));
+    if (++iterations == maxIterations)
+    {
+      sumSquaredDiff += sumUnsignedLanes<Ops>(sum);
+      sum = zero;
+      iterations = 0;
+    }
+
+    const Vec val = Ops::min(Ops::max(Ops::add(Ops::mul(diff, amplification), diffZero), zero), maxVal);
+    if (bpsOut > 8)
+      Ops::storeU16(dst + x*2, val);
+    else
+      Ops::storeU8(dst + x, val);
+  }
+  sumSquaredDiff += sumUnsignedLanes<Ops>(sum);
+  return x;
+}
+
+template<class Ops>
+int calculateSSIMBlockSumsKernel(const LineDifferenceParameters &par, const unsigned char *src0, const int stride0, const unsigned char *src1, const int stride1, int64_t (*sums)[4], const int nrBlocks)
+{
+  typedef typename Ops::Vec Vec;
+  // For 12 bit, the sum of A*A+B*B over the 4 lines of a lane is below 2^27 and the sum over 4 lanes below 2^29.
+  if (par.bitsPerSampleOut > 12 || Ops::lanes % 4 != 0)
+    return 0;
+
+  const int blocksPerIteration = Ops::lanes / 4;
+  int b = 0;
+  for (; b + blocksPerIteration <= nrBlocks; b += blocksPerIteration)
+  {
+    Vec sum[4] = {Ops::set1(0), Ops::set1(0), Ops::set1(0), Ops::set1(0)};
+    for (int y = 0; y < 4; y++)
+    {
+      const Vec val0 = loadDifferenceInput<Ops>(par, 0, src0 + y * stride0, b * 4);
+      const Vec val1 = loadDifferenceInput<Ops>(par, 1, src1 + y * stride1, b * 4);
+      sum[0] = Ops::add(sum[0], val0);
+      sum[1] = Ops::add(sum[1], val1);
+      sum[2] = Ops::add(sum[2], Ops::add(Ops::mul(val0, val0), Ops::mul(val1, val1)));
+      sum[3] = Ops::add(sum[3], Ops::mul(val0, val1));
+    }
+
+    // Add up the 4 lanes of each block
+    for (int i = 0; i < 4; i++)
+    {
+      int32_t values[Ops::lanes];
+      Ops::store((unsigned char*)values, sum[i]);
+      for (int j = 0; j < blocksPerIteration; j++)
+        sums[b + j][i] = int64_t(values[j*4]) + values[j*4+1] + values[j*4+2] + values[j*4+3];
+    }
+  }
+  return b;
+}
+
+} // namespace
+} // namespace YUV_Internals
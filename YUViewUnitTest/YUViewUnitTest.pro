@@ -3,4 +3,6 @@ TEMPLATE = subdirs
 requires(qtHaveModule(testlib))
 
 SUBDIRS = filesource \
+          statistics \
+          ui \
           video
@@ -1,4 +1,5 @@
 #include <QtTest>
+#include <QtConcurrent>
 
 #include <filesource/FileSource.h>
 
@@ -14,6 +15,9 @@ private slots:
   void testFormatFromFilename_data();
   void testFormatFromFilename();
 
+  void testReadBytesMemoryMapped();
+  void testReadBytesConcurrent();
+
 };
 
 FileSourceTest::FileSourceTest()
@@ -120,6 +124,105 @@ void FileSourceTest::testFormatFromFilename()
   QCOMPARE(fileFormat.packed, packed);
 }
 
+void FileSourceTest::testReadBytesMemoryMapped()
+{
+  QTemporaryFile file;
+  QVERIFY(file.open());
+  QByteArray fileData;
+  for (int i = 0; i < 100000; i++)
+    fileData.append(char(i * 7));
+  QVERIFY(file.write(fileData) == fileData.size());
+  file.flush();
+
+  QSettings settings;
+  const auto memoryMapSetting = settings.value("VideoCache/MemoryMapFiles");
+  settings.setValue("VideoCache/MemoryMapFiles", false);
+
+  FileSource source;
+  QVERIFY(source.openFile(file.fileName()));
+  source.updateMemoryMapSetting();
+  QVERIFY(!source.isMemoryMapped());
+
+  QByteArray readData;
+  QCOMPARE(source.readBytes(readData, 1000, 5000), int64_t(5000));
+  const auto dataRead = readData.left(5000);
+  QCOMPARE(dataRead, fileData.mid(1000, 5000));
+
+  settings.setValue("VideoCache/MemoryMapFiles", true);
+  source.updateMemoryMapSetting();
+  QVERIFY(source.isMemoryMapped());
+
+  QByteArray mappedData;
+  QCOMPARE(source.readBytes(mappedData, 1000, 5000), int64_t(5000));
+  QCOMPARE(mappedData, dataRead);
+  QCOMPARE(source.readBytes(mappedData, 99000, 1000), int64_t(1000));
+  QCOMPARE(mappedData, fileData.mid(99000, 1000));
+
+  // Reading past the end of the file is not possible from the mapping
+  QCOMPARE(source.readBytes(mappedData, 99500, 1000), int64_t(500));
+
+  // The data stays valid if the mapping is not used anymore
+  QByteArray frameData;
+  source.readBytes(frameData, 0, 100);
+  settings.setValue("VideoCache/MemoryMapFiles", false);
+  source.updateMemoryMapSetting();
+  QVERIFY(!source.isMemoryMapped());
+  QCOMPARE(frameData, fileData.left(100));
+
+  if (memoryMapSetting.isValid())
+    settings.setValue("VideoCache/MemoryMapFiles", memoryMapSetting);
+  else
+    settings.remove("VideoCache/MemoryMapFiles");
+}
+
+void FileSourceTest::testReadBytesConcurrent()
+{
+  QTemporaryFile file;
+  QVERIFY(file.open());
+  QByteArray fileData;
+  for (int i = 0; i < 1000000; i++)
+    fileData.append(char(i * 13));
+  QVERIFY(file.write(fileData) == fileData.size());
+  file.flush();
+
+  QSettings settings;
+  const auto memoryMapSetting = settings.value("VideoCache/MemoryMapFiles");
+  settings.setValue("VideoCache/MemoryMapFiles", false);
+
+  FileSource source;
+  QVERIFY(source.openFile(file.fileName()));
+  source.updateMemoryMapSetting();
+  QVERIFY(!source.isMemoryMapped());
+
+  // Read "frames" of the file from multiple threads at the same time. Every thread reads every frame.
+  const int frameSize = 10000;
+  const int nrFrames = int(fileData.size()) / frameSize;
+  QAtomicInt nrErrors;
+  auto readAllFrames = [&](int startFrame) {
+    QByteArray frameData;
+    for (int i = 0; i < nrFrames; i++)
+    {
+      const int frame = (startFrame + i) % nrFrames;
+      if (source.readBytes(frameData, frame * frameSize, frameSize) != frameSize || frameData.left(frameSize) != fileData.mid(frame * frameSize, frameSize))
+        nrErrors.ref();
+    }
+  };
+  QList<QFuture<void>> futures;
+  for (int t = 0; t < 8; t++)
+    futures.append(QtConcurrent::run([&readAllFrames, t, nrFrames]() { readAllFrames(t * nrFrames / 8); }));
+  for (auto &f : futures)
+    f.waitForFinished();
+  QCOMPARE(nrErrors.load(), 0);
+
+  // Reading does not change the position of the file
+  QCOMPARE(source.pos(), int64_t(0));
+
+  if (memoryMapSetting.isValid())
+    settings.setValue("VideoCache/MemoryMapFiles", memoryMapSetting);
+  else
+    settings.remove("VideoCache/MemoryMapFiles");
+}
+
 QTEST_MAIN(FileSourceTest)
 
 #include "tst_Filesource.moc"
@@ -2,8 +2,11 @@
 #include <QTemporaryFile>
 
 #include <filesource/FileSourceAnnexBFile.h>
+#include <filesource/StartCodeSearch.h>
+#include <video/yuvConversionSIMD.h>
 
 #include <optional>
+#include <random>
 
 class FileSourceAnnexBTest : public QObject
 {
@@ -16,6 +19,8 @@ public:
 private slots:
   void testNalUnitParsing_data();
   void testNalUnitParsing();
+
+  void testStartCodeSearch();
 };
 
 FileSourceAnnexBTest::FileSourceAnnexBTest()
@@ -43,6 +48,9 @@ void FileSourceAnnexBTest::testNalUnitParsing_data()
 
   // Test cases where a buffer reload is needed (the buffer is 500k)
   QTest::newRow("testBufferReload") << unsigned(3) << unsigned(1000000) << QList<unsigned>({80, 208, 500, 50000, 800000});
+  // NAL units that span multiple buffers and start codes at multiple buffer edges (the next buffer is read ahead in the background)
+  QTest::newRow("testBufferReloadMultiple1") << unsigned(3) << unsigned(3000000) << QList<unsigned>({80, 1200000, 2900000});
+  QTest::newRow("testBufferReloadMultiple2") << unsigned(4) << unsigned(3000000) << QList<unsigned>({80, 499998, 999999, 1500000, 2499997});
 
   // The buffer is 500k in size. Test all variations with a start code around this position
   QTest::newRow("testBufferEdge1") << unsigned(3) << unsigned(800000) << QList<unsigned>({80, 208, 500, 50000, 499997});
@@ -112,6 +120,35 @@ void FileSourceAnnexBTest::testNalUnitParsing()
   }
 }
 
+void FileSourceAnnexBTest::testStartCodeSearch()
+{
+  using YUV_Internals::SIMDInstructionSet;
+  const auto defaultSet = YUV_Internals::getSIMDInstructionSet();
+
+  // Random data with many 0 and 1 bytes so that there are start codes (and almost start codes) everywhere
+  std::mt19937 random(42);
+  QByteArray data;
+  for (int i = 0; i < 5000; i++)
+  {
+    const auto r = random() % 10;
+    data.append(r < 5 ? char(0) : r < 7 ? char(1) : char(random() % 256));
+  }
+
+  for (auto set : {SIMDInstructionSet::None, SIMDInstructionSet::SSE41, SIMDInstructionSet::AVX2, SIMDInstructionSet::NEON})
+  {
+    if (!YUV_Internals::setSIMDInstructionSet(set))
+      continue;
+
+    for (int size = 0; size < 300; size++)
+      for (int start = 0; start <= size; start++)
+        QCOMPARE(StartCodeSearch::findStartCode(data.constData(), size, start), StartCodeSearch::findStartCodeScalar(data.constData(), size, start));
+    for (int start = 0; start < data.size(); start++)
+      QCOMPARE(StartCodeSearch::findStartCode(data.constData(), data.size(), start), int64_t(data.indexOf(QByteArrayLiteral("\x00\x00\x01"), start)));
+  }
+
+  YUV_Internals::setSIMDInstructionSet(defaultSet);
+}
+
 QTEST_MAIN(FileSourceAnnexBTest)
 
 #include "tst_FilesourceAnnexB.moc"
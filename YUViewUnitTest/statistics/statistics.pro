@@ -0,0 +1,6 @@
+TEMPLATE = subdirs
+
+requires(qtHaveModule(testlib))
+
+SUBDIRS = statisticsDataTest.pro
+SUBDIRS += statisticsCSVParserTest.pro
@@ -0,0 +1,154 @@
+#include <QtTest>
+#include <QTemporaryFile>
+
+#include <random>
+
+#include <statistics/CSVStatisticsParser.h>
+
+class statisticsCSVParserTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  statisticsCSVParserTest() {};
+  ~statisticsCSVParserTest() {};
+
+private slots:
+  void testParseInt();
+  void testParseDataLine();
+  void testReadDataLines();
+};
+
+bool parseInt(const QByteArray &s, int &value)
+{
+  return CSVStatisticsParser::parseInt(s.constData(), s.constData() + s.size(), value);
+}
+
+bool parseDataLine(const QByteArray &s, CSVStatisticsParser::DataLine &line)
+{
+  return CSVStatisticsParser::parseDataLine(s.constData(), s.constData() + s.size(), line);
+}
+
+void statisticsCSVParserTest::testParseInt()
+{
+  int value = 0;
+  QVERIFY(parseInt("0", value) && value == 0);
+  QVERIFY(parseInt("1234", value) && value == 1234);
+  QVERIFY(parseInt(" -56 ", value) && value == -56);
+  QVERIFY(parseInt("+7\r", value) && value == 7);
+  QVERIFY(parseInt("2147483647", value) && value == 2147483647);
+  QVERIFY(parseInt("-2147483648", value) && value == -2147483647 - 1);
+
+  QVERIFY(!parseInt("", value));
+  QVERIFY(!parseInt(" ", value));
+  QVERIFY(!parseInt("-", value));
+  QVERIFY(!parseInt("12a", value));
+  QVERIFY(!parseInt("1 2", value));
+  QVERIFY(!parseInt("2147483648", value));
+  QVERIFY(!parseInt("99999999999999999999", value));
+}
+
+void statisticsCSVParserTest::testParseDataLine()
+{
+  CSVStatisticsParser::DataLine line;
+  QVERIFY(parseDataLine("3;16;32;8;4;2;-5", line));
+  QCOMPARE(line.poc, 3);
+  QCOMPARE(line.posX, 16);
+  QCOMPARE(line.posY, 32);
+  QCOMPARE(line.width, 8);
+  QCOMPARE(line.height, 4);
+  QCOMPARE(line.typeID, 2);
+  QCOMPARE(line.nrValues, 1);
+  QCOMPARE(line.values[0], -5);
+
+  QVERIFY(parseDataLine(" 1; 0; 0; 4; 4; 7; 3; -4\r", line));
+  QCOMPARE(line.nrValues, 2);
+  QCOMPARE(line.values[0], 3);
+  QCOMPARE(line.values[1], -4);
+
+  QVERIFY(parseDataLine("1;0;0;4;4;7;1;2;3;4", line));
+  QCOMPARE(line.nrValues, 4);
+  QCOMPARE(line.values[3], 4);
+
+  // A delimiter at the end of the line does not add a value
+  QVERIFY(parseDataLine("1;0;0;4;4;7;9;", line));
+  QCOMPARE(line.nrValues, 1);
+
+  QVERIFY(!parseDataLine("", line));
+  QVERIFY(!parseDataLine("  \r", line));
+  QVERIFY(!parseDataLine("% ; type; 1; MVs; vector", line));
+  QVERIFY(!parseDataLine("1;0;0;4;4;7", line));
+  QVERIFY(!parseDataLine("1;0;0;4;;7;3", line));
+  QVERIFY(!parseDataLine("1;0;0;4;x;7;3", line));
+}
+
+void statisticsCSVParserTest::testReadDataLines()
+{
+  // A file with header lines, comments and data lines of different lengths. The last line has no newline.
+  std::mt19937 random(42);
+  QByteArray data = "%;syntax-version;v1.22\n%;seq-specs;test;0;64;64;30\n%;type;1;value;range\n";
+  QList<QPair<qint64, QByteArray>> expectedLines;
+  for (int i = 0; i < 500; i++)
+  {
+    if (random() % 10 == 0)
+      data += "% comment\r\n";
+    QByteArray line = QByteArray::number(i / 50) + ";" + QByteArray::number(int(random() % 64)) + ";" + QByteArray::number(int(random() % 64)) + ";4;4;1";
+    const int nrValues = 1 + random() % 4;
+    for (int v = 0; v < nrValues; v++)
+      line += ";" + QByteArray::number(int(random() % 200) - 100);
+    expectedLines.append(qMakePair(qint64(data.size()), line));
+    data += line;
+    if (i < 499)
+      data += "\n";
+  }
+
+  QTemporaryFile f;
+  f.open();
+  f.write(data);
+  f.close();
+
+  FileSource file;
+  QVERIFY(file.openFile(f.fileName()));
+
+  // Small buffers, so that many lines cross the end of a buffer
+  for (int64_t bufferSize : {int64_t(37), int64_t(100), int64_t(4096), CSVStatisticsParser::ReadBufferSize})
+  {
+    QList<qint64> positions;
+    QList<CSVStatisticsParser::DataLine> lines;
+    CSVStatisticsParser::readDataLines(file, 0, [&](const CSVStatisticsParser::DataLine &line, int64_t lineStartPos)
+    {
+      positions.append(lineStartPos);
+      lines.append(line);
+      return true;
+    }, nullptr, bufferSize);
+
+    QCOMPARE(lines.count(), expectedLines.count());
+    for (int i = 0; i < lines.count(); i++)
+    {
+      CSVStatisticsParser::DataLine expected;
+      QVERIFY(parseDataLine(expectedLines[i].second, expected));
+      QCOMPARE(positions[i], expectedLines[i].first);
+      QCOMPARE(lines[i].poc, expected.poc);
+      QCOMPARE(lines[i].posX, expected.posX);
+      QCOMPARE(lines[i].posY, expected.posY);
+      QCOMPARE(lines[i].nrValues, expected.nrValues);
+      for (int v = 0; v < expected.nrValues; v++)
+        QCOMPARE(lines[i].values[v], expected.values[v]);
+    }
+  }
+
+  // Start reading at a line and stop when the POC changes
+  int count = 0;
+  CSVStatisticsParser::readDataLines(file, expectedLines[100].first, [&](const CSVStatisticsParser::DataLine &line, int64_t)
+  {
+    if (line.poc != 2)
+      return false;
+    count++;
+    return true;
+  }, nullptr, 64);
+  QCOMPARE(count, 50);
+}
+
+QTEST_MAIN(statisticsCSVParserTest)
+
+#include "statisticsCSVParserTest.moc"
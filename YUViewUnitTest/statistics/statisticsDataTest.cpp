@@ -0,0 +1,127 @@
+#include <QtTest>
+
+#include <random>
+
+#include <statistics/StatisticsBinaryFormat.h>
+#include <statistics/statisticsExtensions.h>
+
+class statisticsDataTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  statisticsDataTest() {};
+  ~statisticsDataTest() {};
+
+private slots:
+  void testBlocksInArea();
+  void testBlocksAtPosition();
+  void testBinaryEncoding();
+};
+
+// Get all blocks that intersect the area by looking at every block
+QList<int> getBlocksInAreaReference(const statisticsBlockList &blocks, const QRect &area)
+{
+  QList<int> result;
+  for (int i = 0; i < blocks.count(); i++)
+    if (blocks.getRect(i).intersects(area))
+      result.append(i);
+  return result;
+}
+
+QList<int> getBlocksInArea(const statisticsBlockList &blocks, const QRect &area)
+{
+  QList<int> result;
+  blocks.forEachBlockIn(area, [&result](int i) { result.append(i); });
+  return result;
+}
+
+void statisticsDataTest::testBlocksInArea()
+{
+  // A frame of 4x4 blocks with some bigger blocks (up to 128x128) on top
+  std::mt19937 random(42);
+  statisticsData data;
+  for (int y = 0; y < 600; y += 4)
+    for (int x = 0; x < 1000; x += 4)
+      data.addBlockValue(x, y, 4, 4, int(random() % 100));
+  for (int i = 0; i < 500; i++)
+  {
+    const int size = 8 << (random() % 5);
+    data.addBlockValue(random() % 1000, random() % 600, size, size, int(random() % 100));
+  }
+  QCOMPARE(data.valueBlocks.count(), data.values.count());
+
+  for (int i = 0; i < 200; i++)
+  {
+    const int x = int(random() % 1200) - 100;
+    const int y = int(random() % 800) - 100;
+    const QRect area(x, y, int(random() % 300) + 1, int(random() % 300) + 1);
+    QCOMPARE(getBlocksInArea(data.valueBlocks, area), getBlocksInAreaReference(data.valueBlocks, area));
+  }
+
+  // An area that contains everything visits all blocks in order
+  const QRect all(-10, -10, 2000, 2000);
+  QCOMPARE(getBlocksInArea(data.valueBlocks, all).count(), data.valueBlocks.count());
+  QCOMPARE(getBlocksInArea(data.valueBlocks, all), getBlocksInAreaReference(data.valueBlocks, all));
+}
+
+void statisticsDataTest::testBlocksAtPosition()
+{
+  statisticsData data;
+  data.addBlockVector(0, 0, 64, 64, 3, -4);
+  data.addLine(64, 0, 8, 8, 0, 0, 100, 2);
+  data.addBlockVector(70, 2, 4, 4, 1, 1);
+  QCOMPARE(data.maxVectorComponent, 100);
+
+  QCOMPARE(getBlocksInArea(data.vectorBlocks, QRect(10, 10, 1, 1)), QList<int>({0}));
+  QCOMPARE(getBlocksInArea(data.vectorBlocks, QRect(71, 3, 1, 1)), QList<int>({1, 2}));
+  QCOMPARE(getBlocksInArea(data.vectorBlocks, QRect(100, 100, 1, 1)), QList<int>());
+  QVERIFY(data.vectorIsLine[1]);
+  QCOMPARE(data.vectorPoints1[1], QPoint(100, 2));
+}
+
+void statisticsDataTest::testBinaryEncoding()
+{
+  statisticsData data;
+  data.addBlockValue(0, 0, 8, 8, 5);
+  data.addBlockValue(8, 0, 16, 8, -7);
+  data.addBlockVector(0, 8, 4, 4, 3, -4);
+  data.addLine(4, 8, 4, 4, 0, 1, 2, 3);
+  data.addBlockAffineTF(16, 16, 8, 8, 1, 2, 3, 4, 5, -6);
+  data.addPolygonValue({QPoint(0, 0), QPoint(10, 0), QPoint(0, 10)}, 42);
+  data.addPolygonVector({QPoint(1, 1), QPoint(5, 1), QPoint(5, 5), QPoint(1, 5)}, -2, 9);
+
+  const QByteArray chunk = StatisticsBinaryFormat::encodeData(data);
+  QCOMPARE(chunk.size() % 4, 0);
+
+  statisticsData decoded;
+  QVERIFY(StatisticsBinaryFormat::decodeData(chunk.constData(), chunk.size(), decoded));
+  QCOMPARE(decoded.valueBlocks.posX, data.valueBlocks.posX);
+  QCOMPARE(decoded.valueBlocks.width, data.valueBlocks.width);
+  QCOMPARE(decoded.values, data.values);
+  QCOMPARE(decoded.vectorBlocks.posY, data.vectorBlocks.posY);
+  QCOMPARE(decoded.vectorPoints0, data.vectorPoints0);
+  QCOMPARE(decoded.vectorPoints1, data.vectorPoints1);
+  QCOMPARE(decoded.vectorIsLine, data.vectorIsLine);
+  QCOMPARE(decoded.affineTFBlocks.height, data.affineTFBlocks.height);
+  QCOMPARE(decoded.affineTFPoints, data.affineTFPoints);
+  QCOMPARE(decoded.polygonValueData.count(), 1);
+  QCOMPARE(decoded.polygonValueData[0].corners, data.polygonValueData[0].corners);
+  QCOMPARE(decoded.polygonValueData[0].value, 42);
+  QCOMPARE(decoded.polygonVectorData.count(), 1);
+  QCOMPARE(decoded.polygonVectorData[0].corners, data.polygonVectorData[0].corners);
+  QCOMPARE(decoded.polygonVectorData[0].point[0], QPoint(-2, 9));
+  QCOMPARE(decoded.maxBlockSize, data.maxBlockSize);
+  QCOMPARE(decoded.maxVectorComponent, data.maxVectorComponent);
+
+  // The block lists can be searched after decoding
+  QCOMPARE(getBlocksInArea(decoded.valueBlocks, QRect(10, 2, 1, 1)), QList<int>({1}));
+
+  // A truncated chunk is rejected
+  statisticsData truncated;
+  QVERIFY(!StatisticsBinaryFormat::decodeData(chunk.constData(), chunk.size() - 4, truncated));
+}
+
+QTEST_MAIN(statisticsDataTest)
+
+#include "statisticsDataTest.moc"
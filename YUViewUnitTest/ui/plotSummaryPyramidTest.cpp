@@ -0,0 +1,181 @@
+#include <QtTest>
+
+#include <cmath>
+#include <random>
+
+#include <ui/views/PlotSummaryPyramid.h>
+
+class plotSummaryPyramidTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  plotSummaryPyramidTest() {};
+  ~plotSummaryPyramidTest() {};
+
+private slots:
+  void testFewPoints();
+  void testSummaries();
+  void testInvalidate();
+  void testCombinePerPixelColumn();
+};
+
+void plotSummaryPyramidTest::testFewPoints()
+{
+  QList<PlotModel::Point> points;
+  for (int i = 0; i < 10; i++)
+    points.append({double(i), double(i), 1, false});
+  auto getPoint = [&points](unsigned i) { return points[int(i)]; };
+
+  // If there are not more points than summaries, the points should be drawn one by one
+  PlotSummaryPyramid pyramid;
+  QVERIFY(!pyramid.getSummaries(unsigned(points.size()), getPoint, {0, 9}, 10));
+  QVERIFY(!pyramid.getSummaries(unsigned(points.size()), getPoint, {0, 3}, 5));
+  QVERIFY(pyramid.getSummaries(unsigned(points.size()), getPoint, {0, 9}, 5));
+}
+
+// Check that the summaries cover all points in the range and that the minimum/maximum of each summary
+// matches the points that it covers.
+void checkSummaries(const QList<PlotModel::Point> &points, const QVector<PlotModel::PointSummary> &summaries, Range<double> range)
+{
+  double maxInRange = -1;
+  double minInRange = std::numeric_limits<double>::max();
+  for (const auto &point : points)
+    if (point.x >= range.min && point.x <= range.max)
+    {
+      maxInRange = std::max(maxInRange, point.y);
+      minInRange = std::min(minInRange, point.y);
+    }
+  double maxInSummaries = -1;
+  double minInSummaries = std::numeric_limits<double>::max();
+  for (const auto &summary : summaries)
+  {
+    maxInSummaries = std::max(maxInSummaries, summary.yMax);
+    minInSummaries = std::min(minInSummaries, summary.yMin);
+
+    double maxInSummary = -1;
+    double minInSummary = std::numeric_limits<double>::max();
+    bool intra = false;
+    for (const auto &point : points)
+      if (point.x - point.width / 2 >= summary.xMin && point.x + point.width / 2 <= summary.xMax)
+      {
+        maxInSummary = std::max(maxInSummary, point.y);
+        minInSummary = std::min(minInSummary, point.y);
+        intra |= point.intra;
+      }
+    QCOMPARE(summary.yMax, maxInSummary);
+    QCOMPARE(summary.yMin, minInSummary);
+    QCOMPARE(summary.intra, intra);
+  }
+  QVERIFY(maxInSummaries >= maxInRange);
+  QVERIFY(minInSummaries <= minInRange);
+}
+
+void plotSummaryPyramidTest::testSummaries()
+{
+  std::mt19937 gen(4711);
+  std::uniform_int_distribution<> distValue(0, 10000);
+
+  QList<PlotModel::Point> points;
+  for (int i = 0; i < 10000; i++)
+    points.append({double(i * 2), double(distValue(gen)), 2, distValue(gen) < 100});
+  auto getPoint = [&points](unsigned i) { return points[int(i)]; };
+
+  PlotSummaryPyramid pyramid;
+  for (const auto maxNrSummaries : {7u, 100u, 640u, 1920u})
+  {
+    for (const Range<double> range : {Range<double>{0, 20000}, Range<double>{5000, 5999}, Range<double>{17, 18003}})
+    {
+      const auto summaries = pyramid.getSummaries(unsigned(points.size()), getPoint, range, maxNrSummaries);
+      if (!summaries)
+      {
+        QVERIFY((range.max - range.min) / 2 < maxNrSummaries + 2);
+        continue;
+      }
+      QVERIFY(unsigned(summaries->size()) <= maxNrSummaries);
+      checkSummaries(points, *summaries, range);
+    }
+  }
+}
+
+void plotSummaryPyramidTest::testInvalidate()
+{
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<> distValue(0, 1000);
+
+  QList<PlotModel::Point> points;
+  auto getPoint = [&points](unsigned i) { return points[int(i)]; };
+
+  // Append points and change existing ones in between. The summaries must always match the current points.
+  PlotSummaryPyramid pyramid;
+  for (int round = 0; round < 50; round++)
+  {
+    for (int i = 0; i < 200; i++)
+      points.append({double(points.size()), double(distValue(gen)), 1, false});
+    if (round % 2 == 0)
+    {
+      const auto changedIndex = unsigned(distValue(gen)) % unsigned(points.size());
+      points[int(changedIndex)].y = 2000;
+      pyramid.invalidateFrom(changedIndex);
+    }
+
+    const Range<double> range {0, double(points.size())};
+    const auto summaries = pyramid.getSummaries(unsigned(points.size()), getPoint, range, 50);
+    QVERIFY(summaries);
+    QVERIFY(summaries->size() <= 50);
+    checkSummaries(points, *summaries, range);
+  }
+}
+
+void plotSummaryPyramidTest::testCombinePerPixelColumn()
+{
+  // 1000 summaries of width 1. Combine them for different (non integer) numbers of pixels per summary.
+  QVector<PlotModel::PointSummary> summaries;
+  for (int i = 0; i < 1000; i++)
+    summaries.append({double(i), double(i + 1), double(i % 7), double(i % 7 + 10), double(i % 7 + 5), i % 100 == 0});
+
+  for (const auto pixelsPerSummary : {0.1, 0.37, 0.5, 0.9, 1.3, 2.5})
+  {
+    const auto offset = 13.7;
+    auto plotXToPixelX = [&](double x) { return offset + x * pixelsPerSummary; };
+    const auto columns = PlotSummaryPyramid::combinePerPixelColumn(summaries, plotXToPixelX);
+
+    // There is one column for every pixel that the center of a summary falls into
+    QSet<double> centerColumns;
+    for (const auto &summary : summaries)
+      centerColumns.insert(std::floor(plotXToPixelX((summary.xMin + summary.xMax) / 2)));
+    QCOMPARE(columns.size(), centerColumns.size());
+    if (pixelsPerSummary < 1)
+      QCOMPARE(columns.size(), int(std::floor(plotXToPixelX(999.5)) - std::floor(plotXToPixelX(0.5))) + 1);
+    else
+      QCOMPARE(columns.size(), summaries.size());
+
+    double lastCenterColumn = -1;
+    for (const auto &column : columns)
+    {
+      // The columns are in order and a column is at most one pixel wider than a single summary
+      const auto centerColumn = std::floor(plotXToPixelX((column.xMin + column.xMax) / 2));
+      QVERIFY(centerColumn > lastCenterColumn);
+      lastCenterColumn = centerColumn;
+      QVERIFY((column.xMax - column.xMin) * pixelsPerSummary <= 1 + pixelsPerSummary + 1e-9);
+
+      // The values match the summaries that the column covers
+      double yMin = std::numeric_limits<double>::max(), yMax = -1;
+      bool intra = false;
+      for (const auto &summary : summaries)
+        if (summary.xMin >= column.xMin && summary.xMax <= column.xMax)
+        {
+          yMin = std::min(yMin, summary.yMin);
+          yMax = std::max(yMax, summary.yMax);
+          intra |= summary.intra;
+        }
+      QCOMPARE(column.yMin, yMin);
+      QCOMPARE(column.yMax, yMax);
+      QCOMPARE(column.intra, intra);
+    }
+  }
+}
+
+QTEST_MAIN(plotSummaryPyramidTest)
+
+#include "plotSummaryPyramidTest.moc"
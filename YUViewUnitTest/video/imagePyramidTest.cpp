@@ -0,0 +1,76 @@
+#include <QtTest>
+
+#include <video/imagePyramid.h>
+
+class imagePyramidTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  imagePyramidTest() {};
+  ~imagePyramidTest() {};
+
+private slots:
+  void testGetLevelForScale();
+  void testDownscaleByTwo();
+  void testDownscaleOddSize();
+};
+
+void imagePyramidTest::testGetLevelForScale()
+{
+  QCOMPARE(ImagePyramid::getLevelForScale(4.0), 0);
+  QCOMPARE(ImagePyramid::getLevelForScale(1.0), 0);
+  QCOMPARE(ImagePyramid::getLevelForScale(0.6), 0);
+  QCOMPARE(ImagePyramid::getLevelForScale(0.5), 1);
+  QCOMPARE(ImagePyramid::getLevelForScale(0.3), 1);
+  QCOMPARE(ImagePyramid::getLevelForScale(0.25), 2);
+  QCOMPARE(ImagePyramid::getLevelForScale(0.125), 3);
+  QCOMPARE(ImagePyramid::getLevelForScale(0.01), ImagePyramid::NrLevels - 1);
+}
+
+void imagePyramidTest::testDownscaleByTwo()
+{
+  // Big enough to be processed in multiple bands
+  QImage image(512, 300, QImage::Format_ARGB32);
+  for (int y = 0; y < image.height(); y++)
+    for (int x = 0; x < image.width(); x++)
+      image.setPixel(x, y, qRgba((x * 7 + y) % 256, (x + y * 3) % 256, (x * y) % 256, (x + y) % 256));
+
+  const QImage scaled = ImagePyramid::downscaleByTwo(image);
+  QCOMPARE(scaled.size(), QSize(256, 150));
+  QCOMPARE(scaled.format(), image.format());
+
+  for (int y = 0; y < scaled.height(); y++)
+  {
+    for (int x = 0; x < scaled.width(); x++)
+    {
+      const QRgb p[4] = {image.pixel(2*x, 2*y), image.pixel(2*x+1, 2*y), image.pixel(2*x, 2*y+1), image.pixel(2*x+1, 2*y+1)};
+      const QRgb expected = qRgba((qRed(p[0]) + qRed(p[1]) + qRed(p[2]) + qRed(p[3]) + 2) / 4,
+                                  (qGreen(p[0]) + qGreen(p[1]) + qGreen(p[2]) + qGreen(p[3]) + 2) / 4,
+                                  (qBlue(p[0]) + qBlue(p[1]) + qBlue(p[2]) + qBlue(p[3]) + 2) / 4,
+                                  (qAlpha(p[0]) + qAlpha(p[1]) + qAlpha(p[2]) + qAlpha(p[3]) + 2) / 4);
+      QCOMPARE(scaled.pixel(x, y), expected);
+    }
+  }
+}
+
+void imagePyramidTest::testDownscaleOddSize()
+{
+  QImage image(3, 3, QImage::Format_RGB32);
+  image.fill(qRgb(10, 20, 30));
+  image.setPixel(2, 2, qRgb(50, 60, 70));
+
+  const QImage scaled = ImagePyramid::downscaleByTwo(image);
+  QCOMPARE(scaled.size(), QSize(2, 2));
+  QCOMPARE(scaled.pixel(0, 0), qRgb(10, 20, 30));
+  // The last row and column are repeated
+  QCOMPARE(scaled.pixel(1, 0), qRgb(10, 20, 30));
+  QCOMPARE(scaled.pixel(1, 1), qRgb(50, 60, 70));
+
+  const QImage one = ImagePyramid::downscaleByTwo(QImage(1, 1, QImage::Format_RGB32));
+  QCOMPARE(one.size(), QSize(1, 1));
+}
+
+QTEST_MAIN(imagePyramidTest)
+
+#include "imagePyramidTest.moc"
@@ -4,4 +4,7 @@ requires(qtHaveModule(testlib))
 
 SUBDIRS = yuvPixelFormatTest.pro \
           rgbPixelFormatTest.pro \
-          yuvPixelFormatGuessTest.pro
+          yuvPixelFormatGuessTest.pro \
+          yuvConversionSIMDTest.pro \
+          yuvConversionBenchmark.pro \
+          imagePyramidTest.pro
@@ -0,0 +1,141 @@
+#include <QtTest>
+
+#include <video/yuvConversion.h>
+#include <video/yuvPixelFormat.h>
+
+using namespace YUV_Internals;
+
+class yuvConversionBenchmark : public QObject
+{
+  Q_OBJECT
+
+public:
+  yuvConversionBenchmark() {};
+  ~yuvConversionBenchmark() {};
+
+private slots:
+  void testSpecializedKernelsBitExact_data();
+  void testSpecializedKernelsBitExact();
+  void benchmarkConversion_data();
+  void benchmarkConversion();
+};
+
+// Get a frame of pseudo random samples (all planes) in the given format
+QByteArray getRandomFrame(const QSize &frameSize, const yuvPixelFormat &format, unsigned int seed)
+{
+  const int maxValue = (1 << format.bitsPerSample) - 1;
+  const int bytesPerSample = (format.bitsPerSample > 8) ? 2 : 1;
+  QByteArray data(int(format.bytesPerFrame(frameSize)), 0);
+  for (int i = 0; i < data.size() / bytesPerSample; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    const int val = int((seed >> 8) % (unsigned int)(maxValue + 1));
+    if (bytesPerSample == 1)
+      data[i] = char(val);
+    else if (format.bigEndian)
+    {
+      data[i*2] = char(val >> 8);
+      data[i*2+1] = char(val & 0xff);
+    }
+    else
+    {
+      data[i*2] = char(val & 0xff);
+      data[i*2+1] = char(val >> 8);
+    }
+  }
+  return data;
+}
+
+void yuvConversionBenchmark::testSpecializedKernelsBitExact_data()
+{
+  QTest::addColumn<int>("subsampling");
+
+  for (auto subsampling : subsamplingList)
+    QTest::newRow(subsamplingToString(subsampling).toLocal8Bit().data()) << int(subsampling);
+}
+
+void yuvConversionBenchmark::testSpecializedKernelsBitExact()
+{
+  QFETCH(int, subsampling);
+
+  const QSize frameSize(64, 48);
+  for (auto bitsPerSample : bitDepthList)
+  {
+    for (auto bigEndian : {false, true})
+    {
+      if (bigEndian && bitsPerSample == 8)
+        continue;
+      const yuvPixelFormat format(Subsampling(subsampling), bitsPerSample, PlaneOrder::YUV, bigEndian);
+      const auto data = getRandomFrame(frameSize, format, 42);
+
+      for (auto interpolation : chromaInterpolationList)
+      {
+        for (auto conversion : {ColorConversion::BT709_LimitedRange, ColorConversion::BT601_FullRange})
+        {
+          for (auto applyMath : {false, true})
+          {
+            ConversionSettings settings;
+            settings.chromaInterpolation = interpolation;
+            settings.colorConversion = conversion;
+            if (applyMath)
+            {
+              settings.mathY = MathParameters(2, 1 << (bitsPerSample - 1), false);
+              settings.mathC = MathParameters(3, 1 << (bitsPerSample - 1), true);
+            }
+
+            QByteArray reference(frameSize.width() * frameSize.height() * 4, 0);
+            QByteArray result(frameSize.width() * frameSize.height() * 4, 0);
+            settings.useSpecializedKernels = false;
+            QVERIFY(convertYUVPlanarToRGB(data, (unsigned char*)reference.data(), frameSize, format, settings));
+            settings.useSpecializedKernels = true;
+            QVERIFY(convertYUVPlanarToRGB(data, (unsigned char*)result.data(), frameSize, format, settings));
+
+            if (result != reference)
+              QFAIL(QString("Result differs from the generic conversion. Bits %1 bigEndian %2 interpolation %3 fullRange %4 math %5")
+                    .arg(bitsPerSample).arg(bigEndian).arg(int(interpolation)).arg(conversion == ColorConversion::BT601_FullRange).arg(applyMath).toLocal8Bit().data());
+          }
+        }
+      }
+    }
+  }
+}
+
+void yuvConversionBenchmark::benchmarkConversion_data()
+{
+  QTest::addColumn<int>("subsampling");
+  QTest::addColumn<int>("bitsPerSample");
+  QTest::addColumn<bool>("specialized");
+
+  // Only these formats have specialized kernels (see ConversionSettings::useSpecializedKernels)
+  for (auto subsampling : {Subsampling::YUV_440, Subsampling::YUV_410, Subsampling::YUV_411})
+    for (auto bitsPerSample : {8, 10})
+      for (auto specialized : {false, true})
+      {
+        const auto name = QString("%1 %2 bit %3").arg(subsamplingToString(subsampling)).arg(bitsPerSample).arg(specialized ? "specialized" : "generic");
+        QTest::newRow(name.toLocal8Bit().data()) << int(subsampling) << bitsPerSample << specialized;
+      }
+}
+
+void yuvConversionBenchmark::benchmarkConversion()
+{
+  QFETCH(int, subsampling);
+  QFETCH(int, bitsPerSample);
+  QFETCH(bool, specialized);
+
+  const QSize frameSize(1920, 1080);
+  const yuvPixelFormat format(Subsampling(subsampling), bitsPerSample);
+  const auto data = getRandomFrame(frameSize, format, 42);
+  QByteArray result(frameSize.width() * frameSize.height() * 4, 0);
+
+  ConversionSettings settings;
+  settings.chromaInterpolation = ChromaInterpolation::Bilinear;
+  settings.useSpecializedKernels = specialized;
+  QBENCHMARK
+  {
+    convertYUVPlanarToRGB(data, (unsigned char*)result.data(), frameSize, format, settings);
+  }
+}
+
+QTEST_MAIN(yuvConversionBenchmark)
+
+#include "yuvConversionBenchmark.moc"
@@ -0,0 +1,225 @@
+#include <QtTest>
+
+#include <video/yuvConversionSIMD.h>
+#include <video/yuvPixelFormat.h>
+
+using namespace YUV_Internals;
+
+class yuvConversionSIMDTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  yuvConversionSIMDTest() {};
+  ~yuvConversionSIMDTest() {};
+
+private slots:
+  void cleanup();
+  void testConversionBitExact_data();
+  void testConversionBitExact();
+  void testDifferenceBitExact_data();
+  void testDifferenceBitExact();
+};
+
+// A simple deterministic pseudo random generator so that failures can be reproduced
+class randomSamples
+{
+public:
+  randomSamples(unsigned int seed) : state(seed) {}
+  int next(int maxValue) { state = state * 1103515245 + 12345; return int((state >> 8) % (unsigned int)(maxValue + 1)); }
+private:
+  unsigned int state;
+};
+
+QByteArray getRandomPlane(randomSamples &rand, int nrSamples, int bitsPerSample, bool bigEndian)
+{
+  const int maxValue = (1 << bitsPerSample) - 1;
+  QByteArray data;
+  for (int i = 0; i < nrSamples; i++)
+  {
+    const int val = rand.next(maxValue);
+    if (bitsPerSample <= 8)
+      data.append(char(val));
+    else if (bigEndian)
+      data.append(char(val >> 8)).append(char(val & 0xff));
+    else
+      data.append(char(val & 0xff)).append(char(val >> 8));
+  }
+  return data;
+}
+
+void yuvConversionSIMDTest::cleanup()
+{
+  // Go back to the default instruction set
+  for (auto set : {SIMDInstructionSet::AVX2, SIMDInstructionSet::NEON, SIMDInstructionSet::SSE41, SIMDInstructionSet::None})
+    if (setSIMDInstructionSet(set))
+      break;
+}
+
+void yuvConversionSIMDTest::testConversionBitExact_data()
+{
+  QTest::addColumn<int>("instructionSet");
+  QTest::addColumn<int>("subsampling");
+
+  for (auto set : {SIMDInstructionSet::SSE41, SIMDInstructionSet::AVX2, SIMDInstructionSet::NEON})
+  {
+    QTest::newRow(QString("%1 4:4:4").arg(getSIMDInstructionSetName(set)).toLocal8Bit().data()) << int(set) << int(Subsampling::YUV_444);
+    QTest::newRow(QString("%1 4:2:2").arg(getSIMDInstructionSetName(set)).toLocal8Bit().data()) << int(set) << int(Subsampling::YUV_422);
+    QTest::newRow(QString("%1 4:2:0").arg(getSIMDInstructionSetName(set)).toLocal8Bit().data()) << int(set) << int(Subsampling::YUV_420);
+  }
+}
+
+void yuvConversionSIMDTest::testConversionBitExact()
+{
+  QFETCH(int, instructionSet);
+  QFETCH(int, subsampling);
+
+  const auto set = SIMDInstructionSet(instructionSet);
+  if (!isSIMDInstructionSetSupported(set))
+    QSKIP("The instruction set is not supported on this machine");
+
+  randomSamples rand(42);
+  for (auto bitsPerSample : bitDepthList)
+  {
+    for (auto bigEndian : {false, true})
+    {
+      if (bigEndian && bitsPerSample == 8)
+        continue;
+      for (auto inValSkip : {1, 2, 3})
+      {
+        for (auto conversion : colorConversionList)
+        {
+          for (auto bilinear : {false, true})
+          {
+            for (auto applyMath : {false, true})
+            {
+              LineConversionParameters par;
+              par.bitsPerSample = bitsPerSample;
+              par.bigEndian = bigEndian;
+              par.inValSkip = inValSkip;
+              par.fullRange = (conversion == ColorConversion::BT709_FullRange || conversion == ColorConversion::BT601_FullRange || conversion == ColorConversion::BT2020_FullRange);
+              getColorConversionCoefficients(conversion, par.RGBConv);
+              par.bilinearInterpolation = bilinear;
+              par.inMax = (1 << bitsPerSample) - 1;
+              par.applyMathLuma = applyMath;
+              par.mathLumaScale = 2;
+              par.mathLumaOffset = 1 << (bitsPerSample - 1);
+              par.mathLumaInvert = false;
+              par.applyMathChroma = applyMath;
+              par.mathChromaScale = 3;
+              par.mathChromaOffset = 1 << (bitsPerSample - 1);
+              par.mathChromaInvert = true;
+
+              // Test widths that are not a multiple of the vector size as well
+              for (auto width : {2, 6, 16, 34, 130})
+              {
+                // For 4:2:0, two lines of luma samples are converted with two lines of chroma samples (the line and the next line)
+                const int nrLines = (Subsampling(subsampling) == Subsampling::YUV_420) ? 2 : 1;
+                const int widthChroma = (Subsampling(subsampling) == Subsampling::YUV_444) ? width : width / 2;
+                const int bytesPerSample = (bitsPerSample > 8) ? 2 : 1;
+                const auto dataY = getRandomPlane(rand, width * nrLines, bitsPerSample, bigEndian);
+                const auto dataUV = getRandomPlane(rand, widthChroma * inValSkip * nrLines, bitsPerSample, bigEndian);
+                const auto srcY = (const unsigned char*)dataY.data();
+                const auto srcU = (const unsigned char*)dataUV.data();
+                const auto srcV = srcU + ((inValSkip > 1) ? bytesPerSample : 0);
+                const int chromaLineOffset = widthChroma * inValSkip * bytesPerSample;
+
+                QByteArray reference(width * nrLines * 4, 0);
+                QByteArray result(width * nrLines * 4, 0);
+                auto convert = [&](QByteArray &output)
+                {
+                  auto dst = (unsigned char*)output.data();
+                  if (Subsampling(subsampling) == Subsampling::YUV_420)
+                    convertLinesToRGB_420(par, srcY, srcY + width * bytesPerSample, srcU, srcV, srcU + chromaLineOffset, srcV + chromaLineOffset, dst, dst + width * 4, width);
+                  else if (Subsampling(subsampling) == Subsampling::YUV_422)
+                    convertLineToRGB_422(par, srcY, srcU, srcV, dst, width);
+                  else
+                    convertLineToRGB_444(par, srcY, srcU, srcV, dst, width);
+                };
+                QVERIFY(setSIMDInstructionSet(SIMDInstructionSet::None));
+                convert(reference);
+                QVERIFY(setSIMDInstructionSet(set));
+                convert(result);
+
+                if (result != reference)
+                  QFAIL(QString("Result differs from the scalar conversion. Bits %1 bigEndian %2 skip %3 bilinear %4 math %5 width %6")
+                        .arg(bitsPerSample).arg(bigEndian).arg(inValSkip).arg(bilinear).arg(applyMath).arg(width).toLocal8Bit().data());
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+void yuvConversionSIMDTest::testDifferenceBitExact_data()
+{
+  QTest::addColumn<int>("instructionSet");
+
+  for (auto set : {SIMDInstructionSet::SSE41, SIMDInstructionSet::AVX2, SIMDInstructionSet::NEON})
+    QTest::newRow(getSIMDInstructionSetName(set)) << int(set);
+}
+
+void yuvConversionSIMDTest::testDifferenceBitExact()
+{
+  QFETCH(int, instructionSet);
+
+  const auto set = SIMDInstructionSet(instructionSet);
+  if (!isSIMDInstructionSetSupported(set))
+    QSKIP("The instruction set is not supported on this machine");
+
+  randomSamples rand(7);
+  for (auto bitsPerSample0 : bitDepthList)
+  {
+    for (auto bitsPerSample1 : {8, 10, 16})
+    {
+      for (auto bigEndian : {false, true})
+      {
+        for (auto amplificationFactor : {1, 4})
+        {
+          LineDifferenceParameters par;
+          par.bitsPerSample[0] = bitsPerSample0;
+          par.bitsPerSample[1] = bitsPerSample1;
+          par.bigEndian[0] = bigEndian;
+          par.bigEndian[1] = false;
+          par.bitsPerSampleOut = std::max(bitsPerSample0, bitsPerSample1);
+          par.shift[0] = par.bitsPerSampleOut - bitsPerSample0;
+          par.shift[1] = par.bitsPerSampleOut - bitsPerSample1;
+          par.amplificationFactor = amplificationFactor;
+
+          // Test widths that are not a multiple of the vector size as well
+          for (auto width : {3, 8, 20, 34, 130})
+          {
+            const auto data0 = getRandomPlane(rand, width * 4, bitsPerSample0, bigEndian);
+            const auto data1 = getRandomPlane(rand, width * 4, bitsPerSample1, false);
+            const auto src0 = (const unsigned char*)data0.data();
+            const auto src1 = (const unsigned char*)data1.data();
+            const int stride0 = width * (bitsPerSample0 > 8 ? 2 : 1);
+            const int stride1 = width * (bitsPerSample1 > 8 ? 2 : 1);
+            const int nrBlocks = width / 4;
+
+            QByteArray reference(width * 2, 0);
+            QByteArray result(width * 2, 0);
+            QVector<int64_t> referenceSums(nrBlocks * 4);
+            QVector<int64_t> resultSums(nrBlocks * 4);
+            QVERIFY(setSIMDInstructionSet(SIMDInstructionSet::None));
+            const auto referenceSSE = calculateLineDifference(par, src0, src1, (unsigned char*)reference.data(), width);
+            calculateSSIMBlockSums(par, src0, stride0, src1, stride1, (int64_t(*)[4])referenceSums.data(), nrBlocks);
+            QVERIFY(setSIMDInstructionSet(set));
+            const auto resultSSE = calculateLineDifference(par, src0, src1, (unsigned char*)result.data(), width);
+            calculateSSIMBlockSums(par, src0, stride0, src1, stride1, (int64_t(*)[4])resultSums.data(), nrBlocks);
+
+            if (result != reference || resultSSE != referenceSSE || resultSums != referenceSums)
+              QFAIL(QString("Result differs from the scalar difference. Bits %1/%2 bigEndian %3 amplification %4 width %5")
+                    .arg(bitsPerSample0).arg(bitsPerSample1).arg(bigEndian).arg(amplificationFactor).arg(width).toLocal8Bit().data());
+          }
+        }
+      }
+    }
+  }
+}
+
+QTEST_MAIN(yuvConversionSIMDTest)
+
+#include "yuvConversionSIMDTest.moc"